@@ -0,0 +1,182 @@
+// ---------------------------------------------------------------
+// Asset archive format (assets.pak)
+// ---------------------------------------------------------------
+// Written by tools/assetcook.cpp, streamed by assetstreamer.h.
+//
+//   AssetPakHeader
+//   AssetPakEntry[entryCount]       sorted by nameHash
+//   blobs                           each kAssetPakAlignment aligned
+//
+// Blobs are GPU-ready: whatever the cooker wrote is what the copy lands in
+// the destination resource, no fixups on load. 4K alignment means every
+// blob starts on a sector and a page, so it can be read unbuffered or by
+// DirectStorage, or memory-mapped without straddling into its neighbour's
+// first page.
+//
+// An entry is either stored as is or GDeflate compressed; GDeflate needs the
+// DirectStorage path to load (it decompresses on the GPU, or on its own worker
+// threads where the GPU can't). Textures are always stored as is – they are
+// streamed a mip at a time, and a compressed blob can only be read whole.
+//
+// Plain std only – the cooker has to build without the Windows SDK.
+#pragma once
+
+#include "shaderpak.h"      // HashString
+#include <cstdint>
+#include <cstring>
+
+static const uint32_t kAssetPakMagic     = 0x50415753;   // 'SWAP'
+static const uint32_t kAssetPakVersion   = 3;
+static const uint64_t kAssetPakAlignment = 4096;
+
+enum AssetType : uint32_t
+{
+    kAssetRaw,          // opaque bytes
+    kAssetMesh,         // PackedVertex[] then uint16 indices, MeshAssetMeta in the entry
+    kAssetMeshlets,     // Meshlet[], vertex indices, packed triangles – "<mesh>/meshlets"
+    kAssetTexture,      // BC blocks, every mip in copy layout (TextureMip()), TextureAssetMeta in the entry
+};
+
+enum AssetCompression : uint32_t
+{
+    kAssetCompressionNone,
+    kAssetCompressionGDeflate,
+};
+
+struct AssetPakHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct AssetPakEntry
+{
+    uint64_t nameHash;
+    uint64_t offset;            // from the start of the file
+    uint64_t storedSize;        // in the file
+    uint64_t size;              // once decompressed – what lands in memory
+    uint32_t type;              // AssetType
+    uint32_t compression;       // AssetCompression
+    uint32_t meta[12];          // per type, so loaders can size things before the data arrives
+    char     name[40];          // for tools / error messages only
+};
+
+// AssetPakEntry::meta of a kAssetMesh
+struct MeshAssetMeta
+{
+    uint32_t vertexCount;
+    uint32_t indexCount;        // 16 bit, right after the vertices
+    uint32_t vertexStride;
+    uint32_t meshletCount;      // in the "<mesh>/meshlets" entry
+    float    boundsCenter[3];   // bounding sphere, mesh space
+    float    boundsRadius;
+    float    positionOffset[3]; // snorm16 position * positionScale + positionOffset = mesh space
+    float    positionScale;
+};
+static_assert(sizeof(MeshAssetMeta) == sizeof(AssetPakEntry::meta), "MeshAssetMeta has to fit AssetPakEntry::meta");
+
+// AssetPakEntry::meta of a kAssetMeshlets
+struct MeshletAssetMeta
+{
+    uint32_t meshletCount;
+    uint32_t vertexCount;       // uint32 indices into the mesh's vertices
+    uint32_t triangleCount;     // uint32 each, three 8 bit meshlet-local indices
+};
+
+// Shared with the mesh shaders – 48 bytes
+struct Meshlet
+{
+    uint32_t vertexOffset;      // into the meshlet vertex indices
+    uint32_t vertexCount;       // <= 64
+    uint32_t triangleOffset;    // into the packed triangles
+    uint32_t triangleCount;     // <= 124
+    float    center[3];         // bounding sphere, mesh space
+    float    radius;
+    float    coneAxis[3];       // backfacing if dot(center - eye, axis) >= coneCutoff * |center - eye| + radius
+    float    coneCutoff;        // 1 = never
+};
+static_assert(sizeof(Meshlet) == 48, "Meshlet layout is shared with HLSL");
+
+// ---- Textures ----
+
+// Both are 4x4 blocks of 16 bytes
+enum AssetTextureFormat : uint32_t
+{
+    kTextureBC7,        // RGBA
+    kTextureBC5,        // two channels – tangent space normal XY, Z is rebuilt in the shader
+};
+
+static const uint32_t kTextureBlockBytes   = 16;
+static const uint32_t kTextureRowAlignment = 256;     // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+static const uint32_t kTextureMipAlignment = 512;     // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+
+// AssetPakEntry::meta of a kAssetTexture
+struct TextureAssetMeta
+{
+    uint32_t format;            // AssetTextureFormat
+    uint32_t width;             // multiples of 4
+    uint32_t height;
+    uint32_t mipCount;          // the whole chain, down to 1x1
+};
+
+// Where one mip sits in the blob. Rows of blocks are pitched and mips placed
+// the way D3D12 wants a copy source laid out, so any mip is one contiguous
+// read that can go straight to the GPU.
+struct TextureMipLayout
+{
+    uint64_t offset;            // from the start of the entry's data
+    uint64_t size;              // rowPitch * rows
+    uint32_t rowPitch;
+    uint32_t rows;              // of blocks
+    uint32_t width;             // texels
+    uint32_t height;
+};
+
+inline TextureMipLayout TextureMip(const TextureAssetMeta& meta, uint32_t mip)
+{
+    TextureMipLayout layout{};
+    for (uint32_t m = 0; m <= mip; ++m)
+    {
+        layout.offset   = (layout.offset + layout.size + kTextureMipAlignment - 1) & ~(uint64_t)(kTextureMipAlignment - 1);
+        layout.width    = meta.width >> m ? meta.width >> m : 1;
+        layout.height   = meta.height >> m ? meta.height >> m : 1;
+        layout.rowPitch = ((layout.width + 3) / 4 * kTextureBlockBytes + kTextureRowAlignment - 1) & ~(kTextureRowAlignment - 1);
+        layout.rows     = (layout.height + 3) / 4;
+        layout.size     = (uint64_t)layout.rowPitch * layout.rows;
+    }
+    return layout;
+}
+
+// ---- Meta access ----
+
+template <typename Meta>
+inline Meta ReadAssetMeta(const AssetPakEntry& entry)
+{
+    static_assert(sizeof(Meta) <= sizeof(entry.meta), "Meta too big for AssetPakEntry::meta");
+    Meta meta;
+    memcpy(&meta, entry.meta, sizeof(meta));
+    return meta;
+}
+
+template <typename Meta>
+inline void WriteAssetMeta(AssetPakEntry& entry, const Meta& meta)
+{
+    static_assert(sizeof(Meta) <= sizeof(entry.meta), "Meta too big for AssetPakEntry::meta");
+    memcpy(entry.meta, &meta, sizeof(meta));
+}
+
+// Binary search over the sorted table of contents
+inline const AssetPakEntry* FindAssetEntry(const AssetPakEntry* entries, uint32_t count, const char* name)
+{
+    const uint64_t hash = HashString(name);
+    uint32_t lo = 0, hi = count;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (entries[mid].nameHash < hash) lo = mid + 1;
+        else                              hi = mid;
+    }
+    return lo < count && entries[lo].nameHash == hash ? &entries[lo] : nullptr;
+}
@@ -0,0 +1,430 @@
+// ---------------------------------------------------------------
+// Asset streaming – assets.pak into GPU resources, in the background
+// ---------------------------------------------------------------
+// Requests are queued by priority and land asynchronously; the renderer polls
+// IsReady() and uses whatever has arrived, so nothing waits on disk.
+//
+//   const AssetPakEntry* e = streamer.Find("mesh/cube");
+//   handle = streamer.Request(e, buffer, offset, AssetStreamer::kPriorityHigh);
+//   streamer.Update();                     // once a frame
+//   if (streamer.IsReady(handle)) ...      // copy is done, GPU can use it
+//   handle = streamer.RequestTextureMip(e, texture, mip, priority);   // one mip of a kAssetTexture
+//
+// Two backends:
+//   DirectStorage (USE_DIRECTSTORAGE, and dstorage.dll present at runtime):
+//     file -> GPU buffer with no CPU copy, one DirectStorage queue per
+//     priority, GDeflate entries decompressed on the GPU.
+//   Memory mapping (everything else): a streaming thread pages the blob in
+//     and feeds it to the Uploader's copy queue in kChunkSize pieces, picking
+//     the most urgent request again between pieces – a big low priority
+//     load never holds up a small urgent one by more than a chunk.
+//
+// Texture mips always take the mapped path, DirectStorage or not: reserved
+// textures get their tiles mapped on the uploader's copy queue
+// (texturestreamer.h), and only copies on that queue are ordered behind it.
+// Their chunks are whole rows of blocks.
+//
+// Destinations must be in COMMON state and outlive the request.
+#pragma once
+
+#include "assetpak.h"
+#include "dxhelpers.h"
+#include "uploader.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(USE_DIRECTSTORAGE)
+#include <dstorage.h>
+#endif
+
+class AssetStreamer
+{
+public:
+    enum Priority : uint32_t
+    {
+        kPriorityLow,
+        kPriorityNormal,
+        kPriorityHigh,
+        kPriorityCritical,      // needed for the next frames to look right
+        kPriorityCount
+    };
+
+    using Handle = uint32_t;
+    static const Handle kInvalid  = ~0u;
+    static const UINT64 kChunkSize = 1024 * 1024;       // mapped path, per copy
+
+    struct Stats
+    {
+        uint32_t pending        = 0;
+        UINT64   bytesRequested = 0;
+        UINT64   bytesLoaded    = 0;
+    };
+
+    // False if there's no archive – callers fall back to building their data themselves
+    bool Open(ID3D12Device* device, Uploader* uploader, const char* path)
+    {
+        m_uploader = uploader;
+        m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return false;
+
+        // The table of contents always comes from the mapping; blobs only on the mapped path
+        LARGE_INTEGER size{};
+        GetFileSizeEx(m_file, &size);
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping)
+            m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_view)
+            throw std::runtime_error("Failed to map asset archive");
+
+        auto* header = reinterpret_cast<const AssetPakHeader*>(m_view);
+        if ((UINT64)size.QuadPart < sizeof(AssetPakHeader) ||
+            header->magic != kAssetPakMagic || header->version != kAssetPakVersion ||
+            sizeof(AssetPakHeader) + sizeof(AssetPakEntry) * (UINT64)header->entryCount > (UINT64)size.QuadPart)
+            throw std::runtime_error("Asset archive is corrupt or out of date");
+        m_entries    = reinterpret_cast<const AssetPakEntry*>(m_view + sizeof(AssetPakHeader));
+        m_entryCount = header->entryCount;
+        m_viewSize   = (UINT64)size.QuadPart;
+
+        OpenDirectStorage(device, path);
+        m_running = true;
+        m_worker  = std::thread([this] { WorkerMain(); });     // everything without DirectStorage, texture mips with
+        return true;
+    }
+
+    void Shutdown()
+    {
+        if (m_worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running = false;
+            }
+            m_wake.notify_all();
+            m_worker.join();
+        }
+#if defined(USE_DIRECTSTORAGE)
+        // DirectStorage writes straight into our resources – let it finish first
+        for (uint32_t p = 0; p < kPriorityCount; ++p)
+            if (m_dsFences[p] && m_dsFences[p]->GetCompletedValue() < m_dsSubmitted[p])
+                m_dsFences[p]->SetEventOnCompletion(m_dsSubmitted[p], nullptr);
+        for (uint32_t p = 0; p < kPriorityCount; ++p)
+        {
+            m_dsQueues[p].Reset();
+            m_dsFences[p].Reset();
+        }
+        m_dsFile.Reset();
+        m_dsFactory.Reset();
+        if (m_dsModule) FreeLibrary(m_dsModule);
+        m_dsModule = nullptr;
+#endif
+        if (m_view)    UnmapViewOfFile(m_view);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_view = nullptr; m_mapping = nullptr; m_file = INVALID_HANDLE_VALUE;
+        m_entries = nullptr;
+        m_entryCount = 0;
+        m_requests.clear();
+        for (std::deque<Handle>& queue : m_queues)
+            queue.clear();
+    }
+
+    bool        IsOpen() const { return m_entries != nullptr; }
+    const char* Backend() const { return !IsOpen() ? "NONE" : UsingDirectStorage() ? "DSTORAGE" : "MMAP"; }
+
+    const AssetPakEntry* Find(const char* name) const
+    {
+        return m_entries ? FindAssetEntry(m_entries, m_entryCount, name) : nullptr;
+    }
+
+    // Streams the whole entry into dst at dstOffset
+    Handle Request(const AssetPakEntry* entry, ID3D12Resource* dst, UINT64 dstOffset, Priority priority)
+    {
+        if (entry->offset + entry->storedSize > m_viewSize)
+            throw std::runtime_error(std::string("Asset archive entry out of range: ") + entry->name);
+        if (entry->compression == kAssetCompressionGDeflate && !UsingDirectStorage())
+            throw std::runtime_error(std::string("GDeflate asset needs DirectStorage: ") + entry->name);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Handle handle = (Handle)m_requests.size();
+        Request& request = m_requests.emplace_back();
+        request.entry     = entry;
+        request.dst       = dst;
+        request.dstOffset = dstOffset;
+        request.size      = entry->size;
+        request.priority  = priority;
+        m_stats.bytesRequested += entry->size;
+        ++m_stats.pending;
+
+#if defined(USE_DIRECTSTORAGE)
+        if (UsingDirectStorage())
+        {
+            DSTORAGE_REQUEST ds{};
+            ds.Options.SourceType        = DSTORAGE_REQUEST_SOURCE_FILE;
+            ds.Options.DestinationType   = DSTORAGE_REQUEST_DESTINATION_BUFFER;
+            ds.Options.CompressionFormat = entry->compression == kAssetCompressionGDeflate
+                                               ? DSTORAGE_COMPRESSION_FORMAT_GDEFLATE : DSTORAGE_COMPRESSION_FORMAT_NONE;
+            ds.Source.File.Source        = m_dsFile.Get();
+            ds.Source.File.Offset        = entry->offset;
+            ds.Source.File.Size          = (UINT32)entry->storedSize;
+            ds.UncompressedSize          = (UINT32)entry->size;
+            ds.Destination.Buffer.Resource = dst;
+            ds.Destination.Buffer.Offset   = dstOffset;
+            ds.Destination.Buffer.Size     = (UINT32)entry->size;
+            ds.Name                      = entry->name;
+            m_dsQueues[priority]->EnqueueRequest(&ds);
+            request.fence = m_dsSubmitted[priority] + 1;       // signalled by the next Update()
+            m_dsDirty[priority] = true;
+            return handle;
+        }
+#endif
+        m_queues[priority].push_back(handle);
+        m_wake.notify_one();
+        return handle;
+    }
+
+    // Streams one mip of a kAssetTexture entry into the same subresource of dst
+    Handle RequestTextureMip(const AssetPakEntry* entry, ID3D12Resource* dst, UINT mip, Priority priority)
+    {
+        const TextureAssetMeta meta = ReadAssetMeta<TextureAssetMeta>(*entry);
+        if (entry->type != kAssetTexture || mip >= meta.mipCount)
+            throw std::runtime_error(std::string("Not a texture, or no such mip: ") + entry->name);
+        const TextureMipLayout layout = TextureMip(meta, mip);
+        if (entry->compression != kAssetCompressionNone || layout.offset + layout.size > entry->size ||
+            entry->offset + entry->storedSize > m_viewSize)
+            throw std::runtime_error(std::string("Asset archive texture is corrupt: ") + entry->name);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Handle handle = (Handle)m_requests.size();
+        Request& request = m_requests.emplace_back();
+        request.entry       = entry;
+        request.dst         = dst;
+        request.subresource = mip;
+        request.srcOffset   = layout.offset;
+        request.size        = layout.size;
+        request.rowPitch    = layout.rowPitch;
+        request.priority    = priority;
+        request.mapped      = true;
+        m_stats.bytesRequested += layout.size;
+        ++m_stats.pending;
+        m_queues[priority].push_back(handle);
+        m_wake.notify_one();
+        return handle;
+    }
+
+    // Copy has landed; the GPU can read the destination without waiting
+    bool IsReady(Handle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return Ready(m_requests[handle]);
+    }
+
+    // Once a frame: submits what DirectStorage has queued up, retires finished requests
+    void Update()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+#if defined(USE_DIRECTSTORAGE)
+        for (uint32_t p = 0; p < kPriorityCount && UsingDirectStorage(); ++p)
+        {
+            if (m_dsDirty[p])
+            {
+                m_dsQueues[p]->EnqueueSignal(m_dsFences[p].Get(), ++m_dsSubmitted[p]);
+                m_dsQueues[p]->Submit();
+                m_dsDirty[p] = false;
+            }
+            DSTORAGE_ERROR_RECORD record{};
+            m_dsQueues[p]->RetrieveErrorRecord(&record);
+            if (record.FailureCount)
+                throw std::runtime_error("DirectStorage request failed");
+        }
+#endif
+        // Requests finish roughly in order – only look past the oldest unfinished one
+        while (m_firstPending < m_requests.size() && Ready(m_requests[m_firstPending]))
+            Retire(m_requests[m_firstPending++]);
+        for (size_t i = m_firstPending; i < m_requests.size(); ++i)
+            if (!m_requests[i].retired && Ready(m_requests[i]))
+                Retire(m_requests[i]);
+    }
+
+    Stats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    static const UINT kBufferDestination = ~0u;
+
+    struct Request
+    {
+        const AssetPakEntry* entry       = nullptr;
+        ID3D12Resource*      dst         = nullptr;
+        UINT64               dstOffset   = 0;           // buffers
+        UINT                 subresource = kBufferDestination;
+        UINT64               srcOffset   = 0;           // into the entry – textures read one mip of it
+        UINT64               size        = 0;
+        UINT                 rowPitch    = 0;           // textures: chunks are whole rows
+        Priority             priority    = kPriorityNormal;
+        UINT64               copied      = 0;           // mapped path, bytes handed to the uploader
+        UINT64               fence       = 0;           // 0 until the last piece is submitted
+        bool                 retired     = false;
+        bool                 mapped      = false;       // goes through the worker, whatever the backend
+    };
+
+    bool UsingDirectStorage() const
+    {
+#if defined(USE_DIRECTSTORAGE)
+        return m_dsFile != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    bool Ready(const Request& request) const
+    {
+        if (request.fence == 0)
+            return false;
+#if defined(USE_DIRECTSTORAGE)
+        if (UsingDirectStorage() && !request.mapped)
+            return m_dsFences[request.priority]->GetCompletedValue() >= request.fence &&
+                   m_dsSubmitted[request.priority] >= request.fence;
+#endif
+        return m_uploader->IsComplete(request.fence);
+    }
+
+    void Retire(Request& request)
+    {
+        if (request.retired)
+            return;
+        request.retired = true;
+        m_stats.bytesLoaded += request.size;
+        --m_stats.pending;
+    }
+
+    // dstorage.dll is loaded on demand, so machines without it just take the mapped path
+    bool OpenDirectStorage(ID3D12Device* device, const char* path)
+    {
+#if defined(USE_DIRECTSTORAGE)
+        m_dsModule = LoadLibraryW(L"dstorage.dll");
+        if (!m_dsModule)
+            return false;
+        using GetFactoryProc = HRESULT(WINAPI*)(REFIID, void**);
+        auto getFactory = reinterpret_cast<GetFactoryProc>(GetProcAddress(m_dsModule, "DStorageGetFactory"));
+        if (!getFactory || FAILED(getFactory(IID_PPV_ARGS(&m_dsFactory))))
+            return false;
+
+        const std::string narrow(path);
+        const std::wstring wide(narrow.begin(), narrow.end());
+        ComPtr<IDStorageFile> file;
+        if (FAILED(m_dsFactory->OpenFile(wide.c_str(), IID_PPV_ARGS(&file))))
+            return false;
+
+        static const DSTORAGE_PRIORITY kPriorities[kPriorityCount] =
+        {
+            DSTORAGE_PRIORITY_LOW, DSTORAGE_PRIORITY_NORMAL, DSTORAGE_PRIORITY_HIGH, DSTORAGE_PRIORITY_REALTIME,
+        };
+        for (uint32_t p = 0; p < kPriorityCount; ++p)
+        {
+            DSTORAGE_QUEUE_DESC desc{};
+            desc.Capacity   = DSTORAGE_MAX_QUEUE_CAPACITY;
+            desc.Priority   = kPriorities[p];
+            desc.SourceType = DSTORAGE_REQUEST_SOURCE_FILE;
+            desc.Device     = device;
+            ThrowIfFailed(m_dsFactory->CreateQueue(&desc, IID_PPV_ARGS(&m_dsQueues[p])));
+            ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_dsFences[p])));
+        }
+        m_dsFile = file;
+        return true;
+#else
+        (void)device; (void)path;
+        return false;
+#endif
+    }
+
+    // Mapped path: one piece of the most urgent request at a time
+    void WorkerMain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [this] { return !m_running || HasQueued(); });
+            if (!m_running)
+                return;
+
+            uint32_t p = kPriorityCount - 1;
+            while (m_queues[p].empty())
+                --p;
+            Request&     request = m_requests[m_queues[p].front()];
+            const UINT64 begin   = request.copied;
+            UINT64       size    = (std::min)(kChunkSize, request.size - begin);
+            if (request.rowPitch)
+                size = (std::max)(size / request.rowPitch, 1ull) * request.rowPitch;
+            const uint8_t* src   = m_view + request.entry->offset + request.srcOffset + begin;
+            ID3D12Resource* dst  = request.dst;
+            const UINT64 dstOffset   = request.dstOffset + begin;
+            const UINT   subresource = request.subresource;
+            const UINT   rowPitch    = request.rowPitch;
+            lock.unlock();
+
+            // Fault the pages in here, not inside the uploader's lock
+            WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(src), (SIZE_T)size };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            volatile uint8_t sink = 0;
+            for (UINT64 offset = 0; offset < size; offset += 4096)
+                sink = sink + src[offset];
+            if (subresource == kBufferDestination)
+                m_uploader->UploadBuffer(dst, dstOffset, src, size);
+            else
+                m_uploader->UploadTextureRows(dst, subresource, src, rowPitch, (UINT)(begin / rowPitch),
+                                              (UINT)(size / rowPitch));
+
+            const bool   last  = begin + size == request.size;
+            const UINT64 fence = last ? m_uploader->Flush() : 0;
+            lock.lock();
+            request.copied += size;
+            if (last)
+            {
+                request.fence = fence;
+                m_queues[p].pop_front();
+            }
+        }
+    }
+
+    bool HasQueued() const
+    {
+        for (const std::deque<Handle>& queue : m_queues)
+            if (!queue.empty())
+                return true;
+        return false;
+    }
+
+    Uploader*                    m_uploader   = nullptr;
+    HANDLE                       m_file       = INVALID_HANDLE_VALUE;
+    HANDLE                       m_mapping    = nullptr;
+    const uint8_t*               m_view       = nullptr;
+    UINT64                       m_viewSize   = 0;
+    const AssetPakEntry*         m_entries    = nullptr;
+    uint32_t                     m_entryCount = 0;
+
+    mutable std::mutex           m_mutex;
+    std::deque<Request>          m_requests;                // indexed by Handle, references stay put
+    size_t                       m_firstPending = 0;
+    std::deque<Handle>           m_queues[kPriorityCount];  // mapped path
+    std::condition_variable      m_wake;
+    std::thread                  m_worker;
+    bool                         m_running = false;
+    Stats                        m_stats;
+
+#if defined(USE_DIRECTSTORAGE)
+    HMODULE                      m_dsModule = nullptr;
+    ComPtr<IDStorageFactory>     m_dsFactory;
+    ComPtr<IDStorageFile>        m_dsFile;
+    ComPtr<IDStorageQueue>       m_dsQueues[kPriorityCount];
+    ComPtr<ID3D12Fence>          m_dsFences[kPriorityCount];
+    UINT64                       m_dsSubmitted[kPriorityCount] = {};
+    bool                         m_dsDirty[kPriorityCount]     = {};
+#endif
+};
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------
+// Async compute – a second hardware queue next to the direct one
+// ---------------------------------------------------------------
+// Work submitted here runs concurrently with whatever the direct queue does
+// in the meantime; GPUs with spare shader units fill the gaps graphics
+// leaves (depth-only passes, fixed function bound work, the tail of a frame).
+//
+//   asyncCompute.BeginFrame(slot);                 // after the slot's fence
+//   asyncCompute.Fork(directQueue);                // compute waits for what's submitted so far
+//   cl = asyncCompute.Begin(); ...record...; asyncCompute.Submit();
+//   asyncCompute.Join(directQueue);                // direct waits for the compute work
+//
+// Both sides of a fork/join are GPU waits – the CPU never blocks here. Every
+// frame must Join() before it signals its frame fence: that fence is then the
+// only thing that says a slot's compute allocator can be reset.
+#pragma once
+
+#include "dxhelpers.h"
+
+class AsyncCompute
+{
+public:
+    static const UINT kMaxFrames          = 3;
+    static const UINT kMaxSubmitsPerFrame = 4;
+
+    void Init(ID3D12Device* device, UINT frameCount)
+    {
+        D3D12_COMMAND_QUEUE_DESC queueDesc{};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
+        ThrowIfFailed(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_queue)));
+        m_queue->SetName(L"AsyncCompute");
+
+        ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_forkFence)));
+        ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+
+        for (UINT i = 0; i < frameCount; ++i)
+            ThrowIfFailed(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE,
+                                                         IID_PPV_ARGS(&m_allocators[i])));
+        for (UINT i = 0; i < kMaxSubmitsPerFrame; ++i)
+        {
+            ThrowIfFailed(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COMPUTE, m_allocators[0].Get(),
+                                                    nullptr, IID_PPV_ARGS(&m_lists[i])));
+            m_lists[i]->Close();
+        }
+    }
+
+    void Shutdown()
+    {
+        for (ComPtr<ID3D12GraphicsCommandList>& list : m_lists)
+            list.Reset();
+        for (ComPtr<ID3D12CommandAllocator>& allocator : m_allocators)
+            allocator.Reset();
+        m_forkFence.Reset();
+        m_fence.Reset();
+        m_queue.Reset();
+    }
+
+    bool                Enabled() const { return m_queue != nullptr; }
+    ID3D12CommandQueue* Queue() const { return m_queue.Get(); }
+
+    // The slot's frame fence has passed, and with it everything joined in that frame
+    void BeginFrame(UINT slot)
+    {
+        ThrowIfFailed(m_allocators[slot]->Reset());
+        m_slot        = slot;
+        m_submitCount = 0;
+    }
+
+    // Compute queue waits for everything `direct` has been given so far
+    void Fork(ID3D12CommandQueue* direct)
+    {
+        ThrowIfFailed(direct->Signal(m_forkFence.Get(), ++m_forkValue));
+        ThrowIfFailed(m_queue->Wait(m_forkFence.Get(), m_forkValue));
+    }
+
+    ID3D12GraphicsCommandList* Begin()
+    {
+        if (m_submitCount == kMaxSubmitsPerFrame)
+            throw std::runtime_error("Too many async compute submits in one frame");
+        ID3D12GraphicsCommandList* cl = m_lists[m_submitCount].Get();
+        ThrowIfFailed(cl->Reset(m_allocators[m_slot].Get(), nullptr));
+        return cl;
+    }
+
+    // Closes and runs the list from Begin(); returns the value m_fence reaches when it's done
+    UINT64 Submit()
+    {
+        ID3D12GraphicsCommandList* cl = m_lists[m_submitCount++].Get();
+        ThrowIfFailed(cl->Close());
+        ID3D12CommandList* lists[] = { cl };
+        m_queue->ExecuteCommandLists(1, lists);
+        ThrowIfFailed(m_queue->Signal(m_fence.Get(), ++m_fenceValue));
+        return m_fenceValue;
+    }
+
+    // `direct` waits for everything submitted so far
+    void Join(ID3D12CommandQueue* direct)
+    {
+        ThrowIfFailed(direct->Wait(m_fence.Get(), m_fenceValue));
+    }
+
+private:
+    ComPtr<ID3D12CommandQueue>        m_queue;
+    ComPtr<ID3D12Fence>               m_forkFence;      // direct -> compute
+    ComPtr<ID3D12Fence>               m_fence;          // compute -> direct
+    UINT64                            m_forkValue   = 0;
+    UINT64                            m_fenceValue  = 0;
+
+    ComPtr<ID3D12CommandAllocator>    m_allocators[kMaxFrames];
+    ComPtr<ID3D12GraphicsCommandList> m_lists[kMaxSubmitsPerFrame];
+    UINT                              m_slot        = 0;
+    UINT                              m_submitCount = 0;
+};
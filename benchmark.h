@@ -0,0 +1,246 @@
+// ---------------------------------------------------------------
+// Benchmark – scripted scenes, per-frame samples, JSON results
+// ---------------------------------------------------------------
+// main.exe --benchmark=<scene> sets the scene up from the table below,
+// warms up, then records a fixed number of frames:
+//
+//   BenchmarkRun run;
+//   run.Begin(frames);                  // reserves every sample up front
+//   run.AddFrame({ frameMs, renderCpuMs, simCpuMs, gpuMs });   // per frame
+//   JsonWriter json; ... run.WriteTimings(json); json.Save(path);
+//
+// The sim steps a fixed 1/60 s per frame in a run, so every run draws the
+// same frames whatever the hardware – only how long they take differs.
+// Percentiles are nearest-rank over the raw samples, no smoothing.
+// tools/benchcompare diffs two result files; CMake's benchmark target runs
+// every scene and compares against the stored baselines.
+//
+// Plain std only.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ---- Scenes ----
+
+struct BenchmarkScene
+{
+    const char* name;
+    uint32_t    instances;      // spinning grid
+    uint32_t    bodies;         // physics rain
+    uint32_t    lights;         // point lights for the clustered pass
+    bool        streaming;      // re-reads the mesh archive nonstop while it runs
+};
+
+inline const BenchmarkScene kBenchmarkScenes[] =
+{
+    { "instances", 32768, 0,    256,  false },   // submission, culling, batching
+    { "physics",   4096,  8192, 256,  false },   // sim thread bound
+    { "streaming", 4096,  1024, 256,  true  },   // the default scene with the streamer saturated
+    { "lights",    4096,  1024, 4096, false },   // light binning and the per-pixel light loops
+};
+
+// name runs to the next space – it comes straight off the command line
+inline const BenchmarkScene* FindBenchmarkScene(const char* name)
+{
+    const size_t length = strcspn(name, " \t\"");
+    for (const BenchmarkScene& scene : kBenchmarkScenes)
+        if (strlen(scene.name) == length && !strncmp(scene.name, name, length))
+            return &scene;
+    return nullptr;
+}
+
+// ---- Samples ----
+
+struct TimingSummary
+{
+    double mean = 0.0;
+    double p50  = 0.0;
+    double p99  = 0.0;
+    double p999 = 0.0;
+    double max  = 0.0;
+};
+
+// Sorts its copy – only called once, after the run
+inline TimingSummary Summarize(std::vector<double> samples)
+{
+    TimingSummary summary;
+    if (samples.empty())
+        return summary;
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p)
+    {
+        const size_t rank = (size_t)std::ceil(p * (double)samples.size());
+        return samples[rank ? rank - 1 : 0];
+    };
+    double sum = 0.0;
+    for (double sample : samples)
+        sum += sample;
+    summary.mean = sum / (double)samples.size();
+    summary.p50  = percentile(0.50);
+    summary.p99  = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    summary.max  = samples.back();
+    return summary;
+}
+
+// ---- JSON ----
+
+// Just enough for the results file: nested objects of numbers, strings and bools
+class JsonWriter
+{
+public:
+    JsonWriter() { m_out = "{"; }
+
+    void BeginObject(const char* key)
+    {
+        Key(key);
+        m_out += "{";
+        m_first = true;
+        ++m_depth;
+    }
+
+    void EndObject()
+    {
+        --m_depth;
+        Newline();
+        m_out += "}";
+        m_first = false;
+    }
+
+    void Field(const char* key, double value)
+    {
+        Key(key);
+        char text[32];
+        snprintf(text, sizeof(text), "%.4f", std::isfinite(value) ? value : 0.0);   // JSON has no inf/nan
+        m_out += text;
+    }
+    void Field(const char* key, uint64_t value)
+    {
+        Key(key);
+        m_out += std::to_string(value);
+    }
+    void Field(const char* key, uint32_t value) { Field(key, (uint64_t)value); }
+    void Field(const char* key, bool value)
+    {
+        Key(key);
+        m_out += value ? "true" : "false";
+    }
+    void Field(const char* key, const char* value)
+    {
+        Key(key);
+        m_out += '"';
+        for (const char* c = value; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                m_out += '\\';
+            if ((unsigned char)*c >= 0x20)
+                m_out += *c;
+        }
+        m_out += '"';
+    }
+
+    void Field(const char* key, const TimingSummary& summary)
+    {
+        BeginObject(key);
+        Field("mean", summary.mean);
+        Field("p50", summary.p50);
+        Field("p99", summary.p99);
+        Field("p999", summary.p999);
+        Field("max", summary.max);
+        EndObject();
+    }
+
+    bool Save(const char* path)
+    {
+        while (m_depth > 1)
+            EndObject();
+        FILE* file = fopen(path, "wb");
+        if (!file)
+            return false;
+        const std::string text = m_out + "\n}\n";
+        const bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+        return fclose(file) == 0 && ok;
+    }
+
+private:
+    void Key(const char* key)
+    {
+        if (!m_first)
+            m_out += ",";
+        m_first = false;
+        Newline();
+        m_out += '"';
+        m_out += key;
+        m_out += "\": ";
+    }
+
+    void Newline()
+    {
+        m_out += '\n';
+        m_out.append((size_t)m_depth * 2, ' ');
+    }
+
+    std::string m_out;
+    int         m_depth = 1;
+    bool        m_first = true;
+};
+
+// ---- Run ----
+
+struct BenchmarkFrame
+{
+    double frameMs;         // render thread, start of one frame to the next
+    double renderCpuMs;     // render thread busy: prepare, record, submit – no fence wait, no Present
+    double simCpuMs;        // SimulateFrame() for the packet the frame drew
+    double gpuMs;           // first to last GPU scope
+};
+
+class BenchmarkRun
+{
+public:
+    // No allocations from here until the run is written out
+    void Begin(uint32_t frames)
+    {
+        m_target = frames;
+        for (std::vector<double>* samples : { &m_frameMs, &m_renderCpuMs, &m_simCpuMs, &m_gpuMs })
+        {
+            samples->clear();
+            samples->reserve(frames);
+        }
+    }
+
+    void AddFrame(const BenchmarkFrame& frame)
+    {
+        if (Done())
+            return;
+        m_frameMs.push_back(frame.frameMs);
+        m_renderCpuMs.push_back(frame.renderCpuMs);
+        m_simCpuMs.push_back(frame.simCpuMs);
+        m_gpuMs.push_back(frame.gpuMs);
+    }
+
+    uint32_t Count() const { return (uint32_t)m_frameMs.size(); }
+    bool     Done() const { return m_target && m_frameMs.size() >= m_target; }
+
+    void WriteTimings(JsonWriter& json) const
+    {
+        json.Field("frames", Count());
+        json.Field("frameMs", Summarize(m_frameMs));
+        json.Field("renderCpuMs", Summarize(m_renderCpuMs));
+        json.Field("simCpuMs", Summarize(m_simCpuMs));
+        json.Field("gpuMs", Summarize(m_gpuMs));
+    }
+
+private:
+    uint32_t            m_target = 0;
+    std::vector<double> m_frameMs;
+    std::vector<double> m_renderCpuMs;
+    std::vector<double> m_simCpuMs;
+    std::vector<double> m_gpuMs;
+};
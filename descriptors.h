@@ -0,0 +1,178 @@
+// ---------------------------------------------------------------
+// Descriptors – one big shader-visible CBV/SRV/UAV heap
+// ---------------------------------------------------------------
+// Layout:
+//   [0, persistentCount)                     free-list, long-lived views (textures, meshes)
+//   [persistentCount + slot * perFrame, ...)  linear per frame slot, reset in BeginFrame()
+//
+// Shaders index the heap directly (bindless), so a draw only pushes an index
+// in its root constants instead of building descriptor tables.
+// Persistent frees are deferred until the GPU is past the given fence value.
+#pragma once
+
+#include "dxhelpers.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+class DescriptorHeap
+{
+public:
+    static const UINT kInvalid = ~0u;
+
+    void Init(ID3D12Device* device, UINT persistentCount, UINT transientPerFrame, UINT frameCount)
+    {
+        m_device            = device;
+        m_persistentCount   = persistentCount;
+        m_transientPerFrame = transientPerFrame;
+
+        D3D12_DESCRIPTOR_HEAP_DESC desc{};
+        desc.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        desc.NumDescriptors = persistentCount + transientPerFrame * frameCount;
+        desc.Flags          = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        ThrowIfFailed(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_heap)));
+
+        m_increment = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        m_cpuStart  = m_heap->GetCPUDescriptorHandleForHeapStart();
+        m_gpuStart  = m_heap->GetGPUDescriptorHandleForHeapStart();
+
+        m_freeList.clear();
+        for (UINT i = persistentCount; i-- > 0;)
+            m_freeList.push_back(i);
+    }
+
+    ID3D12DescriptorHeap* Heap() const { return m_heap.Get(); }
+    UINT Capacity() const { return m_heap->GetDesc().NumDescriptors; }
+
+    // ---- persistent region ----
+    UINT AllocatePersistent()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeList.empty())
+            throw std::runtime_error("Out of persistent descriptors");
+        UINT index = m_freeList.back();
+        m_freeList.pop_back();
+        return index;
+    }
+
+    // The slot is reused only after `fenceValue` has completed
+    void FreePersistent(UINT index, UINT64 fenceValue)
+    {
+        if (index == kInvalid)
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_deferredFrees.push_back({ index, fenceValue });
+    }
+
+    // ---- per-frame region ----
+    // Recycles the slot's transient range and retires deferred frees up to completedFence
+    void BeginFrame(UINT slot, UINT64 completedFence)
+    {
+        m_frameBase = m_persistentCount + slot * m_transientPerFrame;
+        m_frameUsed.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_deferredFrees.empty() && m_deferredFrees.front().fenceValue <= completedFence)
+        {
+            m_freeList.push_back(m_deferredFrees.front().index);
+            m_deferredFrees.pop_front();
+        }
+    }
+
+    // First index of `count` contiguous descriptors valid for this frame only. Thread safe.
+    UINT AllocateTransient(UINT count = 1)
+    {
+        UINT offset = m_frameUsed.fetch_add(count, std::memory_order_relaxed);
+        if (offset + count > m_transientPerFrame)
+            throw std::runtime_error("Out of transient descriptors this frame");
+        return m_frameBase + offset;
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE Cpu(UINT index) const
+    {
+        return { m_cpuStart.ptr + (SIZE_T)index * m_increment };
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE Gpu(UINT index) const
+    {
+        return { m_gpuStart.ptr + (UINT64)index * m_increment };
+    }
+
+    // ---- view helpers ----
+    // ByteAddressBuffer view, offset/size in bytes (both multiples of 4)
+    void CreateRawBufferSrv(UINT index, ID3D12Resource* buffer, UINT64 offset, UINT64 size)
+    {
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
+        desc.Format                  = DXGI_FORMAT_R32_TYPELESS;
+        desc.ViewDimension           = D3D12_SRV_DIMENSION_BUFFER;
+        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        desc.Buffer.FirstElement     = offset / 4;
+        desc.Buffer.NumElements      = (UINT)(size / 4);
+        desc.Buffer.Flags            = D3D12_BUFFER_SRV_FLAG_RAW;
+        m_device->CreateShaderResourceView(buffer, &desc, Cpu(index));
+    }
+
+    void CreateStructuredBufferSrv(UINT index, ID3D12Resource* buffer, UINT firstElement,
+                                   UINT numElements, UINT stride)
+    {
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
+        desc.Format                     = DXGI_FORMAT_UNKNOWN;
+        desc.ViewDimension              = D3D12_SRV_DIMENSION_BUFFER;
+        desc.Shader4ComponentMapping    = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        desc.Buffer.FirstElement        = firstElement;
+        desc.Buffer.NumElements         = numElements;
+        desc.Buffer.StructureByteStride = stride;
+        m_device->CreateShaderResourceView(buffer, &desc, Cpu(index));
+    }
+
+    void CreateRawBufferUav(UINT index, ID3D12Resource* buffer, UINT64 offset, UINT64 size)
+    {
+        D3D12_UNORDERED_ACCESS_VIEW_DESC desc{};
+        desc.Format              = DXGI_FORMAT_R32_TYPELESS;
+        desc.ViewDimension       = D3D12_UAV_DIMENSION_BUFFER;
+        desc.Buffer.FirstElement = offset / 4;
+        desc.Buffer.NumElements  = (UINT)(size / 4);
+        desc.Buffer.Flags        = D3D12_BUFFER_UAV_FLAG_RAW;
+        m_device->CreateUnorderedAccessView(buffer, nullptr, &desc, Cpu(index));
+    }
+
+    // Default view of the whole texture
+    void CreateTextureSrv(UINT index, ID3D12Resource* texture, const D3D12_SHADER_RESOURCE_VIEW_DESC* desc = nullptr)
+    {
+        m_device->CreateShaderResourceView(texture, desc, Cpu(index));
+    }
+
+    void CreateTextureUav(UINT index, ID3D12Resource* texture, const D3D12_UNORDERED_ACCESS_VIEW_DESC* desc = nullptr)
+    {
+        m_device->CreateUnorderedAccessView(texture, nullptr, desc, Cpu(index));
+    }
+
+    void CreateCbv(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address, UINT size)
+    {
+        D3D12_CONSTANT_BUFFER_VIEW_DESC desc{ address, (UINT)AlignUp(size, 256) };
+        m_device->CreateConstantBufferView(&desc, Cpu(index));
+    }
+
+private:
+    struct DeferredFree
+    {
+        UINT   index;
+        UINT64 fenceValue;
+    };
+
+    ID3D12Device*                m_device = nullptr;
+    ComPtr<ID3D12DescriptorHeap> m_heap;
+    UINT                         m_increment = 0;
+    D3D12_CPU_DESCRIPTOR_HANDLE  m_cpuStart{};
+    D3D12_GPU_DESCRIPTOR_HANDLE  m_gpuStart{};
+
+    UINT                         m_persistentCount   = 0;
+    std::vector<UINT>            m_freeList;
+    std::deque<DeferredFree>     m_deferredFrees;
+    std::mutex                   m_mutex;
+
+    UINT                         m_transientPerFrame = 0;
+    UINT                         m_frameBase         = 0;
+    std::atomic<UINT>            m_frameUsed{ 0 };
+};
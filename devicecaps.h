@@ -0,0 +1,253 @@
+// ---------------------------------------------------------------
+// Device capabilities – adapter choice, a cached capability probe, performance tiers
+// ---------------------------------------------------------------
+// SelectAdapter() walks the adapters in high performance order
+// (EnumAdapterByGpuPreference), so hybrid laptops get the discrete GPU rather
+// than whatever the OS calls default, and takes the first one D3D12 will make
+// a device on – WARP if none will.
+//
+// ProbeDeviceCaps() asks that device everything the renderer branches on.
+// GetDeviceCaps() keeps the answers in a small file, one record per adapter,
+// keyed by its PCI ids and driver version: later launches read the record
+// instead of probing, and a driver update starts over.
+//
+// PickDeviceTier() boils the caps down to a coarse tier main.cpp picks its
+// defaults from – computed, not cached, so changing it needs no new file.
+//
+//   AdapterChoice choice = SelectAdapter(factory, -1);
+//   bool cached = false;
+//   DeviceCaps caps = GetDeviceCaps(choice, "devicecaps.bin", &cached);
+//   DeviceTier tier = PickDeviceTier(caps);
+#pragma once
+
+#include "dxhelpers.h"
+#include <dxgi1_6.h>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+enum DeviceTier : uint32_t
+{
+    kTierLow,       // integrated / shared memory / old feature level – render below native, one queue
+    kTierMid,       // discrete, but small or without the SM 6.6 + mesh shader set – dynamic resolution
+    kTierHigh,      // everything on at native resolution
+};
+
+inline const char* DeviceTierName(DeviceTier tier)
+{
+    return tier == kTierHigh ? "HIGH" : tier == kTierMid ? "MID" : "LOW";
+}
+
+// Everything the probe found. Any change to this struct needs kDeviceCapsVersion bumped.
+struct DeviceCaps
+{
+    UINT64                      dedicatedVideoMemory = 0;   // bytes, from the adapter desc
+    D3D_FEATURE_LEVEL           featureLevel         = D3D_FEATURE_LEVEL_11_0;
+    D3D_SHADER_MODEL            shaderModel          = D3D_SHADER_MODEL_5_1;
+    D3D12_RESOURCE_BINDING_TIER bindingTier          = D3D12_RESOURCE_BINDING_TIER_1;
+    D3D12_TILED_RESOURCES_TIER  tiledResourcesTier   = D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED;
+    D3D12_MESH_SHADER_TIER      meshShaderTier       = D3D12_MESH_SHADER_TIER_NOT_SUPPORTED;
+    BOOL                        enhancedBarriers     = FALSE;
+    BOOL                        uma                  = FALSE;   // one memory pool for CPU and GPU
+    BOOL                        cacheCoherentUma     = FALSE;
+    BOOL                        gpuUploadHeap        = FALSE;   // CPU-visible VRAM (resizable BAR)
+    BOOL                        software             = FALSE;   // WARP
+};
+
+struct AdapterChoice
+{
+    ComPtr<IDXGIAdapter3> adapter;
+    ComPtr<ID3D12Device>  device;
+    DXGI_ADAPTER_DESC1    desc{};
+    UINT                  index = 0;     // in high performance order, hardware adapters only
+};
+
+// index < 0: the first hardware adapter that works; otherwise that one, or throw
+inline AdapterChoice SelectAdapter(IDXGIFactory6* factory, int index)
+{
+    AdapterChoice choice;
+    ComPtr<IDXGIAdapter3> adapter;
+    UINT hardware = 0;
+    for (UINT i = 0; SUCCEEDED(factory->EnumAdapterByGpuPreference(i, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE,
+                                                                    IID_PPV_ARGS(&adapter))); ++i)
+    {
+        DXGI_ADAPTER_DESC1 desc{};
+        adapter->GetDesc1(&desc);
+        if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)
+            continue;
+        const UINT position = hardware++;
+        if (index >= 0 && position != (UINT)index)
+            continue;
+        if (SUCCEEDED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&choice.device))))
+        {
+            choice.adapter = adapter;
+            choice.desc    = desc;
+            choice.index   = position;
+            return choice;
+        }
+        if (index >= 0)
+            throw std::runtime_error("The adapter asked for can't create a D3D12 device");
+    }
+    if (index >= 0)
+        throw std::runtime_error("No adapter with that index");
+
+    ThrowIfFailed(factory->EnumWarpAdapter(IID_PPV_ARGS(&choice.adapter)));
+    ThrowIfFailed(D3D12CreateDevice(choice.adapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&choice.device)));
+    choice.adapter->GetDesc1(&choice.desc);
+    return choice;
+}
+
+inline DeviceCaps ProbeDeviceCaps(ID3D12Device* device, const DXGI_ADAPTER_DESC1& desc)
+{
+    DeviceCaps caps;
+    caps.dedicatedVideoMemory = desc.DedicatedVideoMemory;
+    caps.software             = (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) != 0;
+
+    // The device is created at 11_0 so everything else runs anywhere; ask what's really there.
+    // Runtimes that predate 12_2 reject the whole query, so retry without it.
+    static const D3D_FEATURE_LEVEL kLevels[] =
+    {
+        D3D_FEATURE_LEVEL_12_2, D3D_FEATURE_LEVEL_12_1, D3D_FEATURE_LEVEL_12_0,
+        D3D_FEATURE_LEVEL_11_1, D3D_FEATURE_LEVEL_11_0,
+    };
+    D3D12_FEATURE_DATA_FEATURE_LEVELS levels{ _countof(kLevels), kLevels };
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_FEATURE_LEVELS, &levels, sizeof(levels))))
+        caps.featureLevel = levels.MaxSupportedFeatureLevel;
+    else
+    {
+        levels = { _countof(kLevels) - 1, kLevels + 1 };
+        if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_FEATURE_LEVELS, &levels, sizeof(levels))))
+            caps.featureLevel = levels.MaxSupportedFeatureLevel;
+    }
+
+    // Highest first – a runtime that doesn't know a shader model fails the query rather than answering lower
+    static const D3D_SHADER_MODEL kModels[] =
+    {
+        D3D_SHADER_MODEL_6_6, D3D_SHADER_MODEL_6_5, D3D_SHADER_MODEL_6_4, D3D_SHADER_MODEL_6_3,
+        D3D_SHADER_MODEL_6_2, D3D_SHADER_MODEL_6_1, D3D_SHADER_MODEL_6_0,
+    };
+    for (D3D_SHADER_MODEL model : kModels)
+    {
+        D3D12_FEATURE_DATA_SHADER_MODEL shaderModel{ model };
+        if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &shaderModel, sizeof(shaderModel))))
+        {
+            caps.shaderModel = shaderModel.HighestShaderModel;
+            break;
+        }
+    }
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+    {
+        caps.bindingTier        = options.ResourceBindingTier;
+        caps.tiledResourcesTier = options.TiledResourcesTier;
+    }
+    D3D12_FEATURE_DATA_D3D12_OPTIONS7 options7{};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS7, &options7, sizeof(options7))))
+        caps.meshShaderTier = options7.MeshShaderTier;
+    D3D12_FEATURE_DATA_ARCHITECTURE1 architecture{};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_ARCHITECTURE1, &architecture, sizeof(architecture))))
+    {
+        caps.uma              = architecture.UMA;
+        caps.cacheCoherentUma = architecture.CacheCoherentUMA;
+    }
+
+    // Only in headers new enough to have them (Agility SDK); older ones report no
+#if defined(D3D12_SDK_VERSION) && D3D12_SDK_VERSION >= 606
+    D3D12_FEATURE_DATA_D3D12_OPTIONS12 options12{};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS12, &options12, sizeof(options12))))
+        caps.enhancedBarriers = options12.EnhancedBarriersSupported;
+#endif
+#if defined(D3D12_SDK_VERSION) && D3D12_SDK_VERSION >= 613
+    D3D12_FEATURE_DATA_D3D12_OPTIONS16 options16{};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS16, &options16, sizeof(options16))))
+        caps.gpuUploadHeap = options16.GPUUploadHeapSupported;
+#endif
+    return caps;
+}
+
+// ---- Cache ----
+
+struct DeviceCapsRecord
+{
+    uint32_t   magic;
+    uint32_t   version;
+    uint32_t   vendorId, deviceId, subSysId, revision;
+    uint64_t   driverVersion;       // 0 if the adapter wouldn't say – then the record is never trusted
+    DeviceCaps caps;
+};
+
+static const uint32_t kDeviceCapsMagic   = 0x50414344;     // 'DCAP'
+static const uint32_t kDeviceCapsVersion = 1;
+
+inline DeviceCapsRecord DeviceCapsKey(const AdapterChoice& choice)
+{
+    DeviceCapsRecord key{};
+    key.magic    = kDeviceCapsMagic;
+    key.version  = kDeviceCapsVersion;
+    key.vendorId = choice.desc.VendorId;
+    key.deviceId = choice.desc.DeviceId;
+    key.subSysId = choice.desc.SubSysId;
+    key.revision = choice.desc.Revision;
+    LARGE_INTEGER driver{};
+    if (SUCCEEDED(choice.adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driver)))
+        key.driverVersion = (uint64_t)driver.QuadPart;
+    return key;
+}
+
+inline bool SameDevice(const DeviceCapsRecord& a, const DeviceCapsRecord& b)
+{
+    return a.magic == b.magic && a.version == b.version && a.vendorId == b.vendorId && a.deviceId == b.deviceId &&
+           a.subSysId == b.subSysId && a.revision == b.revision && a.driverVersion == b.driverVersion &&
+           a.driverVersion != 0;
+}
+
+// The cached record for this adapter + driver, or a fresh probe written back to `path`
+inline DeviceCaps GetDeviceCaps(const AdapterChoice& choice, const char* path, bool* cached)
+{
+    DeviceCapsRecord key = DeviceCapsKey(choice);
+    std::vector<DeviceCapsRecord> records;
+    {
+        std::ifstream in(path, std::ios::binary);
+        DeviceCapsRecord record{};
+        while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+            if (record.magic == kDeviceCapsMagic && record.version == kDeviceCapsVersion)
+                records.push_back(record);
+    }
+    for (const DeviceCapsRecord& record : records)
+        if (SameDevice(record, key))
+        {
+            *cached = true;
+            return record.caps;
+        }
+
+    *cached  = false;
+    key.caps = ProbeDeviceCaps(choice.device.Get(), choice.desc);
+    if (key.driverVersion == 0)
+        return key.caps;
+
+    // Same device, older driver – replaced rather than kept
+    size_t kept = 0;
+    for (const DeviceCapsRecord& record : records)
+        if (record.vendorId != key.vendorId || record.deviceId != key.deviceId ||
+            record.subSysId != key.subSysId || record.revision != key.revision)
+            records[kept++] = record;
+    records.resize(kept);
+    records.push_back(key);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(records.data()), (std::streamsize)(records.size() * sizeof(DeviceCapsRecord)));
+    return key.caps;
+}
+
+// ---- Tiers ----
+
+inline DeviceTier PickDeviceTier(const DeviceCaps& caps)
+{
+    const UINT64 kGiB = 1024ull * 1024 * 1024;
+    if (caps.software || caps.uma || caps.featureLevel < D3D_FEATURE_LEVEL_12_0 || caps.dedicatedVideoMemory < 2 * kGiB)
+        return kTierLow;
+    if (caps.shaderModel >= D3D_SHADER_MODEL_6_6 && caps.bindingTier >= D3D12_RESOURCE_BINDING_TIER_3 &&
+        caps.meshShaderTier >= D3D12_MESH_SHADER_TIER_1 && caps.dedicatedVideoMemory >= 6 * kGiB)
+        return kTierHigh;
+    return kTierMid;
+}
@@ -0,0 +1,140 @@
+// ---------------------------------------------------------------
+// Draw batching – objects grouped by (material, mesh) into instanced draws
+// ---------------------------------------------------------------
+// Game code adds one InstanceData per object every frame; Build() sorts
+// them so every (material, mesh) pair ends up contiguous, and each pair
+// becomes a single instanced draw.
+//
+//   batcher.Clear();
+//   batcher.Add(mesh, material, instance);     // per object
+//   batcher.Build(instancesOut);               // packed in batch order
+//   for (const DrawBatch& b : batcher.Batches()) ...
+//
+// Callers that keep instance data elsewhere (ECS chunks) add references
+// instead and write the packed instances themselves, in Order():
+//
+//   batcher.AddRef(mesh, material, ref);       // ref means something to the caller
+//   batcher.BuildRefs();                       // dst[i] is the instance Order()[i] refers to
+//
+// Renderer side, a batch reads its instances from
+// instances[firstInstance + SV_InstanceID] – see shaders/common.hlsli.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Mirrors InstanceData in shaders/common.hlsli – 64 bytes
+struct InstanceData
+{
+    float world[3][4];      // rows of a 3x4 affine matrix, column-vector convention
+    float color[4];
+};
+static_assert(sizeof(InstanceData) == 64, "InstanceData must match the HLSL layout");
+
+// Vertex and index ranges in the shared geometry buffer, as cooked by meshcook.h
+struct Mesh
+{
+    uint32_t firstVertex;       // base vertex of the indices
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float    boundsCenter[3];   // bounding sphere, mesh space – used by GPU culling
+    float    boundsRadius;
+    float    positionOffset[3]; // mesh space = snorm16 position * positionScale + positionOffset
+    float    positionScale;
+    uint32_t meshletCount;      // 0 unless the mesh shader path loaded them
+};
+
+struct DrawBatch
+{
+    uint32_t mesh;
+    uint32_t material;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+class DrawBatcher
+{
+public:
+    void Clear()
+    {
+        m_items.clear();
+        m_instances.clear();
+        m_batches.clear();
+    }
+
+    void Add(uint32_t mesh, uint32_t material, const InstanceData& instance)
+    {
+        m_items.push_back({ ((uint64_t)material << 32) | mesh, (uint32_t)m_instances.size(), (uint32_t)m_items.size() });
+        m_instances.push_back(instance);
+    }
+
+    void AddRef(uint32_t mesh, uint32_t material, uint32_t ref)
+    {
+        m_items.push_back({ ((uint64_t)material << 32) | mesh, ref, (uint32_t)m_items.size() });
+    }
+
+    uint32_t InstanceCount() const { return (uint32_t)m_items.size(); }
+
+    // Writes InstanceCount() instances to `dst` in batch order and fills Batches()
+    void Build(InstanceData* dst)
+    {
+        SortItems();
+
+        m_batches.clear();
+        for (uint32_t i = 0; i < (uint32_t)m_items.size(); ++i)
+        {
+            const Item& item = m_items[i];
+            if (i == 0 || m_items[i - 1].key != item.key)
+                m_batches.push_back({ (uint32_t)item.key, (uint32_t)(item.key >> 32), i, 0 });
+            ++m_batches.back().instanceCount;
+
+            memcpy(&dst[i], &m_instances[item.instance], sizeof(InstanceData));
+        }
+    }
+
+    // Build() for AddRef(): fills Batches() and Order(), the caller copies the instances
+    void BuildRefs()
+    {
+        SortItems();
+
+        m_batches.clear();
+        m_order.resize(m_items.size());
+        for (uint32_t i = 0; i < (uint32_t)m_items.size(); ++i)
+        {
+            const Item& item = m_items[i];
+            if (i == 0 || m_items[i - 1].key != item.key)
+                m_batches.push_back({ (uint32_t)item.key, (uint32_t)(item.key >> 32), i, 0 });
+            ++m_batches.back().instanceCount;
+            m_order[i] = item.instance;
+        }
+    }
+
+    const std::vector<DrawBatch>& Batches() const { return m_batches; }
+    const std::vector<uint32_t>&  Order() const { return m_order; }
+
+private:
+    struct Item
+    {
+        uint64_t key;           // material << 32 | mesh
+        uint32_t instance;      // index into m_instances, or the caller's ref
+        uint32_t sequence;      // submission order
+    };
+
+    // Objects keep their submission order inside a batch. The sequence makes that
+    // a plain sort – stable_sort wants a temporary buffer every frame.
+    void SortItems()
+    {
+        std::sort(m_items.begin(), m_items.end(), [](const Item& a, const Item& b)
+        {
+            return a.key != b.key ? a.key < b.key : a.sequence < b.sequence;
+        });
+    }
+
+    std::vector<Item>         m_items;
+    std::vector<InstanceData> m_instances;
+    std::vector<DrawBatch>    m_batches;
+    std::vector<uint32_t>     m_order;      // BuildRefs(): ref per packed instance
+};
@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------
+// Small D3D12 helpers shared by main.cpp and the subsystem headers
+// ---------------------------------------------------------------
+#pragma once
+
+// windows.h defines min/max as macros – headers write (std::min)/(std::max)
+#include <windows.h>
+#include <wrl/client.h>
+#include <d3d12.h>
+#include <stdexcept>
+
+using Microsoft::WRL::ComPtr;
+
+inline void ThrowIfFailed(HRESULT hr)
+{
+    if (FAILED(hr))
+        throw std::runtime_error("HRESULT failed");
+}
+
+inline UINT64 AlignUp(UINT64 value, UINT64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+inline D3D12_HEAP_PROPERTIES HeapProperties(D3D12_HEAP_TYPE type)
+{
+    D3D12_HEAP_PROPERTIES props{};
+    props.Type = type;
+    return props;
+}
+
+inline D3D12_RESOURCE_DESC BufferDesc(UINT64 size, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE)
+{
+    D3D12_RESOURCE_DESC desc{};
+    desc.Dimension         = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width             = size;
+    desc.Height            = 1;
+    desc.DepthOrArraySize  = 1;
+    desc.MipLevels         = 1;
+    desc.SampleDesc.Count  = 1;
+    desc.Layout            = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags             = flags;
+    return desc;
+}
+
+inline D3D12_RESOURCE_DESC Texture2DDesc(DXGI_FORMAT format, UINT64 width, UINT height, UINT16 mipLevels = 1,
+                                         D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE)
+{
+    D3D12_RESOURCE_DESC desc{};
+    desc.Dimension         = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    desc.Width             = width;
+    desc.Height            = height;
+    desc.DepthOrArraySize  = 1;
+    desc.MipLevels         = mipLevels;
+    desc.Format            = format;
+    desc.SampleDesc.Count  = 1;
+    desc.Layout            = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    desc.Flags             = flags;
+    return desc;
+}
+
+// Committed buffer – fine for a handful of long-lived objects
+inline ComPtr<ID3D12Resource> CreateBuffer(ID3D12Device* device, UINT64 size, D3D12_HEAP_TYPE heapType,
+                                           D3D12_RESOURCE_STATES state,
+                                           D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE)
+{
+    D3D12_HEAP_PROPERTIES heapProps  = HeapProperties(heapType);
+    D3D12_RESOURCE_DESC   bufferDesc = BufferDesc(size, flags);
+
+    ComPtr<ID3D12Resource> buffer;
+    ThrowIfFailed(device->CreateCommittedResource(
+        &heapProps, D3D12_HEAP_FLAG_NONE,
+        &bufferDesc,
+        state,
+        nullptr,
+        IID_PPV_ARGS(&buffer)));
+    return buffer;
+}
+
+inline D3D12_RESOURCE_BARRIER TransitionBarrier(ID3D12Resource* resource,
+                                                D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after,
+                                                UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+{
+    D3D12_RESOURCE_BARRIER barrier{};
+    barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Transition.pResource   = resource;
+    barrier.Transition.StateBefore = before;
+    barrier.Transition.StateAfter  = after;
+    barrier.Transition.Subresource = subresource;
+    return barrier;
+}
+
+inline D3D12_RESOURCE_BARRIER UavBarrier(ID3D12Resource* resource)
+{
+    D3D12_RESOURCE_BARRIER barrier{};
+    barrier.Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    barrier.UAV.pResource = resource;
+    return barrier;
+}
+
+// Same defaults as CD3DX12_*_DESC(D3D12_DEFAULT), without pulling in d3dx12.h
+inline D3D12_RASTERIZER_DESC DefaultRasterizerState()
+{
+    D3D12_RASTERIZER_DESC desc{};
+    desc.FillMode              = D3D12_FILL_MODE_SOLID;
+    desc.CullMode              = D3D12_CULL_MODE_BACK;
+    desc.FrontCounterClockwise = FALSE;
+    desc.DepthBias             = D3D12_DEFAULT_DEPTH_BIAS;
+    desc.DepthBiasClamp        = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
+    desc.SlopeScaledDepthBias  = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
+    desc.DepthClipEnable       = TRUE;
+    desc.ConservativeRaster    = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+    return desc;
+}
+
+inline D3D12_BLEND_DESC DefaultBlendState()
+{
+    D3D12_BLEND_DESC desc{};
+    for (D3D12_RENDER_TARGET_BLEND_DESC& rt : desc.RenderTarget)
+    {
+        rt.SrcBlend              = D3D12_BLEND_ONE;
+        rt.DestBlend             = D3D12_BLEND_ZERO;
+        rt.BlendOp               = D3D12_BLEND_OP_ADD;
+        rt.SrcBlendAlpha         = D3D12_BLEND_ONE;
+        rt.DestBlendAlpha        = D3D12_BLEND_ZERO;
+        rt.BlendOpAlpha          = D3D12_BLEND_OP_ADD;
+        rt.LogicOp               = D3D12_LOGIC_OP_NOOP;
+        rt.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    }
+    return desc;
+}
+
+inline D3D12_DEPTH_STENCIL_DESC DefaultDepthStencilState()
+{
+    const D3D12_DEPTH_STENCILOP_DESC op =
+        { D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_COMPARISON_FUNC_ALWAYS };
+
+    D3D12_DEPTH_STENCIL_DESC desc{};
+    desc.DepthEnable      = TRUE;
+    desc.DepthWriteMask   = D3D12_DEPTH_WRITE_MASK_ALL;
+    desc.DepthFunc        = D3D12_COMPARISON_FUNC_LESS;
+    desc.StencilEnable    = FALSE;
+    desc.StencilReadMask  = D3D12_DEFAULT_STENCIL_READ_MASK;
+    desc.StencilWriteMask = D3D12_DEFAULT_STENCIL_WRITE_MASK;
+    desc.FrontFace        = op;
+    desc.BackFace         = op;
+    return desc;
+}
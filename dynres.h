@@ -0,0 +1,56 @@
+// ---------------------------------------------------------------
+// Dynamic resolution – render scale that holds a GPU frame time target
+// ---------------------------------------------------------------
+// The scene is rendered into the top-left (scale * size) corner of full
+// size targets and upscaled to the back buffer, so changing the scale is
+// just a different viewport – nothing gets reallocated.
+//
+// GPU cost is treated as proportional to pixel count (scale squared). The
+// measured time lags by the frames in flight plus the profiler's smoothing,
+// so the scale only moves every few frames, in bounded steps, and there is
+// a dead band below the target so it doesn't hunt.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+class DynamicResolution
+{
+public:
+    void Init(double targetMs, float minScale = 0.5f, float maxScale = 1.0f)
+    {
+        m_targetMs = targetMs;
+        m_minScale = minScale;
+        m_maxScale = maxScale;
+        m_scale    = maxScale;
+    }
+
+    // Once a frame with the latest GPU frame time; returns the scale to render at
+    float Update(double gpuMs)
+    {
+        if (++m_frames < kSettleFrames || gpuMs <= 0.0)
+            return m_scale;
+        m_frames = 0;
+
+        const double goal = m_targetMs * 0.9;      // aim under the target, spikes need room
+        if (gpuMs > m_targetMs || gpuMs < goal * 0.85)
+        {
+            float desired = m_scale * (float)std::sqrt(goal / gpuMs);
+            desired = std::clamp(desired, m_scale - kMaxStep, m_scale + kMaxStep);
+            m_scale = std::clamp(desired, m_minScale, m_maxScale);      // std::min/max are macros after windows.h
+        }
+        return m_scale;
+    }
+
+    float Scale() const { return m_scale; }
+
+private:
+    static const int      kSettleFrames = 8;
+    static constexpr float kMaxStep     = 0.05f;
+
+    double m_targetMs = 16.6;
+    float  m_minScale = 0.5f;
+    float  m_maxScale = 1.0f;
+    float  m_scale    = 1.0f;
+    int    m_frames   = 0;
+};
@@ -0,0 +1,391 @@
+// ---------------------------------------------------------------
+// ECS – archetype based entities, SoA chunk storage
+// ---------------------------------------------------------------
+// Every distinct set of component types is an archetype. An archetype's
+// entities live in fixed size chunks, each chunk holding one tightly packed
+// array per component (structure of arrays), so a system touching two
+// components streams through exactly those two arrays and nothing else.
+//
+//   Entity e = world.Create(Transform{...}, Spin{...});
+//   world.ForEach<Transform, const Spin>([](uint32_t count, Transform* t, const Spin* s) { ... });
+//   world.ParallelForEach<Transform, const Spin>(jobs, fn);     // one job per few chunks
+//
+// Components are plain data: trivially copyable, moved around with memcpy.
+// Destroy() fills the hole with the archetype's last entity, so chunks stay
+// dense and iteration never sees gaps. Structural changes (Create, Destroy,
+// Add, Remove) invalidate column pointers and must not run during ForEach.
+#pragma once
+
+#include "jobsystem.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+struct Entity
+{
+    uint32_t index      = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+using ComponentMask = uint64_t;
+
+class World
+{
+public:
+    static const uint32_t kMaxComponentTypes = 64;      // bits in ComponentMask
+    static const uint32_t kChunkBytes        = 16 * 1024;
+    static const uint32_t kChunkAlignment    = 64;
+
+    World() = default;
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+    ~World() { Clear(); }
+
+    // Ids are handed out on first use, process wide
+    template <typename T>
+    static uint32_t ComponentType() { return TypeId<std::remove_const_t<T>>(); }
+
+    template <typename... Ts>
+    static ComponentMask MaskOf() { return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << ComponentType<Ts>())); }
+
+    template <typename... Ts>
+    Entity Create(const Ts&... components)
+    {
+        Entity entity = AllocateEntity();
+        Record& record = m_records[entity.index];
+        Archetype& archetype = GetArchetype(MaskOf<Ts...>());
+        PushRow(archetype, entity, record);
+        (Write(archetype, record, components), ...);
+        return entity;
+    }
+
+    void Destroy(Entity entity)
+    {
+        if (!Alive(entity))
+            return;
+        Record& record = m_records[entity.index];
+        RemoveRow(*m_archetypes[record.archetype], record);
+        record = Record{ kNoArchetype, 0, 0, record.generation + 1 };
+        m_freeEntities.push_back(entity.index);
+        --m_entityCount;
+    }
+
+    bool Alive(Entity entity) const
+    {
+        return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation &&
+               m_records[entity.index].archetype != kNoArchetype;
+    }
+
+    template <typename T>
+    bool Has(Entity entity) const
+    {
+        return Alive(entity) && (m_archetypes[m_records[entity.index].archetype]->mask & MaskOf<T>());
+    }
+
+    // nullptr if the entity is gone or doesn't have a T
+    template <typename T>
+    T* Get(Entity entity)
+    {
+        if (!Has<T>(entity))
+            return nullptr;
+        const Record& record = m_records[entity.index];
+        return Column<T>(*m_archetypes[record.archetype], record.chunk) + record.row;
+    }
+
+    // Moves the entity to the archetype with T added (or just overwrites an existing T)
+    template <typename T>
+    void Add(Entity entity, const T& component)
+    {
+        if (!Alive(entity))
+            return;
+        if (!Has<T>(entity))
+            Move(entity, m_archetypes[m_records[entity.index].archetype]->mask | MaskOf<T>());
+        *Get<T>(entity) = component;
+    }
+
+    template <typename T>
+    void Remove(Entity entity)
+    {
+        if (Has<T>(entity))
+            Move(entity, m_archetypes[m_records[entity.index].archetype]->mask & ~MaskOf<T>());
+    }
+
+    // fn(uint32_t count, Ts*... columns) once per chunk of every archetype with all of Ts.
+    // Ask for const T where a system only reads.
+    template <typename... Ts, typename Fn>
+    void ForEach(Fn&& fn)
+    {
+        const ComponentMask mask = MaskOf<Ts...>();
+        for (std::unique_ptr<Archetype>& archetype : m_archetypes)
+        {
+            if ((archetype->mask & mask) != mask)
+                continue;
+            for (uint32_t chunk = 0; chunk < (uint32_t)archetype->chunks.size(); ++chunk)
+                fn(archetype->chunks[chunk].count, Column<Ts>(*archetype, chunk)...);
+        }
+    }
+
+    // ForEach spread over the job system, chunksPerJob chunks at a time; returns once all ran.
+    // fn runs concurrently on different chunks – it may only touch the rows it's given.
+    template <typename... Ts, typename Fn>
+    void ParallelForEach(JobSystem& jobs, Fn&& fn, uint32_t chunksPerJob = 4)
+    {
+        const ComponentMask mask = MaskOf<Ts...>();
+        m_scratch.clear();
+        for (uint32_t a = 0; a < (uint32_t)m_archetypes.size(); ++a)
+            if ((m_archetypes[a]->mask & mask) == mask)
+                for (uint32_t chunk = 0; chunk < (uint32_t)m_archetypes[a]->chunks.size(); ++chunk)
+                    m_scratch.push_back({ a, chunk });
+
+        JobSystem::Counter counter;
+        jobs.ParallelFor((uint32_t)m_scratch.size(), chunksPerJob, [this, &fn](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                Archetype& archetype = *m_archetypes[m_scratch[i].archetype];
+                const uint32_t chunk = m_scratch[i].chunk;
+                fn(archetype.chunks[chunk].count, Column<Ts>(archetype, chunk)...);
+            }
+        }, counter);
+        jobs.Wait(counter);
+    }
+
+    void Clear()
+    {
+        for (std::unique_ptr<Archetype>& archetype : m_archetypes)
+            for (Chunk& chunk : archetype->chunks)
+                FreeChunk(chunk.data);
+        m_archetypes.clear();
+        m_archetypeByMask.clear();
+        m_records.clear();
+        m_freeEntities.clear();
+        m_entityCount = 0;
+    }
+
+    uint32_t EntityCount() const { return m_entityCount; }
+    uint32_t ArchetypeCount() const { return (uint32_t)m_archetypes.size(); }
+    uint32_t ChunkCount() const
+    {
+        uint32_t count = 0;
+        for (const std::unique_ptr<Archetype>& archetype : m_archetypes)
+            count += (uint32_t)archetype->chunks.size();
+        return count;
+    }
+
+private:
+    static const uint32_t kNoArchetype = ~0u;
+    static const uint32_t kNoColumn    = ~0u;
+
+    struct TypeInfo
+    {
+        uint32_t size;
+        uint32_t alignment;
+    };
+
+    struct Chunk
+    {
+        uint8_t* data  = nullptr;
+        uint32_t count = 0;
+    };
+
+    struct Archetype
+    {
+        ComponentMask      mask     = 0;
+        uint32_t           capacity = 0;                    // rows per chunk
+        uint32_t           columns[kMaxComponentTypes];     // byte offset in a chunk, kNoColumn if absent
+        std::vector<Chunk> chunks;                          // all full except the last
+    };
+
+    // Where an entity's row is – entities column first in every chunk
+    struct Record
+    {
+        uint32_t archetype;
+        uint32_t chunk;
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    struct ChunkRef
+    {
+        uint32_t archetype;
+        uint32_t chunk;
+    };
+
+    // Only ever instantiated for non-const T – const T must map to the same id
+    template <typename T>
+    static uint32_t TypeId()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Components are moved with memcpy");
+        static_assert(alignof(T) <= kChunkAlignment, "Component alignment exceeds the chunk's");
+        static const uint32_t id = RegisterType(sizeof(T), alignof(T));
+        return id;
+    }
+
+    static std::vector<TypeInfo>& Types()
+    {
+        static std::vector<TypeInfo> types;
+        return types;
+    }
+
+    static uint32_t RegisterType(uint32_t size, uint32_t alignment)
+    {
+        std::vector<TypeInfo>& types = Types();
+        if (types.size() == kMaxComponentTypes)
+            throw std::runtime_error("Too many component types");
+        types.push_back({ size, alignment });
+        return (uint32_t)types.size() - 1;
+    }
+
+    static uint8_t* AllocateChunk()
+    {
+        return static_cast<uint8_t*>(::operator new(kChunkBytes, std::align_val_t(kChunkAlignment)));
+    }
+
+    static void FreeChunk(uint8_t* data) { ::operator delete(data, std::align_val_t(kChunkAlignment)); }
+
+    template <typename T>
+    T* Column(Archetype& archetype, uint32_t chunk)
+    {
+        return reinterpret_cast<T*>(archetype.chunks[chunk].data + archetype.columns[ComponentType<T>()]);
+    }
+
+    Entity* Entities(Archetype& archetype, uint32_t chunk)
+    {
+        return reinterpret_cast<Entity*>(archetype.chunks[chunk].data);
+    }
+
+    Archetype& GetArchetype(ComponentMask mask)
+    {
+        auto found = m_archetypeByMask.find(mask);
+        if (found != m_archetypeByMask.end())
+            return *m_archetypes[found->second];
+
+        const std::vector<TypeInfo>& types = Types();
+        auto archetype = std::make_unique<Archetype>();
+        archetype->mask = mask;
+
+        // Row size plus worst case alignment padding per column decides the capacity
+        uint32_t rowBytes = sizeof(Entity), padding = 0;
+        for (uint32_t type = 0; type < kMaxComponentTypes; ++type)
+            if (mask & (ComponentMask{ 1 } << type))
+            {
+                rowBytes += types[type].size;
+                padding  += types[type].alignment;
+            }
+        archetype->capacity = (kChunkBytes - padding) / rowBytes;
+        if (archetype->capacity == 0)
+            throw std::runtime_error("Archetype row doesn't fit in a chunk");
+
+        uint32_t offset = sizeof(Entity) * archetype->capacity;
+        for (uint32_t type = 0; type < kMaxComponentTypes; ++type)
+        {
+            archetype->columns[type] = kNoColumn;
+            if (!(mask & (ComponentMask{ 1 } << type)))
+                continue;
+            offset = (offset + types[type].alignment - 1) & ~(types[type].alignment - 1);
+            archetype->columns[type] = offset;
+            offset += types[type].size * archetype->capacity;
+        }
+
+        m_archetypeByMask[mask] = (uint32_t)m_archetypes.size();
+        m_archetypes.push_back(std::move(archetype));
+        return *m_archetypes.back();
+    }
+
+    Entity AllocateEntity()
+    {
+        ++m_entityCount;
+        if (!m_freeEntities.empty())
+        {
+            const uint32_t index = m_freeEntities.back();
+            m_freeEntities.pop_back();
+            return { index, m_records[index].generation };
+        }
+        m_records.push_back({ kNoArchetype, 0, 0, 0 });
+        return { (uint32_t)m_records.size() - 1, 0 };
+    }
+
+    // Appends a row for entity – its components are left for the caller to fill
+    void PushRow(Archetype& archetype, Entity entity, Record& record)
+    {
+        if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity)
+            archetype.chunks.push_back({ AllocateChunk(), 0 });
+
+        const uint32_t chunk = (uint32_t)archetype.chunks.size() - 1;
+        const uint32_t row   = archetype.chunks[chunk].count++;
+        Entities(archetype, chunk)[row] = entity;
+        record.archetype = m_archetypeByMask[archetype.mask];
+        record.chunk     = chunk;
+        record.row       = row;
+    }
+
+    // Fills the row with the archetype's last one, then drops the last
+    void RemoveRow(Archetype& archetype, const Record& record)
+    {
+        const uint32_t lastChunk = (uint32_t)archetype.chunks.size() - 1;
+        const uint32_t lastRow   = archetype.chunks[lastChunk].count - 1;
+        if (record.chunk != lastChunk || record.row != lastRow)
+        {
+            const Entity moved = Entities(archetype, lastChunk)[lastRow];
+            Entities(archetype, record.chunk)[record.row] = moved;
+            CopyRow(archetype, lastChunk, lastRow, archetype, record.chunk, record.row);
+            m_records[moved.index].chunk = record.chunk;
+            m_records[moved.index].row   = record.row;
+        }
+
+        if (--archetype.chunks[lastChunk].count == 0)
+        {
+            FreeChunk(archetype.chunks[lastChunk].data);
+            archetype.chunks.pop_back();
+        }
+    }
+
+    // Every component both archetypes have
+    void CopyRow(Archetype& src, uint32_t srcChunk, uint32_t srcRow, Archetype& dst, uint32_t dstChunk, uint32_t dstRow)
+    {
+        const std::vector<TypeInfo>& types = Types();
+        const ComponentMask shared = src.mask & dst.mask;
+        for (uint32_t type = 0; type < kMaxComponentTypes; ++type)
+        {
+            if (!(shared & (ComponentMask{ 1 } << type)))
+                continue;
+            const uint32_t size = types[type].size;
+            memcpy(dst.chunks[dstChunk].data + dst.columns[type] + (size_t)size * dstRow,
+                   src.chunks[srcChunk].data + src.columns[type] + (size_t)size * srcRow, size);
+        }
+    }
+
+    void Move(Entity entity, ComponentMask mask)
+    {
+        Record&    record = m_records[entity.index];
+        Archetype& target = GetArchetype(mask);            // may grow m_archetypes – look the source up after
+        Archetype& source = *m_archetypes[record.archetype];
+
+        const Record old = record;
+        PushRow(target, entity, record);
+        CopyRow(source, old.chunk, old.row, target, record.chunk, record.row);
+        RemoveRow(source, old);
+    }
+
+    template <typename T>
+    void Write(Archetype& archetype, const Record& record, const T& component)
+    {
+        Column<T>(archetype, record.chunk)[record.row] = component;
+    }
+
+    std::vector<std::unique_ptr<Archetype>>  m_archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeByMask;
+    std::vector<Record>                      m_records;          // per entity index
+    std::vector<uint32_t>                    m_freeEntities;
+    std::vector<ChunkRef>                    m_scratch;          // ParallelForEach's chunk list
+    uint32_t                                 m_entityCount = 0;
+};
@@ -0,0 +1,353 @@
+// ---------------------------------------------------------------
+// Frame memory – linear arenas, small object pools, heap counters
+// ---------------------------------------------------------------
+// The frame loop is meant to run without touching the general-purpose heap:
+//
+//   LinearArena     bump allocator over blocks it keeps across Reset(), so once
+//                   warm a frame's worth of scratch costs a pointer add. Frame
+//                   slots own one each (reset when the slot comes round), the
+//                   render graph has its own. ArenaVector puts std::vector in one.
+//   SmallPool       size classes up to 256 bytes, a free list per class per
+//                   thread. Blocks freed on another thread go back to the owner
+//                   through a lock-free list it picks up when it runs dry.
+//   HeapCounters    bumped by the app's operator new/delete (main.cpp); read a
+//                   delta around a frame and it should be zero once warm.
+//
+// Arena memory is never freed piece by piece – destructors don't run either,
+// so keep it to trivially destructible things, or containers that are
+// released (ReleaseVector) before the arena is reset.
+//
+// Plain std only.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ---- Heap counters ----
+
+struct HeapCounters
+{
+    static inline std::atomic<uint64_t> allocations{ 0 };
+    static inline std::atomic<uint64_t> frees{ 0 };
+    static inline std::atomic<uint64_t> bytes{ 0 };     // requested, ever
+};
+
+// What the app's replacement operator new/delete call
+inline void* CountedAlloc(size_t size, size_t alignment = 0)
+{
+    HeapCounters::allocations.fetch_add(1, std::memory_order_relaxed);
+    HeapCounters::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+#if defined(_MSC_VER)
+    void* p = alignment ? _aligned_malloc(size, alignment) : malloc(size);
+#else
+    void* p = alignment ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : malloc(size);
+#endif
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+inline void CountedFree(void* p, bool aligned = false)
+{
+    if (!p)
+        return;
+    HeapCounters::frees.fetch_add(1, std::memory_order_relaxed);
+#if defined(_MSC_VER)
+    if (aligned)
+    {
+        _aligned_free(p);
+        return;
+    }
+#endif
+    (void)aligned;
+    free(p);
+}
+
+// Heap allocations made (by any thread) since construction
+class AllocationScope
+{
+public:
+    AllocationScope() : m_start(HeapCounters::allocations.load(std::memory_order_relaxed)) {}
+    uint64_t Count() const { return HeapCounters::allocations.load(std::memory_order_relaxed) - m_start; }
+
+private:
+    uint64_t m_start;
+};
+
+// ---- Linear arena ----
+
+class LinearArena
+{
+public:
+    explicit LinearArena(size_t blockSize = 64 * 1024) : m_blockSize(blockSize) {}
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        while (m_current < m_blocks.size())
+        {
+            Block&    block  = m_blocks[m_current];
+            uintptr_t base   = reinterpret_cast<uintptr_t>(block.memory.get());
+            uintptr_t offset = ((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+            if (offset + size <= block.size)
+            {
+                m_offset = offset + size;
+                m_used  += size;
+                if (m_used > m_highWater)
+                    m_highWater = m_used;
+                return reinterpret_cast<void*>(base + offset);
+            }
+            // Next kept block, if any – the rest of this one is wasted until Reset()
+            ++m_current;
+            m_offset = 0;
+        }
+
+        // Out of blocks: only while warming up, or if a frame wants more than ever before
+        const size_t blockSize = size + alignment > m_blockSize ? size + alignment : m_blockSize;
+        m_blocks.push_back({ std::unique_ptr<uint8_t[]>(new uint8_t[blockSize]), blockSize });
+        m_current = m_blocks.size() - 1;
+        m_offset  = 0;
+        return Allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* Allocate(size_t count)
+    {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Keeps every block – the next frame reuses them
+    void Reset()
+    {
+        m_current = 0;
+        m_offset  = 0;
+        m_used    = 0;
+    }
+
+    size_t Used() const { return m_used; }
+    size_t HighWater() const { return m_highWater; }   // most Used() ever got between resets
+    size_t Reserved() const
+    {
+        size_t total = 0;
+        for (const Block& block : m_blocks)
+            total += block.size;
+        return total;
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> memory;
+        size_t                     size;
+    };
+
+    size_t             m_blockSize;
+    std::vector<Block> m_blocks;
+    size_t             m_current   = 0;
+    size_t             m_offset    = 0;
+    size_t             m_used      = 0;
+    size_t             m_highWater = 0;
+};
+
+// std allocator over an arena – deallocate is a no-op, Reset() takes it all back
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator(LinearArena* arena) : m_arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.Arena()) {}
+
+    T*   allocate(size_t count) { return m_arena->Allocate<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    LinearArena* Arena() const { return m_arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.Arena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.Arena(); }
+
+private:
+    LinearArena* m_arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Drops the vector's arena memory – clear() alone keeps pointing at it across a Reset()
+template <typename T>
+void ReleaseVector(ArenaVector<T>& v)
+{
+    ArenaVector<T>(v.get_allocator()).swap(v);
+}
+
+// ---- Small object pool ----
+
+class SmallPool
+{
+public:
+    static const size_t kMaxSize    = 256;
+    static const size_t kPageSize   = 64 * 1024;    // pages are aligned to this, the header says whose they are
+    static const size_t kClassCount = 5;            // 16, 32, 64, 128, 256
+
+    SmallPool() = default;
+    SmallPool(const SmallPool&) = delete;
+    SmallPool& operator=(const SmallPool&) = delete;
+    ~SmallPool()
+    {
+        for (void* page : m_pages)
+            ::operator delete(page, std::align_val_t(kPageSize));
+    }
+
+    static void* Allocate(size_t size)
+    {
+        if (size > kMaxSize)
+            return ::operator new(size);
+        return Local().Pop(ClassOf(size));
+    }
+
+    // size as passed to Allocate()
+    static void Free(void* p, size_t size)
+    {
+        if (!p)
+            return;
+        if (size > kMaxSize)
+        {
+            ::operator delete(p);
+            return;
+        }
+        Page*      page  = reinterpret_cast<Page*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(kPageSize - 1));
+        SmallPool* owner = page->owner;
+        Node*      node  = static_cast<Node*>(p);
+        if (owner == &Local())
+        {
+            node->next = owner->m_free[page->sizeClass];
+            owner->m_free[page->sizeClass] = node;
+            return;
+        }
+        // Someone else's – push onto its remote list, it collects them when it runs out
+        std::atomic<Node*>& remote = owner->m_remote[page->sizeClass];
+        node->next = remote.load(std::memory_order_relaxed);
+        while (!remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static uint64_t PagesAllocated() { return s_pages.load(std::memory_order_relaxed); }
+
+private:
+    struct Node
+    {
+        Node* next;
+    };
+
+    struct Page
+    {
+        SmallPool* owner;
+        size_t     sizeClass;
+    };
+
+    static size_t ClassOf(size_t size)
+    {
+        size_t sizeClass = 0;
+        while ((size_t)16 << sizeClass < size)
+            ++sizeClass;
+        return sizeClass;
+    }
+
+    // One per thread, outliving it – other threads may still free into it
+    static SmallPool& Local()
+    {
+        static thread_local SmallPool* pool = nullptr;
+        if (!pool)
+        {
+            PoolRegistry& registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.pools.push_back(std::make_unique<SmallPool>());
+            pool = registry.pools.back().get();
+        }
+        return *pool;
+    }
+
+    struct PoolRegistry
+    {
+        std::mutex                              mutex;
+        std::vector<std::unique_ptr<SmallPool>> pools;
+    };
+    // Leaked on purpose: static destructors may still hand blocks back at exit
+    static PoolRegistry& Registry()
+    {
+        static PoolRegistry* registry = new PoolRegistry;
+        return *registry;
+    }
+
+    void* Pop(size_t sizeClass)
+    {
+        if (!m_free[sizeClass])
+            m_free[sizeClass] = m_remote[sizeClass].exchange(nullptr, std::memory_order_acquire);
+        if (!m_free[sizeClass])
+            Grow(sizeClass);
+        Node* node = m_free[sizeClass];
+        m_free[sizeClass] = node->next;
+        return node;
+    }
+
+    void Grow(size_t sizeClass)
+    {
+        void* memory = ::operator new(kPageSize, std::align_val_t(kPageSize));
+        m_pages.push_back(memory);
+        s_pages.fetch_add(1, std::memory_order_relaxed);
+
+        Page* page = static_cast<Page*>(memory);
+        page->owner     = this;
+        page->sizeClass = sizeClass;
+
+        // Blocks after the header, each aligned to its size
+        const size_t blockSize = (size_t)16 << sizeClass;
+        uint8_t*     base      = static_cast<uint8_t*>(memory);
+        for (size_t offset = (sizeof(Page) + blockSize - 1) / blockSize * blockSize; offset + blockSize <= kPageSize;
+             offset += blockSize)
+        {
+            Node* node = reinterpret_cast<Node*>(base + offset);
+            node->next = m_free[sizeClass];
+            m_free[sizeClass] = node;
+        }
+    }
+
+    Node*                m_free[kClassCount]   = {};
+    std::atomic<Node*>   m_remote[kClassCount] = {};
+    std::vector<void*>   m_pages;
+
+    static inline std::atomic<uint64_t> s_pages{ 0 };
+};
+
+template <typename T, typename... Args>
+T* PoolNew(Args&&... args)
+{
+    void* memory = SmallPool::Allocate(sizeof(T));
+    static_assert(alignof(T) <= 16, "SmallPool blocks are 16 byte aligned");
+    return new (memory) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void PoolDelete(T* object)
+{
+    if (!object)
+        return;
+    object->~T();
+    SmallPool::Free(object, sizeof(T));
+}
@@ -0,0 +1,165 @@
+// ---------------------------------------------------------------
+// Frame queue – hand-off between the OS, simulation and render threads
+// ---------------------------------------------------------------
+//   OS thread      pumps messages, stamps input with QPC ticks -> InputQueue
+//   sim thread     drains input, steps the world, fills a packet -> FramePacketQueue
+//   render thread  takes the packet, uploads, records, presents
+//
+// FramePacketQueue is two packets and a state word each, single producer,
+// single consumer. The producer fills one while the consumer works from the
+// other, so simulating frame N+1 overlaps recording/submitting frame N. It
+// never runs further ahead than that: a new packet is only started once the
+// last one has been picked up, which keeps input-to-photon latency at one
+// frame of pipelining rather than however fast the simulation can spin.
+// Blocking is C++20 atomic wait/notify (WaitOnAddress on Windows) – no locks.
+//
+// InputQueue is a fixed SPSC ring; when the reader falls behind, new events
+// are dropped and counted rather than blocking the window procedure.
+//
+// Plain std only.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+template <typename Packet>
+class FramePacketQueue
+{
+public:
+    // Producer. nullptr once Close() was called.
+    Packet* BeginWrite()
+    {
+        // The packet we published last has to be taken first...
+        if (!WaitWhile(m_state[m_write ^ 1], kReady))
+            return nullptr;
+        // ...and the consumer has to be done with the one we are about to overwrite
+        if (!WaitUntil(m_state[m_write], kFree))
+            return nullptr;
+        return &m_packets[m_write];
+    }
+
+    void Publish()
+    {
+        Set(m_state[m_write], kReady);
+        m_write ^= 1;
+    }
+
+    // Consumer. nullptr once Close() was called.
+    const Packet* BeginRead()
+    {
+        if (!WaitUntil(m_state[m_read], kReady))
+            return nullptr;
+        Set(m_state[m_read], kReading);
+        return &m_packets[m_read];
+    }
+
+    // As soon as the packet's contents have been copied out, not at the end of the frame
+    void EndRead()
+    {
+        Set(m_state[m_read], kFree);
+        m_read ^= 1;
+    }
+
+    // Wakes both sides; every Begin* fails from here on
+    void Close()
+    {
+        for (std::atomic<uint32_t>& state : m_state)
+        {
+            state.fetch_or(kClosed, std::memory_order_acq_rel);
+            state.notify_all();
+        }
+    }
+
+private:
+    static const uint32_t kFree    = 0;
+    static const uint32_t kReady   = 1;
+    static const uint32_t kReading = 2;
+    static const uint32_t kClosed  = 0x80000000u;
+
+    static void Set(std::atomic<uint32_t>& state, uint32_t value)
+    {
+        // Keep a concurrent Close() bit
+        uint32_t old = state.load(std::memory_order_relaxed);
+        while (!state.compare_exchange_weak(old, (old & kClosed) | value, std::memory_order_acq_rel))
+        {
+        }
+        state.notify_all();
+    }
+
+    static bool WaitUntil(std::atomic<uint32_t>& state, uint32_t value)
+    {
+        uint32_t current = state.load(std::memory_order_acquire);
+        while (current != value)
+        {
+            if (current & kClosed)
+                return false;
+            state.wait(current, std::memory_order_acquire);
+            current = state.load(std::memory_order_acquire);
+        }
+        return true;
+    }
+
+    static bool WaitWhile(std::atomic<uint32_t>& state, uint32_t value)
+    {
+        uint32_t current = state.load(std::memory_order_acquire);
+        while (current == value)
+        {
+            state.wait(current, std::memory_order_acquire);
+            current = state.load(std::memory_order_acquire);
+        }
+        return !(current & kClosed);
+    }
+
+    Packet                m_packets[2];
+    std::atomic<uint32_t> m_state[2] = { kFree, kFree };
+    uint32_t              m_write = 0;      // producer only
+    uint32_t              m_read  = 0;      // consumer only
+};
+
+// A window message as it arrived, with when it arrived
+struct InputEvent
+{
+    int64_t  time;          // QPC ticks
+    uint32_t message;
+    uint64_t wParam;
+    int64_t  lParam;
+};
+
+class InputQueue
+{
+public:
+    static const uint32_t kCapacity = 256;  // power of two
+
+    // Window procedure side
+    bool Push(const InputEvent& event)
+    {
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == kCapacity)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_events[head & (kCapacity - 1)] = event;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Simulation side
+    bool Pop(InputEvent& out)
+    {
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+        out = m_events[tail & (kCapacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    InputEvent            m_events[kCapacity];
+    std::atomic<uint32_t> m_head{ 0 };
+    std::atomic<uint32_t> m_tail{ 0 };
+    std::atomic<uint32_t> m_dropped{ 0 };
+};
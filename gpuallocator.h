@@ -0,0 +1,452 @@
+// ---------------------------------------------------------------
+// GPU memory allocator – placed resources in big ID3D12Heap blocks
+// ---------------------------------------------------------------
+// Instead of one implicit heap per CreateCommittedResource, resources are
+// placed into 64MB heaps. Every heap is cut into equal slots of one size
+// class (64KB steps, four classes per power of two, so at most 25% rounding
+// waste). Anything bigger than a quarter block gets its own exactly sized
+// heap. Heaps are split by heap type and by resource category so this works
+// on resource heap tier 1 hardware too.
+//
+// Free() does not wait for the GPU – defer it until the last fence that
+// used the resource has passed, same as releasing a committed resource.
+#pragma once
+
+#include "dxhelpers.h"
+#include "framememory.h"
+#include <dxgi1_6.h>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+struct GpuAllocation
+{
+    ComPtr<ID3D12Resource> resource;
+    UINT64                 size     = 0;        // bytes reserved, including class rounding
+    void*                  userData = nullptr;  // handed back to the move callback
+
+private:
+    friend class GpuAllocator;
+    UINT                   pool      = 0;
+    UINT                   sizeClass = 0;
+    UINT                   block     = 0;
+    UINT                   slot      = 0;
+    bool                   dedicated = false;
+    ComPtr<ID3D12Heap>     dedicatedHeap;
+    D3D12_RESOURCE_DESC    desc{};
+};
+
+struct GpuMemoryStats
+{
+    // What we have carved out of the heaps we own
+    UINT64 reservedBytes    = 0;   // sum of heap sizes
+    UINT64 allocatedBytes   = 0;   // sum of live slots
+    UINT   heapCount        = 0;
+    UINT   allocationCount  = 0;
+
+    // What the OS says (IDXGIAdapter3::QueryVideoMemoryInfo)
+    DXGI_QUERY_VIDEO_MEMORY_INFO local{};      // VRAM
+    DXGI_QUERY_VIDEO_MEMORY_INFO nonLocal{};   // shared system memory
+};
+
+// One pending defragment copy: copy src -> dst on the GPU, then EndDefragment()
+struct GpuDefragMove
+{
+    GpuAllocation*         allocation;
+    ComPtr<ID3D12Resource> src;
+    ComPtr<ID3D12Resource> dst;   // created in COPY_DEST
+};
+
+class GpuAllocator
+{
+public:
+    // Called from EndDefragment() once an allocation has a new resource – rebuild views here
+    using MoveCallback = std::function<void(GpuAllocation&)>;
+
+    void Init(ID3D12Device* device, IDXGIAdapter3* adapter, UINT64 blockSize = 64ull * 1024 * 1024)
+    {
+        m_device    = device;
+        m_adapter   = adapter;
+        m_blockSize = blockSize;
+
+        // 64K, 128K, 192K, 256K, 320K, 384K, 448K, 512K, 640K ... up to blockSize / 4
+        m_classes.clear();
+        for (UINT64 p = kSlotAlignment; p <= blockSize / 4; p *= 2)
+        {
+            for (UINT64 step = 0; step < 4; ++step)
+            {
+                UINT64 size = AlignUp(p + p * step / 4, kSlotAlignment);
+                if (size <= blockSize / 4 && (m_classes.empty() || m_classes.back() < size))
+                    m_classes.push_back(size);
+            }
+        }
+
+        for (Pool& pool : m_pools)
+            pool.classes.assign(m_classes.size(), {});
+    }
+
+    void SetMoveCallback(MoveCallback callback) { m_onMoved = std::move(callback); }
+
+    GpuAllocation* CreateBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES state,
+                                D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE)
+    {
+        D3D12_RESOURCE_DESC desc = BufferDesc(size, flags);
+        return CreateResource(heapType, desc, state, nullptr);
+    }
+
+    GpuAllocation* CreateResource(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc,
+                                  D3D12_RESOURCE_STATES state, const D3D12_CLEAR_VALUE* clearValue)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+        if (info.SizeInBytes == UINT64_MAX)
+            throw std::runtime_error("Invalid resource description");
+
+        auto* alloc  = PoolNew<GpuAllocation>();   // small, and frees come from any thread
+        alloc->pool  = PoolIndex(heapType, desc);
+        alloc->desc  = desc;
+
+        // MSAA (4MB alignment) and anything huge gets its own heap
+        const bool dedicated = info.Alignment > kSlotAlignment || info.SizeInBytes > m_classes.back();
+
+        ID3D12Heap* heap   = nullptr;
+        UINT64      offset = 0;
+        if (dedicated)
+        {
+            alloc->dedicated     = true;
+            alloc->size          = AlignUp(info.SizeInBytes, info.Alignment);
+            alloc->dedicatedHeap = CreateHeap(alloc->pool, alloc->size, info.Alignment);
+            heap = alloc->dedicatedHeap.Get();
+        }
+        else
+        {
+            alloc->sizeClass = ClassFor(info.SizeInBytes);
+            alloc->size      = m_classes[alloc->sizeClass];
+            AllocateSlot(*alloc, ~0u);
+
+            Block& block = m_pools[alloc->pool].classes[alloc->sizeClass][alloc->block];
+            heap   = block.heap.Get();
+            offset = (UINT64)alloc->slot * alloc->size;
+        }
+
+        HRESULT hr = m_device->CreatePlacedResource(heap, offset, &desc, state, clearValue,
+                                                    IID_PPV_ARGS(&alloc->resource));
+        if (FAILED(hr))
+        {
+            FreeLocked(alloc);
+            ThrowIfFailed(hr);
+        }
+
+        m_allocatedBytes += alloc->size;
+        ++m_allocationCount;
+        return alloc;
+    }
+
+    void Free(GpuAllocation* alloc)
+    {
+        if (!alloc)
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_allocatedBytes -= alloc->size;
+        --m_allocationCount;
+        FreeLocked(alloc);
+    }
+
+    GpuMemoryStats GetStats()
+    {
+        GpuMemoryStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stats.reservedBytes   = m_reservedBytes;
+            stats.allocatedBytes  = m_allocatedBytes;
+            stats.heapCount       = m_heapCount;
+            stats.allocationCount = m_allocationCount;
+        }
+        if (m_adapter)
+        {
+            m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &stats.local);
+            m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL, &stats.nonLocal);
+        }
+        return stats;
+    }
+
+    // Defragmentation hooks.
+    // BeginDefragment() picks sparse heaps and creates new homes (in denser heaps)
+    // for up to maxBytes of their buffers and sampled textures. The caller records
+    // CopyResource(dst, src) for every move; once those copies have finished on
+    // the GPU it calls EndDefragment(), which swaps the resources, fires the move
+    // callback and gives the old slots back. Empty heaps are released as usual.
+    std::vector<GpuDefragMove> BeginDefragment(UINT64 maxBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<GpuDefragMove> moves;
+        UINT64 moved = 0;
+
+        for (UINT p = 0; p < kPoolCount && moved < maxBytes; ++p)
+        {
+            if (p % kCategoryCount == kCategoryRtDs)
+                continue;   // render targets are cheaper to recreate than to copy
+
+            for (UINT c = 0; c < (UINT)m_classes.size() && moved < maxBytes; ++c)
+            {
+                std::vector<Block>& blocks = m_pools[p].classes[c];
+
+                // Evacuate blocks that are less than a quarter full, sparsest first
+                std::vector<UINT> sources;
+                for (UINT b = 0; b < (UINT)blocks.size(); ++b)
+                    if (blocks[b].heap && blocks[b].used > 0 && blocks[b].used * 4 < blocks[b].owners.size())
+                        sources.push_back(b);
+                std::sort(sources.begin(), sources.end(),
+                          [&](UINT a, UINT b) { return blocks[a].used < blocks[b].used; });
+
+                // If every live heap is sparse, the fullest of them becomes the destination
+                if (!sources.empty() && sources.size() == CountLiveBlocks(blocks))
+                    sources.pop_back();
+                if (sources.empty())
+                    continue;
+
+                for (UINT b : sources)
+                    blocks[b].evacuating = true;
+
+                for (UINT b : sources)
+                {
+                    for (UINT s = 0; s < (UINT)blocks[b].owners.size() && moved < maxBytes; ++s)
+                    {
+                        GpuAllocation* alloc = blocks[b].owners[s];
+                        if (!alloc || alloc->desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET |
+                                                           D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+                            continue;
+
+                        // Reserve a slot elsewhere; the old one stays taken until EndDefragment
+                        GpuAllocation target;
+                        target.pool      = p;
+                        target.sizeClass = c;
+                        if (!AllocateSlot(target, b, /*allowNewBlock*/ false))
+                            break;
+
+                        Block& dstBlock = blocks[target.block];
+                        dstBlock.owners[target.slot] = alloc;
+                        m_pendingMoves.push_back({ alloc, target.block, target.slot });
+
+                        GpuDefragMove move{ alloc, alloc->resource, nullptr };
+                        ThrowIfFailed(m_device->CreatePlacedResource(
+                            dstBlock.heap.Get(), (UINT64)target.slot * alloc->size, &alloc->desc,
+                            D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&move.dst)));
+                        moves.push_back(move);
+                        moved += alloc->size;
+                    }
+                }
+
+                for (UINT b : sources)
+                    blocks[b].evacuating = false;
+            }
+        }
+        return moves;
+    }
+
+    void EndDefragment(std::vector<GpuDefragMove>& moves)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < moves.size(); ++i)
+        {
+            GpuAllocation* alloc = moves[i].allocation;
+            const PendingMove& pending = m_pendingMoves[i];
+
+            // Give back the old slot, then point the allocation at the new one
+            Block& oldBlock = m_pools[alloc->pool].classes[alloc->sizeClass][alloc->block];
+            oldBlock.owners[alloc->slot] = nullptr;
+            oldBlock.freeSlots.push_back(alloc->slot);
+            --oldBlock.used;
+            const UINT oldBlockIndex = alloc->block;
+
+            alloc->block    = pending.block;
+            alloc->slot     = pending.slot;
+            alloc->resource = moves[i].dst;
+            ReleaseBlockIfEmpty(alloc->pool, alloc->sizeClass, oldBlockIndex);
+        }
+        m_pendingMoves.clear();
+        lock.unlock();
+
+        if (m_onMoved)
+            for (GpuDefragMove& move : moves)
+                m_onMoved(*move.allocation);
+        moves.clear();
+    }
+
+private:
+    static const UINT64 kSlotAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT; // 64KB
+
+    enum : UINT { kCategoryBuffer, kCategoryTexture, kCategoryRtDs, kCategoryCount };
+    static const UINT kHeapTypeCount = 3;   // DEFAULT, UPLOAD, READBACK
+    static const UINT kPoolCount     = kHeapTypeCount * kCategoryCount;
+
+    struct Block
+    {
+        ComPtr<ID3D12Heap>          heap;
+        std::vector<GpuAllocation*> owners;     // one entry per slot
+        std::vector<UINT>           freeSlots;
+        UINT                        used       = 0;
+        bool                        evacuating = false;
+    };
+
+    struct Pool
+    {
+        std::vector<std::vector<Block>> classes;   // [sizeClass][block]
+    };
+
+    struct PendingMove
+    {
+        GpuAllocation* allocation;
+        UINT           block;
+        UINT           slot;
+    };
+
+    static UINT PoolIndex(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc)
+    {
+        UINT type = heapType == D3D12_HEAP_TYPE_UPLOAD ? 1 : heapType == D3D12_HEAP_TYPE_READBACK ? 2 : 0;
+        UINT category = kCategoryTexture;
+        if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+            category = kCategoryBuffer;
+        else if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+            category = kCategoryRtDs;
+        return type * kCategoryCount + category;
+    }
+
+    UINT ClassFor(UINT64 size) const
+    {
+        return (UINT)(std::lower_bound(m_classes.begin(), m_classes.end(), size) - m_classes.begin());
+    }
+
+    ComPtr<ID3D12Heap> CreateHeap(UINT pool, UINT64 size, UINT64 alignment)
+    {
+        static const D3D12_HEAP_TYPE types[kHeapTypeCount] =
+            { D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_TYPE_READBACK };
+        static const D3D12_HEAP_FLAGS flags[kCategoryCount] =
+            { D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+              D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+              D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES };
+
+        D3D12_HEAP_DESC desc{};
+        desc.SizeInBytes     = size;
+        desc.Properties.Type = types[pool / kCategoryCount];
+        desc.Alignment       = alignment;
+        desc.Flags           = flags[pool % kCategoryCount];
+
+        ComPtr<ID3D12Heap> heap;
+        ThrowIfFailed(m_device->CreateHeap(&desc, IID_PPV_ARGS(&heap)));
+        m_reservedBytes += size;
+        ++m_heapCount;
+        return heap;
+    }
+
+    // Finds a free slot for alloc's pool/class, skipping `exclude` and evacuating blocks
+    bool AllocateSlot(GpuAllocation& alloc, UINT exclude, bool allowNewBlock = true)
+    {
+        std::vector<Block>& blocks = m_pools[alloc.pool].classes[alloc.sizeClass];
+
+        UINT chosen = ~0u;
+        for (UINT b = 0; b < (UINT)blocks.size() && chosen == ~0u; ++b)
+            if (b != exclude && blocks[b].heap && !blocks[b].evacuating && !blocks[b].freeSlots.empty())
+                chosen = b;
+
+        if (chosen == ~0u)
+        {
+            if (!allowNewBlock)
+                return false;
+
+            // Reuse a released entry so block indices stay stable
+            for (UINT b = 0; b < (UINT)blocks.size() && chosen == ~0u; ++b)
+                if (!blocks[b].heap)
+                    chosen = b;
+            if (chosen == ~0u)
+            {
+                chosen = (UINT)blocks.size();
+                blocks.emplace_back();
+            }
+
+            const UINT64 classSize = m_classes[alloc.sizeClass];
+            const UINT   slots     = (UINT)(m_blockSize / classSize);
+            Block& block = blocks[chosen];
+            block.heap = CreateHeap(alloc.pool, slots * classSize, kSlotAlignment);
+            block.owners.assign(slots, nullptr);
+            block.freeSlots.clear();
+            for (UINT s = slots; s-- > 0;)
+                block.freeSlots.push_back(s);   // hand out low offsets first
+            block.used = 0;
+        }
+
+        Block& block = blocks[chosen];
+        alloc.block = chosen;
+        alloc.slot  = block.freeSlots.back();
+        block.freeSlots.pop_back();
+        block.owners[alloc.slot] = &alloc;
+        ++block.used;
+        return true;
+    }
+
+    void FreeLocked(GpuAllocation* alloc)
+    {
+        alloc->resource.Reset();
+        if (alloc->dedicated)
+        {
+            if (alloc->dedicatedHeap)
+            {
+                m_reservedBytes -= alloc->dedicatedHeap->GetDesc().SizeInBytes;
+                --m_heapCount;
+            }
+        }
+        else
+        {
+            Block& block = m_pools[alloc->pool].classes[alloc->sizeClass][alloc->block];
+            block.owners[alloc->slot] = nullptr;
+            block.freeSlots.push_back(alloc->slot);
+            --block.used;
+            ReleaseBlockIfEmpty(alloc->pool, alloc->sizeClass, alloc->block);
+        }
+        PoolDelete(alloc);
+    }
+
+    // Keeps one empty heap per class around to avoid create/destroy churn
+    void ReleaseBlockIfEmpty(UINT pool, UINT sizeClass, UINT index)
+    {
+        std::vector<Block>& blocks = m_pools[pool].classes[sizeClass];
+        if (blocks[index].used != 0)
+            return;
+
+        UINT emptyBlocks = 0;
+        for (const Block& b : blocks)
+            if (b.heap && b.used == 0)
+                ++emptyBlocks;
+        if (emptyBlocks <= 1)
+            return;
+
+        m_reservedBytes -= blocks[index].heap->GetDesc().SizeInBytes;
+        --m_heapCount;
+        blocks[index] = Block();
+    }
+
+    static size_t CountLiveBlocks(const std::vector<Block>& blocks)
+    {
+        size_t n = 0;
+        for (const Block& b : blocks)
+            if (b.heap && b.used > 0)
+                ++n;
+        return n;
+    }
+
+    ID3D12Device*            m_device    = nullptr;
+    IDXGIAdapter3*           m_adapter   = nullptr;
+    UINT64                   m_blockSize = 0;
+    std::vector<UINT64>      m_classes;
+    Pool                     m_pools[kPoolCount];
+    std::vector<PendingMove> m_pendingMoves;
+    MoveCallback             m_onMoved;
+
+    UINT64                   m_reservedBytes   = 0;
+    UINT64                   m_allocatedBytes  = 0;
+    UINT                     m_heapCount       = 0;
+    UINT                     m_allocationCount = 0;
+    std::mutex               m_mutex;
+};
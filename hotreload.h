@@ -0,0 +1,303 @@
+// ---------------------------------------------------------------
+// Hot reload – edited shaders recompiled in the background, PSOs swapped between frames
+// ---------------------------------------------------------------
+// A watcher thread polls the shader directory's write times. When a file
+// changes, every shader built from it (all of them, for an .hlsli) that a
+// tracked pipeline uses is recompiled through ShaderLibrary::Reload(), and
+// every pipeline using one is rebuilt through PsoCache::Rebuild() – DXC and
+// the driver compile both on the watcher thread, the frame never waits.
+//
+// Apply() then swaps the finished PSOs into their ComPtrs on the render
+// thread, before anything is recorded, so a frame never mixes old and new.
+// The replaced PSOs are kept until the fence says the GPU is done with them,
+// and only then evicted from the PSO cache (on the watcher thread again).
+// A shader that doesn't compile leaves its pipelines as they were; the error
+// is kept for the overlay.
+//
+//   reload.Track(&g_cullPso, { "cull_cs@bindless" });     // stages in PsoCache::Rebuild() order
+//   reload.Start(&shaders, &psos, "shaders");
+//   reload.Apply(fenceValue, completedValue);              // once a frame, render thread
+//
+// Only shaders – the rest of a PSO's state, and new manifest entries, still need a restart.
+#pragma once
+
+#include "dxhelpers.h"
+#include "psocache.h"
+#include "shaderlibrary.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class HotReload
+{
+public:
+    static constexpr std::chrono::milliseconds kPollInterval{ 250 };
+    static constexpr std::chrono::milliseconds kSettleTime{ 100 };  // editors save in more than one write
+
+    struct Stats
+    {
+        UINT        reloads  = 0;       // pipelines swapped in
+        UINT        failures = 0;       // shaders or pipelines that didn't build
+        UINT        pending  = 0;       // built, waiting for the next Apply()
+        bool        failed   = false;   // the last change didn't fully build
+        char        error[96] = {};     // and why – the first line of DXC's output, say; fixed so
+                                        // the overlay's copy every frame stays off the heap
+    };
+
+    // Before Start(), from any thread – init tasks build their PSOs in parallel; `target` must outlive this
+    void Track(ComPtr<ID3D12PipelineState>* target, std::initializer_list<const char*> shaders)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Pipeline& pipeline = m_pipelines.emplace_back();
+        pipeline.target  = target;
+        pipeline.current = target->Get();
+        size_t stage = 0;
+        for (const char* name : shaders)
+            if (stage < 5)
+                pipeline.shaders[stage++] = name ? name : "";
+    }
+
+    void Start(ShaderLibrary* shaders, PsoCache* psos, const char* shaderDir)
+    {
+        m_shaders = shaders;
+        m_psos    = psos;
+        m_dir     = shaderDir;
+        Scan();             // what's there now is what was built
+        m_running = true;
+        m_thread  = std::thread([this] { WatcherMain(); });
+    }
+
+    // After the GPU is idle – drops the retired PSOs too
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+        m_swaps.clear();
+        m_retired.clear();
+        m_evict.clear();
+    }
+
+    bool Running() const { return m_thread.joinable(); }
+
+    // Render thread, before recording: `fenceValue` is the one this frame signals
+    void Apply(UINT64 fenceValue, UINT64 completedValue)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Swap& swap : m_swaps)
+        {
+            ComPtr<ID3D12PipelineState>& target = *m_pipelines[swap.pipeline].target;
+            m_retired.push_back({ target, fenceValue });
+            target = std::move(swap.pso);
+            ++m_stats.reloads;
+        }
+        m_swaps.clear();
+
+        size_t kept = 0;
+        for (Retired& retired : m_retired)
+        {
+            if (retired.fence <= completedValue)
+                m_evict.push_back(retired.pso.Get());   // the cache still holds a reference until then
+            else
+                m_retired[kept++] = std::move(retired);
+        }
+        m_retired.resize(kept);
+        if (!m_evict.empty())
+            m_wake.notify_all();
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats   = m_stats;
+        stats.pending = (UINT)m_swaps.size();
+        return stats;
+    }
+
+private:
+    struct Pipeline
+    {
+        ComPtr<ID3D12PipelineState>* target = nullptr;       // render thread's, only Apply() writes it
+        ID3D12PipelineState*         current = nullptr;      // watcher thread's – the newest build
+        std::string                  shaders[5];             // "" for stages it doesn't have
+    };
+
+    struct Swap
+    {
+        size_t                      pipeline;
+        ComPtr<ID3D12PipelineState> pso;
+    };
+
+    struct Retired
+    {
+        ComPtr<ID3D12PipelineState> pso;
+        UINT64                      fence;
+    };
+
+    void WatcherMain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_running)
+        {
+            m_wake.wait_for(lock, kPollInterval, [this] { return !m_running || !m_evict.empty(); });
+            if (!m_running)
+                return;
+            std::vector<ID3D12PipelineState*> evict;
+            evict.swap(m_evict);
+            lock.unlock();
+
+            Evict(evict);
+            std::vector<std::filesystem::path> changed = Scan();
+            if (!changed.empty())
+            {
+                std::this_thread::sleep_for(kSettleTime);
+                for (std::filesystem::path& file : Scan())
+                    changed.push_back(std::move(file));
+                Reload(changed);
+            }
+            lock.lock();
+        }
+    }
+
+    // Files whose write time moved since the last scan
+    std::vector<std::filesystem::path> Scan()
+    {
+        std::vector<std::filesystem::path> changed;
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator(m_dir, ec))
+        {
+            const std::filesystem::path& path = file.path();
+            if (path.extension() != ".hlsl" && path.extension() != ".hlsli")
+                continue;
+            const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                continue;       // mid-save
+            auto it = m_times.find(path.string());
+            if (it == m_times.end())
+                m_times.emplace(path.string(), time);
+            else if (it->second != time)
+            {
+                it->second = time;
+                changed.push_back(path);
+            }
+        }
+        return changed;
+    }
+
+    void Reload(const std::vector<std::filesystem::path>& files)
+    {
+        std::unordered_set<std::string> affected;
+        for (const std::filesystem::path& file : files)
+            for (std::string& name : m_shaders->ShadersFrom(file))
+                affected.insert(std::move(name));
+
+        // Each shader once, however many pipelines share it
+        std::unordered_map<std::string, D3D12_SHADER_BYTECODE> built;
+        std::unordered_set<std::string>                        broken;
+        std::string                                            error;
+        for (const Pipeline& pipeline : m_pipelines)
+            for (const std::string& name : pipeline.shaders)
+            {
+                if (name.empty() || !affected.count(name) || built.count(name) || broken.count(name))
+                    continue;
+                try
+                {
+                    built[name] = m_shaders->Reload(name);
+                }
+                catch (const std::exception& e)
+                {
+                    broken.insert(name);
+                    error = e.what();
+                }
+            }
+
+        std::vector<Swap> swaps;
+        for (size_t i = 0; i < m_pipelines.size(); ++i)
+        {
+            Pipeline&             pipeline = m_pipelines[i];
+            D3D12_SHADER_BYTECODE stages[5]{};
+            bool                  touched = false, skip = false;
+            for (int stage = 0; stage < 5; ++stage)
+            {
+                const std::string& name = pipeline.shaders[stage];
+                skip |= broken.count(name) != 0;
+                auto it = built.find(name);
+                if (it != built.end())
+                {
+                    stages[stage] = it->second;
+                    touched       = true;
+                }
+            }
+            if (!touched || skip)
+                continue;
+
+            try
+            {
+                ID3D12PipelineState* next = m_psos->Rebuild(pipeline.current, stages);
+                if (next == pipeline.current)
+                    continue;       // same bytecode – saved without a change
+                pipeline.current = next;
+                swaps.push_back({ i, next });
+            }
+            catch (const std::exception& e)
+            {
+                broken.insert(pipeline.shaders[0]);
+                error = e.what();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Swap& swap : swaps)
+            m_swaps.push_back(std::move(swap));
+        m_stats.failures += (UINT)broken.size();
+        if (!affected.empty())
+        {
+            m_stats.failed = !broken.empty();
+            const size_t length = (std::min)(error.find('\n'), sizeof(m_stats.error) - 1);
+            memcpy(m_stats.error, error.data(), (std::min)(length, error.size()));
+            m_stats.error[(std::min)(length, error.size())] = '\0';
+        }
+        if (!error.empty())
+            OutputDebugStringA(("Hot reload: " + error + "\n").c_str());
+    }
+
+    // The GPU is done with these; drop the cache's copy unless a pipeline went back to it
+    void Evict(const std::vector<ID3D12PipelineState*>& psos)
+    {
+        for (ID3D12PipelineState* pso : psos)
+        {
+            bool inUse = false;
+            for (const Pipeline& pipeline : m_pipelines)
+                inUse |= pipeline.current == pso;
+            if (!inUse)
+                m_psos->Evict(pso);
+        }
+    }
+
+    ShaderLibrary*                         m_shaders = nullptr;
+    PsoCache*                              m_psos    = nullptr;
+    std::filesystem::path                  m_dir;
+    std::vector<Pipeline>                  m_pipelines;          // fixed once Start() runs, Track() locks m_mutex until then
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_times;   // watcher thread only
+
+    std::thread                            m_thread;
+    std::mutex                             m_mutex;              // everything below
+    std::condition_variable                m_wake;
+    bool                                   m_running = false;
+    std::vector<Swap>                      m_swaps;              // built, not applied yet
+    std::vector<Retired>                   m_retired;            // applied, GPU may still use the old one
+    std::vector<ID3D12PipelineState*>      m_evict;              // GPU is done, for the watcher to evict
+    Stats                                  m_stats;
+};
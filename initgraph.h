@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------
+// Init graph – startup as a dependency graph of tasks on the job system
+// ---------------------------------------------------------------
+// Each task names the tasks it needs; Start() queues every task that needs
+// nothing, and whichever job finishes a task's last input queues that task
+// next – no thread waits on another, the caller doesn't wait at all. The
+// caller polls Done() meanwhile (and draws a loading screen, pumps messages
+// – see main.cpp), then Finish() rethrows the first task's exception.
+//
+//   InitGraph init;
+//   InitGraph::TaskId shaders = init.Add("Shaders", [] { ... });
+//   InitGraph::TaskId psos    = init.Add("PSOs", [] { ... }, { shaders, rootSig });
+//   init.Start(&jobs);                     // or RunSerial(), for A/B timing
+//   while (!init.Done()) { ... }
+//   init.Finish();
+//
+// Tasks can only need tasks added before them, so Add() order is always a
+// valid serial order. Once one throws, the ones that haven't started are
+// skipped – startup is over anyway. Plain std + the job system only.
+#pragma once
+
+#include "jobsystem.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+class InitGraph
+{
+public:
+    using Task   = std::function<void()>;
+    using TaskId = uint32_t;
+
+    struct TaskStats
+    {
+        const char* name;
+        double      startMs;    // since Start()
+        double      ms;
+    };
+
+    TaskId Add(const char* name, Task task, std::initializer_list<TaskId> after = {})
+    {
+        const TaskId id = (TaskId)m_nodes.size();
+        std::unique_ptr<Node> node = std::make_unique<Node>();
+        node->name = name;
+        node->task = std::move(task);
+        for (TaskId input : after)
+        {
+            if (input >= id)
+                throw std::runtime_error("Init task needs one that isn't added yet");
+            m_nodes[input]->dependents.push_back(id);
+            ++node->inputs;
+        }
+        m_nodes.push_back(std::move(node));
+        return id;
+    }
+
+    // Not again until Finish()
+    void Start(JobSystem* jobs)
+    {
+        m_jobs  = jobs;
+        m_start = std::chrono::steady_clock::now();
+        m_remaining.store((uint32_t)m_nodes.size(), std::memory_order_release);
+        for (std::unique_ptr<Node>& node : m_nodes)
+            node->waiting.store(node->inputs, std::memory_order_relaxed);
+        for (TaskId id = 0; id < (TaskId)m_nodes.size(); ++id)
+            if (!m_nodes[id]->inputs)
+                Launch(id);
+    }
+
+    // Everything on the calling thread, in Add() order – what init was before the graph
+    void RunSerial()
+    {
+        m_jobs  = nullptr;
+        m_start = std::chrono::steady_clock::now();
+        m_remaining.store((uint32_t)m_nodes.size(), std::memory_order_release);
+        for (TaskId id = 0; id < (TaskId)m_nodes.size(); ++id)
+            Execute(id);
+    }
+
+    bool Done() const { return m_remaining.load(std::memory_order_acquire) == 0; }
+
+    // Tasks finished over tasks added – what the loading bar shows
+    float Progress() const
+    {
+        if (m_nodes.empty())
+            return 1.0f;
+        return 1.0f - (float)m_remaining.load(std::memory_order_relaxed) / (float)m_nodes.size();
+    }
+
+    // After Done(): rethrows the first task's exception, or hands over the timings
+    const std::vector<TaskStats>& Finish()
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+        m_stats.clear();
+        for (const std::unique_ptr<Node>& node : m_nodes)
+            m_stats.push_back({ node->name, node->startMs, node->ms });
+        return m_stats;
+    }
+
+private:
+    struct Node
+    {
+        const char*           name = nullptr;
+        Task                  task;
+        std::vector<TaskId>   dependents;
+        uint32_t              inputs = 0;
+        std::atomic<uint32_t> waiting{ 0 };     // inputs not done yet this run
+        double                startMs = 0.0;
+        double                ms      = 0.0;
+    };
+
+    void Launch(TaskId id)
+    {
+        m_jobs->Run([this, id] { Execute(id); });
+    }
+
+    // Never throws – a job without a counter that throws takes its worker down
+    void Execute(TaskId id)
+    {
+        Node& node = *m_nodes[id];
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        if (!m_failed.load(std::memory_order_acquire))
+        {
+            try
+            {
+                node.task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_errorMutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+                m_failed.store(true, std::memory_order_release);
+            }
+        }
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        node.startMs = std::chrono::duration<double, std::milli>(begin - m_start).count();
+        node.ms      = std::chrono::duration<double, std::milli>(end - begin).count();
+        node.task    = nullptr;     // captures go now, not at shutdown
+
+        if (m_jobs)
+            for (TaskId next : node.dependents)
+                if (m_nodes[next]->waiting.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    Launch(next);
+        m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    std::vector<std::unique_ptr<Node>>    m_nodes;
+    std::vector<TaskStats>                m_stats;
+    JobSystem*                            m_jobs = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+    std::atomic<uint32_t>                 m_remaining{ 0 };
+    std::atomic<bool>                     m_failed{ false };
+    std::mutex                            m_errorMutex;
+    std::exception_ptr                    m_error;
+};
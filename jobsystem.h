@@ -0,0 +1,255 @@
+// ---------------------------------------------------------------
+// Job system – work-stealing worker pool
+// ---------------------------------------------------------------
+// One queue per thread. Owners push/pop at the back (LIFO, hot caches),
+// idle threads steal from the front of somebody else's queue.
+// Thread 0 is whoever called Init() (the WinMain thread); it does not
+// sleep in the pool but helps out whenever it calls Wait(). Init() can
+// reserve more such host threads (simulation, rendering) – each one calls
+// AttachThread() with its index so it gets its own queue and trace row.
+//
+// Queues are fixed rings, sized at Init(), so queuing a job doesn't allocate;
+// a job pushed onto a full ring just runs right there. Keep captures small
+// enough for std::function's inline buffer for the same reason.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    static const uint32_t kQueueCapacity = 1024;    // jobs per thread's ring
+
+    // Tracks a group of jobs. Wait() on it to join them; the first
+    // exception thrown by any of them is rethrown from Wait().
+    struct Counter
+    {
+        std::atomic<int>   pending{ 0 };
+        std::mutex         errorMutex;
+        std::exception_ptr error;
+        std::function<void(uint32_t, uint32_t)> range;      // ParallelFor()'s body, shared by its jobs
+    };
+
+    JobSystem() = default;
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    ~JobSystem() { Shutdown(); }
+
+    // workerCount == 0 -> one worker per core, minus the calling thread.
+    // Indices 0..hostThreads-1 are for threads outside the pool.
+    void Init(unsigned workerCount = 0, unsigned hostThreads = 1)
+    {
+        if (workerCount == 0)
+        {
+            unsigned cores = std::thread::hardware_concurrency();
+            workerCount = cores > 1 ? cores - 1 : 1;
+        }
+
+        m_running = true;
+        m_queues.clear();
+        if (hostThreads == 0)
+            hostThreads = 1;
+        for (unsigned i = 0; i < workerCount + hostThreads; ++i)
+            m_queues.push_back(std::make_unique<Queue>());
+
+        t_threadIndex = 0;
+        for (unsigned i = hostThreads; i < workerCount + hostThreads; ++i)
+            m_workers.emplace_back([this, i] { WorkerMain(i); });
+    }
+
+    // Called once on a host thread, before it submits or waits on anything
+    void AttachThread(unsigned hostIndex) { t_threadIndex = hostIndex; }
+
+    void Shutdown()
+    {
+        if (!m_running)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_running = false;
+        }
+        m_wakeCv.notify_all();
+        for (std::thread& t : m_workers)
+            t.join();
+        m_workers.clear();
+        m_queues.clear();
+    }
+
+    // Total threads that execute jobs, including the host threads
+    unsigned ThreadCount() const { return (unsigned)m_queues.size(); }
+
+    // 0 for the main thread (and any foreign thread), then host threads, then workers
+    static unsigned ThreadIndex() { return t_threadIndex; }
+
+    void Run(Job job, Counter* counter = nullptr)
+    {
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+        Queue& q = *m_queues[ThreadIndex()];
+        {
+            std::unique_lock<std::mutex> lock(q.mutex);
+            if (q.count == kQueueCapacity)
+            {
+                lock.unlock();
+                Entry entry{ std::move(job), counter };
+                Execute(entry);
+                return;
+            }
+            q.jobs[(q.head + q.count++) % kQueueCapacity] = { std::move(job), counter };
+        }
+        m_queued.fetch_add(1, std::memory_order_release);
+
+        // Taking the lock closes the gap between a worker's predicate check and its sleep
+        { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+        m_wakeCv.notify_one();
+    }
+
+    // Splits [0, count) into batches of batchSize and runs fn(begin, end) on each.
+    // fn is copied once into the counter, so the counter can't have other jobs pending.
+    void ParallelFor(uint32_t count, uint32_t batchSize,
+                     const std::function<void(uint32_t, uint32_t)>& fn, Counter& counter)
+    {
+        if (counter.pending.load(std::memory_order_acquire) != 0)
+            throw std::runtime_error("ParallelFor needs a counter with nothing pending");
+        if (batchSize == 0)
+            batchSize = 1;
+        counter.range = fn;
+        for (uint32_t begin = 0; begin < count; begin += batchSize)
+        {
+            uint32_t end = begin + batchSize < count ? begin + batchSize : count;
+            Run([&counter, begin, end] { counter.range(begin, end); }, &counter);
+        }
+    }
+
+    // Blocks until the counter hits zero, executing queued jobs meanwhile
+    void Wait(Counter& counter)
+    {
+        while (counter.pending.load(std::memory_order_acquire) > 0)
+        {
+            Entry entry;
+            if (TryGetJob(ThreadIndex(), entry))
+                Execute(entry);
+            else
+                std::this_thread::yield();
+        }
+
+        if (counter.error)
+        {
+            std::exception_ptr error = counter.error;
+            counter.error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Job      job;
+        Counter* counter = nullptr;
+    };
+
+    struct Queue
+    {
+        std::mutex         mutex;
+        std::vector<Entry> jobs = std::vector<Entry>(kQueueCapacity);    // ring
+        uint32_t           head  = 0;                                    // oldest
+        uint32_t           count = 0;
+    };
+
+    bool TryGetJob(unsigned self, Entry& out)
+    {
+        // Own queue first, newest job
+        {
+            Queue& q = *m_queues[self];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.count)
+            {
+                Entry& entry = q.jobs[(q.head + --q.count) % kQueueCapacity];
+                out   = std::move(entry);
+                entry = Entry();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Steal the oldest job from someone else
+        const unsigned n = (unsigned)m_queues.size();
+        for (unsigned i = 1; i < n; ++i)
+        {
+            Queue& q = *m_queues[(self + i) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.count)
+            {
+                Entry& entry = q.jobs[q.head];
+                out    = std::move(entry);
+                entry  = Entry();
+                q.head = (q.head + 1) % kQueueCapacity;
+                --q.count;
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void Execute(Entry& entry)
+    {
+        try
+        {
+            entry.job();
+        }
+        catch (...)
+        {
+            if (!entry.counter)
+                throw;
+            std::lock_guard<std::mutex> lock(entry.counter->errorMutex);
+            if (!entry.counter->error)
+                entry.counter->error = std::current_exception();
+        }
+
+        if (entry.counter)
+            entry.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    void WorkerMain(unsigned index)
+    {
+        t_threadIndex = index;
+        while (true)
+        {
+            Entry entry;
+            if (TryGetJob(index, entry))
+            {
+                Execute(entry);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCv.wait(lock, [this] {
+                return !m_running || m_queued.load(std::memory_order_acquire) > 0;
+            });
+            if (!m_running)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_workers;
+    std::atomic<int>                    m_queued{ 0 };
+    bool                                m_running = false;
+    std::mutex                          m_wakeMutex;
+    std::condition_variable             m_wakeCv;
+
+    static inline thread_local unsigned t_threadIndex = 0;
+};
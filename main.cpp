@@ -2,347 +2,3092 @@
 // Minimal DX12 Triangle – full source
 // ---------------------------------------------------------------
 #include <windows.h>
+#include <psapi.h>
 #include <wrl/client.h>
 #include <dxgi1_6.h>
 #include <d3d12.h>
+#include <DirectXMath.h>
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <string>
-#include <d3dcompiler.h>          // For D3DCompile()
-#pragma comment(lib,"d3dcompiler.lib")
+#include <thread>
+#include <vector>
 
-using Microsoft::WRL::ComPtr;
+#include "asynccompute.h"
+#include "assetstreamer.h"
+#include "benchmark.h"
+#include "descriptors.h"
+#include "devicecaps.h"
+#include "dynres.h"
+#include "drawbatch.h"
+#include "dxhelpers.h"
+#include "ecs.h"
+#include "framememory.h"
+#include "framequeue.h"
+#include "gpuallocator.h"
+#include "hotreload.h"
+#include "initgraph.h"
+#include "jobsystem.h"
+#include "meshcook.h"
+#include "ocean.h"
+#include "overlay.h"
+#include "physics.h"
+#include "profiler.h"
+#include "psocache.h"
+#include "rendergraph.h"
+#include "scenetextures.h"
+#include "shaderlibrary.h"
+#include "simdmath.h"
+#include "swapchain.h"
+#include "temporalupscale.h"
+#include "texturestreamer.h"
+#include "uploader.h"
+
+// ---------------------------------------------------------------
+// Heap – every operator new is counted, see framememory.h
+// ---------------------------------------------------------------
+void* operator new(size_t size)                                       { return CountedAlloc(size); }
+void* operator new[](size_t size)                                     { return CountedAlloc(size); }
+void* operator new(size_t size, std::align_val_t alignment)           { return CountedAlloc(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment)         { return CountedAlloc(size, (size_t)alignment); }
+void  operator delete(void* p) noexcept                               { CountedFree(p); }
+void  operator delete[](void* p) noexcept                             { CountedFree(p); }
+void  operator delete(void* p, size_t) noexcept                       { CountedFree(p); }
+void  operator delete[](void* p, size_t) noexcept                     { CountedFree(p); }
+void  operator delete(void* p, std::align_val_t) noexcept             { CountedFree(p, true); }
+void  operator delete[](void* p, std::align_val_t) noexcept           { CountedFree(p, true); }
+void  operator delete(void* p, size_t, std::align_val_t) noexcept     { CountedFree(p, true); }
+void  operator delete[](void* p, size_t, std::align_val_t) noexcept   { CountedFree(p, true); }
 
 // ---------------------------------------------------------------
 // Global DX12 objects
 // ---------------------------------------------------------------
+static ComPtr<IDXGIFactory6>         g_factory;
 static ComPtr<ID3D12Device>          g_device;
-static ComPtr<IDXGISwapChain3>       g_swapChain;
+static ComPtr<IDXGIAdapter3>         g_adapter;        // for video memory budget queries
+static UINT                          g_adapterIndex = 0;   // in high performance order, --adapter=N
+static DeviceCaps                    g_caps;           // probed once per adapter + driver, see devicecaps.h
+static bool                          g_capsCached   = false;
+static DeviceTier                    g_tier         = kTierHigh;   // picks the defaults, --tier= overrides
+static SwapChain                     g_swapChain;      // waitable, tearing aware – see swapchain.h
+static SwapChainSettings             g_swapSettings;   // --buffers= --max-latency= --no-vsync --fps-cap=
 static ComPtr<ID3D12CommandQueue>    g_commandQueue;
-static ComPtr<ID3D12CommandAllocator> g_commandAllocator;
-static ComPtr<ID3D12GraphicsCommandList> g_commandList;
+static AsyncCompute                  g_asyncCompute;   // compute queue the graph forks kPassAsyncCompute passes to
+static bool                          g_useAsyncCompute = true;   // --no-async-compute
+
+// Direct lists, handed out in order: the graph's stops (forks, joins, the
+// parallel scene) each end one. The last one also resolves the timestamps.
+static const UINT                    kMaxGraphicsLists = 8;
+static ComPtr<ID3D12GraphicsCommandList> g_graphicsLists[kMaxGraphicsLists];
+static Uploader                      g_uploader;       // copy queue + staging ring
+static GpuAllocator                  g_gpuAllocator;   // placed resources in shared heaps
+
+static ComPtr<ID3D12DescriptorHeap>  g_dsvHeap;
+
+// Shader-visible CBV/SRV/UAV heap: persistent free-list + per-frame transient ring
+static const UINT                   kPersistentDescriptors = 16384;
+static const UINT                   kTransientDescriptors  = 4096;   // per frame slot
+static DescriptorHeap               g_descriptors;
+static bool                         g_bindlessHeap = false;          // SM 6.6 ResourceDescriptorHeap
+
+// Sync objects
+static ComPtr<ID3D12Fence>           g_fence;
+static UINT64                       g_fenceValue = 0;
+static HANDLE                       g_fenceEvent = nullptr;
+
+// Render targets live in g_swapChain
+static UINT                         g_frameIndex = 0;      // current back buffer
+
+// ---------------------------------
+// Frames in flight
+// ---------------------------------
+// Every slot owns its own command allocator, fence value and upload memory,
+// so the CPU only blocks when it wraps around to a slot the GPU still uses.
+static const UINT   kMaxFramesInFlight = 3;
+static const UINT64 kFrameUploadSize   = 16 * 1024 * 1024; // per slot – instance data lives here
+static UINT         g_framesInFlight   = 2;                // 1..kMaxFramesInFlight
+
+// Parallel recording: a frame's draws are split into chunks, each recorded
+// into its own list on the job system, each list with its own allocator per slot
+static const UINT   kMaxRecordLists    = 16;
+static const UINT   kMinDrawsPerList   = 256;  // below this a thread costs more than it saves
+
+struct FrameContext
+{
+    ComPtr<ID3D12CommandAllocator> commandAllocator;
+    ComPtr<ID3D12CommandAllocator> recordAllocators[kMaxRecordLists];
+    UINT64                         fenceValue   = 0;       // 0 = never submitted
+
+    // Persistently mapped, bump allocated, rewound when the slot comes round again
+    GpuAllocation*                 uploadBuffer = nullptr;
+    UINT8*                         uploadCpu    = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS      uploadGpu    = 0;
+    UINT64                         uploadOffset = 0;
+
+    LinearArena                    arena;                  // CPU scratch, same lifetime
+};
+static FrameContext                 g_frames[kMaxFramesInFlight];
+static UINT                         g_frameSlot = 0;
+
+static JobSystem                    g_jobs;
+
+// Steady state the frame loop shouldn't allocate – HeapCounters says whether it does
+static const UINT                   kAllocWarmupFrames = 120;  // after startup, resize, streaming
+static bool                         g_allocCheck       = false; // --alloc-check: throw when a warm frame allocates
+static UINT                         g_warmFrames       = 0;
+static uint64_t                     g_frameAllocs      = 0;     // heap allocations, all threads, last frame
+static uint64_t                     g_allocMark        = 0;
+static UINT64                       g_uploadHighWater  = 0;     // most upload memory a frame has used
+static ComPtr<ID3D12GraphicsCommandList> g_recordLists[kMaxRecordLists];
+static UINT                         g_recordListCount = 0;
+
+// ---------------------------------
+// Root signature & PSO
+// ---------------------------------
+// One bindless root signature for everything – see shaders/bindless.hlsli
+enum RootParam : UINT
+{
+    kRootDrawConstants  = 0,   // b0, 16 dwords of indices/params per draw
+    kRootFrameConstants = 1,   // b1, root CBV with the per-frame constants
+    kRootBindlessTable  = 2,   // only without BINDLESS_HEAP: tables over the whole heap
+};
+static const UINT                    kDrawConstantCount = 16;
+static ComPtr<ID3D12RootSignature>   g_rootSig;
+static ComPtr<ID3D12PipelineState>   g_pipelineState;
+static ShaderLibrary                 g_shaders;        // shaders.pak + dev compile cache
+static PsoCache                      g_psoCache;       // dedup + on-disk pipeline library
+static HotReload                     g_hotReload;      // tracks every PSO below, watches shaders/ with --hot-reload
+static bool                          g_hotReloadEnabled = false;
+
+// ---------------------------------
+// Geometry buffer – every mesh is its vertices then its 16 bit indices, all in one buffer
+// ---------------------------------
+// Meshes stream in from assets.pak (tools/assetcook) and are drawn from the
+// first frame their data is on the GPU; until then they're skipped, never waited on.
+// Vertices are quantized (PackedVertex, meshcook.h); the mesh table holds what
+// the shaders dequantize positions with, and where each mesh's meshlets are.
+enum SceneMesh : uint32_t
+{
+    kMeshTriangle, kMeshQuad,       // the grid cycles through these
+    kMeshCube,                      // unit cube, physics boxes scale it to their size
+    kMeshSphere,                    // radius 0.5
+    kMeshGround,                    // unit quad in XZ
+    kMeshCount
+};
+static_assert(kMeshCount == sizeof(kSceneMeshNames) / sizeof(kSceneMeshNames[0]), "SceneMesh and kSceneMeshNames disagree");
+static GpuAllocation*                g_geometryBuffer = nullptr;
+static D3D12_VERTEX_BUFFER_VIEW     g_vbView;
+static D3D12_INDEX_BUFFER_VIEW      g_ibView;
+static UINT                         g_geometrySrv  = DescriptorHeap::kInvalid;     // raw, for the mesh shaders
+static GpuAllocation*                g_meshTable    = nullptr;
+static UINT                         g_meshTableSrv = DescriptorHeap::kInvalid;
+
+// Mesh table entry, mirrors MeshInfo in shaders/scene.hlsli
+struct MeshTableEntry
+{
+    float    positionOffset[3];
+    float    positionScale;
+    uint32_t meshletOffset;         // bytes, into g_meshletBuffer
+    uint32_t meshletCount;
+    uint32_t meshletVertexCount;
+    uint32_t firstVertex;
+};
+static_assert(sizeof(MeshTableEntry) == 32, "MeshTableEntry must match the HLSL layout");
+
+// Mesh shader path (FL 12_2 class hardware) – the cooked meshlets, culled per
+// instance in the AS, see shaders/meshlet.hlsl. Off: the input assembler path.
+static const UINT                   kMaxMeshInstances = 65535;    // DispatchMesh's per dimension limit
+static bool                         g_meshShaders      = false;   // supported, and not turned off
+static bool                         g_allowMeshShaders = true;    // --no-mesh-shaders
+static D3D_FEATURE_LEVEL            g_featureLevel     = D3D_FEATURE_LEVEL_11_0;   // highest the adapter has
+static ComPtr<ID3D12PipelineState>   g_meshletPso;
+static GpuAllocation*                g_meshletBuffer = nullptr;     // each mesh's "<mesh>/meshlets" blob
+static UINT                         g_meshletSrv    = DescriptorHeap::kInvalid;
+static std::vector<Mesh>            g_meshes;
+static AssetStreamer                g_assets;
+static std::vector<AssetStreamer::Handle> g_meshLoads;        // kInvalid when built in-process
+static std::vector<AssetStreamer::Handle> g_meshletLoads;     // kInvalid too without mesh shaders
+static std::vector<uint8_t>         g_meshResident;
+
+// ---------------------------------
+// Textures – BC7/BC5 mip chains from assets.pak, paged in on feedback (texturestreamer.h)
+// ---------------------------------
+// Only with the archive: without it (or without tiled resources) the scene
+// keeps its vertex colours. Streamed texture indices are SceneTexture values.
+enum SceneTexture : uint32_t
+{
+    kTexturePlanks,                 // the grid and the rain
+    kTextureOcean,                  // normals only, the ground
+    kTextureCount
+};
+static_assert(kTextureCount == sizeof(kSceneTextureNames) / sizeof(kSceneTextureNames[0]), "SceneTexture and kSceneTextureNames disagree");
+static TextureStreamer               g_textures;
+static UINT64                       g_textureBudgetMB  = 0;       // --texture-budget=MB, 0 = a quarter of the VRAM budget
+static GpuAllocation*                g_materialTable    = nullptr;
+static UINT                         g_materialTableSrv = DescriptorHeap::kInvalid;
+
+// Material table entry, mirrors MaterialInfo in shaders/triangle.hlsl
+struct MaterialEntry
+{
+    uint32_t albedo;                // SceneTexture, ~0 = none
+    uint32_t normal;
+    float    uvScale;               // repeats per metre
+    float    specular;
+    float    scroll[2];             // uv per second
+    float    pad[2];
+};
+static_assert(sizeof(MaterialEntry) == 32, "MaterialEntry must match the HLSL layout");
+static const uint32_t               kMaterialOcean  = 4;          // 0..3 are the grid's tints
+static const uint32_t               kMaterialCount  = 5;
+
+// ---------------------------------
+// Scene – objects are batched by mesh/material into instanced draws (drawbatch.h)
+// ---------------------------------
+// Mirrors FrameConstants in shaders/common.hlsli
+struct FrameConstants
+{
+    DirectX::XMFLOAT4X4 viewProj;
+    DirectX::XMFLOAT4X4 prevViewProj;
+    float               frustumPlanes[6][4];
+    float               cameraPos[3];
+    float               time;
+    float               hizSize[2];
+    UINT                hizMips;
+    UINT                hizValid;
+    UINT                materialTable;      // SRVs and a UAV, ~0 without textures
+    UINT                textureTable;
+    UINT                textureFeedback;
+    UINT                lightBuffer;        // this frame's LightData[], see "Clustered lighting"
+    DirectX::XMFLOAT4X4 view;
+    float               projParams[4];      // P00, P11, near, far
+    float               renderSize[2];
+    UINT                lightCount;
+    UINT                clusterBuffer;
+    float               sunIntensity;
+    float               ambient;
+    float               jitter[2];          // render pixels, 0 without TAA
+    DirectX::XMFLOAT4X4 unjitteredViewProj; // what motion vectors are measured with
+    DirectX::XMFLOAT4X4 prevUnjitteredViewProj;
+};
+static DrawBatcher                  g_batcher;
+static UINT                         g_sceneInstances = 4096;   // --instances=N
+static const float                  kSceneSpacing    = 1.25f;  // grid step
+static int64_t                      g_startTime      = 0;      // QPC ticks, the sim clock's zero
+
+// ---------------------------------
+// Simulation – entities in g_world (ecs.h), systems run over the job system
+// ---------------------------------
+// Transform comes from simdmath.h
+struct Spin         { float rate; };                // radians per second around Y
+struct LocalToWorld { Float3x4 matrix; };           // same layout as InstanceData::world
+struct RenderMesh   { uint32_t mesh; uint32_t material; };
+struct Tint         { float color[4]; };
+struct RigidBody    { PhysicsWorld::BodyId body; };  // Transform follows the body, interpolated
+struct PointLight   { float color[3]; float radius; };  // at the Transform's position
+struct Flicker      { float rate; float phase; float base; float sharpness; };  // see LightIntensity()
+struct Buoyant      { float radius; };                  // floats on g_ocean, see ApplyBuoyancy()
+
+static World                        g_world;
+static float                        g_simTime = 0.0f;      // seconds, as of the last SimulateFrame
+
+// Bodies rain down on the grid, which collides as static spheres
+static PhysicsWorld                 g_physics;
+static UINT                         g_physicsBodies = 1024;     // --bodies=N
+static const float                  kGroundHeight   = -0.5f;    // just under the grid
+
+// ---------------------------------
+// Clustered lighting – point lights binned into a froxel grid on the GPU every
+// frame (shaders/lightbin.hlsl), the scene PS only walks its own cluster's list
+// ---------------------------------
+// Light buffer entry, mirrors Light in shaders/lighting.hlsli – colour has the flicker folded in
+struct LightData
+{
+    float position[3];
+    float radius;
+    float color[3];
+    float pad;
+};
+static_assert(sizeof(LightData) == 32, "LightData must match the HLSL layout");
+
+// Mirror shaders/lighting.hlsli
+static const UINT                   kClustersX        = 16;
+static const UINT                   kClustersY        = 9;
+static const UINT                   kClustersZ        = 24;
+static const UINT                   kClusterCount     = kClustersX * kClustersY * kClustersZ;
+static const UINT                   kMaxClusterLights = 128;
+
+static UINT                         g_lightCount       = 256;      // --lights=N
+static bool                         g_night            = false;    // --night – sun and sky nearly off, the lights carry it
+static ComPtr<ID3D12PipelineState>  g_lightBinPso;
+static GpuAllocation*               g_lightClusters    = nullptr;  // counts, then kMaxClusterLights indices per cluster
+static UINT                         g_lightClustersSrv = DescriptorHeap::kInvalid;
+static UINT                         g_lightClustersUav = DescriptorHeap::kInvalid;
+
+// Lanterns glow between base and 1; flashes (base 0, sharp) are dark most of the time and spike
+float LightIntensity(const Flicker& flicker, float time)
+{
+    const float wave = 0.5f + 0.5f * sinf(time * flicker.rate + flicker.phase);
+    return flicker.base + (1.0f - flicker.base) * powf(wave, flicker.sharpness);
+}
+
+// ---------------------------------
+// Ocean – FFT waves and clipmap tiles on the GPU (ocean.h); the rain floats on its readback
+// ---------------------------------
+static Ocean                        g_ocean;
+static bool                         g_oceanEnabled = true;     // --no-ocean: the flat textured ground instead
+static bool                         g_oceanAsync   = true;     // --no-async-ocean keeps the waves on the direct queue
+static const float                  kSeaFloor      = -12.0f;   // the physics ground under the sea
+static const float                  kBuoyancy      = 2.2f;     // upward g fully under – floats a bit under half sunk
+static const float                  kWaterDrag     = 1.5f;     // per second, fully under
+static ComPtr<ID3D12PipelineState>  g_oceanSpectrumPso;
+static ComPtr<ID3D12PipelineState>  g_oceanFftPso;
+static ComPtr<ID3D12PipelineState>  g_oceanFinalizePso;
+static ComPtr<ID3D12PipelineState>  g_oceanQueryPso;
+static ComPtr<ID3D12PipelineState>  g_oceanTilesPso;
+static ComPtr<ID3D12PipelineState>  g_oceanPso;
+static ComPtr<ID3D12CommandSignature> g_oceanSignature;       // just the draw – TilesCS writes its arguments
+static UINT                         g_oceanQuerySrv   = DescriptorHeap::kInvalid;     // this frame's points
+static UINT                         g_oceanQueryCount = 0;
+static std::vector<uint32_t>        g_buoyancyIds;              // sim thread scratch, keeps its capacity
+static std::vector<float>           g_buoyancyHeights;
+
+// ---------------------------------
+// Threads – the WinMain thread only pumps messages; simulation and rendering
+// run on their own and meet in g_packets (framequeue.h)
+// ---------------------------------
+enum HostThread : unsigned
+{
+    kThreadOs     = 0,      // window, input – also whoever ran init
+    kThreadSim    = 1,
+    kThreadRender = 2,
+    kHostThreads  = 3,
+};
+
+// Everything the renderer needs from a simulated frame, copied out of the
+// world – the sim thread is already changing it while the packet is drawn.
+// Renderables are SoA in entity order, batching refs index them.
+struct FramePacket
+{
+    float                       time = 0.0f;        // seconds on the sim clock
+    float                       eye[3]{};
+    float                       target[3]{};
+    std::vector<RenderMesh>     meshes;
+    std::vector<LocalToWorld>   worlds;
+    std::vector<Tint>           tints;
+    std::vector<float>          scales;
+    std::vector<LightData>      lights;
+    std::vector<OceanQuery>     oceanQueries;       // where the floating bodies are, for next frames' buoyancy
+    PhysicsWorld::Stats         physics{};
+    double                      simMs       = 0.0;  // SimulateFrame()'s CPU time
+    int64_t                     inputTime   = 0;    // QPC stamp of the newest input it saw, 0 = none
+    bool                        showOverlay = true;
+    bool                        exportTrace = false;
+};
+static FramePacketQueue<FramePacket> g_packets;
+static InputQueue                   g_input;            // WindowProc -> SimulateFrame
+static bool                         g_simOverlay = true;   // F1 – sim side, reaches g_showOverlay via the packet
+static HWND                         g_hwnd = nullptr;
+static const UINT                   kMsgThreadsStopped = WM_APP + 1;   // last host thread out posts it
+static std::atomic<bool>            g_quit{ false };        // WM_CLOSE – threads wind down, then the window goes
+static std::atomic<int>             g_threadsRunning{ 0 };
+static std::mutex                   g_threadErrorMutex;
+static std::exception_ptr           g_threadError;          // first one either thread threw, rethrown by WinMain
+
+static const uint32_t               kCullBlock = 1024;     // CPU path culls this many boxes at a time
+
+// Set up by PrepareFrame(), valid for the current frame only
+static D3D12_GPU_VIRTUAL_ADDRESS    g_frameConstants = 0;
+static UINT                         g_instanceSrv    = 0;
+static UINT                         g_prevWorldSrv   = DescriptorHeap::kInvalid;  // last frame's worlds, same order
+
+// ---------------------------------
+// Indirect draws – GPU culling writes the argument buffer, one ExecuteIndirect per frame
+// ---------------------------------
+static const UINT                   kMaxBatches = 4096;
+
+// Batch table entry, mirrors shaders/cull.hlsl
+struct GpuBatch
+{
+    UINT  indexCount;
+    UINT  firstIndex;
+    UINT  firstInstance;
+    UINT  instanceCount;
+    UINT  material;
+    UINT  baseVertex;
+    UINT  mesh;
+    UINT  meshletGroups;        // amplification groups per instance
+    float boundsCenter[3];      // mesh space
+    float boundsRadius;
+};
+
+// One argument record – layout has to match g_drawSignature
+struct IndirectCommand
+{
+    UINT                 firstInstance;     // -> draw constant 1
+    UINT                 material;          // -> draw constant 2
+    UINT                 mesh;              // -> draw constant 3
+    D3D12_DRAW_INDEXED_ARGUMENTS draw;
+};
+static_assert(sizeof(IndirectCommand) == 32, "IndirectCommand must match ArgsCS in shaders/cull.hlsl");
+
+// Same, for the mesh shader path – layout has to match g_meshSignature
+struct MeshCommand
+{
+    UINT                          firstInstance;
+    UINT                          material;
+    UINT                          mesh;
+    D3D12_DISPATCH_MESH_ARGUMENTS dispatch;
+};
+static_assert(sizeof(MeshCommand) == 24, "MeshCommand must match ArgsCS in shaders/cull.hlsl");
+
+// Amplification groups per instance – each tests kMeshletsPerGroup meshlets, see shaders/meshlet.hlsl
+static const UINT                   kMeshletsPerGroup = 32;
+inline UINT MeshletGroups(const Mesh& mesh) { return (mesh.meshletCount + kMeshletsPerGroup - 1) / kMeshletsPerGroup; }
+
+static bool                          g_useIndirect = true;              // --no-indirect for the CPU path
+static ComPtr<ID3D12CommandSignature> g_drawSignature;
+static ComPtr<ID3D12CommandSignature> g_meshSignature;
+static GpuAllocation*                g_indirectArgs    = nullptr;       // kMaxBatches Indirect- or MeshCommands
+static UINT                          g_indirectArgsUav = DescriptorHeap::kInvalid;
+
+// Culling – frustum + last frame's HiZ, see shaders/cull.hlsl
+enum CullFlags : UINT
+{
+    kCullFrustum   = 1,
+    kCullOcclusion = 2,
+    kCullMeshArgs  = 4,     // not a user flag – ArgsCS writes MeshCommands
+};
+static UINT                          g_cullFlags = kCullFrustum | kCullOcclusion;   // --no-cull, --no-occlusion
+static ComPtr<ID3D12PipelineState>   g_cullClearPso;
+static ComPtr<ID3D12PipelineState>   g_cullPso;
+static ComPtr<ID3D12PipelineState>   g_cullArgsPso;
+static GpuAllocation*                g_visibleInstances = nullptr;      // visible instance indices, in batch ranges
+static UINT                          g_visibleSrv       = DescriptorHeap::kInvalid;
+static UINT                          g_visibleUav       = DescriptorHeap::kInvalid;
+static GpuAllocation*                g_cullCounters     = nullptr;      // [0] draw count, [1 + b] per batch
+static UINT                          g_cullCountersUav  = DescriptorHeap::kInvalid;
+
+// HiZ pyramid (max depth per texel) built from the depth buffer after the scene is drawn
+static const UINT                    kMaxHiZMips = 16;
+static ComPtr<ID3D12PipelineState>   g_hizPso;
+static GpuAllocation*                g_hiz         = nullptr;
+static UINT                          g_hizWidth    = 0;                 // area the last build covered
+static UINT                          g_hizHeight   = 0;
+static UINT                          g_hizMips     = 0;
+static UINT                          g_hizSrv      = DescriptorHeap::kInvalid;
+static UINT                          g_hizUavs[kMaxHiZMips];
+static bool                          g_hizValid    = false;             // built last frame with g_prevViewProj
+static DirectX::XMFLOAT4X4           g_prevViewProj;
+
+// ---------------------------------
+// Render graph – scene colour and depth are transients of it (rendergraph.h)
+// ---------------------------------
+static RenderGraph                   g_renderGraph;
+static ComPtr<ID3D12DescriptorHeap>  g_sceneRtvHeap;                    // views rewritten every frame
+static UINT                          g_sceneColorSrv = DescriptorHeap::kInvalid;  // this frame's, transient
+static UINT                          g_sceneDepthSrv = DescriptorHeap::kInvalid;
+static ComPtr<ID3D12PipelineState>   g_upscalePso;
+
+// ---------------------------------
+// Temporal upscaling – jittered scene + motion vectors, resolved at full size (temporalupscale.h)
+// ---------------------------------
+static bool                          g_taa           = true;            // --no-taa: bilinear upscale, no AA
+static std::string                   g_upscalerName  = "taa";           // --upscaler=name, a registered plugin
+static std::unique_ptr<TemporalUpscaler> g_upscaler;                    // null with --no-taa
+static ComPtr<ID3D12PipelineState>   g_taaPso;                          // the built-in one's
+static UINT                          g_taaFrame      = 0;               // position in the jitter sequence
+static TemporalInputs                g_temporalInputs{};                // PrepareFrame's half, the pass fills the rest
+static bool                          g_taaReset      = true;            // first frame, resizes
+static DirectX::XMFLOAT4X4           g_prevUnjitteredViewProj;
+static std::vector<LocalToWorld>     g_prevWorlds;                      // last drawn packet's, entity order
+static UINT                          g_sceneMotionSrv = DescriptorHeap::kInvalid;  // this frame's, transient
+
+// ---------------------------------
+// Startup – InitD3D12 does what a loading frame needs, the rest runs as an InitGraph (initgraph.h)
+// ---------------------------------
+// Milliseconds since WinMain's first line, for the overlay and the benchmark JSON
+struct StartupTimes
+{
+    double loadingFrame = 0.0;      // first loading frame presented
+    double init         = 0.0;      // init graph done, uploads queued
+    double firstFrame   = 0.0;      // first scene frame presented – render thread's
+};
+static int64_t                       g_launchTime   = 0;                // QPC ticks
+static StartupTimes                  g_startup;
+static bool                          g_serialInit   = false;            // --serial-init: the graph in order, one thread
+static const float                   kLoadingColor[] = { 0.05f, 0.06f, 0.08f, 1.0f };
+
+// ---------------------------------
+// Resolution – the scene renders into its own targets at a (dynamic) scale,
+// then gets upscaled to the back buffer; see dynres.h
+// ---------------------------------
+static const UINT                    kDefaultWidth  = 800;              // client area at startup, --size=WxH
+static const UINT                    kDefaultHeight = 600;
+static const float                   kClearColor[]  = { 0.2f, 0.4f, 0.6f, 1.0f };
+static UINT                          g_targetWidth  = 0;                // scene targets, = back buffer size
+static UINT                          g_targetHeight = 0;
+static UINT                          g_renderWidth  = 0;                // this frame's viewport inside them
+static UINT                          g_renderHeight = 0;
+static float                         g_renderScale  = 1.0f;             // --render-scale=S
+static bool                          g_dynamicRes   = false;            // --dynamic-res[=targetMs]
+static DynamicResolution             g_dynRes;
+static std::atomic<uint32_t>         g_pendingSize{ 0 };                // WM_SIZE, width << 16 | height, applied between frames
+static std::atomic<bool>             g_minimized{ false };
+
+// ---------------------------------
+// Profiling – CPU/GPU scopes (profiler.h), stats overlay (overlay.h)
+// ---------------------------------
+static Profiler                      g_profiler;        // F9 writes profile.json
+static DebugOverlay                  g_overlay;
+static bool                          g_showOverlay = true;  // this frame's F1 state, from the packet
+static PhysicsWorld::Stats           g_physicsStats{};      // render side copy, from the packet
+static double                        g_inputLatencyMs = 0.0;  // newest input event -> its frame's Present
+static ComPtr<ID3D12PipelineState>   g_overlayPso;
+
+// ---------------------------------
+// Benchmark – --benchmark=<scene> renders a fixed run of a scripted scene
+// (benchmark.h) and writes timings and memory high-water marks as JSON
+// ---------------------------------
+static const float                   kBenchmarkStep     = 1.0f / 60.0f;    // sim seconds per frame in a run
+static const UINT                    kBenchmarkWarmup   = 120;             // frames once everything is resident
+static const UINT                    kStreamStressSlots = 8;               // re-reads the streaming scene keeps queued
+static const BenchmarkScene*         g_benchmark        = nullptr;         // --benchmark=<scene>
+static UINT                          g_benchmarkFrames  = 2000;            // --benchmark-frames=N, measured
+static std::string                   g_benchmarkOut     = "benchmark.json";   // --benchmark-out=path
+static bool                          g_offscreen        = false;           // --offscreen: hidden window, no Present
+static BenchmarkRun                  g_benchmarkRun;
+static UINT                          g_benchmarkWarm    = 0;               // warmup frames so far
+static uint32_t                      g_simFrames        = 0;               // sim thread – fixed steps taken
+static int64_t                       g_lastRenderStart  = 0;
+
+// Highest seen over the measured frames
+struct BenchmarkPeaks
+{
+    UINT64   videoMemory    = 0;    // QueryVideoMemoryInfo, local segment
+    UINT64   gpuHeaps       = 0;    // what g_gpuAllocator has reserved
+    UINT64   transients     = 0;    // render graph heap
+    UINT64   texturePool    = 0;    // tile heaps g_textures has created
+    UINT64   textureMapped  = 0;    // tiles of it mapped to mips
+    UINT64   frameArena     = 0;
+    uint64_t heapAllocs     = 0;    // per frame
+    int64_t  start          = 0;    // QPC, first measured frame
+    UINT64   streamedBefore = 0;    // AssetStreamer bytesLoaded at that point
+};
+static BenchmarkPeaks                g_benchmarkPeaks;
+
+// Streaming scene: the archive's meshes are read again and again into a
+// buffer nothing draws from, one slot per read in flight
+static GpuAllocation*                g_streamScratch = nullptr;
+static UINT64                        g_streamSlotSize = 0;
+static AssetStreamer::Handle         g_streamLoads[kStreamStressSlots];
+static UINT                          g_streamNext = 0;
+
+// ---------------------------------------------------------------
+// Frame pacing
+// ---------------------------------------------------------------
+void WaitForFenceValue(UINT64 value)
+{
+    if (g_fence->GetCompletedValue() < value)
+    {
+        ThrowIfFailed(g_fence->SetEventOnCompletion(value, g_fenceEvent));
+        WaitForSingleObject(g_fenceEvent, INFINITE);
+    }
+}
+
+// Full flush – only for shutdown and other rare cases (resizes etc.)
+void WaitForGpu()
+{
+    ThrowIfFailed(g_commandQueue->Signal(g_fence.Get(), g_fenceValue));
+    WaitForFenceValue(g_fenceValue);
+    ++g_fenceValue;
+}
+
+// Waits until the GPU is done with the current slot, then recycles it
+FrameContext& BeginFrame()
+{
+    FrameContext& frame = g_frames[g_frameSlot];
+    {
+        PROFILE_SCOPE("WaitForGpu");
+        WaitForFenceValue(frame.fenceValue);
+    }
+    g_profiler.BeginFrame(g_frameSlot);
+
+    ThrowIfFailed(frame.commandAllocator->Reset());
+    if (g_asyncCompute.Enabled())
+        g_asyncCompute.BeginFrame(g_frameSlot);
+    frame.uploadOffset = 0;
+    frame.arena.Reset();
+    g_descriptors.BeginFrame(g_frameSlot, g_fence->GetCompletedValue());
+    return frame;
+}
+
+// Marks the slot as in use up to the fence value we just signalled
+void EndFrame()
+{
+    FrameContext& frame = g_frames[g_frameSlot];
+    ThrowIfFailed(g_commandQueue->Signal(g_fence.Get(), g_fenceValue));
+    frame.fenceValue = g_fenceValue++;
+
+    g_frameSlot  = (g_frameSlot + 1) % g_framesInFlight;
+    g_frameIndex = g_swapChain.CurrentIndex();
+}
+
+// Transient upload memory that lives until the current slot is reused
+struct FrameAllocation
+{
+    UINT8*                    cpu;
+    D3D12_GPU_VIRTUAL_ADDRESS gpu;
+    ID3D12Resource*           resource;     // for views – data starts at `offset`
+    UINT64                    offset;
+};
+
+FrameAllocation AllocFrameUpload(UINT64 size, UINT64 alignment = 256)
+{
+    FrameContext& frame = g_frames[g_frameSlot];
+    UINT64 offset = (frame.uploadOffset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > kFrameUploadSize)
+        throw std::runtime_error("Per-frame upload memory exhausted");
+
+    frame.uploadOffset = offset + size;
+    g_uploadHighWater  = max(g_uploadHighWater, frame.uploadOffset);
+    return { frame.uploadCpu + offset, frame.uploadGpu + offset, frame.uploadBuffer->resource.Get(), offset };
+}
+
+// Constant buffer in this frame's upload memory, 256 byte placed and sized like a CBV wants
+template <typename T>
+D3D12_GPU_VIRTUAL_ADDRESS AllocFrameConstants(const T& constants)
+{
+    FrameAllocation cb = AllocFrameUpload(AlignUp(sizeof(T), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT),
+                                          D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    memcpy(cb.cpu, &constants, sizeof(T));
+    return cb.gpu;
+}
+
+// CPU scratch that lives until the current slot is reused – never freed, never heap
+template <typename T>
+T* AllocFrameScratch(size_t count)
+{
+    return g_frames[g_frameSlot].arena.Allocate<T>(count);
+}
+
+// SM 6.6 variant when the heap can be indexed directly – see shaders/shaders.txt
+std::string BindlessName(const char* name)
+{
+    return g_bindlessHeap ? std::string(name) + "@bindless" : std::string(name);
+}
+
+D3D12_SHADER_BYTECODE GetBindlessShader(const char* name)
+{
+    return g_shaders.Get(BindlessName(name).c_str());
+}
+
+// HiZ pyramid at full back buffer size – dynamic resolution only ever covers
+// the top-left corner of it. Scene colour and depth are render graph transients.
+void CreateHiZ(UINT width, UINT height)
+{
+    g_targetWidth  = width;
+    g_targetHeight = height;
+
+    // Full-resolution mip 0 down to 1x1
+    g_hizMips   = 1;
+    while ((max(width, height) >> g_hizMips) > 0 && g_hizMips < kMaxHiZMips)
+        ++g_hizMips;
+
+    g_hiz = g_gpuAllocator.CreateResource(D3D12_HEAP_TYPE_DEFAULT,
+                                          Texture2DDesc(DXGI_FORMAT_R32_FLOAT, width, height, (UINT16)g_hizMips,
+                                                        D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS),
+                                          D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, nullptr);
+    g_hizSrv = g_descriptors.AllocatePersistent();
+    g_descriptors.CreateTextureSrv(g_hizSrv, g_hiz->resource.Get());
+    for (UINT mip = 0; mip < g_hizMips; ++mip)
+    {
+        D3D12_UNORDERED_ACCESS_VIEW_DESC uav{};
+        uav.Format             = DXGI_FORMAT_R32_FLOAT;
+        uav.ViewDimension      = D3D12_UAV_DIMENSION_TEXTURE2D;
+        uav.Texture2D.MipSlice = mip;
+        g_hizUavs[mip] = g_descriptors.AllocatePersistent();
+        g_descriptors.CreateTextureUav(g_hizUavs[mip], g_hiz->resource.Get(), &uav);
+    }
+    g_hizValid = false;
+}
+
+// Only with the GPU idle
+void ReleaseHiZ()
+{
+    const UINT64 completed = g_fence->GetCompletedValue();
+    g_descriptors.FreePersistent(g_hizSrv, completed);
+    for (UINT mip = 0; mip < g_hizMips; ++mip)
+        g_descriptors.FreePersistent(g_hizUavs[mip], completed);
+    g_gpuAllocator.Free(g_hiz);
+    g_hiz = nullptr;
+}
+
+// ---------------------------------------------------------------
+// Device / SwapChain creation
+// ---------------------------------------------------------------
+// Before the command line flags – those override the tier's defaults.
+// adapterIndex < 0 takes the first adapter that works, fastest first.
+void CreateDevice(int adapterIndex)
+{
+    ThrowIfFailed(CreateDXGIFactory1(IID_PPV_ARGS(&g_factory)));
+    AdapterChoice choice = SelectAdapter(g_factory.Get(), adapterIndex);
+    g_device       = choice.device;
+    g_adapter      = choice.adapter;
+    g_adapterIndex = choice.index;
+    g_caps         = GetDeviceCaps(choice, "devicecaps.bin", &g_capsCached);
+    g_tier         = PickDeviceTier(g_caps);
+}
+
+// What each tier starts from. Paths the caps decide outright (bindless, mesh shaders) aren't here.
+void ApplyTierDefaults()
+{
+    switch (g_tier)
+    {
+    case kTierLow:
+        // Shared memory and usually one engine: an async queue only adds barriers and waits
+        g_renderScale     = 0.67f;
+        g_useAsyncCompute = false;
+        g_oceanAsync      = false;
+        break;
+    case kTierMid:
+        g_dynamicRes = true;
+        g_dynRes.Init(16.6f);
+        break;
+    case kTierHigh:
+        break;
+    }
+}
+
+// Serial, and only what a loading frame needs – the rest is AddRenderInitTasks()
+void InitD3D12(HWND hwnd)
+{
+    // GPU memory – heaps are sub-allocated, budget comes from the adapter CreateDevice() picked
+    g_gpuAllocator.Init(g_device.Get(), g_adapter.Get());
+
+    // Command queue
+    D3D12_COMMAND_QUEUE_DESC queueDesc{};
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    ThrowIfFailed(g_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&g_commandQueue)));
+
+    // Swap chain + back buffer RTVs, sized to whatever client area the window ended up with
+    RECT client{};
+    GetClientRect(hwnd, &client);
+    const UINT width  = max(1L, client.right - client.left);
+    const UINT height = max(1L, client.bottom - client.top);
+    if (g_offscreen)
+        g_swapChain.InitOffscreen(g_device.Get(), width, height, g_swapSettings);
+    else
+        g_swapChain.Init(g_factory.Get(), g_device.Get(), g_commandQueue.Get(), hwnd, width, height, g_swapSettings);
+    g_frameIndex = g_swapChain.CurrentIndex();
+
+    // Frame slots – allocator + upload memory each
+    for (UINT i = 0; i < g_framesInFlight; ++i)
+    {
+        FrameContext& frame = g_frames[i];
+        ThrowIfFailed(g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                       IID_PPV_ARGS(&frame.commandAllocator)));
+
+        frame.uploadBuffer = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, kFrameUploadSize,
+                                                         D3D12_RESOURCE_STATE_GENERIC_READ);
+
+        // Upload heaps can stay mapped for their whole lifetime
+        ID3D12Resource* upload = frame.uploadBuffer->resource.Get();
+        D3D12_RANGE readRange{ 0, 0 };
+        ThrowIfFailed(upload->Map(0, &readRange, reinterpret_cast<void**>(&frame.uploadCpu)));
+        frame.uploadGpu = upload->GetGPUVirtualAddress();
+    }
+
+    // Command lists – all recorded from the slot's allocator, one after the other
+    for (ComPtr<ID3D12GraphicsCommandList>& list : g_graphicsLists)
+    {
+        ThrowIfFailed(g_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                  g_frames[0].commandAllocator.Get(), nullptr,
+                                                  IID_PPV_ARGS(&list)));
+        list->Close();
+    }
+
+    // Async compute – timestamps from its lists go through the direct queue's
+    // calibration; both queues tick at the same frequency on current hardware
+    if (g_useAsyncCompute)
+        g_asyncCompute.Init(g_device.Get(), g_framesInFlight);
+
+    // Recording lists – one per job thread, one allocator per list per slot
+    g_recordListCount = min(g_jobs.ThreadCount(), kMaxRecordLists);
+    for (UINT i = 0; i < g_recordListCount; ++i)
+    {
+        for (UINT f = 0; f < g_framesInFlight; ++f)
+            ThrowIfFailed(g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                           IID_PPV_ARGS(&g_frames[f].recordAllocators[i])));
+
+        ThrowIfFailed(g_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                  g_frames[0].recordAllocators[i].Get(), nullptr,
+                                                  IID_PPV_ARGS(&g_recordLists[i])));
+        g_recordLists[i]->Close();
+    }
+
+    // Fence
+    ThrowIfFailed(g_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&g_fence)));
+    g_fenceValue = 1;
+    g_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!g_fenceEvent) throw std::runtime_error("Failed to create fence event");
+
+    g_uploader.Init(g_device.Get());
+    g_profiler.Init(g_device.Get(), g_commandQueue.Get(), g_framesInFlight);
+}
+
+// The rest of the renderer's startup as tasks, each naming what it needs; `assets` opens assets.pak.
+// Every task may run on any job thread, next to any task it doesn't depend on.
+void AddRenderInitTasks(InitGraph& init, InitGraph::TaskId assets)
+{
+    /* Descriptor heap, and the paths the caps decide outright – nearly everything else needs one of them */
+    const InitGraph::TaskId descriptors = init.Add("Descriptors", []
+    {
+        if (g_caps.bindingTier < D3D12_RESOURCE_BINDING_TIER_2)
+            throw std::runtime_error("Resource binding tier 2 or better is required");
+        g_bindlessHeap = g_caps.shaderModel >= D3D_SHADER_MODEL_6_6 &&
+                         g_caps.bindingTier >= D3D12_RESOURCE_BINDING_TIER_3;
+
+        g_descriptors.Init(g_device.Get(), kPersistentDescriptors, kTransientDescriptors, g_framesInFlight);
+
+        // Mesh shaders – what FL 12_2 guarantees, but the tier is what actually matters
+        g_featureLevel = g_caps.featureLevel;
+        const bool tier1 = g_caps.meshShaderTier >= D3D12_MESH_SHADER_TIER_1;
+        const bool sm65  = g_caps.shaderModel >= D3D_SHADER_MODEL_6_5;
+
+        // A batch's instances go in one DispatchMesh dimension – bigger scenes stay on the classic path
+        const bool fits = g_sceneInstances + g_physicsBodies + 1 <= kMaxMeshInstances;
+        g_meshShaders = g_allowMeshShaders && tier1 && sm65 && fits;
+    });
+
+    /* Root signature */
+    const InitGraph::TaskId rootSignature = init.Add("RootSignature", []
+    {
+        D3D12_ROOT_PARAMETER1 params[3]{};
+        params[kRootDrawConstants].ParameterType            = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        params[kRootDrawConstants].Constants.ShaderRegister = 0;
+        params[kRootDrawConstants].Constants.Num32BitValues = kDrawConstantCount;
+        params[kRootDrawConstants].ShaderVisibility         = D3D12_SHADER_VISIBILITY_ALL;
+
+        params[kRootFrameConstants].ParameterType             = D3D12_ROOT_PARAMETER_TYPE_CBV;
+        params[kRootFrameConstants].Descriptor.ShaderRegister = 1;
+        params[kRootFrameConstants].Descriptor.Flags          = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+        params[kRootFrameConstants].ShaderVisibility          = D3D12_SHADER_VISIBILITY_ALL;
+
+        // Fallback: every range starts at heap index 0, so an index means the same thing everywhere
+        const D3D12_DESCRIPTOR_RANGE_FLAGS rangeFlags =
+            D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+        D3D12_DESCRIPTOR_RANGE1 ranges[] =
+        {
+            { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 1, rangeFlags, 0 },   // buffers
+            { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 2, rangeFlags, 0 },   // textures
+            { D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 1, rangeFlags, 0 },   // RW buffers
+            { D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 2, rangeFlags, 0 },   // RW float4 textures
+            { D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 3, rangeFlags, 0 },   // RW float textures
+        };
+        params[kRootBindlessTable].ParameterType                       = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        params[kRootBindlessTable].DescriptorTable.NumDescriptorRanges = _countof(ranges);
+        params[kRootBindlessTable].DescriptorTable.pDescriptorRanges   = ranges;
+        params[kRootBindlessTable].ShaderVisibility                    = D3D12_SHADER_VISIBILITY_ALL;
+
+        // s0 linear clamp, s1 linear wrap, s2 point clamp
+        D3D12_STATIC_SAMPLER_DESC samplers[3]{};
+        const D3D12_FILTER             filters[3] = { D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_FILTER_MIN_MAG_MIP_LINEAR,
+                                                      D3D12_FILTER_MIN_MAG_MIP_POINT };
+        const D3D12_TEXTURE_ADDRESS_MODE modes[3] = { D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_WRAP,
+                                                      D3D12_TEXTURE_ADDRESS_MODE_CLAMP };
+        for (UINT i = 0; i < 3; ++i)
+        {
+            samplers[i].Filter           = filters[i];
+            samplers[i].AddressU         = modes[i];
+            samplers[i].AddressV         = modes[i];
+            samplers[i].AddressW         = modes[i];
+            samplers[i].MaxLOD           = D3D12_FLOAT32_MAX;
+            samplers[i].ComparisonFunc   = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[i].ShaderRegister   = i;
+            samplers[i].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        }
+
+        D3D12_VERSIONED_ROOT_SIGNATURE_DESC desc{};
+        desc.Version                    = D3D_ROOT_SIGNATURE_VERSION_1_1;
+        desc.Desc_1_1.NumParameters     = g_bindlessHeap ? 2 : 3;
+        desc.Desc_1_1.pParameters       = params;
+        desc.Desc_1_1.NumStaticSamplers = _countof(samplers);
+        desc.Desc_1_1.pStaticSamplers   = samplers;
+        desc.Desc_1_1.Flags             = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+        if (g_bindlessHeap)
+            desc.Desc_1_1.Flags |= D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED;
+
+        ComPtr<ID3DBlob> signatureBlob, errorBlob;
+        HRESULT hr = D3D12SerializeVersionedRootSignature(&desc, &signatureBlob, &errorBlob);
+        if (FAILED(hr))
+        {
+            if (errorBlob) OutputDebugStringA((char*)errorBlob->GetBufferPointer());
+            throw std::runtime_error("Failed to serialize root signature");
+        }
+
+        ThrowIfFailed(g_device->CreateRootSignature(
+            0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(),
+            IID_PPV_ARGS(&g_rootSig)));
+
+        g_psoCache.Init(g_device.Get(), "pipelines.bin", &g_jobs);
+        g_psoCache.RegisterRootSignature(g_rootSig.Get(), signatureBlob->GetBufferPointer(),
+                                         signatureBlob->GetBufferSize());
+    }, { descriptors });
+
+    /* Shaders – precompiled DXIL from shaders.pak, see shaders/shaders.txt */
+    const InitGraph::TaskId shaders = init.Add("Shaders", []
+    {
+        g_shaders.Init("shaders.pak", "shaders/shaders.txt", "shadercache");
+    });
+
+    /* PSO */
+    init.Add("ScenePSOs", []
+    {
+        D3D12_SHADER_BYTECODE vs = GetBindlessShader("triangle_vs");
+        D3D12_SHADER_BYTECODE ps = GetBindlessShader("triangle_ps");
+
+        D3D12_INPUT_ELEMENT_DESC inputLayout[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, 0,
+              offsetof(PackedVertex, position), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+
+            { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0,
+              offsetof(PackedVertex, normal), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+
+            { "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0,
+              offsetof(PackedVertex, color), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{};
+        psoDesc.InputLayout       = { inputLayout, _countof(inputLayout) };
+        psoDesc.pRootSignature    = g_rootSig.Get();
+        psoDesc.VS                = vs;
+        psoDesc.PS                = ps;
+        psoDesc.RasterizerState   = DefaultRasterizerState();
+        psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;   // spinning flat meshes
+        psoDesc.BlendState        = DefaultBlendState();
+        psoDesc.DepthStencilState = DefaultDepthStencilState();
+        psoDesc.SampleMask        = UINT_MAX;
+        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        psoDesc.NumRenderTargets  = g_taa ? 2 : 1;
+        psoDesc.RTVFormats[0]     = DXGI_FORMAT_R8G8B8A8_UNORM;
+        psoDesc.RTVFormats[1]     = g_taa ? DXGI_FORMAT_R16G16_FLOAT : DXGI_FORMAT_UNKNOWN;    // motion vectors
+        psoDesc.DSVFormat         = DXGI_FORMAT_D32_FLOAT;
+        psoDesc.SampleDesc.Count  = 1;
+
+        // Comes out of pipelines.bin on every launch after the first
+        g_pipelineState = g_psoCache.Get(psoDesc);
+        g_hotReload.Track(&g_pipelineState, { BindlessName("triangle_vs").c_str(), BindlessName("triangle_ps").c_str() });
+
+        // Meshlet path: same state and PS, amplification + mesh shaders in front instead of the IA
+        if (g_meshShaders)
+        {
+            MeshPipelineDesc meshDesc;
+            meshDesc.pRootSignature    = g_rootSig.Get();
+            meshDesc.AS                = GetBindlessShader("meshlet_as");
+            meshDesc.MS                = GetBindlessShader("meshlet_ms");
+            meshDesc.PS                = ps;
+            meshDesc.BlendState        = psoDesc.BlendState;
+            meshDesc.SampleMask        = psoDesc.SampleMask;
+            meshDesc.RasterizerState   = psoDesc.RasterizerState;
+            meshDesc.DepthStencilState = psoDesc.DepthStencilState;
+            meshDesc.NumRenderTargets  = psoDesc.NumRenderTargets;
+            meshDesc.RTVFormats[0]     = psoDesc.RTVFormats[0];
+            meshDesc.RTVFormats[1]     = psoDesc.RTVFormats[1];
+            meshDesc.DSVFormat         = psoDesc.DSVFormat;
+            meshDesc.SampleDesc        = psoDesc.SampleDesc;
+            g_meshletPso = g_psoCache.GetMesh(meshDesc);
+            g_hotReload.Track(&g_meshletPso, { BindlessName("meshlet_as").c_str(), BindlessName("meshlet_ms").c_str(),
+                                               BindlessName("triangle_ps").c_str() });
+        }
+
+        // Overlay: no vertex input, alpha blended straight onto the back buffer
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC overlayDesc = psoDesc;
+        overlayDesc.InputLayout                     = { nullptr, 0 };
+        overlayDesc.VS                              = GetBindlessShader("overlay_vs");
+        overlayDesc.PS                              = g_shaders.Get("overlay_ps");
+        overlayDesc.DepthStencilState.DepthEnable   = FALSE;
+        overlayDesc.DSVFormat                       = DXGI_FORMAT_UNKNOWN;
+        overlayDesc.NumRenderTargets                = 1;
+        overlayDesc.RTVFormats[1]                   = DXGI_FORMAT_UNKNOWN;
+        D3D12_RENDER_TARGET_BLEND_DESC& blend       = overlayDesc.BlendState.RenderTarget[0];
+        blend.BlendEnable = TRUE;
+        blend.SrcBlend    = D3D12_BLEND_SRC_ALPHA;
+        blend.DestBlend   = D3D12_BLEND_INV_SRC_ALPHA;
+        g_overlayPso = g_psoCache.Get(overlayDesc);
+        g_hotReload.Track(&g_overlayPso, { BindlessName("overlay_vs").c_str(), "overlay_ps" });
+
+        // Upscale: fullscreen triangle, scene colour -> back buffer
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC upscaleDesc = overlayDesc;
+        upscaleDesc.VS         = g_shaders.Get("upscale_vs");
+        upscaleDesc.PS         = GetBindlessShader("upscale_ps");
+        upscaleDesc.BlendState = DefaultBlendState();
+        g_upscalePso = g_psoCache.Get(upscaleDesc);
+        g_hotReload.Track(&g_upscalePso, { "upscale_vs", BindlessName("upscale_ps").c_str() });
+
+        // Ocean: no vertex input either – the VS builds its tiles from SV_VertexID and the tile list
+        if (g_oceanEnabled)
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC oceanDesc = psoDesc;
+            oceanDesc.InputLayout = { nullptr, 0 };
+            oceanDesc.VS          = GetBindlessShader("ocean_vs");
+            oceanDesc.PS          = GetBindlessShader("ocean_ps");
+            g_oceanPso = g_psoCache.Get(oceanDesc);
+            g_hotReload.Track(&g_oceanPso, { BindlessName("ocean_vs").c_str(), BindlessName("ocean_ps").c_str() });
+        }
+    }, { rootSignature, shaders });
+
+    /* Scene targets: RTV/DSV for the graph's transients + HiZ */
+    const InitGraph::TaskId sceneTargets = init.Add("SceneTargets", []
+    {
+        D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{};
+        dsvHeapDesc.NumDescriptors = 1;
+        dsvHeapDesc.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+        ThrowIfFailed(g_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&g_dsvHeap)));
+
+        // Colour, then motion – adjacent, so the scene binds both through one handle
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{};
+        rtvHeapDesc.NumDescriptors = 2;
+        rtvHeapDesc.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        ThrowIfFailed(g_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&g_sceneRtvHeap)));
+
+        g_renderGraph.Init(g_device.Get());
+        g_renderGraph.SetAsyncCompute(g_asyncCompute.Enabled());
+        CreateHiZ(g_swapChain.Width(), g_swapChain.Height());
+    }, { descriptors });
+
+    /* Temporal upscaler – the plugin --upscaler= names if one registered, the built-in TAA otherwise */
+    init.Add("Temporal", []
+    {
+        if (!g_taa)
+            return;
+        D3D12_COMPUTE_PIPELINE_STATE_DESC csDesc{};
+        csDesc.pRootSignature = g_rootSig.Get();
+        csDesc.CS = GetBindlessShader("taa_cs");
+        g_taaPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_taaPso, { BindlessName("taa_cs").c_str() });
+
+        g_upscaler = CreateTemporalUpscalerPlugin(g_upscalerName.c_str(), g_device.Get(), &g_gpuAllocator, &g_descriptors);
+        if (!g_upscaler)
+        {
+            if (g_upscalerName != "taa")
+                OutputDebugStringA(("No temporal upscaler plugin \"" + g_upscalerName + "\", using TAA\n").c_str());
+            g_upscaler = std::make_unique<TaaUpscaler>(&g_gpuAllocator, &g_descriptors, &g_taaPso);
+        }
+        g_upscaler->Resize(g_targetWidth, g_targetHeight);
+    }, { rootSignature, shaders, sceneTargets });
+
+    /* Indirect draws + GPU culling */
+    init.Add("Culling", []
+    {
+        D3D12_COMPUTE_PIPELINE_STATE_DESC csDesc{};
+        csDesc.pRootSignature = g_rootSig.Get();
+        csDesc.CS = GetBindlessShader("cull_clear_cs");
+        g_cullClearPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_cullClearPso, { BindlessName("cull_clear_cs").c_str() });
+        csDesc.CS = GetBindlessShader("cull_cs");
+        g_cullPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_cullPso, { BindlessName("cull_cs").c_str() });
+        csDesc.CS = GetBindlessShader("cull_args_cs");
+        g_cullArgsPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_cullArgsPso, { BindlessName("cull_args_cs").c_str() });
+        csDesc.CS = GetBindlessShader("hiz_cs");
+        g_hizPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_hizPso, { BindlessName("hiz_cs").c_str() });
+
+        // Three draw constants, then the draw itself; the rest (instance buffer, visible list, mesh table) stay as set
+        D3D12_INDIRECT_ARGUMENT_DESC args[2]{};
+        args[0].Type                             = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+        args[0].Constant.RootParameterIndex      = kRootDrawConstants;
+        args[0].Constant.DestOffsetIn32BitValues = 1;
+        args[0].Constant.Num32BitValuesToSet     = 3;
+        args[1].Type                             = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+        D3D12_COMMAND_SIGNATURE_DESC sigDesc{};
+        sigDesc.ByteStride       = sizeof(IndirectCommand);
+        sigDesc.NumArgumentDescs = _countof(args);
+        sigDesc.pArgumentDescs   = args;
+        ThrowIfFailed(g_device->CreateCommandSignature(&sigDesc, g_rootSig.Get(), IID_PPV_ARGS(&g_drawSignature)));
+        if (g_meshShaders)
+        {
+            args[1].Type       = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH;
+            sigDesc.ByteStride = sizeof(MeshCommand);
+            ThrowIfFailed(g_device->CreateCommandSignature(&sigDesc, g_rootSig.Get(), IID_PPV_ARGS(&g_meshSignature)));
+        }
+
+        const UINT64 argsSize = kMaxBatches * max(sizeof(IndirectCommand), sizeof(MeshCommand));
+        g_indirectArgs = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, argsSize,
+                                                     D3D12_RESOURCE_STATE_COMMON,
+                                                     D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        g_indirectArgsUav = g_descriptors.AllocatePersistent();
+        g_descriptors.CreateRawBufferUav(g_indirectArgsUav, g_indirectArgs->resource.Get(), 0, argsSize);
+
+        const UINT64 countersSize = (1 + kMaxBatches) * sizeof(UINT);
+        g_cullCounters = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, countersSize,
+                                                     D3D12_RESOURCE_STATE_COMMON,
+                                                     D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        g_cullCountersUav = g_descriptors.AllocatePersistent();
+        g_descriptors.CreateRawBufferUav(g_cullCountersUav, g_cullCounters->resource.Get(), 0, countersSize);
+
+        const UINT64 visibleSize = (UINT64)(g_sceneInstances + g_physicsBodies + 1) * sizeof(UINT);     // + ground
+        g_visibleInstances = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, visibleSize,
+                                                         D3D12_RESOURCE_STATE_COMMON,
+                                                         D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        g_visibleSrv = g_descriptors.AllocatePersistent();
+        g_visibleUav = g_descriptors.AllocatePersistent();
+        g_descriptors.CreateRawBufferSrv(g_visibleSrv, g_visibleInstances->resource.Get(), 0, visibleSize);
+        g_descriptors.CreateRawBufferUav(g_visibleUav, g_visibleInstances->resource.Get(), 0, visibleSize);
+    }, { rootSignature, shaders });
+
+    /* Clustered lighting – the bin is rewritten every frame, so it never needs clearing */
+    init.Add("Lighting", []
+    {
+        D3D12_COMPUTE_PIPELINE_STATE_DESC csDesc{};
+        csDesc.pRootSignature = g_rootSig.Get();
+        csDesc.CS = GetBindlessShader("light_bin_cs");
+        g_lightBinPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_lightBinPso, { BindlessName("light_bin_cs").c_str() });
+
+        const UINT64 clustersSize = (UINT64)kClusterCount * (1 + kMaxClusterLights) * sizeof(UINT);
+        g_lightClusters = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, clustersSize,
+                                                      D3D12_RESOURCE_STATE_COMMON,
+                                                      D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        g_lightClustersSrv = g_descriptors.AllocatePersistent();
+        g_lightClustersUav = g_descriptors.AllocatePersistent();
+        g_descriptors.CreateRawBufferSrv(g_lightClustersSrv, g_lightClusters->resource.Get(), 0, clustersSize);
+        g_descriptors.CreateRawBufferUav(g_lightClustersUav, g_lightClusters->resource.Get(), 0, clustersSize);
+    }, { rootSignature, shaders });
+
+    /* Ocean – h0 goes up with the other startup uploads */
+    init.Add("Ocean", []
+    {
+        if (!g_oceanEnabled)
+            return;
+        g_ocean.Init(&g_gpuAllocator, &g_descriptors, &g_uploader, g_framesInFlight, kGroundHeight);
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC csDesc{};
+        csDesc.pRootSignature = g_rootSig.Get();
+        csDesc.CS = GetBindlessShader("ocean_spec_cs");
+        g_oceanSpectrumPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_oceanSpectrumPso, { BindlessName("ocean_spec_cs").c_str() });
+        csDesc.CS = GetBindlessShader("ocean_fft_cs");
+        g_oceanFftPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_oceanFftPso, { BindlessName("ocean_fft_cs").c_str() });
+        csDesc.CS = GetBindlessShader("ocean_final_cs");
+        g_oceanFinalizePso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_oceanFinalizePso, { BindlessName("ocean_final_cs").c_str() });
+        csDesc.CS = GetBindlessShader("ocean_query_cs");
+        g_oceanQueryPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_oceanQueryPso, { BindlessName("ocean_query_cs").c_str() });
+        csDesc.CS = GetBindlessShader("ocean_tiles_cs");
+        g_oceanTilesPso = g_psoCache.GetCompute(csDesc);
+        g_hotReload.Track(&g_oceanTilesPso, { BindlessName("ocean_tiles_cs").c_str() });
+
+        // Draw arguments only, no root arguments – so no root signature either
+        D3D12_INDIRECT_ARGUMENT_DESC drawArg{};
+        drawArg.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW;
+        D3D12_COMMAND_SIGNATURE_DESC sigDesc{};
+        sigDesc.ByteStride       = sizeof(D3D12_DRAW_ARGUMENTS);
+        sigDesc.NumArgumentDescs = 1;
+        sigDesc.pArgumentDescs   = &drawArg;
+        ThrowIfFailed(g_device->CreateCommandSignature(&sigDesc, nullptr, IID_PPV_ARGS(&g_oceanSignature)));
+    }, { rootSignature, shaders });
+
+    /* Geometry buffer */
+    init.Add("Geometry", []
+    {
+        // What the grid needs first, the rain can pop in a frame or two later
+        static const AssetStreamer::Priority kMeshPriority[kMeshCount] =
+        {
+            AssetStreamer::kPriorityCritical, AssetStreamer::kPriorityCritical,
+            AssetStreamer::kPriorityNormal, AssetStreamer::kPriorityNormal, AssetStreamer::kPriorityHigh,
+        };
+
+        // No archive (fresh checkout) – cook the meshes here and upload them with the rest of startup
+        const bool streamed = g_assets.IsOpen();
+        std::vector<MeshSource>        sources;
+        std::vector<std::vector<char>> cooked, cookedMeshlets;
+        if (!streamed)
+            sources = BuildSceneMeshes();
+
+        // Blobs are 16 byte multiples, so every mesh's vertices start on a stride boundary
+        UINT64 geometrySize = 0, meshletSize = 0;
+        std::vector<MeshTableEntry> meshTable;
+        for (UINT i = 0; i < kMeshCount; ++i)
+        {
+            const std::string meshletName = std::string(kSceneMeshNames[i]) + "/meshlets";
+            MeshAssetMeta    meta{};
+            MeshletAssetMeta meshletMeta{};
+            UINT64           blobSize = 0, meshletBlobSize = 0;
+            if (streamed)
+            {
+                const AssetPakEntry* entry = g_assets.Find(kSceneMeshNames[i]);
+                if (!entry || entry->type != kAssetMesh)
+                    throw std::runtime_error(std::string("assets.pak has no ") + kSceneMeshNames[i]);
+                meta     = ReadAssetMeta<MeshAssetMeta>(*entry);
+                blobSize = entry->size;
+                if (g_meshShaders)
+                {
+                    const AssetPakEntry* meshlets = g_assets.Find(meshletName.c_str());
+                    if (!meshlets || meshlets->type != kAssetMeshlets)
+                        throw std::runtime_error("assets.pak has no " + meshletName);
+                    meshletMeta     = ReadAssetMeta<MeshletAssetMeta>(*meshlets);
+                    meshletBlobSize = meshlets->size;
+                }
+            }
+            else
+            {
+                const CookedMesh mesh = CookMesh(sources[i].vertices);
+                meta     = mesh.meta;
+                cooked.push_back(MeshBlob(mesh));
+                blobSize = cooked.back().size();
+                meshletMeta = { (uint32_t)mesh.meshlets.size(), (uint32_t)mesh.meshletVertices.size(),
+                                (uint32_t)mesh.meshletTriangles.size() };
+                if (g_meshShaders)
+                {
+                    cookedMeshlets.push_back(MeshletBlob(mesh));
+                    meshletBlobSize = cookedMeshlets.back().size();
+                }
+            }
+            const UINT64 vertexBytes = (UINT64)meta.vertexCount * sizeof(PackedVertex);
+            if (meta.vertexStride != sizeof(PackedVertex) || blobSize % sizeof(PackedVertex) != 0 ||
+                blobSize < vertexBytes + meta.indexCount * sizeof(uint16_t))
+                throw std::runtime_error("assets.pak is out of date – rerun tools/assetcook");
+
+            Mesh mesh{};
+            mesh.firstVertex   = (UINT)(geometrySize / sizeof(PackedVertex));
+            mesh.vertexCount   = meta.vertexCount;
+            mesh.firstIndex    = (UINT)((geometrySize + vertexBytes) / sizeof(uint16_t));
+            mesh.indexCount    = meta.indexCount;
+            mesh.boundsRadius  = meta.boundsRadius;
+            mesh.positionScale = meta.positionScale;
+            mesh.meshletCount  = g_meshShaders ? meshletMeta.meshletCount : 0;
+            memcpy(mesh.boundsCenter, meta.boundsCenter, sizeof(mesh.boundsCenter));
+            memcpy(mesh.positionOffset, meta.positionOffset, sizeof(mesh.positionOffset));
+            g_meshes.push_back(mesh);
+            geometrySize += blobSize;
+
+            MeshTableEntry& entry = meshTable.emplace_back();
+            memcpy(entry.positionOffset, mesh.positionOffset, sizeof(entry.positionOffset));
+            entry.positionScale = mesh.positionScale;
+            entry.firstVertex   = mesh.firstVertex;
+            if (g_meshShaders)
+            {
+                entry.meshletOffset      = (uint32_t)meshletSize;
+                entry.meshletCount       = meshletMeta.meshletCount;
+                entry.meshletVertexCount = meshletMeta.vertexCount;
+                meshletSize += (meshletBlobSize + 15) & ~15ull;
+            }
+        }
+
+        // GPU-resident; filled through the copy queue rather than read over PCIe every frame
+        g_geometryBuffer = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, geometrySize,
+                                                       D3D12_RESOURCE_STATE_COMMON);
+        if (g_meshShaders)
+            g_meshletBuffer = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, meshletSize,
+                                                          D3D12_RESOURCE_STATE_COMMON);
+        g_meshLoads.assign(kMeshCount, AssetStreamer::kInvalid);
+        g_meshletLoads.assign(kMeshCount, AssetStreamer::kInvalid);
+        g_meshResident.assign(kMeshCount, streamed ? 0 : 1);
+        for (UINT i = 0; i < kMeshCount; ++i)
+        {
+            const UINT64 offset        = (UINT64)g_meshes[i].firstVertex * sizeof(PackedVertex);
+            const UINT64 meshletOffset = meshTable[i].meshletOffset;
+            if (streamed)
+            {
+                g_meshLoads[i] = g_assets.Request(g_assets.Find(kSceneMeshNames[i]), g_geometryBuffer->resource.Get(),
+                                                  offset, kMeshPriority[i]);
+                if (g_meshShaders)
+                    g_meshletLoads[i] = g_assets.Request(g_assets.Find((std::string(kSceneMeshNames[i]) + "/meshlets").c_str()),
+                                                         g_meshletBuffer->resource.Get(), meshletOffset, kMeshPriority[i]);
+            }
+            else
+            {
+                g_uploader.UploadBuffer(g_geometryBuffer->resource.Get(), offset, cooked[i].data(), cooked[i].size());
+                if (g_meshShaders)
+                    g_uploader.UploadBuffer(g_meshletBuffer->resource.Get(), meshletOffset, cookedMeshlets[i].data(),
+                                            cookedMeshlets[i].size());
+            }
+        }
+
+        // Views – both span the whole buffer, draws pick their ranges with base vertex / first index
+        g_vbView.BufferLocation = g_geometryBuffer->resource->GetGPUVirtualAddress();
+        g_vbView.StrideInBytes  = sizeof(PackedVertex);
+        g_vbView.SizeInBytes    = (UINT)geometrySize;
+        g_ibView.BufferLocation = g_vbView.BufferLocation;
+        g_ibView.Format         = DXGI_FORMAT_R16_UINT;
+        g_ibView.SizeInBytes    = (UINT)geometrySize;
+
+        // Raw views for the mesh shaders, which fetch and unpack vertices themselves
+        if (g_meshShaders)
+        {
+            g_geometrySrv = g_descriptors.AllocatePersistent();
+            g_descriptors.CreateRawBufferSrv(g_geometrySrv, g_geometryBuffer->resource.Get(), 0, geometrySize);
+            g_meshletSrv = g_descriptors.AllocatePersistent();
+            g_descriptors.CreateRawBufferSrv(g_meshletSrv, g_meshletBuffer->resource.Get(), 0, meshletSize);
+        }
+
+        // Mesh table – tiny, known up front, so it never waits on the stream
+        const UINT64 tableSize = meshTable.size() * sizeof(MeshTableEntry);
+        g_meshTable = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, tableSize, D3D12_RESOURCE_STATE_COMMON);
+        g_uploader.UploadBuffer(g_meshTable->resource.Get(), 0, meshTable.data(), tableSize);
+        g_meshTableSrv = g_descriptors.AllocatePersistent();
+        g_descriptors.CreateRawBufferSrv(g_meshTableSrv, g_meshTable->resource.Get(), 0, tableSize);
+    }, { assets, descriptors });
+
+    /* Textures – the mip tails start streaming now, everything finer once something samples it */
+    init.Add("Textures", []
+    {
+        const UINT64 budget = g_textureBudgetMB ? g_textureBudgetMB * 1024 * 1024
+                                                : g_gpuAllocator.GetStats().local.Budget / 4;
+        if (g_assets.IsOpen() && g_textures.Init(g_device.Get(), &g_gpuAllocator, &g_descriptors, &g_uploader,
+                                                 &g_assets, budget, g_framesInFlight))
+        {
+            for (UINT i = 0; i < kTextureCount; ++i)
+            {
+                const AssetPakEntry* entry = g_assets.Find(kSceneTextureNames[i]);
+                if (!entry || entry->type != kAssetTexture)
+                    throw std::runtime_error(std::string("assets.pak has no ") + kSceneTextureNames[i]);
+                g_textures.Add(entry);
+            }
+
+            // Planks under every tint; the sea is the tint with moving wave normals on top
+            MaterialEntry materials[kMaterialCount];
+            for (MaterialEntry& material : materials)
+                material = { kTexturePlanks, DescriptorHeap::kInvalid, 0.42f, 0.15f, { 0.0f, 0.0f }, { 0.0f, 0.0f } };
+            materials[kMaterialOcean] = { DescriptorHeap::kInvalid, kTextureOcean, 0.125f, 0.8f, { 0.011f, 0.006f },
+                                          { 0.0f, 0.0f } };
+            g_materialTable = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, sizeof(materials),
+                                                          D3D12_RESOURCE_STATE_COMMON);
+            g_uploader.UploadBuffer(g_materialTable->resource.Get(), 0, materials, sizeof(materials));
+            g_materialTableSrv = g_descriptors.AllocatePersistent();
+            g_descriptors.CreateRawBufferSrv(g_materialTableSrv, g_materialTable->resource.Get(), 0, sizeof(materials));
+        }
+    }, { assets, descriptors });
+}
+
+// ---------------------------------------------------------------
+// Loading screen – WinMain thread, while the init graph runs
+// ---------------------------------------------------------------
+// Clears only: no PSO, no root signature, no descriptors – none of those exist
+// yet. A bar across the middle of the back buffer, filled to `progress`.
+void PresentLoadingFrame(float progress)
+{
+    FrameContext& frame = g_frames[g_frameSlot];
+    WaitForFenceValue(frame.fenceValue);
+    ThrowIfFailed(frame.commandAllocator->Reset());
+
+    ID3D12GraphicsCommandList* cl   = g_graphicsLists[0].Get();
+    ID3D12Resource*            back = g_swapChain.BackBuffer(g_frameIndex);
+    const D3D12_CPU_DESCRIPTOR_HANDLE rtv = g_swapChain.Rtv(g_frameIndex);
+    ThrowIfFailed(cl->Reset(frame.commandAllocator.Get(), nullptr));
+    D3D12_RESOURCE_BARRIER barrier = TransitionBarrier(back, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    cl->ResourceBarrier(1, &barrier);
+
+    const LONG width  = (LONG)g_swapChain.Width();
+    const LONG height = (LONG)g_swapChain.Height();
+    const LONG left   = width / 4, right = width - width / 4;
+    const LONG top    = height / 2 - max(2L, height / 100), bottom = height / 2 + max(2L, height / 100);
+    const D3D12_RECT track = { left, top, right, bottom };
+    const D3D12_RECT done  = { left, top, left + (LONG)((float)(right - left) * min(max(progress, 0.0f), 1.0f)), bottom };
+    const float trackColor[] = { 0.15f, 0.17f, 0.2f, 1.0f };
+    cl->ClearRenderTargetView(rtv, kLoadingColor, 0, nullptr);
+    cl->ClearRenderTargetView(rtv, trackColor, 1, &track);
+    if (done.right > done.left)
+        cl->ClearRenderTargetView(rtv, kClearColor, 1, &done);
+
+    barrier = TransitionBarrier(back, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+    cl->ResourceBarrier(1, &barrier);
+    ThrowIfFailed(cl->Close());
+    ID3D12CommandList* lists[] = { cl };
+    g_commandQueue->ExecuteCommandLists(1, lists);
+    g_swapChain.Present();
+    EndFrame();
+}
+
+// ---------------------------------------------------------------
+// Rendering
+// ---------------------------------------------------------------
+
+// A grid of spinning meshes, four tints – stand-in until there's a real scene – with
+// physics crates and balls raining down on it
+void CreateScene()
+{
+    static const float palette[4][4] =
+    {
+        { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 0.6f, 0.4f, 1.0f },
+        { 0.5f, 1.0f, 0.6f, 1.0f }, { 0.6f, 0.7f, 1.0f, 1.0f },
+    };
+    const UINT  side   = (UINT)ceilf(sqrtf((float)g_sceneInstances));
+    const float origin = -0.5f * kSceneSpacing * (float)(side - 1);
+
+    for (UINT i = 0; i < g_sceneInstances; ++i)
+    {
+        const UINT material = (i / 7) % 4;
+        g_world.Create(Transform{ { origin + kSceneSpacing * (float)(i % side), 0.0f,
+                                    origin + kSceneSpacing * (float)(i / side) }, 1.0f,
+                                  QuatFromAxisAngle({ 0.0f, 1.0f, 0.0f }, (float)i * 0.37f) },
+                       Spin{ 1.0f },
+                       LocalToWorld{},
+                       RenderMesh{ i % (kMeshQuad + 1), material },
+                       Tint{ { palette[material][0], palette[material][1], palette[material][2], palette[material][3] } });
+    }
+
+    // With the ocean the ground is its surface, drawn by the ocean pass; the physics ground is the sea floor
+    g_physics.Init(&g_jobs, { 0.0f, -9.81f, 0.0f }, g_oceanEnabled ? kSeaFloor : kGroundHeight);
+    const float extent = kSceneSpacing * (float)side;
+    if (!g_oceanEnabled)
+        g_world.Create(Transform{ { 0.0f, kGroundHeight, 0.0f }, extent + 2.0f, QuatIdentity() },
+                       LocalToWorld{},
+                       RenderMesh{ kMeshGround, kMaterialOcean },
+                       Tint{ { 0.12f, 0.3f, 0.42f, 1.0f } });
+
+    // The grid collides as spheres – it spins, a sphere doesn't care
+    PhysicsWorld::BodyDesc grid;
+    grid.mass        = 0.0f;
+    grid.halfExtents = { 0.45f, 0.45f, 0.45f };
+    for (UINT i = 0; i < g_sceneInstances; ++i)
+    {
+        grid.position = { origin + kSceneSpacing * (float)(i % side), 0.0f, origin + kSceneSpacing * (float)(i / side) };
+        g_physics.AddBody(grid);
+    }
+
+    // Scattered over the whole grid and up to 20m high, so they keep landing for a few seconds
+    uint32_t seed = 12345;
+    auto random = [&seed] { seed = seed * 1664525u + 1013904223u; return (float)(seed >> 8) * (1.0f / 16777216.0f); };
+    const float size = 0.6f;
+    for (UINT i = 0; i < g_physicsBodies; ++i)
+    {
+        PhysicsWorld::BodyDesc desc;
+        desc.shape       = i % 3 ? PhysicsWorld::kShapeSphere : PhysicsWorld::kShapeBox;
+        desc.halfExtents = { 0.5f * size, 0.5f * size, 0.5f * size };
+        desc.mass        = desc.shape == PhysicsWorld::kShapeBox ? 2.0f : 1.0f;
+        desc.position    = { (random() - 0.5f) * extent, 3.0f + random() * 20.0f, (random() - 0.5f) * extent };
+        desc.rotation    = QuatFromAxisAngle(Normalize(Float3{ random() - 0.5f, random() - 0.5f, random() - 0.5f } +
+                                                       Float3{ 0.0f, 0.01f, 0.0f }), random() * DirectX::XM_2PI);
+        desc.restitution = desc.shape == PhysicsWorld::kShapeSphere ? 0.5f : 0.1f;
+
+        const UINT material = i % 4;
+        g_world.Create(Transform{ desc.position, size, desc.rotation },
+                       RigidBody{ g_physics.AddBody(desc) },
+                       Buoyant{ 0.5f * size },
+                       LocalToWorld{},
+                       RenderMesh{ desc.shape == PhysicsWorld::kShapeBox ? (uint32_t)kMeshCube : (uint32_t)kMeshSphere, material },
+                       Tint{ { palette[material][0], palette[material][1], palette[material][2], palette[material][3] } });
+    }
+
+    // Lanterns hung over the grid, warm and slow; every 8th is a cannon flash instead – big, white, brief
+    for (UINT i = 0; i < g_lightCount; ++i)
+    {
+        const bool  flash = i % 8 == 7;
+        const float warm  = 0.8f + 0.4f * random();
+        g_world.Create(Transform{ { (random() - 0.5f) * extent, 0.8f + random() * 2.7f, (random() - 0.5f) * extent },
+                                  1.0f, QuatIdentity() },
+                       flash ? PointLight{ { 4.0f, 3.6f, 3.0f }, 8.0f }
+                             : PointLight{ { 1.6f * warm, 0.9f * warm, 0.35f * warm }, 3.0f + 2.0f * random() },
+                       flash ? Flicker{ 1.5f + random(), random() * DirectX::XM_2PI, 0.0f, 24.0f }
+                             : Flicker{ 6.0f + 6.0f * random(), random() * DirectX::XM_2PI, 0.7f, 1.0f });
+    }
+}
+
+// Up to kBuoyancy g when fully under, linear in how far down the body's bottom is, plus water drag.
+// The heights are the GPU's from a few frames back, extrapolated (Ocean::SampleHeights).
+void ApplyBuoyancy(float dt)
+{
+    PROFILE_SCOPE("Buoyancy");
+    g_buoyancyIds.clear();
+    g_world.ForEach<const RigidBody, const Buoyant>([](uint32_t count, const RigidBody* bodies, const Buoyant*)
+    {
+        for (uint32_t row = 0; row < count; ++row)
+            g_buoyancyIds.push_back(bodies[row].body);
+    });
+    g_buoyancyHeights.resize(g_buoyancyIds.size());
+    g_ocean.SampleHeights((UINT)g_buoyancyIds.size(), g_buoyancyIds.data(), g_simTime + dt, g_buoyancyHeights.data());
+
+    // Same chunks in the same order, so row n is still g_buoyancyIds[n]
+    uint32_t next = 0;
+    g_world.ForEach<const RigidBody, const Buoyant, const Transform>(
+        [dt, &next](uint32_t count, const RigidBody* bodies, const Buoyant* buoyants, const Transform* transforms)
+    {
+        for (uint32_t row = 0; row < count; ++row, ++next)
+        {
+            const float radius = buoyants[row].radius;
+            const float under  = min(1.0f, (g_buoyancyHeights[next] - transforms[row].position.y + radius) / (2.0f * radius));
+            if (under <= 0.0f)
+                continue;
+            const Float3 velocity = g_physics.GetVelocity(bodies[row].body);
+            const float  drag     = min(kWaterDrag * under * dt, 1.0f);
+            g_physics.ApplyVelocityChange(bodies[row].body,
+                                          Float3{ 0.0f, kBuoyancy * 9.81f * under * dt, 0.0f } - velocity * drag);
+        }
+    });
+}
+
+void Simulate(float dt)
+{
+    PROFILE_SCOPE("Simulate");
+    g_world.ParallelForEach<Transform, const Spin>(g_jobs, [dt](uint32_t count, Transform* transforms, const Spin* spins)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            transforms[i].rotation = Normalize(QuatFromAxisAngle({ 0.0f, 1.0f, 0.0f }, spins[i].rate * dt) *
+                                               transforms[i].rotation);
+    });
+    if (g_oceanEnabled)
+        ApplyBuoyancy(dt);
+    {
+        PROFILE_SCOPE("Physics");
+        g_physics.Update(dt);
+    }
+    // Blended between the last two fixed steps, so motion is smooth at any frame rate
+    g_world.ParallelForEach<Transform, const RigidBody>(g_jobs, [](uint32_t count, Transform* transforms,
+                                                                   const RigidBody* bodies)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float scale = transforms[i].scale;
+            transforms[i]       = g_physics.GetTransform(bodies[i].body);
+            transforms[i].scale = scale;
+        }
+    });
+    // SIMD kernel straight over the chunk's columns
+    static_assert(sizeof(LocalToWorld) == sizeof(Float3x4), "LocalToWorld columns are Float3x4 arrays");
+    g_world.ParallelForEach<const Transform, LocalToWorld>(g_jobs, [](uint32_t count, const Transform* transforms,
+                                                                      LocalToWorld* worlds)
+    {
+        TransformsToMatrices(count, transforms, &worlds[0].matrix);
+    });
+}
+
+// Sim thread – input, one step of the world, and the packet the renderer draws it from
+void SimulateFrame(FramePacket& packet)
+{
+    PROFILE_SCOPE("SimulateFrame");
+
+    // Keys arrive stamped by WindowProc; repeats (lParam bit 30) don't toggle again
+    packet.inputTime   = 0;
+    packet.exportTrace = false;
+    InputEvent event;
+    while (g_input.Pop(event))
+    {
+        packet.inputTime = event.time;
+        if (event.message == WM_KEYDOWN && !(event.lParam & 0x40000000))
+        {
+            if (event.wParam == VK_F1)
+                g_simOverlay = !g_simOverlay;
+            if (event.wParam == VK_F9)
+                packet.exportTrace = true;
+        }
+    }
+    packet.showOverlay = g_simOverlay;
+
+    // Benchmark runs step a fixed amount, so each one draws exactly the same frames
+    const float time = g_benchmark ? (float)++g_simFrames * kBenchmarkStep
+                                   : (float)(g_profiler.ToMs(Profiler::Now() - g_startTime) * 0.001);
+    Simulate(time - g_simTime);
+    g_simTime      = time;
+    packet.time    = time;
+    packet.physics = g_physics.GetStats();
+
+    // Low camera circling over the grid, so a good part of it is off screen
+    const UINT  side   = (UINT)ceilf(sqrtf((float)g_sceneInstances));
+    const float extent = kSceneSpacing * (float)side;
+    const float orbit  = time * 0.1f;
+    packet.eye[0]    = sinf(orbit) * extent * 0.3f;
+    packet.eye[1]    = extent * 0.08f + 2.0f;
+    packet.eye[2]    = cosf(orbit) * extent * 0.3f;
+    packet.target[0] = sinf(orbit + 0.6f) * extent * 0.3f;
+    packet.target[1] = 0.0f;
+    packet.target[2] = cosf(orbit + 0.6f) * extent * 0.3f;
+
+    // Copied chunk by chunk – the vectors keep their capacity, so no allocations once warm
+    PROFILE_SCOPE("Extract");
+    packet.meshes.clear();
+    packet.worlds.clear();
+    packet.tints.clear();
+    packet.scales.clear();
+    g_world.ForEach<const RenderMesh, const LocalToWorld, const Tint, const Transform>(
+        [&packet](uint32_t count, const RenderMesh* meshes, const LocalToWorld* worlds, const Tint* tints,
+                  const Transform* transforms)
+    {
+        packet.meshes.insert(packet.meshes.end(), meshes, meshes + count);
+        packet.worlds.insert(packet.worlds.end(), worlds, worlds + count);
+        packet.tints.insert(packet.tints.end(), tints, tints + count);
+        for (uint32_t row = 0; row < count; ++row)
+            packet.scales.push_back(fabsf(transforms[row].scale));
+    });
+    packet.lights.clear();
+    g_world.ForEach<const PointLight, const Flicker, const Transform>(
+        [&packet, time](uint32_t count, const PointLight* lights, const Flicker* flickers, const Transform* transforms)
+    {
+        for (uint32_t row = 0; row < count; ++row)
+        {
+            const float intensity = LightIntensity(flickers[row], time);
+            packet.lights.push_back({ { transforms[row].position.x, transforms[row].position.y, transforms[row].position.z },
+                                      lights[row].radius,
+                                      { lights[row].color[0] * intensity, lights[row].color[1] * intensity,
+                                        lights[row].color[2] * intensity }, 0.0f });
+        }
+    });
+    packet.oceanQueries.clear();
+    if (g_oceanEnabled)
+        g_world.ForEach<const RigidBody, const Buoyant, const Transform>(
+            [&packet](uint32_t count, const RigidBody* bodies, const Buoyant*, const Transform* transforms)
+        {
+            for (uint32_t row = 0; row < count; ++row)
+                packet.oceanQueries.push_back({ transforms[row].position.x, transforms[row].position.z, bodies[row].body });
+        });
+}
+
+// Render thread – builds this frame's batches and uploads instances + frame constants.
+// Nothing in the packet is looked at after this, so it can go back to the sim thread.
+void PrepareFrame(const FramePacket& packet)
+{
+    using namespace DirectX;
+    const UINT    side   = (UINT)ceilf(sqrtf((float)g_sceneInstances));
+    const float   extent = kSceneSpacing * (float)side;
+    XMVECTOR      eye    = XMVectorSet(packet.eye[0], packet.eye[1], packet.eye[2], 1.0f);
+    XMVECTOR      target = XMVectorSet(packet.target[0], packet.target[1], packet.target[2], 1.0f);
+    XMMATRIX      view   = XMMatrixLookAtLH(eye, target, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const float   aspect = (float)g_targetWidth / (float)g_targetHeight;
+    const float   zNear  = 0.1f, zFar = extent * 2.0f;
+    XMMATRIX      proj   = XMMatrixPerspectiveFovLH(XM_PIDIV4, aspect, zNear, zFar);
+
+    // A new sub-pixel offset every frame; more phases the further below output size we render, so every
+    // output pixel still gets samples near its centre (8 x the upscale ratio squared, as FSR2 does)
+    XMMATRIX jittered = proj;
+    float    jitter[2] = { 0.0f, 0.0f };
+    if (g_taa)
+    {
+        const float ratio  = (float)g_targetWidth / (float)g_renderWidth;
+        const UINT  phases = (UINT)ceilf(8.0f * ratio * ratio);
+        HaltonJitter(g_taaFrame++ % phases + 1, &jitter[0], &jitter[1]);
+        // clip.w is view z, so this shifts ndc by a constant – pixels right and down
+        jittered.r[2] = XMVectorAdd(jittered.r[2], XMVectorSet(2.0f * jitter[0] / (float)g_renderWidth,
+                                                               -2.0f * jitter[1] / (float)g_renderHeight, 0.0f, 0.0f));
+    }
+
+    if (g_showOverlay != packet.showOverlay)
+        g_warmFrames = 0;           // one more graph pass – its arena may have to grow
+    g_showOverlay  = packet.showOverlay;
+    g_physicsStats = packet.physics;
+
+    // Built on the stack – upload memory is write-combined, never read it back
+    FrameConstants constants{};
+    // Row-vector matrix as stored by DirectXMath, read column_major by HLSL -> mul(M, v) just works
+    XMStoreFloat4x4(&constants.viewProj, view * jittered);
+    constants.prevViewProj = g_hizValid ? g_prevViewProj : constants.viewProj;
+    XMStoreFloat4x4(&constants.unjitteredViewProj, view * proj);
+    constants.prevUnjitteredViewProj = g_taaReset ? constants.unjitteredViewProj : g_prevUnjitteredViewProj;
+    constants.jitter[0] = jitter[0];
+    constants.jitter[1] = jitter[1];
+    XMStoreFloat3(reinterpret_cast<XMFLOAT3*>(constants.cameraPos), eye);
+    constants.time       = packet.time;
+    constants.hizSize[0] = (float)g_hizWidth;
+    constants.hizSize[1] = (float)g_hizHeight;
+    constants.hizMips    = g_hizMips;
+    constants.hizValid   = g_hizValid ? 1 : 0;
+
+    // Clusters are cut in view space – the bin needs the view and enough of the projection to undo it
+    XMStoreFloat4x4(&constants.view, view);
+    XMFLOAT4X4 projection;
+    XMStoreFloat4x4(&projection, proj);
+    constants.projParams[0] = projection._11;
+    constants.projParams[1] = projection._22;
+    constants.projParams[2] = zNear;
+    constants.projParams[3] = zFar;
+    constants.renderSize[0] = (float)g_renderWidth;
+    constants.renderSize[1] = (float)g_renderHeight;
+    constants.sunIntensity  = g_night ? 0.03f : 0.55f;
+    constants.ambient       = g_night ? 0.04f : 0.45f;
+
+    // This frame's lights, flicker already applied by the sim
+    const UINT64    lightBytes = max((UINT64)packet.lights.size(), (UINT64)1) * sizeof(LightData);
+    FrameAllocation lights     = AllocFrameUpload(lightBytes);
+    if (!packet.lights.empty())
+        memcpy(lights.cpu, packet.lights.data(), packet.lights.size() * sizeof(LightData));
+    constants.lightBuffer   = g_descriptors.AllocateTransient();
+    g_descriptors.CreateRawBufferSrv(constants.lightBuffer, lights.resource, lights.offset, lightBytes);
+    constants.lightCount    = (UINT)packet.lights.size();
+    constants.clusterBuffer = g_lightClustersSrv;
+
+    // What the temporal pass hands its upscaler on top of the targets
+    g_temporalInputs.renderWidth  = g_renderWidth;
+    g_temporalInputs.renderHeight = g_renderHeight;
+    g_temporalInputs.jitterX      = jitter[0];
+    g_temporalInputs.jitterY      = jitter[1];
+    g_temporalInputs.frameSeconds = (float)(g_profiler.FrameMs() * 0.001);
+    g_temporalInputs.nearPlane    = zNear;
+    g_temporalInputs.farPlane     = zFar;
+    g_temporalInputs.verticalFov  = XM_PIDIV4;
+    g_temporalInputs.reset        = g_taaReset;
+
+    // Frustum planes straight from the matrix (Gribb/Hartmann); clip = v * M, so columns.
+    // Unjittered – the jitter is less than a pixel either way
+    const XMFLOAT4X4& m = constants.unjitteredViewProj;
+    const float planes[6][4] =
+    {
+        { m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41 },    // left
+        { m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41 },    // right
+        { m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42 },    // bottom
+        { m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42 },    // top
+        { m._13,         m._23,         m._33,         m._43         },    // near (z >= 0)
+        { m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43 },    // far
+    };
+    for (UINT i = 0; i < 6; ++i)
+    {
+        const float invLength = 1.0f / sqrtf(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] +
+                                             planes[i][2] * planes[i][2]);
+        for (UINT j = 0; j < 4; ++j)
+            constants.frustumPlanes[i][j] = planes[i][j] * invLength;
+    }
+
+    // Batch keys from the packet, then the instances straight from it into the upload
+    // ring in batch order – sequential writes, write-combined memory likes that.
+    // The CPU path has no GPU culling, so it frustum tests the boxes here, a block at a time.
+    const bool cpuCull = !g_useIndirect && (g_cullFlags & kCullFrustum);
+
+    // Meshes still streaming in are left out of the frame
+    g_assets.Update();
+    for (UINT i = 0; i < kMeshCount; ++i)
+        if (!g_meshResident[i] && g_assets.IsReady(g_meshLoads[i]) &&
+            (g_meshletLoads[i] == AssetStreamer::kInvalid || g_assets.IsReady(g_meshletLoads[i])))
+            g_meshResident[i] = 1;
+
+    // Textures go by what this slot's last frame sampled; its fence has passed, so its feedback is in
+    {
+        PROFILE_SCOPE("Textures");
+        g_textures.Update(g_frameSlot, g_fenceValue, g_fence->GetCompletedValue());
+    }
+    constants.materialTable   = g_materialTableSrv;
+    constants.textureTable    = g_textures.TableSrv(g_frameSlot);
+    constants.textureFeedback = g_textures.FeedbackUav();
+
+    // Buoyancy: the heights this slot asked for frames ago are in, this frame's points go up
+    if (g_oceanEnabled)
+    {
+        g_ocean.ResolveQueries(g_frameSlot);
+        g_oceanQueryCount = g_ocean.SubmitQueries(g_frameSlot, packet.oceanQueries.data(),
+                                                  (UINT)packet.oceanQueries.size(), packet.time);
+        const UINT64    pointBytes = max((UINT64)g_oceanQueryCount, (UINT64)1) * sizeof(OceanQuery);
+        FrameAllocation points     = AllocFrameUpload(pointBytes);
+        if (g_oceanQueryCount)
+            memcpy(points.cpu, packet.oceanQueries.data(), g_oceanQueryCount * sizeof(OceanQuery));
+        g_oceanQuerySrv = g_descriptors.AllocateTransient();
+        g_descriptors.CreateRawBufferSrv(g_oceanQuerySrv, points.resource, points.offset, pointBytes);
+    }
+
+    g_batcher.Clear();
+    const uint32_t renderables = (uint32_t)packet.meshes.size();
+    if (!cpuCull)
+    {
+        for (uint32_t i = 0; i < renderables; ++i)
+            if (g_meshResident[packet.meshes[i].mesh])
+                g_batcher.AddRef(packet.meshes[i].mesh, packet.meshes[i].material, i);
+    }
+    else
+    {
+        // Cube around each bounding sphere, world space
+        float*    scratch = AllocFrameScratch<float>(kCullBlock * 6);
+        uint32_t* visible = AllocFrameScratch<uint32_t>(kCullBlock);
+        for (uint32_t base = 0; base < renderables; base += kCullBlock)
+        {
+            const uint32_t count = min(kCullBlock, renderables - base);
+            float* soa[6];
+            for (uint32_t k = 0; k < 6; ++k)
+                soa[k] = scratch + k * count;
+            for (uint32_t row = 0; row < count; ++row)
+            {
+                const Mesh&  mesh   = g_meshes[packet.meshes[base + row].mesh];
+                const Float3 center = TransformPoint(packet.worlds[base + row].matrix,
+                                                     { mesh.boundsCenter[0], mesh.boundsCenter[1], mesh.boundsCenter[2] });
+                const float  radius = mesh.boundsRadius * packet.scales[base + row];
+                soa[0][row] = center.x;
+                soa[1][row] = center.y;
+                soa[2][row] = center.z;
+                soa[3][row] = soa[4][row] = soa[5][row] = radius;
+            }
+            const AabbArrays boxes{ { soa[0], soa[1], soa[2] }, { soa[3], soa[4], soa[5] } };
+            const uint32_t   visibleCount = CullAabbs(count, boxes, constants.frustumPlanes, visible);
+            for (uint32_t i = 0; i < visibleCount; ++i)
+            {
+                const RenderMesh& item = packet.meshes[base + visible[i]];
+                if (g_meshResident[item.mesh])
+                    g_batcher.AddRef(item.mesh, item.material, base + visible[i]);
+            }
+        }
+    }
+    g_batcher.BuildRefs();
+
+    const UINT64    instanceBytes = (UINT64)g_batcher.InstanceCount() * sizeof(InstanceData);
+    FrameAllocation instances     = AllocFrameUpload(instanceBytes);
+
+    // Motion vectors need where each instance was in the last frame drawn – same entities in the
+    // same order unless the world changed shape, and then this frame goes without object motion
+    const UINT64    prevWorldBytes = (UINT64)g_batcher.InstanceCount() * sizeof(Float3x4);
+    const bool      objectMotion   = g_taa && prevWorldBytes && g_prevWorlds.size() == packet.worlds.size();
+    FrameAllocation prevWorlds     = objectMotion ? AllocFrameUpload(prevWorldBytes) : FrameAllocation{};
+    {
+        PROFILE_SCOPE("WriteInstances");
+        InstanceData* dst  = reinterpret_cast<InstanceData*>(instances.cpu);
+        Float3x4*     prev = reinterpret_cast<Float3x4*>(prevWorlds.cpu);
+        const std::vector<uint32_t>& order = g_batcher.Order();
+        JobSystem::Counter counter;
+        g_jobs.ParallelFor((uint32_t)order.size(), 4096, [dst, prev, &order, &packet](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                InstanceData inst;      // whole 64 bytes in one go
+                memcpy(inst.world, packet.worlds[order[i]].matrix.m, sizeof(inst.world));
+                memcpy(inst.color, packet.tints[order[i]].color, sizeof(inst.color));
+                dst[i] = inst;
+                if (prev)
+                    prev[i] = g_prevWorlds[order[i]].matrix;
+            }
+        }, counter);
+        g_jobs.Wait(counter);
+    }
+
+    g_instanceSrv = g_descriptors.AllocateTransient();
+    g_descriptors.CreateRawBufferSrv(g_instanceSrv, instances.resource, instances.offset, instanceBytes);
+    g_prevWorldSrv = DescriptorHeap::kInvalid;
+    if (objectMotion)
+    {
+        g_prevWorldSrv = g_descriptors.AllocateTransient();
+        g_descriptors.CreateRawBufferSrv(g_prevWorldSrv, prevWorlds.resource, prevWorlds.offset, prevWorldBytes);
+    }
+    if (g_taa)
+        g_prevWorlds.assign(packet.worlds.begin(), packet.worlds.end());    // keeps its capacity once warm
+
+    g_prevViewProj = constants.viewProj;        // what the HiZ built this frame will match
+    g_prevUnjitteredViewProj = constants.unjitteredViewProj;
+    g_taaReset     = false;
+
+    g_frameConstants = AllocFrameConstants(constants);
+}
 
-static ComPtr<ID3D12DescriptorHeap>  g_rtvHeap;
+// State every list needs before it can draw – bundles aside, nothing carries over between lists.
+// Picks the scene PSO too: input assembler or meshlets.
+void SetDrawState(ID3D12GraphicsCommandList* cl, D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle)
+{
+    // Viewport & scissor – the scaled corner of the scene targets
+    D3D12_VIEWPORT vp{0.0f, 0.0f, (float)g_renderWidth, (float)g_renderHeight, 0.0f, 1.0f};
+    D3D12_RECT   scissor{0, 0, (LONG)g_renderWidth, (LONG)g_renderHeight};
+    cl->RSSetViewports(1, &vp);
+    cl->RSSetScissorRects(1, &scissor);
 
-// Sync objects
-static ComPtr<ID3D12Fence>           g_fence;
-static UINT64                       g_fenceValue = 0;
-static HANDLE                       g_fenceEvent = nullptr;
+    // With TAA the motion target's RTV follows the colour one
+    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = g_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+    cl->OMSetRenderTargets(g_taa ? 2 : 1, &rtvHandle, TRUE, &dsvHandle);
 
-// Render targets
-static ComPtr<ID3D12Resource>        g_renderTargets[2];
-static UINT                         g_frameIndex = 0;
+    // Heap before root signature – directly indexed root signatures require that order
+    ID3D12DescriptorHeap* heaps[] = { g_descriptors.Heap() };
+    cl->SetDescriptorHeaps(1, heaps);
+    cl->SetGraphicsRootSignature(g_rootSig.Get());
+    if (!g_bindlessHeap)
+        cl->SetGraphicsRootDescriptorTable(kRootBindlessTable, g_descriptors.Gpu(0));
+    cl->SetGraphicsRootConstantBufferView(kRootFrameConstants, g_frameConstants);
+    cl->SetGraphicsRoot32BitConstant(kRootDrawConstants, g_instanceSrv, 0);
+    cl->SetGraphicsRoot32BitConstant(kRootDrawConstants, DescriptorHeap::kInvalid, 4);   // no visible list
+    cl->SetGraphicsRoot32BitConstant(kRootDrawConstants, g_meshTableSrv, 5);
+    cl->SetGraphicsRoot32BitConstant(kRootDrawConstants, g_prevWorldSrv, 9);
 
-// ---------------------------------
-// Root signature & PSO
-// ---------------------------------
-static ComPtr<ID3D12RootSignature>   g_rootSig;
-static ComPtr<ID3D12PipelineState>   g_pipelineState;
+    // Mesh shaders fetch their own vertices – the IA isn't part of that pipeline at all
+    if (g_meshShaders)
+    {
+        const UINT constants[3] = { g_geometrySrv, g_meshletSrv, (g_cullFlags & kCullFrustum) ? 1u : 0u };
+        cl->SetPipelineState(g_meshletPso.Get());
+        cl->SetGraphicsRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 6);
+        return;
+    }
+    cl->SetPipelineState(g_pipelineState.Get());
+    cl->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    cl->IASetVertexBuffers(0, 1, &g_vbView);
+    cl->IASetIndexBuffer(&g_ibView);
+}
 
-// ---------------------------------
-// Vertex buffer
-// ---------------------------------
-struct Vertex { float pos[3]; float col[4]; };
-static ComPtr<ID3D12Resource>        g_vertexBuffer;
-static D3D12_VERTEX_BUFFER_VIEW     g_vbView;
+// CPU path – one instanced draw per batch, or one meshlet dispatch
+void RecordDraws(ID3D12GraphicsCommandList* cl, UINT begin, UINT end)
+{
+    const std::vector<DrawBatch>& batches = g_batcher.Batches();
+    if (g_meshShaders)
+    {
+        ComPtr<ID3D12GraphicsCommandList6> cl6;
+        ThrowIfFailed(cl->QueryInterface(IID_PPV_ARGS(&cl6)));
+        for (UINT i = begin; i < end; ++i)
+        {
+            const DrawBatch& batch = batches[i];
+            const UINT constants[3] = { batch.firstInstance, batch.material, batch.mesh };
+            cl->SetGraphicsRoot32BitConstants(kRootDrawConstants, 3, constants, 1);
+            cl6->DispatchMesh(MeshletGroups(g_meshes[batch.mesh]), batch.instanceCount, 1);
+        }
+        return;
+    }
 
-// ---------------------------------------------------------------
-// Helper functions
-// ---------------------------------------------------------------
-inline void ThrowIfFailed(HRESULT hr)
+    for (UINT i = begin; i < end; ++i)
+    {
+        const DrawBatch& batch = batches[i];
+        const Mesh&      mesh  = g_meshes[batch.mesh];
+
+        const UINT constants[3] = { batch.firstInstance, batch.material, batch.mesh };
+        cl->SetGraphicsRoot32BitConstants(kRootDrawConstants, 3, constants, 1);
+        cl->DrawIndexedInstanced(mesh.indexCount, batch.instanceCount, mesh.firstIndex, (INT)mesh.firstVertex, 0);
+    }
+}
+
+// Heap + root signature for compute work on the direct queue
+void SetComputeState(ID3D12GraphicsCommandList* cl)
 {
-    if (FAILED(hr))
-        throw std::runtime_error("HRESULT failed");
+    ID3D12DescriptorHeap* heaps[] = { g_descriptors.Heap() };
+    cl->SetDescriptorHeaps(1, heaps);
+    cl->SetComputeRootSignature(g_rootSig.Get());
+    if (!g_bindlessHeap)
+        cl->SetComputeRootDescriptorTable(kRootBindlessTable, g_descriptors.Gpu(0));
+    cl->SetComputeRootConstantBufferView(kRootFrameConstants, g_frameConstants);
 }
 
-ComPtr<ID3DBlob> CompileShader(const char* src, const char* entry, const char* target)
+// GPU path – the CPU only uploads the batch table. Compute passes cull every
+// instance, compact the survivors per batch and write one draw per non-empty
+// batch; a single ExecuteIndirect (RecordIndirectScene) then draws however
+// many came out. The graph moves args/counters/visible list in between.
+void RecordCull(ID3D12GraphicsCommandList* cl)
 {
-    UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
-#if defined(_DEBUG)
-    flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
-    ComPtr<ID3DBlob> byteCode, errors;
-    HRESULT hr = D3DCompile(src, strlen(src), nullptr, nullptr,
-                            nullptr, entry, target, flags, 0,
-                            &byteCode, &errors);
-    if (FAILED(hr))
+    const std::vector<DrawBatch>& batches    = g_batcher.Batches();
+    const UINT                    batchCount = (UINT)batches.size();
+    if (batchCount > kMaxBatches)
+        throw std::runtime_error("Too many draw batches for the indirect argument buffer");
+    if (batchCount == 0)
+        return;
+
+    FrameAllocation table = AllocFrameUpload(batchCount * sizeof(GpuBatch));
+    GpuBatch*       dst   = reinterpret_cast<GpuBatch*>(table.cpu);
+    for (UINT i = 0; i < batchCount; ++i)
+    {
+        const Mesh& mesh = g_meshes[batches[i].mesh];
+        dst[i] = { mesh.indexCount, mesh.firstIndex, batches[i].firstInstance,
+                   batches[i].instanceCount, batches[i].material, mesh.firstVertex, batches[i].mesh, MeshletGroups(mesh),
+                   { mesh.boundsCenter[0], mesh.boundsCenter[1], mesh.boundsCenter[2] }, mesh.boundsRadius };
+    }
+    const UINT tableSrv = g_descriptors.AllocateTransient();
+    g_descriptors.CreateRawBufferSrv(tableSrv, table.resource, table.offset, batchCount * sizeof(GpuBatch));
+
+    const UINT instanceCount = g_batcher.InstanceCount();
+    const UINT constants[9] =
     {
-        if (errors) OutputDebugStringA((char*)errors->GetBufferPointer());
-        throw std::runtime_error("Shader compilation failed");
+        g_instanceSrv, tableSrv, batchCount,
+        g_visibleUav, g_cullCountersUav, g_indirectArgsUav,
+        g_hizSrv, g_cullFlags | (g_meshShaders ? kCullMeshArgs : 0u), instanceCount,
+    };
+    {
+        PROFILE_GPU_SCOPE(cl, "Cull");
+        SetComputeState(cl);
+        cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+
+        D3D12_RESOURCE_BARRIER counterUav = UavBarrier(g_cullCounters->resource.Get());
+        cl->SetPipelineState(g_cullClearPso.Get());
+        cl->Dispatch((batchCount + 1 + 63) / 64, 1, 1);
+        cl->ResourceBarrier(1, &counterUav);
+        cl->SetPipelineState(g_cullPso.Get());
+        cl->Dispatch((instanceCount + 63) / 64, 1, 1);
+        cl->ResourceBarrier(1, &counterUav);
+        cl->SetPipelineState(g_cullArgsPso.Get());
+        cl->Dispatch((batchCount + 63) / 64, 1, 1);
     }
-    return byteCode;
 }
 
-// ---------------------------------------------------------------
-// Device / SwapChain creation
-// ---------------------------------------------------------------
-void InitD3D12(HWND hwnd)
+// Draw – counters[0] says how many of the batchCount records are real
+void RecordIndirectScene(ID3D12GraphicsCommandList* cl, D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle)
 {
-    // Factory
-    ComPtr<IDXGIFactory6> factory;
-    ThrowIfFailed(CreateDXGIFactory1(IID_PPV_ARGS(&factory)));
+    const UINT batchCount = (UINT)g_batcher.Batches().size();
+    if (batchCount == 0)
+        return;
 
-    // Device
-    ThrowIfFailed(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0,
-                                    IID_PPV_ARGS(&g_device)));
-
-    // Command queue
-    D3D12_COMMAND_QUEUE_DESC queueDesc{};
-    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-    ThrowIfFailed(g_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&g_commandQueue)));
+    PROFILE_GPU_SCOPE(cl, "Scene");
+    SetDrawState(cl, rtvHandle);
+    cl->SetGraphicsRoot32BitConstant(kRootDrawConstants, g_visibleSrv, 4);
+    cl->ExecuteIndirect(g_meshShaders ? g_meshSignature.Get() : g_drawSignature.Get(), batchCount,
+                        g_indirectArgs->resource.Get(), 0, g_cullCounters->resource.Get(), 0);
+}
 
-    // Swap chain
-    DXGI_SWAP_CHAIN_DESC1 swapDesc{};
-    swapDesc.BufferCount       = 2;
-    swapDesc.Width             = 800;
-    swapDesc.Height            = 600;
-    swapDesc.Format            = DXGI_FORMAT_R8G8B8A8_UNORM;
-    swapDesc.BufferUsage       = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapDesc.SwapEffect        = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    swapDesc.SampleDesc.Count  = 1;
-
-    ComPtr<IDXGISwapChain1> swapChain1;
-    ThrowIfFailed(factory->CreateSwapChainForHwnd(
-        g_commandQueue.Get(),
-        hwnd,
-        &swapDesc,
-        nullptr,
-        nullptr,
-        &swapChain1));
-
-    ThrowIfFailed(swapChain1.As(&g_swapChain));
-    g_frameIndex = g_swapChain->GetCurrentBackBufferIndex();
-
-    // RTV heap
-    D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{};
-    rtvHeapDesc.NumDescriptors = swapDesc.BufferCount;
-    rtvHeapDesc.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-    rtvHeapDesc.Flags          = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-    ThrowIfFailed(g_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&g_rtvHeap)));
-
-    // Render target views
-    UINT rtvSize = g_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = g_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-    for (UINT i = 0; i < 2; ++i)
-    {
-        ThrowIfFailed(g_swapChain->GetBuffer(i, IID_PPV_ARGS(&g_renderTargets[i])));
-        g_device->CreateRenderTargetView(g_renderTargets[i].Get(), nullptr, rtvHandle);
-        rtvHandle.ptr += rtvSize;
-    }
-
-    // Command allocator & list
-    ThrowIfFailed(g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                                   IID_PPV_ARGS(&g_commandAllocator)));
-    ThrowIfFailed(g_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                              g_commandAllocator.Get(), nullptr,
-                                              IID_PPV_ARGS(&g_commandList)));
-    g_commandList->Close();
+// One thread per cluster, each keeps the lights that reach into its box
+void RecordLightBin(ID3D12GraphicsCommandList* cl)
+{
+    PROFILE_GPU_SCOPE(cl, "LightBin");
+    SetComputeState(cl);
+    cl->SetComputeRoot32BitConstant(kRootDrawConstants, g_lightClustersUav, 0);
+    cl->SetPipelineState(g_lightBinPso.Get());
+    cl->Dispatch((kClusterCount + 63) / 64, 1, 1);
+}
 
-    // Fence
-    ThrowIfFailed(g_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&g_fence)));
-    g_fenceValue = 1;
-    g_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-    if (!g_fenceEvent) throw std::runtime_error("Failed to create fence event");
+// Spectrum at this frame's time, inverse FFT rows then columns (ping-ponging the two
+// spectrum buffers), then displacement + slopes – one pass, UAV barriers between
+void RecordOceanWaves(ID3D12GraphicsCommandList* cl)
+{
+    PROFILE_GPU_SCOPE(cl, "OceanWaves");
+    SetComputeState(cl);
+    const UINT groups = Ocean::kSize / 8;
 
-    // ----------------------------------------------------------------
-    // New objects – root signature, PSO and vertex buffer
-    // ----------------------------------------------------------------
+    D3D12_RESOURCE_BARRIER uavs[2] = { UavBarrier(g_ocean.Spectrum(0)), UavBarrier(g_ocean.Spectrum(1)) };
+    const UINT spectrum[2] = { g_ocean.H0Srv(), g_ocean.SpectrumUav(0) };
+    cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(spectrum), spectrum, 0);
+    cl->SetPipelineState(g_oceanSpectrumPso.Get());
+    cl->Dispatch(groups, groups, 1);
+    cl->ResourceBarrier(2, uavs);
 
-    /* Root signature */
+    // One group per line; rows 0 -> 1, columns 1 -> 0
+    cl->SetPipelineState(g_oceanFftPso.Get());
+    for (UINT pass = 0; pass < 2; ++pass)
     {
-        D3D12_ROOT_SIGNATURE_DESC desc{};
-        desc.NumParameters = 0;
-        desc.pParameters   = nullptr;
-        desc.Flags         = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+        const UINT fft[3] = { g_ocean.SpectrumUav(pass), g_ocean.SpectrumUav(pass ^ 1), pass };
+        cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(fft), fft, 0);
+        cl->Dispatch(Ocean::kSize, 1, 1);
+        cl->ResourceBarrier(2, uavs);
+    }
 
-        ComPtr<ID3DBlob> signatureBlob, errorBlob;
-        HRESULT hr = D3D12SerializeRootSignature(&desc,
-                                                 D3D_ROOT_SIGNATURE_VERSION_1,
-                                                 &signatureBlob, &errorBlob);
-        if (FAILED(hr))
-            throw std::runtime_error("Failed to serialize root signature");
+    const UINT finalize[3] = { g_ocean.SpectrumUav(0), g_ocean.DisplacementUav(), g_ocean.SlopesUav() };
+    cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(finalize), finalize, 0);
+    cl->SetPipelineState(g_oceanFinalizePso.Get());
+    cl->Dispatch(groups, groups, 1);
+}
 
-        ThrowIfFailed(g_device->CreateRootSignature(
-            0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(),
-            IID_PPV_ARGS(&g_rootSig)));
-    }
+// Surface heights under this frame's floating bodies, into the results buffer
+void RecordOceanQuery(ID3D12GraphicsCommandList* cl)
+{
+    if (g_oceanQueryCount == 0)
+        return;
+    PROFILE_GPU_SCOPE(cl, "OceanQuery");
+    SetComputeState(cl);
+    const UINT constants[4] = { g_oceanQuerySrv, g_oceanQueryCount, g_ocean.ResultsUav(), g_ocean.DisplacementSrv() };
+    cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+    cl->SetPipelineState(g_oceanQueryPso.Get());
+    cl->Dispatch((g_oceanQueryCount + 63) / 64, 1, 1);
+}
 
-    /* Shaders */
-    const char* vsSource = R"(
-struct VSInput
+// Clipmap tiles around the camera, frustum culled, and the instance count of the draw
+void RecordOceanTiles(ID3D12GraphicsCommandList* cl)
 {
-    float3 pos : POSITION;
-    float4 col : COLOR0;
-};
+    PROFILE_GPU_SCOPE(cl, "OceanTiles");
+    SetComputeState(cl);
+    const UINT constants[2] = { g_ocean.TilesUav(), g_ocean.TileArgsUav() };
+    cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+    cl->SetPipelineState(g_oceanTilesPso.Get());
+    cl->Dispatch(1, 1, 1);
+}
 
-struct PSOutput
+// One instanced draw, one instance per tile TilesCS kept
+void RecordOcean(ID3D12GraphicsCommandList* cl, D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle)
 {
-    float4 pos : SV_POSITION;
-    float4 col : COLOR0;
-};
+    PROFILE_GPU_SCOPE(cl, "Ocean");
+    SetDrawState(cl, rtvHandle);
+    const UINT constants[3] = { g_ocean.TilesSrv(), g_ocean.DisplacementSrv(), g_ocean.SlopesSrv() };
+    cl->SetGraphicsRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+    cl->SetPipelineState(g_oceanPso.Get());
+    cl->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    cl->ExecuteIndirect(g_oceanSignature.Get(), 1, g_ocean.TileArgs(), 0, nullptr, 0);
+}
 
-PSOutput main(VSInput input)
+// Reduces this frame's depth into the HiZ pyramid next frame's culling tests against
+void BuildHiZ(ID3D12GraphicsCommandList* cl, UINT depthSrv)
 {
-    PSOutput output;
-    output.pos = float4(input.pos, 1.0);
-    output.col = input.col;
-    return output;
+    PROFILE_GPU_SCOPE(cl, "HiZ");
+    ID3D12Resource* hiz = g_hiz->resource.Get();
+    SetComputeState(cl);
+    cl->SetPipelineState(g_hizPso.Get());
+
+    // Only the area rendered this frame; next frame's culling is told its size
+    g_hizWidth  = g_renderWidth;
+    g_hizHeight = g_renderHeight;
+
+    UINT srcWidth = g_hizWidth, srcHeight = g_hizHeight;
+    for (UINT mip = 0; mip < g_hizMips; ++mip)
+    {
+        const UINT dstWidth  = max(g_hizWidth >> mip, 1u);
+        const UINT dstHeight = max(g_hizHeight >> mip, 1u);
+        const UINT constants[7] =
+        {
+            mip == 0 ? depthSrv : g_hizUavs[mip - 1], g_hizUavs[mip],
+            srcWidth, srcHeight, dstWidth, dstHeight, mip == 0 ? 1u : 0u,
+        };
+        cl->SetComputeRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+        cl->Dispatch((dstWidth + 7) / 8, (dstHeight + 7) / 8, 1);
+
+        // Next mip reads this one
+        D3D12_RESOURCE_BARRIER uav = UavBarrier(hiz);
+        cl->ResourceBarrier(1, &uav);
+        srcWidth  = dstWidth;
+        srcHeight = dstHeight;
+    }
+    g_hizValid = true;
 }
-)";
 
-    const char* psSource = R"(
-struct PSInput
+// Profiler stats over the back buffer – CPU and GPU milliseconds per scope
+void RecordOverlay(ID3D12GraphicsCommandList* cl, D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle)
 {
-    float4 pos : SV_POSITION;
-    float4 col : COLOR0;
-};
+    if (!g_showOverlay)
+        return;
+
+    const std::vector<Profiler::Stat>& stats = g_profiler.Stats();
+    const float lineHeight = (float)DebugOverlay::kLineHeight;
+    const double frameMs   = g_profiler.FrameMs();
+
+    g_overlay.Clear();
+    g_overlay.Rect(4.0f, 4.0f, 256.0f, lineHeight * (float)(stats.size() + (g_hotReloadEnabled ? 14 : 13)) + 6.0f, 0xb0000000);
+    float y = 8.0f;
+    g_overlay.Text(8.0f, y, 0xffffffff, "FRAME %6.2f MS %5.0f FPS", frameMs, frameMs > 0.0 ? 1000.0 / frameMs : 0.0);
+    y += lineHeight;
+    g_overlay.Text(8.0f, y, 0xffffffff, "RES %ux%u %3.0f%%%s %s %s %s", g_renderWidth, g_renderHeight,
+                   100.0f * (float)g_renderWidth / (float)g_targetWidth, g_dynamicRes ? " DYN" : "",
+                   SimdLevelName(ActiveSimdLevel()), g_meshShaders ? "MESHLET" : "IA",
+                   g_upscaler ? g_upscaler->Name() : "NO AA");
+    y += lineHeight;
+    g_overlay.Text(8.0f, y, 0xffffffff, "GPU %u %s FL%u_%u SM%u_%u RB%u%s%s%s%s", g_adapterIndex, DeviceTierName(g_tier),
+                   (UINT)g_caps.featureLevel >> 12, ((UINT)g_caps.featureLevel >> 8) & 0xf,
+                   (UINT)g_caps.shaderModel >> 4, (UINT)g_caps.shaderModel & 0xf, (UINT)g_caps.bindingTier,
+                   g_caps.enhancedBarriers ? " EB" : "", g_caps.uma ? " UMA" : "", g_caps.gpuUploadHeap ? " REBAR" : "",
+                   g_capsCached ? " CACHED" : "");
+    y += lineHeight;
+    const RenderGraph::Stats& graph = g_renderGraph.GetStats();
+    g_overlay.Text(8.0f, y, 0xffffffff, "PASS %u/%u BARR %u MEM %.1f/%.1fMB",
+                   graph.passes - graph.culledPasses, graph.passes, graph.barriers,
+                   graph.transientBytes / (1024.0 * 1024.0), graph.unaliasedBytes / (1024.0 * 1024.0));
+    y += lineHeight;
+    const PhysicsWorld::Stats& physics = g_physicsStats;
+    g_overlay.Text(8.0f, y, 0xffffffff, "PHYS AWAKE %u/%u CON %u ISL %u", physics.awake, physics.bodies,
+                   physics.contacts, physics.islands);
+    y += lineHeight;
+    g_overlay.Text(8.0f, y, 0xffffffff, "INPUT %5.2f MS DROP %u", g_inputLatencyMs, g_input.Dropped());
+    y += lineHeight;
+    g_overlay.Text(8.0f, y, g_frameAllocs && g_warmFrames > kAllocWarmupFrames ? 0xff8080ff : 0xffffffff,
+                   "ALLOC %u/FRAME UPLOAD %.1f/%.0fMB", (UINT)g_frameAllocs,
+                   g_uploadHighWater / (1024.0 * 1024.0), kFrameUploadSize / (1024.0 * 1024.0));
+    y += lineHeight;
+    const AssetStreamer::Stats io = g_assets.GetStats();
+    g_overlay.Text(8.0f, y, 0xffffffff, "IO %s PEND %u %.1f/%.1fMB", g_assets.Backend(), io.pending,
+                   io.bytesLoaded / (1024.0 * 1024.0), io.bytesRequested / (1024.0 * 1024.0));
+    y += lineHeight;
+    const TextureStreamer::Stats tex = g_textures.GetStats();
+    g_overlay.Text(8.0f, y, 0xffffffff, "TEX %u PEND %u %.0f/%.0fMB EVICT %u", tex.textures, tex.pendingLoads,
+                   tex.residentBytes / (1024.0 * 1024.0), tex.budgetBytes / (1024.0 * 1024.0), (UINT)tex.evictions);
+    y += lineHeight;
+    g_overlay.Text(8.0f, y, 0xffffffff, "LIGHTS %u CLUSTERS %ux%ux%u%s", g_lightCount, kClustersX, kClustersY,
+                   kClustersZ, g_night ? " NIGHT" : "");
+    y += lineHeight;
+    const Ocean::Stats ocean = g_ocean.GetStats();
+    g_overlay.Text(8.0f, y, 0xffffffff, "OCEAN %u/%u QUERIES %.1fms BEHIND %s", ocean.resolved, ocean.queries,
+                   ocean.latency * 1000.0f, !g_oceanEnabled ? "OFF" : g_oceanAsync ? "ASYNC" : "DIRECT");
+    y += lineHeight;
+    g_overlay.Text(8.0f, y, 0xffffffff, "START %.0f MS INIT %.0f FIRST %.0f%s", g_startup.loadingFrame, g_startup.init,
+                   g_startup.firstFrame, g_serialInit ? " SERIAL" : "");
+    y += lineHeight;
+    if (g_hotReloadEnabled)
+    {
+        const HotReload::Stats reload = g_hotReload.GetStats();
+        g_overlay.Text(8.0f, y, reload.failed ? 0xff6060ff : 0xffffffff, "RELOAD %u FAIL %u %s", reload.reloads,
+                       reload.failures, reload.failed ? reload.error : reload.pending ? "PENDING" : "");
+        y += lineHeight;
+    }
+    g_overlay.Text(8.0f, y, 0xff80ffff, "%-14s %7s %7s", "SCOPE", "CPU", "GPU");
+    y += lineHeight;
+    for (const Profiler::Stat& stat : stats)
+    {
+        char cpu[16] = "-", gpu[16] = "-";
+        if (stat.cpu) snprintf(cpu, sizeof(cpu), "%.2f", stat.cpuMs);
+        if (stat.gpu) snprintf(gpu, sizeof(gpu), "%.2f", stat.gpuMs);
+        g_overlay.Text(8.0f, y, 0xffffffff, "%-14.14s %7s %7s", stat.name, cpu, gpu);
+        y += lineHeight;
+    }
+
+    const std::vector<OverlayQuad>& quads = g_overlay.Quads();
+    const UINT64    bytes  = quads.size() * sizeof(OverlayQuad);
+    FrameAllocation upload = AllocFrameUpload(bytes);
+    memcpy(upload.cpu, quads.data(), bytes);
+    const UINT quadSrv = g_descriptors.AllocateTransient();
+    g_descriptors.CreateRawBufferSrv(quadSrv, upload.resource, upload.offset, bytes);
+
+    PROFILE_GPU_SCOPE(cl, "Overlay");
+    D3D12_VIEWPORT vp{0.0f, 0.0f, (float)g_swapChain.Width(), (float)g_swapChain.Height(), 0.0f, 1.0f};
+    D3D12_RECT   scissor{0, 0, (LONG)g_swapChain.Width(), (LONG)g_swapChain.Height()};
+    cl->RSSetViewports(1, &vp);
+    cl->RSSetScissorRects(1, &scissor);
+    cl->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
 
-float4 main(PSInput input) : SV_TARGET
+    ID3D12DescriptorHeap* heaps[] = { g_descriptors.Heap() };
+    cl->SetDescriptorHeaps(1, heaps);
+    cl->SetGraphicsRootSignature(g_rootSig.Get());
+    if (!g_bindlessHeap)
+        cl->SetGraphicsRootDescriptorTable(kRootBindlessTable, g_descriptors.Gpu(0));
+    cl->SetPipelineState(g_overlayPso.Get());
+    cl->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    const float viewport[2] = { vp.Width, vp.Height };
+    UINT constants[3] = { quadSrv };
+    memcpy(&constants[1], viewport, sizeof(viewport));
+    cl->SetGraphicsRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+    cl->DrawInstanced(6, (UINT)quads.size(), 0, 0);
+}
+
+// Jittered scene + motion -> the upscaler's output, full size
+void RecordTemporal(ID3D12GraphicsCommandList* cl, ID3D12Resource* color, ID3D12Resource* depth, ID3D12Resource* motion)
 {
-    return input.col;
+    PROFILE_GPU_SCOPE(cl, "Temporal");
+    SetComputeState(cl);
+    TemporalInputs inputs = g_temporalInputs;
+    inputs.color     = color;
+    inputs.depth     = depth;
+    inputs.motion    = motion;
+    inputs.colorSrv  = g_sceneColorSrv;
+    inputs.depthSrv  = g_sceneDepthSrv;
+    inputs.motionSrv = g_sceneMotionSrv;
+    g_upscaler->Record(cl, inputs);
 }
-)";
 
-    auto vsBlob = CompileShader(vsSource, "main", "vs_5_0");
-    auto psBlob = CompileShader(psSource, "main", "ps_5_0");
+// Scene colour (render size, top-left) -> whole back buffer, bilinear;
+// `width` x `height` is the part of the source that's covered – the render size, or all of it after TAA
+void RecordUpscale(ID3D12GraphicsCommandList* cl, D3D12_CPU_DESCRIPTOR_HANDLE rtv, UINT sourceSrv, UINT width, UINT height)
+{
+    PROFILE_GPU_SCOPE(cl, "Upscale");
+    D3D12_VIEWPORT vp{0.0f, 0.0f, (float)g_swapChain.Width(), (float)g_swapChain.Height(), 0.0f, 1.0f};
+    D3D12_RECT   scissor{0, 0, (LONG)g_swapChain.Width(), (LONG)g_swapChain.Height()};
+    cl->RSSetViewports(1, &vp);
+    cl->RSSetScissorRects(1, &scissor);
+    cl->OMSetRenderTargets(1, &rtv, FALSE, nullptr);
+
+    ID3D12DescriptorHeap* heaps[] = { g_descriptors.Heap() };
+    cl->SetDescriptorHeaps(1, heaps);
+    cl->SetGraphicsRootSignature(g_rootSig.Get());
+    if (!g_bindlessHeap)
+        cl->SetGraphicsRootDescriptorTable(kRootBindlessTable, g_descriptors.Gpu(0));
+    cl->SetPipelineState(g_upscalePso.Get());
+    cl->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    /* PSO */
+    // uv scale picks out the rendered corner, the clamp keeps bilinear taps off the stale texels past it
+    const float uv[4] =
     {
-        D3D12_INPUT_ELEMENT_DESC inputLayout[] =
-        {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,
-              offsetof(Vertex, pos), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        (float)width / (float)g_targetWidth,
+        (float)height / (float)g_targetHeight,
+        ((float)width - 0.5f) / (float)g_targetWidth,
+        ((float)height - 0.5f) / (float)g_targetHeight,
+    };
+    UINT constants[5] = { sourceSrv };
+    memcpy(&constants[1], uv, sizeof(uv));
+    cl->SetGraphicsRoot32BitConstants(kRootDrawConstants, _countof(constants), constants, 0);
+    cl->DrawInstanced(3, 1, 0, 0);
+}
 
-            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0,
-              offsetof(Vertex, col), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-        };
+// Between frames – WM_SIZE only records the new size. A drag sends many; the latest wins.
+void ApplyPendingResize()
+{
+    const uint32_t size   = g_pendingSize.exchange(0);
+    const UINT     width  = size >> 16;
+    const UINT     height = size & 0xffff;
+    if (!size || (width == g_swapChain.Width() && height == g_swapChain.Height()))
+        return;
 
-        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{};
-        psoDesc.InputLayout       = { inputLayout, _countof(inputLayout) };
-        psoDesc.pRootSignature    = g_rootSig.Get();
-        psoDesc.VS                = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
-        psoDesc.PS                = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
-        psoDesc.RasterizerState   = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-        psoDesc.BlendState        = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-        psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
-        psoDesc.SampleMask        = UINT_MAX;
-        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-        psoDesc.NumRenderTargets  = 1;
-        psoDesc.RTVFormats[0]     = DXGI_FORMAT_R8G8B8A8_UNORM;
-        psoDesc.SampleDesc.Count  = 1;
+    WaitForGpu();   // back buffers and scene targets may still be referenced
+    g_swapChain.Resize(width, height);
+    g_frameIndex = g_swapChain.CurrentIndex();
+    ReleaseHiZ();
+    CreateHiZ(g_swapChain.Width(), g_swapChain.Height());
+    if (g_upscaler)
+        g_upscaler->Resize(g_targetWidth, g_targetHeight);
+    g_taaReset   = true;
+    g_warmFrames = 0;
+}
+
+// This frame's passes. Transients are placed by Compile(), so their views
+// are (re)written right after it – RTV/DSV descriptors are consumed at
+// record time, so one of each is enough.
+void BuildRenderGraph(bool parallelScene)
+{
+    PROFILE_SCOPE("RenderGraph");
+    RenderGraph& graph = g_renderGraph;
+    graph.Reset(g_fence->GetCompletedValue());
+
+    const D3D12_CPU_DESCRIPTOR_HANDLE sceneRtv = g_sceneRtvHeap->GetCPUDescriptorHandleForHeapStart();
+    const D3D12_CPU_DESCRIPTOR_HANDLE dsv      = g_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+    const D3D12_CPU_DESCRIPTOR_HANDLE backRtv  = g_swapChain.Rtv(g_frameIndex);
+
+    // Full size – dynamic resolution only changes the viewport, so the placements stay put
+    D3D12_CLEAR_VALUE colorClear{};
+    colorClear.Format = SwapChain::kFormat;
+    memcpy(colorClear.Color, kClearColor, sizeof(kClearColor));
+    D3D12_CLEAR_VALUE depthClear{};
+    depthClear.Format             = DXGI_FORMAT_D32_FLOAT;
+    depthClear.DepthStencil.Depth = 1.0f;
+    const RenderGraph::Resource color = graph.CreateTexture(
+        "SceneColor", Texture2DDesc(SwapChain::kFormat, g_targetWidth, g_targetHeight, 1,
+                                    D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET), &colorClear);
+    // Typeless so the HiZ pass can read it as R32_FLOAT
+    const RenderGraph::Resource depth = graph.CreateTexture(
+        "SceneDepth", Texture2DDesc(DXGI_FORMAT_R32_TYPELESS, g_targetWidth, g_targetHeight, 1,
+                                    D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL), &depthClear);
+    // Zero where nothing draws – the background doesn't move
+    const D3D12_CPU_DESCRIPTOR_HANDLE motionRtv{ sceneRtv.ptr + g_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV) };
+    D3D12_CLEAR_VALUE motionClear{};
+    motionClear.Format = DXGI_FORMAT_R16G16_FLOAT;
+    RenderGraph::Resource motion = 0;
+    if (g_taa)
+        motion = graph.CreateTexture("SceneMotion", Texture2DDesc(DXGI_FORMAT_R16G16_FLOAT, g_targetWidth, g_targetHeight, 1,
+                                                                  D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET), &motionClear);
+
+    const RenderGraph::Resource back = graph.Import("BackBuffer", g_swapChain.BackBuffer(g_frameIndex),
+                                                    D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+    const RenderGraph::Resource hiz  = graph.Import("HiZ", g_hiz->resource.Get(),
+                                                    D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+                                                    D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+
+    // Clear – whole targets, cheaper than a rect clear and keeps fast-clear metadata intact
+    RenderGraph::PassBuilder clear = graph.AddPass("Clear", [=](ID3D12GraphicsCommandList* cl)
+    {
+        cl->ClearRenderTargetView(sceneRtv, kClearColor, 0, nullptr);
+        cl->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+        if (g_taa)
+            cl->ClearRenderTargetView(motionRtv, motionClear.Color, 0, nullptr);
+    }).Write(color, D3D12_RESOURCE_STATE_RENDER_TARGET).Write(depth, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+    if (g_taa)
+        clear.Write(motion, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // Texture feedback – cleared before the scene, min'd into by its pixels, copied back after
+    const bool            textured = g_textures.Enabled();
+    RenderGraph::Resource feedback = 0;
+    if (textured)
+    {
+        feedback = graph.Import("TextureFeedback", g_textures.FeedbackBuffer(), D3D12_RESOURCE_STATE_COMMON);
+        graph.AddPass("FeedbackReset", [](ID3D12GraphicsCommandList* cl) { g_textures.RecordFeedbackReset(cl); })
+            .Write(feedback, D3D12_RESOURCE_STATE_COPY_DEST);
+    }
+
+    // Lights binned for this frame's view; the scene's pixels read the result
+    const RenderGraph::Resource clusters = graph.Import("LightClusters", g_lightClusters->resource.Get(),
+                                                        D3D12_RESOURCE_STATE_COMMON);
+    graph.AddPass("LightBin", RecordLightBin)
+        .Write(clusters, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    // Ocean – waves and the buoyancy heights on the compute queue while the scene draws,
+    // the tiles on the direct queue since the tile list only depends on the camera
+    RenderGraph::Resource oceanTiles = 0, oceanArgs = 0, oceanDisplacement = 0, oceanSlopes = 0;
+    if (g_oceanEnabled)
+    {
+        const UINT async = g_oceanAsync ? RenderGraph::kPassAsyncCompute : 0;
+        const RenderGraph::Resource spectrum0 = graph.Import("OceanSpectrum0", g_ocean.Spectrum(0),
+                                                             D3D12_RESOURCE_STATE_COMMON);
+        const RenderGraph::Resource spectrum1 = graph.Import("OceanSpectrum1", g_ocean.Spectrum(1),
+                                                             D3D12_RESOURCE_STATE_COMMON);
+        const RenderGraph::Resource results   = graph.Import("OceanResults", g_ocean.Results(),
+                                                             D3D12_RESOURCE_STATE_COMMON);
+        oceanTiles        = graph.Import("OceanTiles", g_ocean.Tiles(), D3D12_RESOURCE_STATE_COMMON);
+        oceanArgs         = graph.Import("OceanTileArgs", g_ocean.TileArgs(), D3D12_RESOURCE_STATE_COMMON);
+        oceanDisplacement = graph.Import("OceanDisplacement", g_ocean.Displacement(),
+                                         D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+                                         D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        oceanSlopes       = graph.Import("OceanSlopes", g_ocean.Slopes(),
+                                         D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+                                         D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-        ThrowIfFailed(g_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&g_pipelineState)));
+        graph.AddPass("OceanWaves", RecordOceanWaves, async)
+            .Write(spectrum0, D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            .Write(spectrum1, D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            .Write(oceanDisplacement, D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            .Write(oceanSlopes, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        graph.AddPass("OceanQuery", RecordOceanQuery, async)
+            .Read(oceanDisplacement, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+            .Write(results, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        // Into this slot's readback – ResolveQueries() reads it when the slot comes round again
+        const UINT slot = g_frameSlot;
+        graph.AddPass("OceanReadback", [slot](ID3D12GraphicsCommandList* cl)
+        {
+            g_ocean.RecordQueryReadback(cl, slot);
+        }, RenderGraph::kPassNeverCull | async)
+            .Read(results, D3D12_RESOURCE_STATE_COPY_SOURCE);
+        graph.AddPass("OceanTiles", RecordOceanTiles)
+            .Write(oceanTiles, D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            .Write(oceanArgs, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
     }
 
-    /* Vertex buffer */
+    if (g_useIndirect)
+    {
+        // Buffers decay back to COMMON after every ExecuteCommandLists, so that's where they start
+        const RenderGraph::Resource args     = graph.Import("IndirectArgs", g_indirectArgs->resource.Get(),
+                                                            D3D12_RESOURCE_STATE_COMMON);
+        const RenderGraph::Resource counters = graph.Import("CullCounters", g_cullCounters->resource.Get(),
+                                                            D3D12_RESOURCE_STATE_COMMON);
+        const RenderGraph::Resource visible  = graph.Import("VisibleInstances", g_visibleInstances->resource.Get(),
+                                                            D3D12_RESOURCE_STATE_COMMON);
+
+        graph.AddPass("Cull", RecordCull)
+            .Read(hiz, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+            .Write(args, D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            .Write(counters, D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            .Write(visible, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        RenderGraph::PassBuilder scene =
+            graph.AddPass("Scene", [=](ID3D12GraphicsCommandList* cl) { RecordIndirectScene(cl, sceneRtv); })
+                .Read(args, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT)
+                .Read(counters, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT)
+                .Read(visible, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+                .Read(clusters, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+                .Write(color, D3D12_RESOURCE_STATE_RENDER_TARGET)
+                .Write(depth, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        if (textured)
+            scene.Write(feedback, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        if (g_taa)
+            scene.Write(motion, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+    else
     {
-        Vertex vertices[] =
+        // Recorded by Render() across the job system when it's big enough
+        RenderGraph::PassBuilder scene = graph.AddPass("Scene", [=](ID3D12GraphicsCommandList* cl)
         {
-            { { 0.0f,  0.5f, 0.0f }, {1.f, 0.f, 0.f, 1.f} },
-            { {-0.5f,-0.5f, 0.0f }, {0.f, 1.f, 0.f, 1.f} },
-            { { 0.5f,-0.5f, 0.0f }, {0.f, 0.f, 1.f, 1.f} }
-        };
-        const UINT vbSize = sizeof(vertices);
+            SetDrawState(cl, sceneRtv);
+            PROFILE_GPU_SCOPE(cl, "Scene");
+            RecordDraws(cl, 0, (UINT)g_batcher.Batches().size());
+        }, parallelScene ? RenderGraph::kPassExternal : 0)
+            .Read(clusters, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+            .Write(color, D3D12_RESOURCE_STATE_RENDER_TARGET)
+            .Write(depth, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        if (textured)
+            scene.Write(feedback, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        if (g_taa)
+            scene.Write(motion, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+
+    // After the scene so early-Z skips what the ships and crates cover
+    if (g_oceanEnabled)
+    {
+        RenderGraph::PassBuilder ocean =
+            graph.AddPass("Ocean", [=](ID3D12GraphicsCommandList* cl) { RecordOcean(cl, sceneRtv); })
+                .Read(oceanTiles, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+                .Read(oceanArgs, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT)
+                .Read(oceanDisplacement, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+                .Read(oceanSlopes, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+                .Read(clusters, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+                .Write(color, D3D12_RESOURCE_STATE_RENDER_TARGET)
+                .Write(depth, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        if (g_taa)
+            ocean.Write(motion, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+
+    // Compute only and nothing after it needs it this frame – overlaps upscale and overlay.
+    // After the ocean, whose depth counts for occlusion too
+    if (g_useIndirect && (g_cullFlags & kCullOcclusion))
+    {
+        graph.AddPass("HiZ", [](ID3D12GraphicsCommandList* cl) { BuildHiZ(cl, g_sceneDepthSrv); },
+                      RenderGraph::kPassAsyncCompute)
+            .Read(depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+            .Write(hiz, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    }
 
-        D3D12_HEAP_PROPERTIES heapProps{};
-        heapProps.Type                 = D3D12_HEAP_TYPE_UPLOAD;
+    // Into this slot's readback – Update() reads it when the slot comes round again
+    if (textured)
+    {
+        const UINT slot = g_frameSlot;
+        graph.AddPass("FeedbackReadback", [slot](ID3D12GraphicsCommandList* cl)
+        {
+            g_textures.RecordFeedbackReadback(cl, slot);
+        }, RenderGraph::kPassNeverCull)
+            .Read(feedback, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    }
 
-        D3D12_RESOURCE_DESC bufferDesc{};
-        bufferDesc.Dimension         = D3D12_RESOURCE_DIMENSION_BUFFER;
-        bufferDesc.Width             = vbSize;
-        bufferDesc.Height            = 1;
-        bufferDesc.DepthOrArraySize  = 1;
-        bufferDesc.MipLevels         = 1;
-        bufferDesc.SampleDesc.Count  = 1;
-        bufferDesc.Layout            = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    // Temporal upscale: this frame's samples + the reprojected history, at full size. The blit
+    // to the back buffer after it is then 1:1 – the upscaler's output can't be a swap chain buffer
+    if (g_taa)
+    {
+        g_upscaler->BeginFrame();
+        const RenderGraph::Resource output = graph.Import("TemporalOutput", g_upscaler->Output(),
+                                                          D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+                                                          D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        graph.AddPass("Temporal", [=](ID3D12GraphicsCommandList* cl)
+        {
+            RecordTemporal(cl, g_renderGraph.GetResource(color), g_renderGraph.GetResource(depth),
+                           g_renderGraph.GetResource(motion));
+        })
+            .Read(color, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+            .Read(depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+            .Read(motion, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+            .Write(output, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        graph.AddPass("Upscale", [=](ID3D12GraphicsCommandList* cl)
+        {
+            RecordUpscale(cl, backRtv, g_upscaler->OutputSrv(), g_targetWidth, g_targetHeight);
+        })
+            .Read(output, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+            .Write(back, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+    else
+        graph.AddPass("Upscale", [=](ID3D12GraphicsCommandList* cl)
+        {
+            RecordUpscale(cl, backRtv, g_sceneColorSrv, g_renderWidth, g_renderHeight);
+        })
+            .Read(color, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+            .Write(back, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    if (g_showOverlay)
+        graph.AddPass("Overlay", [=](ID3D12GraphicsCommandList* cl) { RecordOverlay(cl, backRtv); })
+            .Write(back, D3D12_RESOURCE_STATE_RENDER_TARGET);
 
-        ThrowIfFailed(g_device->CreateCommittedResource(
-            &heapProps, D3D12_HEAP_FLAG_NONE,
-            &bufferDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&g_vertexBuffer)));
+    graph.Compile(g_fenceValue);
 
-        // Copy data
-        UINT8* pData;
-        CD3DX12_RANGE readRange(0, 0);
-        ThrowIfFailed(g_vertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pData)));
-        memcpy(pData, vertices, vbSize);
-        g_vertexBuffer->Unmap(0, nullptr);
+    g_device->CreateRenderTargetView(graph.GetResource(color), nullptr, sceneRtv);
+    if (g_taa)
+        g_device->CreateRenderTargetView(graph.GetResource(motion), nullptr, motionRtv);
+    D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
+    dsvDesc.Format        = DXGI_FORMAT_D32_FLOAT;
+    dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+    g_device->CreateDepthStencilView(graph.GetResource(depth), &dsvDesc, dsv);
 
-        // View
-        g_vbView.BufferLocation = g_vertexBuffer->GetGPUVirtualAddress();
-        g_vbView.StrideInBytes  = sizeof(Vertex);
-        g_vbView.SizeInElements = _countof(vertices);
+    D3D12_SHADER_RESOURCE_VIEW_DESC depthSrv{};
+    depthSrv.Format                  = DXGI_FORMAT_R32_FLOAT;
+    depthSrv.ViewDimension           = D3D12_SRV_DIMENSION_TEXTURE2D;
+    depthSrv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    depthSrv.Texture2D.MipLevels     = 1;
+    g_sceneColorSrv = g_descriptors.AllocateTransient();
+    g_sceneDepthSrv = g_descriptors.AllocateTransient();
+    g_descriptors.CreateTextureSrv(g_sceneColorSrv, graph.GetResource(color));
+    g_descriptors.CreateTextureSrv(g_sceneDepthSrv, graph.GetResource(depth), &depthSrv);
+    if (g_taa)
+    {
+        g_sceneMotionSrv = g_descriptors.AllocateTransient();
+        g_descriptors.CreateTextureSrv(g_sceneMotionSrv, graph.GetResource(motion));
     }
 }
 
 // ---------------------------------------------------------------
-// Rendering
+// Benchmark runs
 // ---------------------------------------------------------------
-void Render()
+// An init task after "Assets" – the streaming scene needs the archive and somewhere to read it to
+void InitBenchmark()
+{
+    if (!g_benchmark->streaming)
+        return;
+    if (!g_assets.IsOpen())
+        throw std::runtime_error("The streaming benchmark needs assets.pak – run tools/assetcook");
+
+    for (UINT i = 0; i < kMeshCount; ++i)
+        g_streamSlotSize = max(g_streamSlotSize, AlignUp(g_assets.Find(kSceneMeshNames[i])->size, 256));
+    g_streamScratch = g_gpuAllocator.CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, g_streamSlotSize * kStreamStressSlots,
+                                                  D3D12_RESOURCE_STATE_COMMON);
+    for (AssetStreamer::Handle& load : g_streamLoads)
+        load = AssetStreamer::kInvalid;
+}
+
+// Every slot whose last read landed gets the next mesh – low priority, real loads still go first
+void StressStreaming()
+{
+    for (UINT slot = 0; slot < kStreamStressSlots; ++slot)
+    {
+        AssetStreamer::Handle& load = g_streamLoads[slot];
+        if (load != AssetStreamer::kInvalid && !g_assets.IsReady(load))
+            continue;
+        const AssetPakEntry* entry = g_assets.Find(kSceneMeshNames[g_streamNext++ % kMeshCount]);
+        load = g_assets.Request(entry, g_streamScratch->resource.Get(), slot * g_streamSlotSize,
+                                AssetStreamer::kPriorityLow);
+    }
+}
+
+// Warms up until every mesh is resident and the frame has settled, then records
+void RecordBenchmarkFrame(const BenchmarkFrame& sample)
 {
-    const float clearColor[] = { 0.2f, 0.4f, 0.6f, 1.0f };
+    if (g_benchmarkWarm < kBenchmarkWarmup)
+    {
+        bool resident = true;
+        for (uint8_t meshResident : g_meshResident)
+            resident = resident && meshResident;
+        g_benchmarkWarm = resident ? g_benchmarkWarm + 1 : 0;
+        if (g_benchmarkWarm == kBenchmarkWarmup)
+        {
+            g_benchmarkRun.Begin(g_benchmarkFrames);
+            g_benchmarkPeaks                = {};
+            g_benchmarkPeaks.start          = Profiler::Now();
+            g_benchmarkPeaks.streamedBefore = g_assets.GetStats().bytesLoaded;
+        }
+        return;
+    }
 
-    ThrowIfFailed(g_commandAllocator->Reset());
-    ThrowIfFailed(g_commandList->Reset(g_commandAllocator.Get(), g_pipelineState.Get()));
+    g_benchmarkRun.AddFrame(sample);
+    const GpuMemoryStats gpu = g_gpuAllocator.GetStats();
+    BenchmarkPeaks&      peaks = g_benchmarkPeaks;
+    peaks.videoMemory = max(peaks.videoMemory, gpu.local.CurrentUsage);
+    peaks.gpuHeaps    = max(peaks.gpuHeaps, gpu.reservedBytes);
+    peaks.transients  = max(peaks.transients, g_renderGraph.GetStats().transientBytes);
+    const TextureStreamer::Stats textures = g_textures.GetStats();
+    peaks.texturePool     = max(peaks.texturePool, textures.poolBytes);
+    peaks.textureMapped   = max(peaks.textureMapped, textures.residentBytes);
+    peaks.heapAllocs  = max(peaks.heapAllocs, g_frameAllocs);
+    for (UINT i = 0; i < g_framesInFlight; ++i)
+        peaks.frameArena = max(peaks.frameArena, (UINT64)g_frames[i].arena.HighWater());
+}
 
-    // Viewport & scissor
-    D3D12_VIEWPORT vp{0.0f, 0.0f, 800.0f, 600.0f, 0.0f, 1.0f};
-    D3D12_RECT   scissor{0, 0, 800, 600};
-    g_commandList->RSSetViewports(1, &vp);
-    g_commandList->RSSetScissorRects(1, &scissor);
+// Render thread, once the run is complete
+void WriteBenchmarkResults()
+{
+    const double seconds = g_profiler.ToMs(Profiler::Now() - g_benchmarkPeaks.start) * 0.001;
 
-    // Render target
-    UINT rtvSize = g_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = g_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-    rtvHandle.ptr += g_frameIndex * rtvSize;
-    g_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    PROCESS_MEMORY_COUNTERS process{};
+    process.cb = sizeof(process);
+    GetProcessMemoryInfo(GetCurrentProcess(), &process, sizeof(process));
 
-    // Clear
-    g_commandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+    DXGI_ADAPTER_DESC1 adapterDesc{};
+    g_adapter->GetDesc1(&adapterDesc);
+    char adapter[256]{};
+    WideCharToMultiByte(CP_UTF8, 0, adapterDesc.Description, -1, adapter, sizeof(adapter) - 1, nullptr, nullptr);
 
-    // Draw triangle
-    g_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    g_commandList->IASetVertexBuffers(0, 1, &g_vbView);
-    g_commandList->DrawInstanced(3, 1, 0, 0);
+    // Everything that changes what a frame costs – benchcompare warns when these differ from the baseline
+    JsonWriter json;
+    json.Field("scene", g_benchmark->name);
+    json.BeginObject("config");
+    json.Field("adapter", adapter);
+    json.Field("tier", DeviceTierName(g_tier));
+    json.Field("width", g_swapChain.Width());
+    json.Field("height", g_swapChain.Height());
+    json.Field("instances", g_sceneInstances);
+    json.Field("bodies", g_physicsBodies);
+    json.Field("lights", g_lightCount);
+    json.Field("night", g_night);
+    json.Field("ocean", g_oceanEnabled);
+    json.Field("oceanAsync", g_oceanEnabled && g_oceanAsync);
+    json.Field("hotReload", g_hotReloadEnabled);
+    json.Field("offscreen", g_swapChain.Offscreen());
+    json.Field("vsync", !g_swapChain.Offscreen() && g_swapSettings.vsync);
+    json.Field("framesInFlight", g_framesInFlight);
+    json.Field("indirect", g_useIndirect);
+    json.Field("meshShaders", g_meshShaders);
+    json.Field("asyncCompute", g_asyncCompute.Enabled());
+    json.Field("renderScale", g_dynamicRes ? 0.0 : (double)g_renderScale);
+    json.Field("upscaler", g_upscaler ? g_upscaler->Name() : "none");
+    json.Field("jobThreads", g_jobs.ThreadCount());
+    json.Field("textures", g_textures.Enabled());
+    json.Field("textureBudget", (uint64_t)g_textures.GetStats().budgetBytes);
+    json.EndObject();
 
-    ThrowIfFailed(g_commandList->Close());
+    g_benchmarkRun.WriteTimings(json);
 
-    ID3D12CommandList* lists[] = { g_commandList.Get() };
-    g_commandQueue->ExecuteCommandLists(_countof(lists), lists);
+    json.BeginObject("memory");
+    json.Field("workingSetPeak", (uint64_t)process.PeakWorkingSetSize);
+    json.Field("commitPeak", (uint64_t)process.PeakPagefileUsage);
+    json.Field("videoMemoryPeak", (uint64_t)g_benchmarkPeaks.videoMemory);
+    json.Field("gpuHeapsPeak", (uint64_t)g_benchmarkPeaks.gpuHeaps);
+    json.Field("transientsPeak", (uint64_t)g_benchmarkPeaks.transients);
+    json.Field("texturePoolPeak", (uint64_t)g_benchmarkPeaks.texturePool);
+    json.Field("textureResidentPeak", (uint64_t)g_benchmarkPeaks.textureMapped);
+    json.Field("uploadPerFramePeak", (uint64_t)g_uploadHighWater);
+    json.Field("frameArenaPeak", (uint64_t)g_benchmarkPeaks.frameArena);
+    json.Field("heapAllocsPerFramePeak", g_benchmarkPeaks.heapAllocs);
+    json.EndObject();
 
-    ThrowIfFailed(g_swapChain->Present(1, 0));
+    // Once per run, not per frame – for the record, benchcompare doesn't gate on them
+    json.BeginObject("startup");
+    json.Field("loadingFrameMs", g_startup.loadingFrame);
+    json.Field("initMs", g_startup.init);
+    json.Field("firstFrameMs", g_startup.firstFrame);
+    json.Field("serialInit", g_serialInit);
+    json.EndObject();
 
-    // GPU‑CPU sync
-    ThrowIfFailed(g_commandQueue->Signal(g_fence.Get(), g_fenceValue));
-    if (g_fence->GetCompletedValue() < g_fenceValue)
+    if (g_benchmark->streaming)
     {
-        ThrowIfFailed(g_fence->SetEventOnCompletion(g_fenceValue, g_fenceEvent));
-        WaitForSingleObject(g_fenceEvent, INFINITE);
+        const UINT64 bytes = g_assets.GetStats().bytesLoaded - g_benchmarkPeaks.streamedBefore;
+        json.BeginObject("streaming");
+        json.Field("bytes", (uint64_t)bytes);
+        json.Field("mbPerSecond", seconds > 0.0 ? (double)bytes / (1024.0 * 1024.0) / seconds : 0.0);
+        json.EndObject();
     }
-    ++g_fenceValue;
-    g_frameIndex = g_swapChain->GetCurrentBackBufferIndex();
+
+    if (!json.Save(g_benchmarkOut.c_str()))
+        throw std::runtime_error("Can't write " + g_benchmarkOut);
+}
+
+void Render(const FramePacket& packet)
+{
+    const int64_t frameStart = Profiler::Now();
+    FrameContext& frame      = BeginFrame();
+    const int64_t workStart  = Profiler::Now();     // the fence wait isn't render thread work
+
+    // Rebuilt PSOs go in before anything is recorded – the whole frame sees one set
+    if (g_hotReload.Running())
+        g_hotReload.Apply(g_fenceValue, g_fence->GetCompletedValue());
+
+    // Last frame's GPU time drives this frame's scale
+    const float scale = g_dynamicRes ? g_dynRes.Update(g_profiler.GpuFrameMs()) : g_renderScale;
+    g_renderWidth  = min(g_targetWidth, max(8u, (UINT)(g_targetWidth * scale + 0.5f)));
+    g_renderHeight = min(g_targetHeight, max(8u, (UINT)(g_targetHeight * scale + 0.5f)));
+
+    if (g_benchmark && g_benchmark->streaming && g_benchmarkWarm)
+        StressStreaming();
+    {
+        PROFILE_SCOPE("PrepareFrame");
+        PrepareFrame(packet);
+    }
+    const int64_t inputTime   = packet.inputTime;
+    const bool    exportTrace = packet.exportTrace;
+    const double  simMs       = packet.simMs;
+    g_packets.EndRead();        // the sim thread starts on the next one while this one records
+    if (exportTrace)
+        g_profiler.ExportChromeTrace("profile.json");
+
+    // Small frames are recorded inline, big ones are split across the job system
+    const UINT drawCount = (UINT)g_batcher.Batches().size();
+    const UINT listCount = g_useIndirect ? 0 : min(g_recordListCount, drawCount / kMinDrawsPerList);
+
+    // Consumed by PrepareFrame above; only the indirect path with occlusion builds a new one
+    if (!g_useIndirect || !(g_cullFlags & kCullOcclusion))
+        g_hizValid = false;
+    BuildRenderGraph(listCount > 1);
+
+    // Lists go to the queue in batches – everything recorded so far is submitted at a fork or join
+    ID3D12CommandList* lists[kMaxGraphicsLists + kMaxRecordLists];
+    UINT               numLists = 0, usedLists = 0;
+    auto submit = [&]
+    {
+        PROFILE_SCOPE("Submit");
+        if (numLists)
+            g_commandQueue->ExecuteCommandLists(numLists, lists);
+        numLists = 0;
+    };
+
+    {
+        PROFILE_SCOPE("Record");
+        UINT from = 0;
+        while (true)
+        {
+            if (usedLists == kMaxGraphicsLists)
+                throw std::runtime_error("Render graph needs more direct command lists");
+            ID3D12GraphicsCommandList* cl = g_graphicsLists[usedLists++].Get();
+            ThrowIfFailed(cl->Reset(frame.commandAllocator.Get(), usedLists == 1 ? g_pipelineState.Get() : nullptr));
+            const RenderGraph::Stop stop = g_renderGraph.Record(cl, from);
+            // Timestamp resolve after every other list, compute included – the graph joins before its end
+            if (stop.kind == RenderGraph::kStopEnd)
+                g_profiler.ResolveGpu(cl);
+            ThrowIfFailed(cl->Close());
+            lists[numLists++] = cl;
+
+            if (stop.kind == RenderGraph::kStopEnd)
+                break;
+            from = stop.next;
+
+            switch (stop.kind)
+            {
+            case RenderGraph::kStopExternal:
+            {
+                // The graph stopped in front of the scene pass (its barriers are in cl) – record it in parallel
+                const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = g_sceneRtvHeap->GetCPUDescriptorHandleForHeapStart();
+                const UINT perList = (drawCount + listCount - 1) / listCount;
+                JobSystem::Counter counter;
+                for (UINT i = 0; i < listCount; ++i)
+                {
+                    g_jobs.Run([&frame, rtvHandle, i, perList, drawCount]
+                    {
+                        PROFILE_SCOPE("RecordDraws");
+                        ID3D12CommandAllocator*    allocator = frame.recordAllocators[i].Get();
+                        ID3D12GraphicsCommandList* cl        = g_recordLists[i].Get();
+
+                        ThrowIfFailed(allocator->Reset());
+                        ThrowIfFailed(cl->Reset(allocator, g_pipelineState.Get()));
+                        SetDrawState(cl, rtvHandle);
+                        {
+                            PROFILE_GPU_SCOPE(cl, "Scene");
+                            RecordDraws(cl, i * perList, min((i + 1) * perList, drawCount));
+                        }
+                        ThrowIfFailed(cl->Close());
+                    }, &counter);
+
+                    lists[numLists++] = g_recordLists[i].Get();
+                }
+                g_jobs.Wait(counter);
+                break;
+            }
+            case RenderGraph::kStopFork:
+            {
+                // The compute queue may only start once the fork's barriers have run
+                submit();
+                g_asyncCompute.Fork(g_commandQueue.Get());
+                ID3D12GraphicsCommandList* computeList = g_asyncCompute.Begin();
+                g_renderGraph.RecordAsync(computeList);
+                g_asyncCompute.Submit();
+                break;
+            }
+            case RenderGraph::kStopJoin:
+                submit();
+                g_asyncCompute.Join(g_commandQueue.Get());
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    submit();
+    const int64_t presentStart = Profiler::Now();
+    {
+        PROFILE_SCOPE("Present");
+        g_swapChain.Present();
+    }
+    if (!g_startup.firstFrame)
+        g_startup.firstFrame = g_profiler.ToMs(Profiler::Now() - g_launchTime);
+    if (inputTime)
+        g_inputLatencyMs = g_profiler.ToMs(Profiler::Now() - inputTime);
+
+    // No full stall here – we only wait once this slot comes round again
+    EndFrame();
+
+    // Counted over every thread – the sim's frame overlaps this one anyway
+    const uint64_t allocs = HeapCounters::allocations.load(std::memory_order_relaxed);
+    g_frameAllocs = allocs - g_allocMark;
+    g_allocMark   = allocs;
+    g_warmFrames  = g_assets.GetStats().pending ? 0 : g_warmFrames + 1;
+    if (g_allocCheck && g_warmFrames > kAllocWarmupFrames && g_frameAllocs)
+        throw std::runtime_error("Warm frame made " + std::to_string(g_frameAllocs) + " heap allocations");
+
+    if (g_benchmark)
+        RecordBenchmarkFrame({ g_lastRenderStart ? g_profiler.ToMs(frameStart - g_lastRenderStart) : 0.0,
+                               g_profiler.ToMs(presentStart - workStart), simMs, g_profiler.LastGpuFrameMs() });
+    g_lastRenderStart = frameStart;
+}
+
+// ---------------------------------------------------------------
+// Sim & render threads
+// ---------------------------------------------------------------
+void SimThread()
+{
+    while (FramePacket* packet = g_packets.BeginWrite())
+    {
+        const int64_t start = Profiler::Now();
+        SimulateFrame(*packet);
+        packet->simMs = g_profiler.ToMs(Profiler::Now() - start);
+        g_packets.Publish();
+    }
+}
+
+void RenderThread()
+{
+    while (!g_quit.load())
+    {
+        // Minimized nothing gets presented and the waitable never fires – sleep until restored
+        if (g_minimized.load())
+        {
+            g_minimized.wait(true);
+            continue;
+        }
+        {
+            PROFILE_SCOPE("WaitForFrame");
+            g_swapChain.WaitForNextFrame();
+        }
+        // Taken after the wait, so the frame is drawn from the freshest packet there is
+        const FramePacket* packet;
+        {
+            PROFILE_SCOPE("WaitForSim");
+            packet = g_packets.BeginRead();
+        }
+        if (!packet)
+            break;
+        ApplyPendingResize();
+        Render(*packet);
+
+        // The run is over – stopping this thread takes the rest down like closing the window would
+        if (g_benchmark && g_benchmarkRun.Done())
+        {
+            WriteBenchmarkResults();
+            break;
+        }
+    }
+}
+
+// Either thread stopping, or throwing, takes the other one down with it. The
+// window outlives both: DestroyWindow only once the last one posted kMsgThreadsStopped.
+void RunHostThread(unsigned index, void (*body)())
+{
+    g_jobs.AttachThread(index);
+    try
+    {
+        body();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(g_threadErrorMutex);
+        if (!g_threadError)
+            g_threadError = std::current_exception();
+    }
+
+    g_quit = true;
+    g_packets.Close();
+    g_minimized = false;
+    g_minimized.notify_all();
+    if (g_threadsRunning.fetch_sub(1) == 1)
+        PostMessage(g_hwnd, kMsgThreadsStopped, 0, 0);
 }
 
 // ---------------------------------------------------------------
-// Win32 window
+// Win32 window – runs on the WinMain thread, which does nothing else
 // ---------------------------------------------------------------
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
+    if (uMsg == WM_CLOSE)
+    {
+        // The render thread may be presenting to us – let it finish first
+        g_quit = true;
+        g_minimized = false;
+        g_minimized.notify_all();
+        return 0;
+    }
+    if (uMsg == kMsgThreadsStopped)
+    {
+        DestroyWindow(hwnd);
+        return 0;
+    }
     if (uMsg == WM_DESTROY)
     {
         PostQuitMessage(0);
         return 0;
     }
+    if (uMsg == WM_SIZE)
+    {
+        // Swap chain resize waits for the GPU, so the render thread does it between frames
+        const bool minimized = wParam == SIZE_MINIMIZED || LOWORD(lParam) == 0 || HIWORD(lParam) == 0;
+        if (!minimized)
+            g_pendingSize = (uint32_t)LOWORD(lParam) << 16 | HIWORD(lParam);
+        g_minimized = minimized;
+        g_minimized.notify_all();
+        return 0;
+    }
+    // Keyboard and mouse go to the sim thread, stamped now rather than when it gets round to them
+    if ((uMsg >= WM_KEYFIRST && uMsg <= WM_KEYLAST) || (uMsg >= WM_MOUSEFIRST && uMsg <= WM_MOUSELAST))
+        g_input.Push({ Profiler::Now(), uMsg, (uint64_t)wParam, (int64_t)lParam });
     return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
 // ---------------------------------------------------------------
 // Entry point
 // ---------------------------------------------------------------
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow)
 {
+    g_launchTime = Profiler::Now();
+
+    // --adapter=N the Nth GPU in high performance order instead of the first that works;
+    // --tier=low|mid|high starts from that tier's defaults instead of the probed one
+    int adapterIndex = -1;
+    if (const char* arg = strstr(lpCmdLine, "--adapter="))
+        adapterIndex = max(0, atoi(arg + strlen("--adapter=")));
+    CreateDevice(adapterIndex);
+    if (const char* arg = strstr(lpCmdLine, "--tier="))
+    {
+        arg += strlen("--tier=");
+        g_tier = !strncmp(arg, "low", 3) ? kTierLow : !strncmp(arg, "mid", 3) ? kTierMid : kTierHigh;
+    }
+    ApplyTierDefaults();
+
+    // --benchmark=<scene> (benchmark.h) sets the scene up, the flags after it can still change it;
+    // --benchmark-frames=N measured frames, --benchmark-out=path for the JSON
+    if (const char* arg = strstr(lpCmdLine, "--benchmark="))
+    {
+        g_benchmark = FindBenchmarkScene(arg + strlen("--benchmark="));
+        if (!g_benchmark)
+            throw std::runtime_error("Unknown benchmark scene");
+        g_sceneInstances = g_benchmark->instances;
+        g_physicsBodies  = g_benchmark->bodies;
+        g_lightCount     = g_benchmark->lights;
+        g_simOverlay     = false;       // nobody reads it, and its text changes every frame
+    }
+    if (const char* arg = strstr(lpCmdLine, "--benchmark-frames="))
+        g_benchmarkFrames = (UINT)max(1, atoi(arg + strlen("--benchmark-frames=")));
+    if (const char* arg = strstr(lpCmdLine, "--benchmark-out="))
+    {
+        const bool quoted = arg > lpCmdLine && arg[-1] == '"';     // "--benchmark-out=a path with spaces"
+        arg += strlen("--benchmark-out=");
+        g_benchmarkOut.assign(arg, strcspn(arg, quoted ? "\"" : " \t"));
+    }
+    // --offscreen renders into plain textures with the window hidden – nothing is presented
+    if (strstr(lpCmdLine, "--offscreen"))
+        g_offscreen = true;
+    // --size=WxH client area (and offscreen target) at startup
+    UINT startWidth = kDefaultWidth, startHeight = kDefaultHeight;
+    if (const char* arg = strstr(lpCmdLine, "--size="))
+    {
+        char* end   = nullptr;
+        startWidth  = (UINT)max(8L, strtol(arg + strlen("--size="), &end, 10));
+        startHeight = *end == 'x' ? (UINT)max(8, atoi(end + 1)) : startWidth;
+    }
+    // --frames-in-flight=N (defaults to 2)
+    if (const char* arg = strstr(lpCmdLine, "--frames-in-flight="))
+    {
+        int n = atoi(arg + strlen("--frames-in-flight="));
+        g_framesInFlight = (UINT)max(1, min(n, (int)kMaxFramesInFlight));
+    }
+    // --instances=N objects in the test scene, --no-indirect records draws on the CPU
+    if (const char* arg = strstr(lpCmdLine, "--instances="))
+        g_sceneInstances = (UINT)max(1, atoi(arg + strlen("--instances=")));
+    // --bodies=N rigid bodies dropped on it
+    if (const char* arg = strstr(lpCmdLine, "--bodies="))
+        g_physicsBodies = (UINT)max(0, atoi(arg + strlen("--bodies=")));
+    // --lights=N point lights over it, --night turns the sun down so they're what you see
+    if (const char* arg = strstr(lpCmdLine, "--lights="))
+        g_lightCount = (UINT)max(0, atoi(arg + strlen("--lights=")));
+    if (strstr(lpCmdLine, "--night"))
+        g_night = true;
+    // --no-ocean puts the flat ground back, --no-async-ocean keeps the waves on the direct queue
+    if (strstr(lpCmdLine, "--no-ocean"))
+        g_oceanEnabled = false;
+    if (strstr(lpCmdLine, "--no-async-ocean"))
+        g_oceanAsync = false;
+    if (strstr(lpCmdLine, "--no-indirect"))
+        g_useIndirect = false;
+    if (strstr(lpCmdLine, "--no-occlusion"))
+        g_cullFlags &= ~kCullOcclusion;
+    if (strstr(lpCmdLine, "--no-cull"))
+        g_cullFlags = 0;
+    // --simd=scalar|sse2 caps the math kernels below what the CPU has (A/B timing)
+    if (const char* arg = strstr(lpCmdLine, "--simd="))
+    {
+        arg += strlen("--simd=");
+        SetSimdLevel(!strncmp(arg, "scalar", 6) ? SimdLevel::Scalar : !strncmp(arg, "sse2", 4) ? SimdLevel::Sse2
+                                                                                                : SimdLevel::Avx2);
+    }
+    // --no-mesh-shaders stays on the input assembler path even where meshlets would work
+    if (strstr(lpCmdLine, "--no-mesh-shaders"))
+        g_allowMeshShaders = false;
+    // --hot-reload rebuilds the PSOs of any shader edited under shaders/ while it runs
+    if (strstr(lpCmdLine, "--hot-reload"))
+        g_hotReloadEnabled = true;
+    // --alloc-check throws once a warm frame touches the heap
+    if (strstr(lpCmdLine, "--alloc-check"))
+        g_allocCheck = true;
+    // --texture-budget=MB caps the streamed texture pool, default a quarter of the VRAM budget
+    if (const char* arg = strstr(lpCmdLine, "--texture-budget="))
+        g_textureBudgetMB = (UINT64)max(16, atoi(arg + strlen("--texture-budget=")));
+    // --no-async-compute keeps every pass on the direct queue
+    if (strstr(lpCmdLine, "--no-async-compute"))
+        g_useAsyncCompute = false;
+    // Presentation: --buffers=N (2..4), --max-latency=N, --no-vsync (tears if supported), --fps-cap=N
+    if (const char* arg = strstr(lpCmdLine, "--buffers="))
+        g_swapSettings.bufferCount = (UINT)max(2, atoi(arg + strlen("--buffers=")));
+    if (const char* arg = strstr(lpCmdLine, "--max-latency="))
+        g_swapSettings.maxFrameLatency = (UINT)max(1, atoi(arg + strlen("--max-latency=")));
+    if (strstr(lpCmdLine, "--no-vsync"))
+        g_swapSettings.vsync = false;
+    if (const char* arg = strstr(lpCmdLine, "--fps-cap="))
+        g_swapSettings.fpsCap = (UINT)max(0, atoi(arg + strlen("--fps-cap=")));
+    // Resolution: --render-scale=S fixed, or --dynamic-res[=targetMs] (default 16.6) scales to hit the GPU budget
+    if (const char* arg = strstr(lpCmdLine, "--render-scale="))
+        g_renderScale = max(0.25f, min((float)atof(arg + strlen("--render-scale=")), 1.0f));
+    if (const char* arg = strstr(lpCmdLine, "--dynamic-res"))
+    {
+        g_dynamicRes = true;
+        const float targetMs = arg[strlen("--dynamic-res")] == '=' ? (float)atof(arg + strlen("--dynamic-res=")) : 0.0f;
+        g_dynRes.Init(targetMs > 0.0f ? targetMs : 16.6f);
+    }
+    // --no-dynamic-res turns off what the mid tier turns on; --render-scale=S alone implies it
+    if (strstr(lpCmdLine, "--no-dynamic-res") || (strstr(lpCmdLine, "--render-scale=") && !strstr(lpCmdLine, "--dynamic-res")))
+        g_dynamicRes = false;
+    // --no-taa drops the jitter, motion vectors and temporal resolve for a bilinear upscale;
+    // --upscaler=name picks a registered TemporalUpscaler plugin over the built-in TAA
+    if (strstr(lpCmdLine, "--no-taa"))
+        g_taa = false;
+    if (const char* arg = strstr(lpCmdLine, "--upscaler="))
+    {
+        arg += strlen("--upscaler=");
+        g_upscalerName.assign(arg, strcspn(arg, " "));
+    }
+    // --serial-init runs the startup tasks one after the other on this thread (A/B timing, debugging)
+    if (strstr(lpCmdLine, "--serial-init"))
+        g_serialInit = true;
+
     const wchar_t CLASS_NAME[] = L"DX12WindowClass";
     WNDCLASS wc{};
     wc.lpfnWndProc   = WindowProc;
@@ -350,30 +3095,148 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
     wc.lpszClassName = CLASS_NAME;
     RegisterClass(&wc);
 
+    RECT rect{0, 0, (LONG)startWidth, (LONG)startHeight};
+    AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
     HWND hwnd = CreateWindowEx(
         0, CLASS_NAME, L"Triangle DX12",
         WS_OVERLAPPEDWINDOW,
-        CW_USEDEFAULT, CW_USEDEFAULT, 800, 600,
+        CW_USEDEFAULT, CW_USEDEFAULT, rect.right - rect.left, rect.bottom - rect.top,
         nullptr, nullptr, hInstance, nullptr);
 
-    ShowWindow(hwnd, nCmdShow);
-    UpdateWindow(hwnd);
+    if (!g_offscreen)
+    {
+        ShowWindow(hwnd, nCmdShow);
+        UpdateWindow(hwnd);
+    }
+    g_hwnd = hwnd;
 
+    g_jobs.Init(0, kHostThreads);   // one worker per core, plus this thread and the sim/render ones
     InitD3D12(hwnd);
 
-    MSG msg{};
-    while (true)
+    // Everything else as one graph on the job system – this thread shows the loading screen and
+    // keeps the window responsive meanwhile. The archive's table of contents is all anything waits on.
+    InitGraph init;
+    const InitGraph::TaskId assets = init.Add("Assets", []
     {
-        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+        g_assets.Open(g_device.Get(), &g_uploader, "assets.pak");
+    });
+    AddRenderInitTasks(init, assets);
+    init.Add("Scene", CreateScene);
+    if (g_benchmark)
+        init.Add("Benchmark", InitBenchmark, { assets });
+    if (g_serialInit)
+    {
+        PresentLoadingFrame(0.0f);
+        g_startup.loadingFrame = g_profiler.ToMs(Profiler::Now() - g_launchTime);
+        init.RunSerial();
+    }
+    else
+    {
+        init.Start(&g_jobs);
+        PresentLoadingFrame(0.0f);
+        g_startup.loadingFrame = g_profiler.ToMs(Profiler::Now() - g_launchTime);
+        while (!init.Done())
         {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-            if (msg.message == WM_QUIT) goto cleanup;
+            // WM_CLOSE meanwhile only sets g_quit – the threads see it once they start, as usual
+            MSG msg{};
+            while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessage(&msg);
+            }
+            if (g_offscreen || g_minimized.load())
+                MsgWaitForMultipleObjects(0, nullptr, FALSE, 1, QS_ALLINPUT);   // nobody to show it to
+            else
+            {
+                g_swapChain.WaitForNextFrame();
+                PresentLoadingFrame(init.Progress());
+            }
         }
-        Render();
     }
+    char line[128];
+    for (const InitGraph::TaskStats& task : init.Finish())
+    {
+        snprintf(line, sizeof(line), "Init: %-14s %7.1f ms at %7.1f ms\n", task.name, task.ms, task.startMs);
+        OutputDebugStringA(line);
+    }
+
+    // Direct queue waits (on the GPU) for the startup uploads before the first frame
+    g_uploader.QueueWait(g_commandQueue.Get(), g_uploader.Flush());
+
+    // Every PSO is tracked by now
+    if (g_hotReloadEnabled)
+        g_hotReload.Start(&g_shaders, &g_psoCache, "shaders");
+    g_startup.init = g_profiler.ToMs(Profiler::Now() - g_launchTime);
+    g_startTime = Profiler::Now();
+
+    // From here this thread only pumps messages – a modal drag or resize loop no longer stalls
+    // the frame, and a slow frame no longer holds up input. WM_CLOSE stops the threads,
+    // the last one out has the window destroyed, WM_QUIT ends the pump.
+    g_threadsRunning = 2;
+    std::thread simThread(RunHostThread, (unsigned)kThreadSim, SimThread);
+    std::thread renderThread(RunHostThread, (unsigned)kThreadRender, RenderThread);
+
+    MSG msg{};
+    while (GetMessage(&msg, nullptr, 0, 0) > 0)
+    {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+    g_quit = true;          // no-ops after a normal close, but the pump can also just fail
+    g_packets.Close();
+    simThread.join();
+    renderThread.join();
+    if (g_threadError)
+        std::rethrow_exception(g_threadError);
 
-cleanup:
+    WaitForGpu();   // nothing may be released while the GPU still uses it
+    g_hotReload.Stop();         // compiles through the PSO cache and the shader library
+    g_assets.Shutdown();        // streaming thread feeds the uploader
+    g_uploader.Shutdown();
+    g_textures.Shutdown();      // tile mappings ran on the uploader's queue
+    g_profiler.Shutdown();
+    g_asyncCompute.Shutdown();
+    g_swapChain.Shutdown();
+    g_gpuAllocator.Free(g_geometryBuffer);
+    g_gpuAllocator.Free(g_meshTable);
+    g_gpuAllocator.Free(g_meshletBuffer);
+    g_gpuAllocator.Free(g_materialTable);
+    g_gpuAllocator.Free(g_indirectArgs);
+    g_gpuAllocator.Free(g_cullCounters);
+    g_gpuAllocator.Free(g_visibleInstances);
+    g_gpuAllocator.Free(g_lightClusters);
+    g_ocean.Shutdown();
+    if (g_upscaler)
+        g_upscaler->Shutdown();
+    g_upscaler.reset();
+    g_gpuAllocator.Free(g_hiz);
+    g_gpuAllocator.Free(g_streamScratch);
+    g_renderGraph.Shutdown();
+    for (FrameContext& frame : g_frames)
+        g_gpuAllocator.Free(frame.uploadBuffer);
+    g_pipelineState.Reset();
+    g_cullClearPso.Reset();
+    g_cullPso.Reset();
+    g_cullArgsPso.Reset();
+    g_hizPso.Reset();
+    g_lightBinPso.Reset();
+    g_oceanSpectrumPso.Reset();
+    g_oceanFftPso.Reset();
+    g_oceanFinalizePso.Reset();
+    g_oceanQueryPso.Reset();
+    g_oceanTilesPso.Reset();
+    g_oceanPso.Reset();
+    g_oceanSignature.Reset();
+    g_overlayPso.Reset();
+    g_upscalePso.Reset();
+    g_taaPso.Reset();
+    g_drawSignature.Reset();
+    g_meshSignature.Reset();
+    g_meshletPso.Reset();
+    g_psoCache.Shutdown();
+    g_shaders.Shutdown();
+    g_world.Clear();
+    g_jobs.Shutdown();
     CloseHandle(g_fenceEvent);
     return 0;
 }
@@ -0,0 +1,511 @@
+// ---------------------------------------------------------------
+// Mesh cooking – triangle soup -> compact indexed GPU mesh + meshlets
+// ---------------------------------------------------------------
+// CookMesh() runs the whole pipeline:
+//
+//   weld           identical corners become one vertex, degenerate triangles go
+//   vertex cache   Tipsify (Sander et al. 2007) – triangles reordered so the
+//                  post-transform cache hits, ACMR close to 0.6-0.7 on closed meshes
+//   overdraw       Tipsify's clusters sorted outward-facing first, so a mesh
+//                  tends to draw its occluders before what they hide
+//   vertex fetch   vertices renumbered in first-use order, so fetches stream
+//   quantize       PackedVertex: snorm16 positions in the mesh's bounds,
+//                  octahedral snorm16 normals, unorm8 colour – 16 bytes, was 40
+//   meshlets       greedy runs of the final order, <= 64 vertices / 124
+//                  triangles, each with a bounding sphere and normal cone
+//                  (closed meshes only – open ones are drawn two-sided)
+//
+// Plain std only – tools/assetcook runs it offline, the engine only when it
+// has no archive.
+#pragma once
+
+#include "assetpak.h"
+#include "scenemeshes.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Mirrors the scene PSO's input layout
+struct PackedVertex
+{
+    int16_t position[4];        // R16G16B16A16_SNORM, w unused
+    int16_t normal[2];          // R16G16_SNORM, octahedral
+    uint8_t color[4];           // R8G8B8A8_UNORM
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must match the input layout");
+
+struct CookedMesh
+{
+    std::vector<PackedVertex> vertices;
+    std::vector<uint16_t>     indices;
+    MeshAssetMeta             meta{};
+
+    std::vector<Meshlet>      meshlets;
+    std::vector<uint32_t>     meshletVertices;      // into vertices
+    std::vector<uint32_t>     meshletTriangles;     // three 8 bit meshlet-local indices each
+
+    float                     acmrBefore = 0.0f;    // transformed vertices per triangle, 16 entry FIFO
+    float                     acmrAfter  = 0.0f;
+};
+
+namespace MeshCook
+{
+static const uint32_t kCacheSize           = 16;    // what Tipsify plans for – small is safe, GPUs are bigger
+static const uint32_t kMaxMeshletVertices  = 64;
+static const uint32_t kMaxMeshletTriangles = 124;
+
+// Average cache misses per triangle with a FIFO cache
+inline float Acmr(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize)
+{
+    if (indices.empty())
+        return 0.0f;
+    std::vector<uint32_t> insertedAt(vertexCount, 0);
+    uint32_t time = cacheSize + 1, misses = 0;
+    for (uint32_t index : indices)
+        if (time - insertedAt[index] > cacheSize)
+        {
+            insertedAt[index] = time++;
+            ++misses;
+        }
+    return (float)misses / (float)(indices.size() / 3);
+}
+
+// Area weighted face normal, flipped to agree with the authored vertex normals –
+// the builders don't keep winding consistent (the PSO doesn't cull)
+inline void FaceNormal(const Vertex& a, const Vertex& b, const Vertex& c, float n[3])
+{
+    const float e0[3] = { b.pos[0] - a.pos[0], b.pos[1] - a.pos[1], b.pos[2] - a.pos[2] };
+    const float e1[3] = { c.pos[0] - a.pos[0], c.pos[1] - a.pos[1], c.pos[2] - a.pos[2] };
+    n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+    n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+    n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+    float side = 0.0f;
+    for (int k = 0; k < 3; ++k)
+        side += n[k] * (a.normal[k] + b.normal[k] + c.normal[k]);
+    if (side < 0.0f)
+        for (int k = 0; k < 3; ++k)
+            n[k] = -n[k];
+}
+
+// Exact duplicates only – the builders spell the same corner out the same way
+inline void Weld(const std::vector<Vertex>& soup, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    struct Key
+    {
+        Vertex v;
+        bool operator==(const Key& o) const { return memcmp(&v, &o.v, sizeof(Vertex)) == 0; }
+    };
+    struct Hash
+    {
+        size_t operator()(const Key& k) const { return (size_t)HashBytes(&k.v, sizeof(Vertex)); }
+    };
+
+    std::unordered_map<Key, uint32_t, Hash> unique;
+    std::vector<uint32_t> corners(soup.size());
+    for (size_t i = 0; i < soup.size(); ++i)
+    {
+        Key key{};
+        memcpy(&key.v, &soup[i], sizeof(Vertex));
+        auto [it, inserted] = unique.emplace(key, (uint32_t)vertices.size());
+        if (inserted)
+            vertices.push_back(soup[i]);
+        corners[i] = it->second;
+    }
+
+    for (size_t t = 0; t + 2 < soup.size(); t += 3)
+    {
+        float n[3];
+        FaceNormal(soup[t], soup[t + 1], soup[t + 2], n);
+        if (n[0] * n[0] + n[1] * n[1] + n[2] * n[2] <= 1e-12f)
+            continue;       // zero area (sphere poles)
+        indices.insert(indices.end(), { corners[t], corners[t + 1], corners[t + 2] });
+    }
+}
+
+// Tipsify: fan around one vertex at a time, move to the neighbour the cache
+// still holds that has the fewest triangles left. Appends a cluster start to
+// `clusters` whenever it has to jump (dead end) – those are the overdraw units.
+inline std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount,
+                                                 std::vector<uint32_t>& clusters)
+{
+    const uint32_t triangleCount = (uint32_t)indices.size() / 3;
+
+    // Vertex -> triangles
+    std::vector<uint32_t> live(vertexCount, 0), offsets(vertexCount + 1, 0);
+    for (uint32_t index : indices)
+        ++live[index];
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + live[v];
+    std::vector<uint32_t> adjacency(indices.size()), fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t i = 0; i < (uint32_t)indices.size(); ++i)
+        adjacency[fill[indices[i]]++] = i / 3;
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0), deadEnds, candidates, out;
+    std::vector<bool>     emitted(triangleCount, false);
+    out.reserve(indices.size());
+    uint32_t time = kCacheSize + 1, cursor = 0;
+    int64_t  fan  = vertexCount ? 0 : -1;
+    clusters.clear();
+    clusters.push_back(0);
+
+    while (fan >= 0)
+    {
+        candidates.clear();
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; ++a)
+        {
+            const uint32_t t = adjacency[a];
+            if (emitted[t])
+                continue;
+            emitted[t] = true;
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                const uint32_t v = indices[t * 3 + k];
+                out.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cacheTime[v] > kCacheSize)
+                    cacheTime[v] = time++;
+            }
+        }
+
+        // Best neighbour still in the cache after its remaining triangles go through
+        int64_t  next = -1;
+        int64_t  best = -1;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0)
+                continue;
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= kCacheSize)
+                priority = time - cacheTime[v];
+            if (priority > best)
+            {
+                best = priority;
+                next = v;
+            }
+        }
+        if (next < 0)
+        {
+            // Dead end – back up through recent vertices, then scan for anything left
+            while (!deadEnds.empty() && next < 0)
+            {
+                const uint32_t v = deadEnds.back();
+                deadEnds.pop_back();
+                if (live[v] > 0)
+                    next = v;
+            }
+            while (next < 0 && cursor < vertexCount)
+            {
+                if (live[cursor] > 0)
+                    next = cursor;
+                ++cursor;
+            }
+            if (next >= 0 && out.size() / 3 > clusters.back())
+                clusters.push_back((uint32_t)(out.size() / 3));
+        }
+        fan = next;
+    }
+    return out;
+}
+
+// Clusters that face away from the mesh centre first – they're the ones in front
+inline void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                             const std::vector<uint32_t>& clusters)
+{
+    const uint32_t triangleCount = (uint32_t)indices.size() / 3;
+    float meshCenter[3] = {};
+    for (const Vertex& v : vertices)
+        for (int k = 0; k < 3; ++k)
+            meshCenter[k] += v.pos[k] / (float)vertices.size();
+
+    struct Cluster { uint32_t begin, end; float sortKey; };
+    std::vector<Cluster> sorted;
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        const uint32_t begin = clusters[c];
+        const uint32_t end   = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        float center[3] = {}, normal[3] = {}, area = 0.0f;
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            const Vertex& a = vertices[indices[t * 3]];
+            const Vertex& b = vertices[indices[t * 3 + 1]];
+            const Vertex& d = vertices[indices[t * 3 + 2]];
+            float n[3];
+            FaceNormal(a, b, d, n);
+            const float w = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);     // twice the area
+            for (int k = 0; k < 3; ++k)
+            {
+                center[k] += (a.pos[k] + b.pos[k] + d.pos[k]) * w;
+                normal[k] += n[k];
+            }
+            area += w;
+        }
+        float key = 0.0f;
+        if (area > 0.0f)
+            for (int k = 0; k < 3; ++k)
+                key += (center[k] / (3.0f * area) - meshCenter[k]) * normal[k];
+        sorted.push_back({ begin, end, key / (area > 0.0f ? area : 1.0f) });
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> out;
+    out.reserve(indices.size());
+    for (const Cluster& c : sorted)
+        out.insert(out.end(), indices.begin() + c.begin * 3, indices.begin() + c.end * 3);
+    indices.swap(out);
+}
+
+// Renumbers vertices in the order the indices first use them
+inline void OptimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<Vertex>& vertices)
+{
+    std::vector<uint32_t> remap(vertices.size(), ~0u);
+    std::vector<Vertex>   out;
+    out.reserve(vertices.size());
+    for (uint32_t& index : indices)
+    {
+        if (remap[index] == ~0u)
+        {
+            remap[index] = (uint32_t)out.size();
+            out.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(out);     // unreferenced vertices dropped
+}
+
+inline int16_t Snorm16(float v)
+{
+    v = v < -1.0f ? -1.0f : v > 1.0f ? 1.0f : v;
+    return (int16_t)lroundf(v * 32767.0f);
+}
+
+inline uint8_t Unorm8(float v)
+{
+    v = v < 0.0f ? 0.0f : v > 1.0f ? 1.0f : v;
+    return (uint8_t)lroundf(v * 255.0f);
+}
+
+// Unit vector -> [-1, 1]^2: project onto the octahedron, fold the lower half over
+inline void OctEncode(const float n[3], float out[2])
+{
+    const float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    float x = l1 > 0.0f ? n[0] / l1 : 0.0f;
+    float y = l1 > 0.0f ? n[1] / l1 : 0.0f;
+    if (n[2] < 0.0f)
+    {
+        const float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    out[0] = x;
+    out[1] = y;
+}
+
+// Every edge shared by exactly two triangles, by position – seams where normals
+// or colours split don't count, and float noise at the sphere's wrap-around shouldn't either
+inline bool IsClosed(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices)
+{
+    std::unordered_map<uint64_t, uint32_t> positions, edges;
+    std::vector<uint32_t> ids(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        int32_t cell[3];
+        for (int k = 0; k < 3; ++k)
+            cell[k] = (int32_t)lroundf(vertices[i].pos[k] * 1e4f);
+        ids[i] = positions.emplace(HashBytes(cell, sizeof(cell)), (uint32_t)positions.size()).first->second;
+    }
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t a = ids[indices[t + k]], b = ids[indices[t + (k + 1) % 3]];
+            ++edges[((uint64_t)(std::min)(a, b) << 32) | (std::max)(a, b)];
+        }
+    for (const auto& edge : edges)
+        if (edge.second != 2)
+            return false;
+    return !edges.empty();
+}
+
+// Open meshes get cutoff 1 everywhere – the scene draws them two-sided, so no side is ever "back"
+inline void BuildMeshlets(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, bool closed,
+                          CookedMesh& out)
+{
+    std::vector<uint8_t> localIndex(vertices.size(), 0xff);
+    Meshlet current{};
+
+    auto flush = [&]
+    {
+        if (current.triangleCount == 0)
+            return;
+
+        // Bounds: box centre, farthest vertex
+        float lo[3] = { 1e30f, 1e30f, 1e30f }, hi[3] = { -1e30f, -1e30f, -1e30f };
+        for (uint32_t i = 0; i < current.vertexCount; ++i)
+            for (int k = 0; k < 3; ++k)
+            {
+                const float p = vertices[out.meshletVertices[current.vertexOffset + i]].pos[k];
+                lo[k] = (std::min)(lo[k], p);
+                hi[k] = (std::max)(hi[k], p);
+            }
+        float radiusSq = 0.0f;
+        for (int k = 0; k < 3; ++k)
+            current.center[k] = 0.5f * (lo[k] + hi[k]);
+        for (uint32_t i = 0; i < current.vertexCount; ++i)
+        {
+            const float* p = vertices[out.meshletVertices[current.vertexOffset + i]].pos;
+            const float  d[3] = { p[0] - current.center[0], p[1] - current.center[1], p[2] - current.center[2] };
+            radiusSq = (std::max)(radiusSq, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+        current.radius = sqrtf(radiusSq);
+
+        // Normal cone: mean face normal, cutoff from the widest one (1 = never cull)
+        std::vector<std::array<float, 3>> normals;
+        float axis[3] = {};
+        for (uint32_t t = 0; t < current.triangleCount; ++t)
+        {
+            const uint32_t packed = out.meshletTriangles[current.triangleOffset + t];
+            const uint32_t* local = &out.meshletVertices[current.vertexOffset];
+            float n[3];
+            FaceNormal(vertices[local[packed & 0xff]], vertices[local[(packed >> 8) & 0xff]], vertices[local[(packed >> 16) & 0xff]], n);
+            const float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; ++k)
+            {
+                n[k] /= length;
+                axis[k] += n[k];
+            }
+            normals.push_back({ n[0], n[1], n[2] });
+        }
+        const float axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        float minDot = 1.0f;
+        for (int k = 0; k < 3; ++k)
+            current.coneAxis[k] = axisLength > 0.0f ? axis[k] / axisLength : 0.0f;
+        for (const std::array<float, 3>& n : normals)
+            minDot = (std::min)(minDot, n[0] * current.coneAxis[0] + n[1] * current.coneAxis[1] + n[2] * current.coneAxis[2]);
+        current.coneCutoff = closed && minDot > 0.1f ? sqrtf(1.0f - minDot * minDot) : 1.0f;
+
+        out.meshlets.push_back(current);
+        for (uint32_t i = 0; i < current.vertexCount; ++i)
+            localIndex[out.meshletVertices[current.vertexOffset + i]] = 0xff;
+        current = Meshlet{};
+        current.vertexOffset   = (uint32_t)out.meshletVertices.size();
+        current.triangleOffset = (uint32_t)out.meshletTriangles.size();
+    };
+
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+        uint32_t fresh = 0;
+        for (int k = 0; k < 3; ++k)
+            fresh += localIndex[indices[t + k]] == 0xff ? 1 : 0;
+        if (current.vertexCount + fresh > kMaxMeshletVertices || current.triangleCount == kMaxMeshletTriangles)
+            flush();
+
+        uint32_t packed = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t v = indices[t + k];
+            if (localIndex[v] == 0xff)
+            {
+                localIndex[v] = (uint8_t)current.vertexCount++;
+                out.meshletVertices.push_back(v);
+            }
+            packed |= (uint32_t)localIndex[v] << (8 * k);
+        }
+        out.meshletTriangles.push_back(packed);
+        ++current.triangleCount;
+    }
+    flush();
+}
+}   // namespace MeshCook
+
+// Throws std::runtime_error if the mesh doesn't fit 16 bit indices
+inline CookedMesh CookMesh(const std::vector<Vertex>& soup)
+{
+    CookedMesh cooked;
+    std::vector<Vertex>   vertices;
+    std::vector<uint32_t> indices;
+    MeshCook::Weld(soup, vertices, indices);
+    if (vertices.size() > 0xffff)
+        throw std::runtime_error("Mesh has too many vertices for 16 bit indices");
+    cooked.acmrBefore = MeshCook::Acmr(indices, (uint32_t)vertices.size());
+
+    std::vector<uint32_t> clusters;
+    indices = MeshCook::OptimizeVertexCache(indices, (uint32_t)vertices.size(), clusters);
+    MeshCook::OptimizeOverdraw(indices, vertices, clusters);
+    MeshCook::OptimizeVertexFetch(indices, vertices);
+    cooked.acmrAfter = MeshCook::Acmr(indices, (uint32_t)vertices.size());
+
+    // Positions over the bounding box, one scale for all axes so the VS can fold it into the world matrix
+    float lo[3] = { 1e30f, 1e30f, 1e30f }, hi[3] = { -1e30f, -1e30f, -1e30f };
+    for (const Vertex& v : vertices)
+        for (int k = 0; k < 3; ++k)
+        {
+            lo[k] = (std::min)(lo[k], v.pos[k]);
+            hi[k] = (std::max)(hi[k], v.pos[k]);
+        }
+    MeshAssetMeta& meta = cooked.meta;
+    float scale = 0.0f;
+    for (int k = 0; k < 3; ++k)
+    {
+        meta.positionOffset[k] = 0.5f * (lo[k] + hi[k]);
+        scale = (std::max)(scale, 0.5f * (hi[k] - lo[k]));
+    }
+    meta.positionScale = scale > 0.0f ? scale : 1.0f;
+
+    cooked.vertices.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vertex& v = vertices[i];
+        PackedVertex& p = cooked.vertices[i];
+        for (int k = 0; k < 3; ++k)
+            p.position[k] = MeshCook::Snorm16((v.pos[k] - meta.positionOffset[k]) / meta.positionScale);
+        p.position[3] = 32767;
+        float oct[2];
+        MeshCook::OctEncode(v.normal, oct);
+        p.normal[0] = MeshCook::Snorm16(oct[0]);
+        p.normal[1] = MeshCook::Snorm16(oct[1]);
+        for (int k = 0; k < 4; ++k)
+            p.color[k] = MeshCook::Unorm8(v.col[k]);
+    }
+    cooked.indices.assign(indices.begin(), indices.end());
+
+    meta.vertexCount     = (uint32_t)cooked.vertices.size();
+    meta.indexCount      = (uint32_t)cooked.indices.size();
+    meta.vertexStride    = sizeof(PackedVertex);
+    meta.boundsCenter[0] = meta.boundsCenter[1] = meta.boundsCenter[2] = 0.0f;
+    meta.boundsRadius    = MeshBoundsRadius(vertices);
+
+    MeshCook::BuildMeshlets(indices, vertices, MeshCook::IsClosed(indices, vertices), cooked);
+    meta.meshletCount = (uint32_t)cooked.meshlets.size();
+    return cooked;
+}
+
+// The kAssetMesh blob: vertices, then indices padded to 16 bytes – where the next mesh can start
+inline std::vector<char> MeshBlob(const CookedMesh& mesh)
+{
+    const size_t vertexBytes = mesh.vertices.size() * sizeof(PackedVertex);
+    const size_t indexBytes  = mesh.indices.size() * sizeof(uint16_t);
+    std::vector<char> blob((vertexBytes + indexBytes + 15) & ~(size_t)15, 0);
+    memcpy(blob.data(), mesh.vertices.data(), vertexBytes);
+    memcpy(blob.data() + vertexBytes, mesh.indices.data(), indexBytes);
+    return blob;
+}
+
+// The kAssetMeshlets blob: Meshlet[], vertex indices, packed triangles
+inline std::vector<char> MeshletBlob(const CookedMesh& mesh)
+{
+    const size_t meshletBytes  = mesh.meshlets.size() * sizeof(Meshlet);
+    const size_t vertexBytes   = mesh.meshletVertices.size() * sizeof(uint32_t);
+    const size_t triangleBytes = mesh.meshletTriangles.size() * sizeof(uint32_t);
+    std::vector<char> blob(meshletBytes + vertexBytes + triangleBytes);
+    memcpy(blob.data(), mesh.meshlets.data(), meshletBytes);
+    memcpy(blob.data() + meshletBytes, mesh.meshletVertices.data(), vertexBytes);
+    memcpy(blob.data() + meshletBytes + vertexBytes, mesh.meshletTriangles.data(), triangleBytes);
+    return blob;
+}
@@ -0,0 +1,367 @@
+// ---------------------------------------------------------------
+// Ocean – FFT waves on the GPU, clipmap geometry, buoyancy readback
+// ---------------------------------------------------------------
+// Tessendorf waves: Init() builds a Phillips spectrum h0(k) once, and every
+// frame shaders/oceanfft.hlsl animates it and inverse-FFTs it into a
+// kSize x kSize tile of the sea, kPatchSize metres across, that repeats:
+//
+//   SpectrumCS  h(k,t), plus the choppy x/z displacements, packed two real
+//               fields per complex signal – h + i*Dx and Dz
+//   FftCS       one Stockham radix-2 line per group, rows then columns,
+//               between the two spectrum buffers
+//   FinalizeCS  displacement (Dx, h, Dz) and slope/foam textures
+//   QueryCS     buoyancy: the sea height under each query point
+//
+// All of that is compute, so it can run on the async queue (render graph
+// kPassAsyncCompute) next to the scene.
+//
+// Geometry (shaders/ocean.hlsl) is camera-centred clipmap rings of tiles:
+// kLevels levels of kLevelTiles x kLevelTiles tiles of kTileCells x
+// kTileCells cells, each level twice the cell size of the last and missing
+// the middle where the finer level sits. TilesCS picks and frustum-culls the
+// tiles into an instance list + DrawInstanced arguments. The VS stitches a
+// tile's outer edge to the coarser level by snapping its odd vertices onto
+// the even ones, so there are no cracks.
+//
+// Buoyancy queries are a readback ring, one slot per frame in flight:
+// SubmitQueries() hands the GPU a slot's points, ResolveQueries() reads
+// them back once that slot comes round again (its fence has passed), and
+// results go into a table by id. The sim thread asks with SampleHeights(),
+// which extrapolates from the last two results – they are a few frames
+// old by the time anyone asks, and that's fine for floating crates.
+#pragma once
+
+#include "descriptors.h"
+#include "dxhelpers.h"
+#include "gpuallocator.h"
+#include "uploader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Tile list entry, mirrors OceanTile in shaders/ocean.hlsli
+struct OceanTile
+{
+    float origin[2];        // world xz of the tile's corner
+    float cellSize;
+    UINT  stitch;           // edges next to the coarser level: 1 -x, 2 +x, 4 -z, 8 +z
+};
+static_assert(sizeof(OceanTile) == 16, "OceanTile must match the HLSL layout");
+
+// Query point, mirrors shaders/oceanfft.hlsl
+struct OceanQuery
+{
+    float    x, z;
+    uint32_t id;            // result table index – the caller's, a body id say
+};
+
+// Phillips spectrum, h0(k) and conj(h0(-k)) per texel (float4 each), centred
+// (k = 0 at n/2), scaled so the sea's RMS height is rmsHeight. Plain std.
+inline std::vector<float> BuildOceanSpectrum(uint32_t n, float patchSize, float windSpeed, float windX, float windZ,
+                                             float rmsHeight, uint32_t seed)
+{
+    const float kGravity = 9.81f, kPi = 3.14159265f;
+    const float windLength = std::sqrt(windX * windX + windZ * windZ);
+    windX /= windLength;
+    windZ /= windLength;
+    const float largest  = windSpeed * windSpeed / kGravity;       // biggest wave the wind makes
+    const float smallest = largest * 0.001f;                       // damps the tiny ones
+
+    // Gaussian pairs via Box-Muller
+    auto random = [&seed] { seed = seed * 1664525u + 1013904223u; return ((float)(seed >> 8) + 0.5f) * (1.0f / 16777216.0f); };
+    std::vector<float> h0((size_t)n * n * 2);
+    double variance = 0.0;
+    for (uint32_t y = 0; y < n; ++y)
+        for (uint32_t x = 0; x < n; ++x)
+        {
+            const float kx = 2.0f * kPi * ((float)x - (float)(n / 2)) / patchSize;
+            const float kz = 2.0f * kPi * ((float)y - (float)(n / 2)) / patchSize;
+            const float k2 = kx * kx + kz * kz;
+            float phillips = 0.0f;
+            if (k2 > 1e-12f)
+            {
+                const float along = (kx * windX + kz * windZ) / std::sqrt(k2);
+                phillips = std::exp(-1.0f / (k2 * largest * largest)) / (k2 * k2) * along * along *
+                           std::exp(-k2 * smallest * smallest);
+                if (along < 0.0f)
+                    phillips *= 0.07f;                  // waves running into the wind are rare
+            }
+            const float radius = std::sqrt(-2.0f * std::log(random())), angle = 2.0f * kPi * random();
+            const float scale  = std::sqrt(phillips * 0.5f);
+            h0[((size_t)y * n + x) * 2 + 0] = radius * std::cos(angle) * scale;
+            h0[((size_t)y * n + x) * 2 + 1] = radius * std::sin(angle) * scale;
+            variance += (double)phillips * radius * radius * 0.5;
+        }
+    // h(x) = sum h(k,t) e^ikx, so the height's variance is the sum of both halves' power
+    const float normalize = variance > 0.0 ? rmsHeight / (float)std::sqrt(2.0 * variance) : 0.0f;
+
+    std::vector<float> spectrum((size_t)n * n * 4);
+    for (uint32_t y = 0; y < n; ++y)
+        for (uint32_t x = 0; x < n; ++x)
+        {
+            const size_t here = (size_t)y * n + x;
+            const size_t mirr = (size_t)((n - y) % n) * n + (n - x) % n;      // -k
+            spectrum[here * 4 + 0] = h0[here * 2 + 0] * normalize;
+            spectrum[here * 4 + 1] = h0[here * 2 + 1] * normalize;
+            spectrum[here * 4 + 2] = h0[mirr * 2 + 0] * normalize;
+            spectrum[here * 4 + 3] = -h0[mirr * 2 + 1] * normalize;
+        }
+    return spectrum;
+}
+
+class Ocean
+{
+public:
+    static const UINT      kSize        = 256;      // FFT resolution, mirrors shaders/ocean.hlsli
+    static constexpr float kPatchSize   = 64.0f;    // metres one FFT tile covers
+    static const UINT      kLevels      = 5;        // clipmap levels
+    static const UINT      kLevelTiles  = 8;        // tiles across a level
+    static const UINT      kTileCells   = 16;       // cells across a tile
+    static constexpr float kCellSize    = 0.25f;    // level 0, metres
+    static const UINT      kMaxTiles    = kLevels * kLevelTiles * kLevelTiles;
+    static const UINT      kTileVertices = kTileCells * kTileCells * 6;     // non-indexed triangle list
+    static const UINT      kMaxQueries  = 16384;    // per frame, the rest wait for another frame
+    static const UINT      kMaxSlots    = 3;
+    static constexpr float kMaxExtrapolation = 0.25f;   // seconds SampleHeights() runs ahead of its newest result
+
+    struct Stats
+    {
+        UINT   queries  = 0;        // submitted last frame
+        UINT   resolved = 0;        // read back last frame
+        float  latency  = 0.0f;     // seconds the sim was ahead of the sea time the results were for
+    };
+
+    void Init(GpuAllocator* allocator, DescriptorHeap* descriptors, Uploader* uploader, UINT slotCount, float seaLevel)
+    {
+        m_allocator   = allocator;
+        m_slotCount   = (std::min)(slotCount, kMaxSlots);
+        m_seaLevel    = seaLevel;
+
+        // h0 – fixed for the run, uploaded once
+        const std::vector<float> spectrum = BuildOceanSpectrum(kSize, kPatchSize, 12.0f, 1.0f, 0.35f, 0.35f, 0x5ea);
+        const UINT64 spectrumSize = (UINT64)kSize * kSize * 4 * sizeof(float);
+        m_h0 = allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, spectrumSize, D3D12_RESOURCE_STATE_COMMON);
+        uploader->UploadBuffer(m_h0->resource.Get(), 0, spectrum.data(), spectrumSize);
+        m_h0Srv = descriptors->AllocatePersistent();
+        descriptors->CreateRawBufferSrv(m_h0Srv, m_h0->resource.Get(), 0, spectrumSize);
+
+        // Two complex signals per texel, float4; ping-ponged through by the FFT – raw buffers, so
+        // no typed UAV loads are needed
+        for (UINT i = 0; i < 2; ++i)
+        {
+            m_spectrum[i] = allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, spectrumSize, D3D12_RESOURCE_STATE_COMMON,
+                                                    D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+            m_spectrumSrv[i] = descriptors->AllocatePersistent();
+            m_spectrumUav[i] = descriptors->AllocatePersistent();
+            descriptors->CreateRawBufferSrv(m_spectrumSrv[i], m_spectrum[i]->resource.Get(), 0, spectrumSize);
+            descriptors->CreateRawBufferUav(m_spectrumUav[i], m_spectrum[i]->resource.Get(), 0, spectrumSize);
+        }
+
+        // Displacement is read by the VS and the queries, slopes only by the PS – they stay in those states
+        const D3D12_RESOURCE_DESC mapDesc = Texture2DDesc(DXGI_FORMAT_R16G16B16A16_FLOAT, kSize, kSize, 1,
+                                                          D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        m_displacement = allocator->CreateResource(D3D12_HEAP_TYPE_DEFAULT, mapDesc,
+                                                   D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, nullptr);
+        m_slopes       = allocator->CreateResource(D3D12_HEAP_TYPE_DEFAULT, mapDesc,
+                                                   D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, nullptr);
+        m_displacementSrv = descriptors->AllocatePersistent();
+        m_displacementUav = descriptors->AllocatePersistent();
+        m_slopesSrv       = descriptors->AllocatePersistent();
+        m_slopesUav       = descriptors->AllocatePersistent();
+        descriptors->CreateTextureSrv(m_displacementSrv, m_displacement->resource.Get());
+        descriptors->CreateTextureUav(m_displacementUav, m_displacement->resource.Get());
+        descriptors->CreateTextureSrv(m_slopesSrv, m_slopes->resource.Get());
+        descriptors->CreateTextureUav(m_slopesUav, m_slopes->resource.Get());
+
+        // Tiles: the list, then D3D12_DRAW_ARGUMENTS in its own buffer
+        const UINT64 tilesSize = kMaxTiles * sizeof(OceanTile);
+        m_tiles = allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, tilesSize, D3D12_RESOURCE_STATE_COMMON,
+                                          D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        m_tileArgs = allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, sizeof(D3D12_DRAW_ARGUMENTS),
+                                             D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        m_tilesSrv    = descriptors->AllocatePersistent();
+        m_tilesUav    = descriptors->AllocatePersistent();
+        m_tileArgsUav = descriptors->AllocatePersistent();
+        descriptors->CreateRawBufferSrv(m_tilesSrv, m_tiles->resource.Get(), 0, tilesSize);
+        descriptors->CreateRawBufferUav(m_tilesUav, m_tiles->resource.Get(), 0, tilesSize);
+        descriptors->CreateRawBufferUav(m_tileArgsUav, m_tileArgs->resource.Get(), 0, sizeof(D3D12_DRAW_ARGUMENTS));
+
+        // Queries: one result buffer, copied into this frame's readback slot
+        const UINT64 resultsSize = kMaxQueries * sizeof(float);
+        m_results = allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, resultsSize, D3D12_RESOURCE_STATE_COMMON,
+                                            D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        m_resultsUav = descriptors->AllocatePersistent();
+        descriptors->CreateRawBufferUav(m_resultsUav, m_results->resource.Get(), 0, resultsSize);
+        m_readback = allocator->CreateBuffer(D3D12_HEAP_TYPE_READBACK, resultsSize * m_slotCount,
+                                             D3D12_RESOURCE_STATE_COPY_DEST);
+        ThrowIfFailed(m_readback->resource->Map(0, nullptr, reinterpret_cast<void**>(&m_readbackCpu)));
+        for (UINT slot = 0; slot < m_slotCount; ++slot)
+            m_slots[slot].ids.reserve(kMaxQueries);
+        m_enabled = true;
+    }
+
+    void Shutdown()
+    {
+        if (!m_enabled)
+            return;
+        m_readback->resource->Unmap(0, nullptr);
+        m_allocator->Free(m_h0);
+        m_allocator->Free(m_spectrum[0]);
+        m_allocator->Free(m_spectrum[1]);
+        m_allocator->Free(m_displacement);
+        m_allocator->Free(m_slopes);
+        m_allocator->Free(m_tiles);
+        m_allocator->Free(m_tileArgs);
+        m_allocator->Free(m_results);
+        m_allocator->Free(m_readback);
+        m_enabled = false;
+    }
+
+    // ---- Queries, render thread
+
+    // The slot's last frame has finished on the GPU – its heights go into the table
+    void ResolveQueries(UINT slot)
+    {
+        Slot& pending = m_slots[slot];
+        m_stats.resolved = (UINT)pending.ids.size();
+        if (pending.ids.empty())
+            return;
+        const float* heights = m_readbackCpu + (size_t)slot * kMaxQueries;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < pending.ids.size(); ++i)
+        {
+            const uint32_t id = pending.ids[i];
+            if (id >= m_samples.size())
+                m_samples.resize((size_t)id + 1);      // warmup only – ids are dense and don't grow after
+            Sample& sample = m_samples[id];
+            sample.height[0] = sample.height[1];
+            sample.time[0]   = sample.time[1];
+            sample.height[1] = heights[i];
+            sample.time[1]   = pending.time;
+        }
+        m_stats.latency = (std::max)(m_lastAsked - pending.time, 0.0f);
+        pending.ids.clear();
+    }
+
+    // Remembers which ids this slot's QueryCS will answer, at what sea time; returns how many it takes
+    UINT SubmitQueries(UINT slot, const OceanQuery* queries, UINT count, float time)
+    {
+        count = (std::min)(count, kMaxQueries);
+        Slot& pending = m_slots[slot];
+        pending.time = time;
+        pending.ids.clear();
+        for (UINT i = 0; i < count; ++i)
+            pending.ids.push_back(queries[i].id);
+        m_stats.queries = count;
+        return count;
+    }
+
+    // Results buffer -> this slot's readback, after QueryCS
+    void RecordQueryReadback(ID3D12GraphicsCommandList* cl, UINT slot)
+    {
+        const UINT64 size = (UINT64)m_slots[slot].ids.size() * sizeof(float);
+        if (size)
+            cl->CopyBufferRegion(m_readback->resource.Get(), (UINT64)slot * kMaxQueries * sizeof(float),
+                                 m_results->resource.Get(), 0, size);
+    }
+
+    // ---- Queries, sim thread
+
+    // Sea surface height under each id at `time`, linear from its last two results; sea level
+    // for ids nothing has come back for yet
+    void SampleHeights(UINT count, const uint32_t* ids, float time, float* heights)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (UINT i = 0; i < count; ++i)
+        {
+            if (ids[i] >= m_samples.size() || m_samples[ids[i]].time[1] < 0.0f)
+            {
+                heights[i] = m_seaLevel;
+                continue;
+            }
+            const Sample& sample = m_samples[ids[i]];
+            float height = sample.height[1];
+            if (sample.time[0] >= 0.0f && sample.time[1] > sample.time[0])
+            {
+                const float ahead = (std::min)(time - sample.time[1], kMaxExtrapolation);
+                height += (sample.height[1] - sample.height[0]) / (sample.time[1] - sample.time[0]) * (std::max)(ahead, 0.0f);
+            }
+            heights[i] = height;
+        }
+        m_lastAsked = time;
+    }
+
+    // ---- Views, all persistent
+
+    UINT H0Srv() const { return m_h0Srv; }
+    UINT SpectrumSrv(UINT i) const { return m_spectrumSrv[i]; }
+    UINT SpectrumUav(UINT i) const { return m_spectrumUav[i]; }
+    UINT DisplacementSrv() const { return m_displacementSrv; }
+    UINT DisplacementUav() const { return m_displacementUav; }
+    UINT SlopesSrv() const { return m_slopesSrv; }
+    UINT SlopesUav() const { return m_slopesUav; }
+    UINT TilesSrv() const { return m_tilesSrv; }
+    UINT TilesUav() const { return m_tilesUav; }
+    UINT TileArgsUav() const { return m_tileArgsUav; }
+    UINT ResultsUav() const { return m_resultsUav; }
+
+    ID3D12Resource* Spectrum(UINT i) const { return m_spectrum[i]->resource.Get(); }
+    ID3D12Resource* Displacement() const { return m_displacement->resource.Get(); }
+    ID3D12Resource* Slopes() const { return m_slopes->resource.Get(); }
+    ID3D12Resource* Tiles() const { return m_tiles->resource.Get(); }
+    ID3D12Resource* TileArgs() const { return m_tileArgs->resource.Get(); }
+    ID3D12Resource* Results() const { return m_results->resource.Get(); }
+
+    bool         Enabled() const { return m_enabled; }
+    float        SeaLevel() const { return m_seaLevel; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Slot
+    {
+        std::vector<uint32_t> ids;      // result i answers ids[i]
+        float                 time = 0.0f;
+    };
+
+    // Last two results per id, oldest first; time < 0 = none yet
+    struct Sample
+    {
+        float height[2] = { 0.0f, 0.0f };
+        float time[2]   = { -1.0f, -1.0f };
+    };
+
+    GpuAllocator*       m_allocator   = nullptr;
+    UINT                m_slotCount   = 0;
+    float               m_seaLevel    = 0.0f;
+    bool                m_enabled     = false;
+
+    GpuAllocation*      m_h0           = nullptr;
+    GpuAllocation*      m_spectrum[2]  = {};
+    GpuAllocation*      m_displacement = nullptr;
+    GpuAllocation*      m_slopes       = nullptr;
+    GpuAllocation*      m_tiles        = nullptr;
+    GpuAllocation*      m_tileArgs     = nullptr;
+    GpuAllocation*      m_results      = nullptr;
+    GpuAllocation*      m_readback     = nullptr;
+    float*              m_readbackCpu  = nullptr;
+
+    UINT                m_h0Srv           = DescriptorHeap::kInvalid;
+    UINT                m_spectrumSrv[2]  = { DescriptorHeap::kInvalid, DescriptorHeap::kInvalid };
+    UINT                m_spectrumUav[2]  = { DescriptorHeap::kInvalid, DescriptorHeap::kInvalid };
+    UINT                m_displacementSrv = DescriptorHeap::kInvalid;
+    UINT                m_displacementUav = DescriptorHeap::kInvalid;
+    UINT                m_slopesSrv       = DescriptorHeap::kInvalid;
+    UINT                m_slopesUav       = DescriptorHeap::kInvalid;
+    UINT                m_tilesSrv        = DescriptorHeap::kInvalid;
+    UINT                m_tilesUav        = DescriptorHeap::kInvalid;
+    UINT                m_tileArgsUav     = DescriptorHeap::kInvalid;
+    UINT                m_resultsUav      = DescriptorHeap::kInvalid;
+
+    Slot                m_slots[kMaxSlots];
+    std::mutex          m_mutex;            // m_samples and m_lastAsked: render thread writes one, sim thread the other
+    std::vector<Sample> m_samples;
+    float               m_lastAsked = 0.0f;
+    Stats               m_stats;
+};
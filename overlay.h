@@ -0,0 +1,82 @@
+// ---------------------------------------------------------------
+// Debug overlay – solid rects and 3x5 pixel text, drawn as instanced quads
+// ---------------------------------------------------------------
+// Collects quads on the CPU; the renderer uploads Quads() and draws them
+// with shaders/overlay.hlsl in one DrawInstanced(6, count) over the back
+// buffer. No font texture – each glyph is a 15-bit mask in the quad itself.
+//
+//   overlay.Clear();
+//   overlay.Text(8, 8, 0xffffffff, "FRAME %.2f MS", ms);
+//   overlay.Rect(8, 30, 200, 4, 0x800000ff);
+#pragma once
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Mirrors the quad layout in shaders/overlay.hlsl – 32 bytes
+struct OverlayQuad
+{
+    float    rect[4];       // x, y, width, height in pixels, origin top left
+    uint32_t glyph;         // 3x5 mask, row-major from the top left bit 14; 0 = solid rect
+    uint32_t color;         // RGBA8, R in the low byte
+    uint32_t pad[2];
+};
+
+class DebugOverlay
+{
+public:
+    static const int kScale      = 2;                   // pixels per font texel
+    static const int kAdvance    = 4 * kScale;          // glyph + 1 texel spacing
+    static const int kLineHeight = 7 * kScale;
+
+    void Clear() { m_quads.clear(); }
+
+    void Rect(float x, float y, float width, float height, uint32_t color)
+    {
+        m_quads.push_back({ { x, y, width, height }, 0, color, {} });
+    }
+
+    // printf-style; returns the x just past the last glyph
+    float Text(float x, float y, uint32_t color, const char* format, ...)
+    {
+        char text[256];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+
+        for (const char* c = text; *c; ++c, x += kAdvance)
+        {
+            uint32_t glyph = Glyph(*c);
+            if (glyph)
+                m_quads.push_back({ { x, y, 3.0f * kScale, 5.0f * kScale }, glyph, color, {} });
+        }
+        return x;
+    }
+
+    const std::vector<OverlayQuad>& Quads() const { return m_quads; }
+
+private:
+    // ' ' .. '_', lower case folds onto upper case
+    static uint32_t Glyph(char c)
+    {
+        static const uint16_t font[64] =
+        {
+        0x0000, 0x2482, 0x0000, 0x5f7d, 0x0000, 0x52a5, 0x0000, 0x2400,
+        0x2922, 0x224a, 0x0aa8, 0x05d0, 0x0014, 0x01c0, 0x0002, 0x12a4,
+        0x7b6f, 0x2c97, 0x73e7, 0x73cf, 0x5bc9, 0x79cf, 0x79ef, 0x7249,
+        0x7bef, 0x7bcf, 0x0410, 0x0000, 0x1511, 0x0e38, 0x4454, 0x6282,
+        0x0000, 0x2bed, 0x6bae, 0x3923, 0x6b6e, 0x79a7, 0x79a4, 0x396b,
+        0x5bed, 0x7497, 0x126a, 0x5bad, 0x4927, 0x5fed, 0x6b6d, 0x2b6a,
+        0x6ba4, 0x2b73, 0x6bad, 0x388e, 0x7492, 0x5b6f, 0x5b6a, 0x5bfd,
+        0x5aad, 0x5a92, 0x72a7, 0x6926, 0x0000, 0x324b, 0x0000, 0x0007,
+        };
+        if (c >= 'a' && c <= 'z')
+            c = (char)(c - 'a' + 'A');
+        return (c >= ' ' && c <= '_') ? font[c - ' '] : 0;
+    }
+
+    std::vector<OverlayQuad> m_quads;
+};
@@ -0,0 +1,981 @@
+// ---------------------------------------------------------------
+// Physics – fixed step rigid bodies on the job system
+// ---------------------------------------------------------------
+// Spheres and boxes over an infinite static ground plane. Update() eats
+// frame time in fixed steps, so the simulation is the same at 30 or 300 fps;
+// GetTransform() blends the last two steps by Alpha() for rendering.
+//
+// A step:
+//   gravity/forces -> velocities
+//   sweep and prune on X (insertion sort, frames are coherent) -> pairs
+//   narrowphase -> contacts, sphere pairs four at a time in SSE
+//   wake sleeping islands something awake touches
+//   union-find islands, each solved on its own job (sequential impulses)
+//   SIMD integration of positions/orientations (simdmath.h)
+//
+// Contacts are speculative: anything within kContactMargin becomes a
+// contact that lets the bodies close the gap but no more, so fast cannonballs
+// don't tunnel thin things. Islands whose bodies all stayed under the sleep
+// thresholds for kTimeToSleep go to sleep and cost nothing but their AABB
+// until something awake touches them.
+//
+// Box vs box only tests corners against faces – no edge/edge contacts. Fine
+// for crates and debris, not for a box balanced on an edge.
+#pragma once
+
+#include "jobsystem.h"
+#include "simdmath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class PhysicsWorld
+{
+public:
+    using BodyId = uint32_t;
+
+    static constexpr float kFixedDt            = 1.0f / 60.0f;
+    static const uint32_t  kMaxSubSteps        = 4;         // per Update(), the rest of the backlog is dropped
+    static const uint32_t  kVelocityIterations = 8;
+    static constexpr float kContactMargin      = 0.05f;     // speculative contact distance
+    static constexpr float kPenetrationSlop    = 0.005f;
+    static constexpr float kBaumgarte          = 0.2f;
+    static constexpr float kRestitutionSpeed   = 1.0f;      // slower impacts don't bounce
+    static constexpr float kSleepLinear        = 0.05f;     // m/s
+    static constexpr float kSleepAngular       = 0.05f;     // rad/s
+    static constexpr float kTimeToSleep        = 0.5f;
+    static const BodyId    kGround             = ~0u;
+
+    enum Shape : uint32_t { kShapeSphere, kShapeBox };
+
+    struct BodyDesc
+    {
+        Shape  shape           = kShapeSphere;
+        Float3 halfExtents     = { 0.5f, 0.5f, 0.5f };      // box; a sphere's radius is halfExtents.x
+        float  mass            = 1.0f;                      // 0 = static
+        Float3 position        = { 0.0f, 0.0f, 0.0f };
+        Quat   rotation        = { 0.0f, 0.0f, 0.0f, 1.0f };
+        Float3 velocity        = { 0.0f, 0.0f, 0.0f };
+        Float3 angularVelocity = { 0.0f, 0.0f, 0.0f };
+        float  friction        = 0.5f;
+        float  restitution     = 0.2f;
+    };
+
+    struct Stats
+    {
+        uint32_t bodies   = 0;
+        uint32_t awake    = 0;
+        uint32_t pairs    = 0;
+        uint32_t contacts = 0;
+        uint32_t islands  = 0;
+        uint32_t steps    = 0;      // in the last Update()
+    };
+
+    void Init(JobSystem* jobs, const Float3& gravity = { 0.0f, -9.81f, 0.0f }, float groundHeight = 0.0f)
+    {
+        m_jobs         = jobs;
+        m_gravity      = gravity;
+        m_groundHeight = groundHeight;
+    }
+
+    BodyId AddBody(const BodyDesc& desc)
+    {
+        BodyId id;
+        if (!m_freeBodies.empty())
+        {
+            id = m_freeBodies.back();
+            m_freeBodies.pop_back();
+        }
+        else
+        {
+            id = (BodyId)m_bodies.size();
+            m_bodies.emplace_back();
+            for (std::vector<float>& column : m_soa)
+                column.push_back(0.0f);
+            m_invInertia.emplace_back();
+        }
+
+        Body& body = m_bodies[id];
+        body            = Body{};
+        body.alive      = true;
+        body.shape      = desc.shape;
+        body.half       = desc.shape == kShapeSphere ? Float3{ desc.halfExtents.x, desc.halfExtents.x, desc.halfExtents.x }
+                                                     : desc.halfExtents;
+        body.friction   = desc.friction;
+        body.restitution = desc.restitution;
+        body.link       = id;
+
+        const float invMass = desc.mass > 0.0f ? 1.0f / desc.mass : 0.0f;
+        body.awake = invMass > 0.0f;
+        if (invMass > 0.0f)
+        {
+            const Float3& h = body.half;
+            if (desc.shape == kShapeSphere)
+            {
+                const float i = 0.4f * desc.mass * h.x * h.x;
+                body.invInertiaLocal = { 1.0f / i, 1.0f / i, 1.0f / i };
+            }
+            else        // full extents are 2h
+                body.invInertiaLocal = { 3.0f / (desc.mass * (h.y * h.y + h.z * h.z)),
+                                         3.0f / (desc.mass * (h.x * h.x + h.z * h.z)),
+                                         3.0f / (desc.mass * (h.x * h.x + h.y * h.y)) };
+        }
+
+        const Quat rotation = Normalize(desc.rotation);
+        SetColumn3(kPosX, id, desc.position);
+        SetColumn3(kVelX, id, invMass > 0.0f ? desc.velocity : Float3{});
+        SetColumn3(kAngX, id, invMass > 0.0f ? desc.angularVelocity : Float3{});
+        SetColumn3(kForceX, id, {});
+        m_soa[kRotX][id] = rotation.x;
+        m_soa[kRotY][id] = rotation.y;
+        m_soa[kRotZ][id] = rotation.z;
+        m_soa[kRotW][id] = rotation.w;
+        m_soa[kInvMass][id]    = invMass;
+        m_soa[kMotionMass][id] = invMass;
+        body.prevPosition = desc.position;
+        body.prevRotation = rotation;
+
+        m_sapDirty = true;
+        return id;
+    }
+
+    void RemoveBody(BodyId id)
+    {
+        if (id >= m_bodies.size() || !m_bodies[id].alive)
+            return;
+        Wake(id);                   // whatever rested on it has to notice
+        Unlink(id);
+        m_bodies[id].alive = false;
+        m_bodies[id].awake = false;
+        m_soa[kInvMass][id] = m_soa[kMotionMass][id] = 0.0f;
+        m_freeBodies.push_back(id);
+        m_sapDirty = true;
+    }
+
+    // Wakes the body's whole last island
+    void Wake(BodyId id)
+    {
+        if (id >= m_bodies.size() || !m_bodies[id].alive || m_soa[kInvMass][id] == 0.0f)
+            return;
+        BodyId member = id;
+        do
+        {
+            Body& body = m_bodies[member];
+            if (!body.awake)
+            {
+                body.awake     = true;
+                body.sleepTime = 0.0f;
+                m_soa[kMotionMass][member] = m_soa[kInvMass][member];
+            }
+            member = body.link;
+        } while (member != id);
+    }
+
+    void ApplyImpulse(BodyId id, const Float3& impulse)
+    {
+        Wake(id);
+        const float invMass = m_soa[kInvMass][id];
+        SetColumn3(kVelX, id, Column3(kVelX, id) + impulse * invMass);
+    }
+
+    void ApplyForce(BodyId id, const Float3& force)
+    {
+        Wake(id);
+        SetColumn3(kForceX, id, Column3(kForceX, id) + force);
+    }
+
+    // Straight onto the velocity, mass or not – buoyancy and drag, already scaled by the caller's dt.
+    // Frame-rate independent where a force isn't: forces only reach the next fixed step.
+    void ApplyVelocityChange(BodyId id, const Float3& delta)
+    {
+        if (m_soa[kInvMass][id] == 0.0f)
+            return;
+        Wake(id);
+        SetColumn3(kVelX, id, Column3(kVelX, id) + delta);
+    }
+
+    // Runs the fixed steps frameDt covers; returns how many ran
+    uint32_t Update(float frameDt)
+    {
+        m_accumulator += frameDt;
+        uint32_t steps = 0;
+        while (m_accumulator >= kFixedDt && steps < kMaxSubSteps)
+        {
+            Step(kFixedDt);
+            m_accumulator -= kFixedDt;
+            ++steps;
+        }
+        if (steps == kMaxSubSteps && m_accumulator >= kFixedDt)
+            m_accumulator = fmodf(m_accumulator, kFixedDt);      // can't keep up – slow down rather than spiral
+        m_stats.steps = steps;
+        return steps;
+    }
+
+    // How far between the last two steps the frame is, 0..1
+    float Alpha() const { return m_accumulator / kFixedDt; }
+
+    // Blended between the last two steps by Alpha(); scale is 1
+    Transform GetTransform(BodyId id) const
+    {
+        const Body&  body  = m_bodies[id];
+        const float  alpha = Alpha();
+        const Float3 position = Column3(kPosX, id);
+        Quat rotation{ m_soa[kRotX][id], m_soa[kRotY][id], m_soa[kRotZ][id], m_soa[kRotW][id] };
+
+        // nlerp, along the short way round
+        const Quat& prev = body.prevRotation;
+        const float sign = prev.x * rotation.x + prev.y * rotation.y + prev.z * rotation.z + prev.w * rotation.w < 0.0f
+                               ? -1.0f : 1.0f;
+        rotation = Normalize(Quat{ prev.x + (rotation.x * sign - prev.x) * alpha, prev.y + (rotation.y * sign - prev.y) * alpha,
+                                   prev.z + (rotation.z * sign - prev.z) * alpha, prev.w + (rotation.w * sign - prev.w) * alpha });
+        return { body.prevPosition + (position - body.prevPosition) * alpha, 1.0f, rotation };
+    }
+
+    Float3 GetVelocity(BodyId id) const { return Column3(kVelX, id); }
+    bool   IsAwake(BodyId id) const { return m_bodies[id].awake; }
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    // SoA columns – the layout simdmath.h's IntegrateBodies wants
+    enum Column : uint32_t
+    {
+        kPosX, kPosY, kPosZ,
+        kVelX, kVelY, kVelZ,
+        kAngX, kAngY, kAngZ,
+        kRotX, kRotY, kRotZ, kRotW,
+        kForceX, kForceY, kForceZ,
+        kInvMass,
+        kMotionMass,            // invMass while awake, 0 asleep – what integration sees
+        kColumnCount
+    };
+
+    struct Body
+    {
+        bool     alive       = false;
+        bool     awake       = false;
+        Shape    shape       = kShapeSphere;
+        Float3   half        = {};
+        Float3   invInertiaLocal = {};
+        float    friction    = 0.5f;
+        float    restitution = 0.2f;
+        float    sleepTime   = 0.0f;
+        BodyId   link        = 0;       // ring through the island it fell asleep in
+        Float3   prevPosition = {};
+        Quat     prevRotation = {};
+    };
+
+    struct Aabb
+    {
+        Float3 min, max;
+    };
+
+    struct Pair
+    {
+        BodyId a, b;
+    };
+
+    struct Contact
+    {
+        BodyId a, b;                    // b is never kGround; a may be
+        Float3 normal;                  // a -> b
+        Float3 point;
+        float  penetration;             // < 0: speculative, the gap left
+        float  friction;
+        float  restitution;
+
+        // Solver
+        Float3 rA, rB, tangent1, tangent2;
+        float  normalMass, tangentMass1, tangentMass2;
+        float  bias;
+        float  normalImpulse, tangentImpulse1, tangentImpulse2;
+    };
+
+    struct Island
+    {
+        uint32_t firstBody, bodyCount;
+        uint32_t firstContact, contactCount;
+    };
+
+    struct Matrix3
+    {
+        float m[3][3];
+    };
+
+    // ---- Columns
+
+    Float3 Column3(uint32_t column, BodyId id) const
+    {
+        return { m_soa[column][id], m_soa[column + 1][id], m_soa[column + 2][id] };
+    }
+
+    void SetColumn3(uint32_t column, BodyId id, const Float3& value)
+    {
+        m_soa[column][id]     = value.x;
+        m_soa[column + 1][id] = value.y;
+        m_soa[column + 2][id] = value.z;
+    }
+
+    Quat Rotation(BodyId id) const
+    {
+        return { m_soa[kRotX][id], m_soa[kRotY][id], m_soa[kRotZ][id], m_soa[kRotW][id] };
+    }
+
+    // ---- Island rings (sleeping)
+
+    void Unlink(BodyId id)
+    {
+        BodyId prev = id;
+        while (m_bodies[prev].link != id)
+            prev = m_bodies[prev].link;
+        m_bodies[prev].link = m_bodies[id].link;
+        m_bodies[id].link   = id;
+    }
+
+    bool Dynamic(BodyId id) const { return id != kGround && m_soa[kInvMass][id] > 0.0f; }
+    bool Moving(BodyId id) const { return Dynamic(id) && m_bodies[id].awake; }
+
+    // ---- Step
+
+    void Step(float dt)
+    {
+        const uint32_t bodyCount = (uint32_t)m_bodies.size();
+        for (uint32_t i = 0; i < bodyCount; ++i)
+        {
+            m_bodies[i].prevPosition = Column3(kPosX, i);
+            m_bodies[i].prevRotation = Rotation(i);
+        }
+
+        ApplyForces(dt);
+        UpdateInertia();
+        Broadphase();
+        Narrowphase();
+        WakeTouched();
+        BuildIslands();
+        SolveIslands(dt);
+        IntegratePositions(dt);
+
+        uint32_t alive = 0, awake = 0;
+        for (const Body& body : m_bodies)
+        {
+            alive += body.alive ? 1 : 0;
+            awake += body.awake ? 1 : 0;
+        }
+        m_stats.bodies   = alive;
+        m_stats.awake    = awake;
+        m_stats.pairs    = (uint32_t)m_pairs.size();
+        m_stats.contacts = (uint32_t)m_contacts.size();
+        m_stats.islands  = (uint32_t)m_islands.size();
+    }
+
+    // Gravity and accumulated forces into velocities; sleeping and static bodies have motion mass 0
+    void ApplyForces(float dt)
+    {
+        const uint32_t count = (uint32_t)m_bodies.size();
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            const float* motionMass = m_soa[kMotionMass].data();
+            float*       velocity   = m_soa[kVelX + k].data();
+            float*       force      = m_soa[kForceX + k].data();
+            const float  gravity    = (&m_gravity.x)[k] * dt;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                velocity[i] += motionMass[i] > 0.0f ? gravity + force[i] * motionMass[i] * dt : 0.0f;
+                force[i]     = 0.0f;
+            }
+        }
+    }
+
+    // World space inverse inertia of everything that moves: R * diag * R^T
+    void UpdateInertia()
+    {
+        for (uint32_t i = 0; i < (uint32_t)m_bodies.size(); ++i)
+        {
+            if (!Moving(i))
+                continue;
+            const Float3x4 r = ToMatrix({ {}, 1.0f, Rotation(i) });
+            const Float3&  d = m_bodies[i].invInertiaLocal;
+            Matrix3& out = m_invInertia[i];
+            for (int row = 0; row < 3; ++row)
+                for (int col = 0; col < 3; ++col)
+                    out.m[row][col] = r.m[row][0] * d.x * r.m[col][0] + r.m[row][1] * d.y * r.m[col][1] +
+                                      r.m[row][2] * d.z * r.m[col][2];
+        }
+    }
+
+    Float3 InvInertiaTimes(BodyId id, const Float3& v) const
+    {
+        if (!Moving(id))
+            return {};
+        const Matrix3& m = m_invInertia[id];
+        return { m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z,
+                 m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z,
+                 m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z };
+    }
+
+    // ---- Broadphase – sweep and prune on X
+
+    void Broadphase()
+    {
+        const uint32_t bodyCount = (uint32_t)m_bodies.size();
+        m_aabbs.resize(bodyCount);
+        for (uint32_t i = 0; i < bodyCount; ++i)
+        {
+            if (!m_bodies[i].alive)
+                continue;
+            const Body&  body   = m_bodies[i];
+            const Float3 center = Column3(kPosX, i);
+            Float3 extent = body.half;
+            if (body.shape == kShapeBox)
+            {
+                const Float3x4 r = ToMatrix({ {}, 1.0f, Rotation(i) });
+                extent = { fabsf(r.m[0][0]) * body.half.x + fabsf(r.m[0][1]) * body.half.y + fabsf(r.m[0][2]) * body.half.z,
+                           fabsf(r.m[1][0]) * body.half.x + fabsf(r.m[1][1]) * body.half.y + fabsf(r.m[1][2]) * body.half.z,
+                           fabsf(r.m[2][0]) * body.half.x + fabsf(r.m[2][1]) * body.half.y + fabsf(r.m[2][2]) * body.half.z };
+            }
+            // Margin both ways so speculative contacts are found; fast bodies sweep their motion
+            const Float3 v      = Column3(kVelX, i);
+            const Float3 margin = Float3{ kContactMargin, kContactMargin, kContactMargin } + extent;
+            const Float3 travel = v * kFixedDt;
+            m_aabbs[i] = { Min(center - margin, center - margin + travel), Max(center + margin, center + margin + travel) };
+        }
+
+        if (m_sapDirty)
+        {
+            m_sapOrder.clear();
+            for (uint32_t i = 0; i < bodyCount; ++i)
+                if (m_bodies[i].alive)
+                    m_sapOrder.push_back(i);
+            std::sort(m_sapOrder.begin(), m_sapOrder.end(),
+                      [this](BodyId a, BodyId b) { return m_aabbs[a].min.x < m_aabbs[b].min.x; });
+            m_sapDirty = false;
+        }
+        // Insertion sort – last step's order is nearly right
+        for (uint32_t i = 1; i < (uint32_t)m_sapOrder.size(); ++i)
+        {
+            const BodyId id  = m_sapOrder[i];
+            const float  key = m_aabbs[id].min.x;
+            uint32_t j = i;
+            for (; j > 0 && m_aabbs[m_sapOrder[j - 1]].min.x > key; --j)
+                m_sapOrder[j] = m_sapOrder[j - 1];
+            m_sapOrder[j] = id;
+        }
+
+        // Sweep in slices, one pair list per job
+        const uint32_t count = (uint32_t)m_sapOrder.size();
+        const uint32_t slice = 512;
+        const uint32_t jobs  = (count + slice - 1) / slice;
+        m_jobPairs.resize((std::max)(jobs, 1u));
+        JobSystem::Counter counter;
+        m_jobs->ParallelFor(jobs, 1, [this, count, slice](uint32_t job, uint32_t)
+        {
+            std::vector<Pair>& pairs = m_jobPairs[job];
+            pairs.clear();
+            const uint32_t end = (std::min)(count, (job + 1) * slice);
+            for (uint32_t i = job * slice; i < end; ++i)
+            {
+                const BodyId a    = m_sapOrder[i];
+                const Aabb&  boxA = m_aabbs[a];
+                const bool   movingA = Moving(a);
+                for (uint32_t j = i + 1; j < count; ++j)
+                {
+                    const BodyId b    = m_sapOrder[j];
+                    const Aabb&  boxB = m_aabbs[b];
+                    if (boxB.min.x > boxA.max.x)
+                        break;
+                    if (!movingA && !Moving(b))
+                        continue;
+                    if (boxA.max.y < boxB.min.y || boxB.max.y < boxA.min.y ||
+                        boxA.max.z < boxB.min.z || boxB.max.z < boxA.min.z)
+                        continue;
+                    pairs.push_back({ a, b });
+                }
+            }
+        }, counter);
+        m_jobs->Wait(counter);
+
+        m_pairs.clear();
+        for (uint32_t job = 0; job < jobs; ++job)
+            m_pairs.insert(m_pairs.end(), m_jobPairs[job].begin(), m_jobPairs[job].end());
+    }
+
+    // ---- Narrowphase
+
+    void AddContact(std::vector<Contact>& out, BodyId a, BodyId b, const Float3& normal, const Float3& point,
+                    float penetration) const
+    {
+        // The solver wants b to be a real body
+        Contact c{};
+        const bool swap = (b == kGround);
+        c.a           = swap ? b : a;
+        c.b           = swap ? a : b;
+        c.normal      = swap ? -normal : normal;
+        c.point       = point;
+        c.penetration = penetration;
+        const Body& bodyB = m_bodies[c.b];
+        const float frictionA    = c.a == kGround ? 0.6f : m_bodies[c.a].friction;
+        const float restitutionA = c.a == kGround ? 0.1f : m_bodies[c.a].restitution;
+        c.friction    = sqrtf(frictionA * bodyB.friction);
+        c.restitution = (std::max)(restitutionA, bodyB.restitution);
+        out.push_back(c);
+    }
+
+    void SphereSphere(std::vector<Contact>& out, BodyId a, BodyId b) const
+    {
+        const Float3 pa = Column3(kPosX, a), pb = Column3(kPosX, b);
+        const float  ra = m_bodies[a].half.x, rb = m_bodies[b].half.x;
+        const Float3 d    = pb - pa;
+        const float  dist = Length(d);
+        const float  pen  = ra + rb - dist;
+        if (pen < -kContactMargin)
+            return;
+        const Float3 n = dist > 1e-6f ? d * (1.0f / dist) : Float3{ 0.0f, 1.0f, 0.0f };
+        AddContact(out, a, b, n, pa + n * (ra - 0.5f * pen), pen);
+    }
+
+    // Rejects four sphere pairs at once, contacts for the rest
+    void SphereSphere4(std::vector<Contact>& out, const Pair* pairs, uint32_t count) const
+    {
+        alignas(16) float ax[4] = {}, ay[4] = {}, az[4] = {}, bx[4] = {}, by[4] = {}, bz[4] = {}, r[4] = {};
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const BodyId a = pairs[i].a, b = pairs[i].b;
+            ax[i] = m_soa[kPosX][a]; ay[i] = m_soa[kPosY][a]; az[i] = m_soa[kPosZ][a];
+            bx[i] = m_soa[kPosX][b]; by[i] = m_soa[kPosY][b]; bz[i] = m_soa[kPosZ][b];
+            r[i]  = m_bodies[a].half.x + m_bodies[b].half.x + kContactMargin;
+        }
+        const __m128 dx = _mm_sub_ps(_mm_load_ps(bx), _mm_load_ps(ax));
+        const __m128 dy = _mm_sub_ps(_mm_load_ps(by), _mm_load_ps(ay));
+        const __m128 dz = _mm_sub_ps(_mm_load_ps(bz), _mm_load_ps(az));
+        const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        const __m128 reach  = _mm_mul_ps(_mm_load_ps(r), _mm_load_ps(r));
+        const int    hits   = _mm_movemask_ps(_mm_cmple_ps(distSq, reach));
+        for (uint32_t i = 0; i < count; ++i)
+            if (hits & (1 << i))
+                SphereSphere(out, pairs[i].a, pairs[i].b);
+    }
+
+    // Normal box -> sphere
+    void BoxSphere(std::vector<Contact>& out, BodyId box, BodyId sphere) const
+    {
+        const Float3 pb = Column3(kPosX, box), ps = Column3(kPosX, sphere);
+        const Quat   q  = Rotation(box);
+        const Float3 h  = m_bodies[box].half;
+        const float  radius = m_bodies[sphere].half.x;
+
+        const Float3 local   = Rotate(Conjugate(q), ps - pb);
+        const Float3 closest = { std::clamp(local.x, -h.x, h.x), std::clamp(local.y, -h.y, h.y), std::clamp(local.z, -h.z, h.z) };
+        const Float3 d       = local - closest;
+        const float  distSq  = Dot(d, d);
+
+        Float3 normalLocal;
+        float  pen;
+        if (distSq > 1e-12f)
+        {
+            const float dist = sqrtf(distSq);
+            pen = radius - dist;
+            if (pen < -kContactMargin)
+                return;
+            normalLocal = d * (1.0f / dist);
+        }
+        else
+        {
+            // Center inside – out through the nearest face
+            const float fx = h.x - fabsf(local.x), fy = h.y - fabsf(local.y), fz = h.z - fabsf(local.z);
+            if (fx <= fy && fx <= fz)      { normalLocal = { local.x < 0.0f ? -1.0f : 1.0f, 0.0f, 0.0f }; pen = radius + fx; }
+            else if (fy <= fz)             { normalLocal = { 0.0f, local.y < 0.0f ? -1.0f : 1.0f, 0.0f }; pen = radius + fy; }
+            else                           { normalLocal = { 0.0f, 0.0f, local.z < 0.0f ? -1.0f : 1.0f }; pen = radius + fz; }
+        }
+        AddContact(out, box, sphere, Rotate(q, normalLocal), pb + Rotate(q, closest), pen);
+    }
+
+    // Corners of `box` against the faces of `other`; normal other -> box
+    void BoxCorners(std::vector<Contact>& out, BodyId box, BodyId other) const
+    {
+        const Float3 pa = Column3(kPosX, box), pb = Column3(kPosX, other);
+        const Quat   qa = Rotation(box), qb = Rotation(other);
+        const Float3 ha = m_bodies[box].half, hb = m_bodies[other].half;
+        const Quat   toB = Conjugate(qb);
+        for (uint32_t corner = 0; corner < 8; ++corner)
+        {
+            const Float3 offset{ corner & 1 ? ha.x : -ha.x, corner & 2 ? ha.y : -ha.y, corner & 4 ? ha.z : -ha.z };
+            const Float3 world = pa + Rotate(qa, offset);
+            const Float3 local = Rotate(toB, world - pb);
+            const float  fx = hb.x - fabsf(local.x), fy = hb.y - fabsf(local.y), fz = hb.z - fabsf(local.z);
+            if (fx < -kContactMargin || fy < -kContactMargin || fz < -kContactMargin)
+                continue;
+            // Outside on one face only counts as speculative if it's inside the others
+            Float3 normalLocal;
+            float  pen;
+            if (fx <= fy && fx <= fz)      { normalLocal = { local.x < 0.0f ? -1.0f : 1.0f, 0.0f, 0.0f }; pen = fx; }
+            else if (fy <= fz)             { normalLocal = { 0.0f, local.y < 0.0f ? -1.0f : 1.0f, 0.0f }; pen = fy; }
+            else                           { normalLocal = { 0.0f, 0.0f, local.z < 0.0f ? -1.0f : 1.0f }; pen = fz; }
+            if ((fx < 0.0f) + (fy < 0.0f) + (fz < 0.0f) > 1)
+                continue;
+            AddContact(out, other, box, Rotate(qb, normalLocal), world, pen);
+        }
+    }
+
+    void GroundContacts(std::vector<Contact>& out, BodyId id) const
+    {
+        const Body&  body = m_bodies[id];
+        const Float3 p    = Column3(kPosX, id);
+        const Float3 up{ 0.0f, 1.0f, 0.0f };
+        if (body.shape == kShapeSphere)
+        {
+            const float pen = m_groundHeight - (p.y - body.half.x);
+            if (pen >= -kContactMargin)
+                AddContact(out, kGround, id, up, { p.x, m_groundHeight, p.z }, pen);
+            return;
+        }
+        const Quat q = Rotation(id);
+        for (uint32_t corner = 0; corner < 8; ++corner)
+        {
+            const Float3 offset{ corner & 1 ? body.half.x : -body.half.x, corner & 2 ? body.half.y : -body.half.y,
+                                 corner & 4 ? body.half.z : -body.half.z };
+            const Float3 world = p + Rotate(q, offset);
+            const float  pen   = m_groundHeight - world.y;
+            if (pen >= -kContactMargin)
+                AddContact(out, kGround, id, up, world, pen);
+        }
+    }
+
+    void Narrowphase()
+    {
+        // Pairs, then one slot per moving body for the ground
+        m_moving.clear();
+        for (uint32_t i = 0; i < (uint32_t)m_bodies.size(); ++i)
+            if (Moving(i))
+                m_moving.push_back(i);
+
+        const uint32_t pairCount = (uint32_t)m_pairs.size();
+        const uint32_t total     = pairCount + (uint32_t)m_moving.size();
+        const uint32_t perJob    = 256;
+        const uint32_t jobs      = (total + perJob - 1) / perJob;
+        m_jobContacts.resize((std::max)(jobs, 1u));
+        JobSystem::Counter counter;
+        m_jobs->ParallelFor(jobs, 1, [this, pairCount, total, perJob](uint32_t job, uint32_t)
+        {
+            std::vector<Contact>& out = m_jobContacts[job];
+            out.clear();
+            Pair     spheres[4];
+            uint32_t sphereCount = 0;
+            const uint32_t end = (std::min)(total, (job + 1) * perJob);
+            for (uint32_t i = job * perJob; i < end; ++i)
+            {
+                if (i >= pairCount)
+                {
+                    GroundContacts(out, m_moving[i - pairCount]);
+                    continue;
+                }
+                const Pair& pair = m_pairs[i];
+                const Shape sa = m_bodies[pair.a].shape, sb = m_bodies[pair.b].shape;
+                if (sa == kShapeSphere && sb == kShapeSphere)
+                {
+                    spheres[sphereCount++] = pair;
+                    if (sphereCount == 4)
+                    {
+                        SphereSphere4(out, spheres, 4);
+                        sphereCount = 0;
+                    }
+                }
+                else if (sa == kShapeBox && sb == kShapeSphere)
+                    BoxSphere(out, pair.a, pair.b);
+                else if (sa == kShapeSphere)
+                    BoxSphere(out, pair.b, pair.a);
+                else
+                {
+                    BoxCorners(out, pair.a, pair.b);
+                    BoxCorners(out, pair.b, pair.a);
+                }
+            }
+            if (sphereCount)
+                SphereSphere4(out, spheres, sphereCount);
+        }, counter);
+        m_jobs->Wait(counter);
+
+        m_contacts.clear();
+        for (uint32_t job = 0; job < jobs; ++job)
+            m_contacts.insert(m_contacts.end(), m_jobContacts[job].begin(), m_jobContacts[job].end());
+    }
+
+    // Anything awake touching a sleeper wakes the sleeper's island
+    void WakeTouched()
+    {
+        for (const Contact& c : m_contacts)
+        {
+            if (c.a == kGround)
+                continue;
+            const bool awakeA = Moving(c.a), awakeB = Moving(c.b);
+            if (awakeA && Dynamic(c.b) && !awakeB)
+                Wake(c.b);
+            else if (awakeB && Dynamic(c.a) && !awakeA)
+                Wake(c.a);
+        }
+    }
+
+    // ---- Islands – union-find over contacts between moving bodies
+
+    uint32_t Find(uint32_t i)
+    {
+        while (m_parent[i] != i)
+            i = m_parent[i] = m_parent[m_parent[i]];
+        return i;
+    }
+
+    void BuildIslands()
+    {
+        const uint32_t bodyCount = (uint32_t)m_bodies.size();
+        m_parent.resize(bodyCount);
+        for (uint32_t i = 0; i < bodyCount; ++i)
+            m_parent[i] = i;
+        for (const Contact& c : m_contacts)
+            if (Moving(c.a) && Moving(c.b))
+                m_parent[Find(c.a)] = Find(c.b);
+
+        // Island per root, then bodies and contacts bucketed by island
+        m_islandOf.assign(bodyCount, ~0u);
+        m_islands.clear();
+        for (uint32_t i = 0; i < bodyCount; ++i)
+        {
+            if (!Moving(i))
+                continue;
+            const uint32_t root = Find(i);
+            if (m_islandOf[root] == ~0u)
+            {
+                m_islandOf[root] = (uint32_t)m_islands.size();
+                m_islands.push_back({ 0, 0, 0, 0 });
+            }
+            m_islandOf[i] = m_islandOf[root];
+            ++m_islands[m_islandOf[i]].bodyCount;
+        }
+
+        // Contacts whose bodies are both asleep or static (woken too late this step) wait for the next one
+        auto islandOf = [this](const Contact& c) { return Moving(c.b) ? m_islandOf[c.b] : Moving(c.a) ? m_islandOf[c.a] : ~0u; };
+        for (const Contact& c : m_contacts)
+            if (islandOf(c) != ~0u)
+                ++m_islands[islandOf(c)].contactCount;
+
+        uint32_t bodyOffset = 0, contactOffset = 0;
+        for (Island& island : m_islands)
+        {
+            island.firstBody    = bodyOffset;
+            island.firstContact = contactOffset;
+            bodyOffset    += island.bodyCount;
+            contactOffset += island.contactCount;
+            island.bodyCount = island.contactCount = 0;
+        }
+        m_islandBodies.resize(bodyOffset);
+        m_islandContacts.resize(contactOffset);
+        for (uint32_t i = 0; i < bodyCount; ++i)
+            if (Moving(i))
+            {
+                Island& island = m_islands[m_islandOf[i]];
+                m_islandBodies[island.firstBody + island.bodyCount++] = i;
+            }
+        for (const Contact& c : m_contacts)
+        {
+            const uint32_t index = islandOf(c);
+            if (index == ~0u)
+                continue;
+            Island& island = m_islands[index];
+            m_islandContacts[island.firstContact + island.contactCount++] = c;
+        }
+    }
+
+    // ---- Solver – sequential impulses, one job per run of islands
+
+    Float3 VelocityAt(BodyId id, const Float3& r) const
+    {
+        if (id == kGround)
+            return {};
+        return Column3(kVelX, id) + Cross(Column3(kAngX, id), r);
+    }
+
+    void ApplyBodyImpulse(BodyId id, const Float3& r, const Float3& impulse)
+    {
+        if (!Moving(id))
+            return;         // static and sleeping bodies are shared between islands – never written
+        SetColumn3(kVelX, id, Column3(kVelX, id) + impulse * m_soa[kInvMass][id]);
+        SetColumn3(kAngX, id, Column3(kAngX, id) + InvInertiaTimes(id, Cross(r, impulse)));
+    }
+
+    float InvMass(BodyId id) const { return Moving(id) ? m_soa[kInvMass][id] : 0.0f; }
+
+    float EffectiveMass(const Contact& c, const Float3& axis) const
+    {
+        const Float3 raXn = Cross(c.rA, axis), rbXn = Cross(c.rB, axis);
+        const float  k = InvMass(c.a) + InvMass(c.b) +
+                         (c.a == kGround ? 0.0f : Dot(raXn, InvInertiaTimes(c.a, raXn))) + Dot(rbXn, InvInertiaTimes(c.b, rbXn));
+        return k > 0.0f ? 1.0f / k : 0.0f;
+    }
+
+    void SolveIsland(const Island& island, float dt)
+    {
+        Contact* contacts = m_islandContacts.data() + island.firstContact;
+        for (uint32_t i = 0; i < island.contactCount; ++i)
+        {
+            Contact& c = contacts[i];
+            c.rA = c.a == kGround ? Float3{} : c.point - Column3(kPosX, c.a);
+            c.rB = c.point - Column3(kPosX, c.b);
+
+            // Any two tangents – friction is isotropic
+            const Float3 helper = fabsf(c.normal.x) < 0.57f ? Float3{ 1.0f, 0.0f, 0.0f } : Float3{ 0.0f, 1.0f, 0.0f };
+            c.tangent1 = Normalize(Cross(c.normal, helper));
+            c.tangent2 = Cross(c.normal, c.tangent1);
+            c.normalMass   = EffectiveMass(c, c.normal);
+            c.tangentMass1 = EffectiveMass(c, c.tangent1);
+            c.tangentMass2 = EffectiveMass(c, c.tangent2);
+
+            // Speculative: may close the gap, no more. Touching: push out, bounce if it hit hard enough
+            const float vn = Dot(VelocityAt(c.b, c.rB) - VelocityAt(c.a, c.rA), c.normal);
+            if (c.penetration < 0.0f)
+                c.bias = c.penetration / dt;
+            else
+                c.bias = (std::max)(kBaumgarte / dt * (std::max)(c.penetration - kPenetrationSlop, 0.0f),
+                                  vn < -kRestitutionSpeed ? -c.restitution * vn : 0.0f);
+        }
+
+        for (uint32_t iteration = 0; iteration < kVelocityIterations; ++iteration)
+        {
+            for (uint32_t i = 0; i < island.contactCount; ++i)
+            {
+                Contact& c = contacts[i];
+
+                // Friction first, bounded by last iteration's normal impulse
+                const float maxFriction = c.friction * c.normalImpulse;
+                const Float3* tangents[2] = { &c.tangent1, &c.tangent2 };
+                const float   masses[2]   = { c.tangentMass1, c.tangentMass2 };
+                float*        impulses[2] = { &c.tangentImpulse1, &c.tangentImpulse2 };
+                for (int t = 0; t < 2; ++t)
+                {
+                    const float vt      = Dot(VelocityAt(c.b, c.rB) - VelocityAt(c.a, c.rA), *tangents[t]);
+                    const float old     = *impulses[t];
+                    *impulses[t]        = std::clamp(old - vt * masses[t], -maxFriction, maxFriction);
+                    const Float3 impulse = *tangents[t] * (*impulses[t] - old);
+                    ApplyBodyImpulse(c.a, c.rA, -impulse);
+                    ApplyBodyImpulse(c.b, c.rB, impulse);
+                }
+
+                const float  vn  = Dot(VelocityAt(c.b, c.rB) - VelocityAt(c.a, c.rA), c.normal);
+                const float  old = c.normalImpulse;
+                c.normalImpulse  = (std::max)(old + (c.bias - vn) * c.normalMass, 0.0f);
+                const Float3 impulse = c.normal * (c.normalImpulse - old);
+                ApplyBodyImpulse(c.a, c.rA, -impulse);
+                ApplyBodyImpulse(c.b, c.rB, impulse);
+            }
+        }
+
+        // Sleep once every body in the island has been still long enough
+        float minSleepTime = kTimeToSleep * 2.0f;
+        for (uint32_t i = 0; i < island.bodyCount; ++i)
+        {
+            const BodyId id = m_islandBodies[island.firstBody + i];
+            Body& body = m_bodies[id];
+            const Float3 v = Column3(kVelX, id), w = Column3(kAngX, id);
+            if (Dot(v, v) > kSleepLinear * kSleepLinear || Dot(w, w) > kSleepAngular * kSleepAngular)
+                body.sleepTime = 0.0f;
+            else
+                body.sleepTime += dt;
+            minSleepTime = (std::min)(minSleepTime, body.sleepTime);
+        }
+        if (minSleepTime < kTimeToSleep)
+            return;
+
+        // Remember the island as a ring so waking one body wakes all of them
+        for (uint32_t i = 0; i < island.bodyCount; ++i)
+        {
+            const BodyId id   = m_islandBodies[island.firstBody + i];
+            const BodyId next = m_islandBodies[island.firstBody + (i + 1) % island.bodyCount];
+            Body& body = m_bodies[id];
+            body.awake = false;
+            body.link  = next;
+            SetColumn3(kVelX, id, {});
+            SetColumn3(kAngX, id, {});
+            m_soa[kMotionMass][id] = 0.0f;
+        }
+    }
+
+    void SolveIslands(float dt)
+    {
+        // Rings from an earlier sleep are stale for anything awake now
+        for (uint32_t i = 0; i < (uint32_t)m_bodies.size(); ++i)
+            if (Moving(i))
+                m_bodies[i].link = i;
+
+        // Islands share nothing that moves: a body falling asleep is only ever read by its own island's job
+        const uint32_t islandCount = (uint32_t)m_islands.size();
+        const uint32_t perJob = (std::max)(1u, islandCount / (m_jobs->ThreadCount() * 4));
+        JobSystem::Counter counter;
+        m_jobs->ParallelFor(islandCount, perJob, [this, dt](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+                SolveIsland(m_islands[i], dt);
+        }, counter);
+        m_jobs->Wait(counter);
+    }
+
+    void IntegratePositions(float dt)
+    {
+        // Sleepers have zero velocity and motion mass, so the kernel can run over everything
+        BodyArrays bodies{};
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            bodies.position[k]        = m_soa[kPosX + k].data();
+            bodies.velocity[k]        = m_soa[kVelX + k].data();
+            bodies.angularVelocity[k] = m_soa[kAngX + k].data();
+            bodies.force[k]           = m_soa[kForceX + k].data();      // zero after ApplyForces
+        }
+        for (uint32_t k = 0; k < 4; ++k)
+            bodies.orientation[k] = m_soa[kRotX + k].data();
+        bodies.invMass = m_soa[kMotionMass].data();
+
+        const IntegrateParams step{ dt, { 0.0f, 0.0f, 0.0f }, 0.05f, 0.1f };     // gravity went in with ApplyForces
+        const uint32_t count  = (uint32_t)m_bodies.size();
+        const uint32_t perJob = 4096;
+        JobSystem::Counter counter;
+        m_jobs->ParallelFor(count, perJob, [&bodies, &step](uint32_t begin, uint32_t end)
+        {
+            BodyArrays range = bodies;
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                range.position[k]        += begin;
+                range.velocity[k]        += begin;
+                range.angularVelocity[k] += begin;
+                range.force[k]           += begin;
+            }
+            for (uint32_t k = 0; k < 4; ++k)
+                range.orientation[k] += begin;
+            range.invMass += begin;
+            IntegrateBodies(end - begin, range, step);
+        }, counter);
+        m_jobs->Wait(counter);
+    }
+
+    JobSystem*                        m_jobs         = nullptr;
+    Float3                            m_gravity      = {};
+    float                             m_groundHeight = 0.0f;
+    float                             m_accumulator  = 0.0f;
+
+    std::vector<Body>                 m_bodies;
+    std::vector<float>                m_soa[kColumnCount];
+    std::vector<Matrix3>              m_invInertia;       // world space, moving bodies only
+    std::vector<BodyId>               m_freeBodies;
+
+    // Per step
+    std::vector<Aabb>                 m_aabbs;
+    std::vector<BodyId>               m_sapOrder;         // alive bodies by AABB min.x
+    bool                              m_sapDirty = false;
+    std::vector<Pair>                 m_pairs;
+    std::vector<std::vector<Pair>>    m_jobPairs;
+    std::vector<BodyId>               m_moving;
+    std::vector<Contact>              m_contacts;
+    std::vector<std::vector<Contact>> m_jobContacts;
+    std::vector<uint32_t>             m_parent;
+    std::vector<uint32_t>             m_islandOf;
+    std::vector<Island>               m_islands;
+    std::vector<BodyId>               m_islandBodies;
+    std::vector<Contact>              m_islandContacts;
+    Stats                             m_stats;
+};
@@ -0,0 +1,376 @@
+// ---------------------------------------------------------------
+// Profiler – scoped CPU markers, GPU timestamps, Chrome trace export
+// ---------------------------------------------------------------
+//   PROFILE_SCOPE("Name");                 // any thread; names must be string literals
+//   PROFILE_GPU_SCOPE(cl, "Name");         // timestamp pair around the enclosed commands
+//
+// The macros report to a Profiler called g_profiler, which the app defines.
+//
+// Every finished scope, CPU or GPU, lands in one lock-free ring: fetch_add
+// claims a slot, a per-slot sequence number publishes it. Once a frame the
+// render thread drains the new events into smoothed per-name stats for the
+// overlay; the ring keeps the last kRingSize events for ExportChromeTrace().
+//
+// GPU timestamps are resolved into a readback buffer per frame slot and
+// picked up in BeginFrame(), once the slot's fence has passed, then moved
+// onto the QPC timeline with GetClockCalibration so CPU and GPU line up.
+// Markers also go out as PIX events: command list BeginEvent/EndEvent
+// always, CPU events through pix3.h when built with USE_PIX.
+#pragma once
+
+#include "dxhelpers.h"
+#include "jobsystem.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(USE_PIX)
+#include <pix3.h>
+#endif
+
+class Profiler
+{
+public:
+    static const uint32_t kGpuThread    = 1000;     // "thread" id GPU events are filed under
+    static const uint32_t kRingSize     = 1 << 16;  // power of two
+    static const UINT     kMaxGpuScopes = 64;       // per frame
+    static const UINT     kMaxFrames    = 3;
+
+    // Exponentially smoothed, in milliseconds
+    struct Stat
+    {
+        const char* name  = nullptr;
+        double      cpuMs = 0.0;
+        double      gpuMs = 0.0;
+        bool        cpu   = false;
+        bool        gpu   = false;
+    };
+
+    void Init(ID3D12Device* device, ID3D12CommandQueue* queue, UINT frameCount)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        m_qpcFrequency = frequency.QuadPart;
+        m_queue        = queue;
+        m_frameCount   = frameCount;
+
+        // Timestamps are optional – no frequency, no GPU timings
+        if (FAILED(queue->GetTimestampFrequency(&m_gpuFrequency)) || m_gpuFrequency == 0)
+            return;
+
+        D3D12_QUERY_HEAP_DESC heapDesc{};
+        heapDesc.Type  = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        heapDesc.Count = kMaxGpuScopes * 2 * frameCount;
+        ThrowIfFailed(device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&m_queryHeap)));
+
+        for (UINT i = 0; i < frameCount; ++i)
+        {
+            m_readback[i] = CreateBuffer(device, kMaxGpuScopes * 2 * sizeof(UINT64),
+                                         D3D12_HEAP_TYPE_READBACK, D3D12_RESOURCE_STATE_COPY_DEST);
+            ThrowIfFailed(m_readback[i]->Map(0, nullptr, reinterpret_cast<void**>(&m_readbackCpu[i])));
+        }
+    }
+
+    void Shutdown()
+    {
+        for (UINT i = 0; i < kMaxFrames; ++i)
+        {
+            if (m_readback[i])
+                m_readback[i]->Unmap(0, nullptr);
+            m_readback[i].Reset();
+            m_readbackCpu[i] = nullptr;
+        }
+        m_queryHeap.Reset();
+    }
+
+    static int64_t Now()
+    {
+        LARGE_INTEGER t;
+        QueryPerformanceCounter(&t);
+        return t.QuadPart;
+    }
+    double ToMs(int64_t ticks) const { return (double)ticks * 1000.0 / (double)m_qpcFrequency; }
+
+    // ---- CPU ----
+    void Record(const char* name, int64_t begin, int64_t end, uint32_t thread)
+    {
+        const uint64_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+        Event& e = m_ring[index & (kRingSize - 1)];
+        e.sequence.store(0, std::memory_order_relaxed);     // unpublished while we write
+        std::atomic_thread_fence(std::memory_order_release);
+        e.name.store(name, std::memory_order_relaxed);
+        e.begin.store(begin, std::memory_order_relaxed);
+        e.end.store(end, std::memory_order_relaxed);
+        e.thread.store(thread, std::memory_order_relaxed);
+        e.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    // ---- GPU ----
+    // Returns the scope to hand to EndGpu(). Thread safe, so parallel lists can use it.
+    UINT BeginGpu(ID3D12GraphicsCommandList* cl, const char* name)
+    {
+        cl->BeginEvent(1, name, (UINT)strlen(name) + 1);   // 1 = ANSI string, what PIX expects
+        if (!m_queryHeap)
+            return ~0u;
+        const UINT scope = m_gpuScopeCount.fetch_add(1, std::memory_order_relaxed);
+        if (scope >= kMaxGpuScopes)
+            return ~0u;
+        m_gpuNames[m_slot][scope] = name;
+        cl->EndQuery(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex(m_slot, scope * 2));
+        return scope;
+    }
+
+    void EndGpu(ID3D12GraphicsCommandList* cl, UINT scope)
+    {
+        if (scope != ~0u)
+            cl->EndQuery(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex(m_slot, scope * 2 + 1));
+        cl->EndEvent();
+    }
+
+    // On the frame's last command list, after every EndGpu()
+    void ResolveGpu(ID3D12GraphicsCommandList* cl)
+    {
+        if (!m_queryHeap)
+            return;
+        const UINT count = min(m_gpuScopeCount.load(std::memory_order_relaxed), kMaxGpuScopes);
+        m_gpuResolved[m_slot] = count;
+        if (count)
+            cl->ResolveQueryData(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex(m_slot, 0),
+                                 count * 2, m_readback[m_slot].Get(), 0);
+    }
+
+    // ---- frame ----
+    // After the slot's fence wait: collects its GPU timings and folds new events into the stats
+    void BeginFrame(UINT slot)
+    {
+        const int64_t now = Now();
+        if (m_lastFrameStart)
+            m_frameMs = Smooth(m_frameMs, ToMs(now - m_lastFrameStart));
+        m_lastFrameStart = now;
+
+        if (m_queryHeap && m_gpuResolved[slot])
+        {
+            UINT64 gpuRef = 0, cpuRef = 0;
+            if (SUCCEEDED(m_queue->GetClockCalibration(&gpuRef, &cpuRef)))
+            {
+                const UINT64* ticks = m_readbackCpu[slot];
+                UINT64 first = ~0ull, last = 0;
+                for (UINT i = 0; i < m_gpuResolved[slot]; ++i)
+                {
+                    Record(m_gpuNames[slot][i], GpuToQpc(ticks[i * 2], gpuRef, cpuRef),
+                           GpuToQpc(ticks[i * 2 + 1], gpuRef, cpuRef), kGpuThread);
+                    first = min(first, ticks[i * 2]);
+                    last  = max(last, ticks[i * 2 + 1]);
+                }
+                if (last > first)
+                {
+                    m_lastGpuFrameMs = (double)(last - first) * 1000.0 / (double)m_gpuFrequency;
+                    m_gpuFrameMs     = Smooth(m_gpuFrameMs, m_lastGpuFrameMs);
+                }
+            }
+            m_gpuResolved[slot] = 0;
+        }
+
+        Drain();
+
+        m_slot = slot;
+        m_gpuScopeCount.store(0, std::memory_order_relaxed);
+    }
+
+    double FrameMs() const { return m_frameMs; }
+    double GpuFrameMs() const { return m_gpuFrameMs; }     // first to last GPU scope of a frame
+    double LastGpuFrameMs() const { return m_lastGpuFrameMs; }     // same, unsmoothed – the slot's previous frame
+    const std::vector<Stat>& Stats() const { return m_stats; }
+
+    // Everything still in the ring, Chrome tracing format (chrome://tracing, Perfetto)
+    bool ExportChromeTrace(const char* path)
+    {
+        FILE* file = nullptr;
+        if (fopen_s(&file, path, "w") != 0 || !file)
+            return false;
+
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}",
+                kGpuThread);
+
+        const uint64_t head  = m_head.load(std::memory_order_acquire);
+        const uint64_t first = head > kRingSize ? head - kRingSize : 0;
+        for (uint64_t index = first; index < head; ++index)
+        {
+            Snapshot e;
+            if (!Read(index, e))
+                continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                          "\"ts\":%.3f,\"dur\":%.3f}",
+                    e.name, e.thread == kGpuThread ? "gpu" : "cpu", e.thread,
+                    ToMs(e.begin) * 1000.0, ToMs(e.end - e.begin) * 1000.0);
+        }
+        fprintf(file, "\n]}\n");
+        fclose(file);
+        return true;
+    }
+
+private:
+    struct Event
+    {
+        std::atomic<uint64_t>    sequence{ 0 };     // ring index + 1 once published
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<int64_t>     begin{ 0 };        // QPC ticks
+        std::atomic<int64_t>     end{ 0 };
+        std::atomic<uint32_t>    thread{ 0 };
+    };
+
+    struct Snapshot
+    {
+        const char* name;
+        int64_t     begin;
+        int64_t     end;
+        uint32_t    thread;
+    };
+
+    // Seqlock-style: the copy only counts if the slot still holds `index` afterwards
+    bool Read(uint64_t index, Snapshot& out) const
+    {
+        const Event& e = m_ring[index & (kRingSize - 1)];
+        if (e.sequence.load(std::memory_order_acquire) != index + 1)
+            return false;
+        out.name   = e.name.load(std::memory_order_relaxed);
+        out.begin  = e.begin.load(std::memory_order_relaxed);
+        out.end    = e.end.load(std::memory_order_relaxed);
+        out.thread = e.thread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return e.sequence.load(std::memory_order_relaxed) == index + 1;
+    }
+
+    // Sums this frame's events per name – a scope hit several times counts once, in total
+    void Drain()
+    {
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        if (head - m_readCursor > kRingSize)
+            m_readCursor = head - kRingSize;        // fell behind – drop what got overwritten
+
+        for (Stat& stat : m_stats)
+            stat.cpu = stat.gpu = false;
+        std::vector<double>& cpuSum = m_cpuSum;     // members only to keep the capacity
+        std::vector<double>& gpuSum = m_gpuSum;
+        cpuSum.assign(m_stats.size(), 0.0);
+        gpuSum.assign(m_stats.size(), 0.0);
+
+        for (; m_readCursor < head; ++m_readCursor)
+        {
+            Snapshot e;
+            if (!Read(m_readCursor, e))
+                break;      // still being written – pick it up next frame
+
+            size_t i = FindStat(e.name);
+            if (i == cpuSum.size())
+            {
+                cpuSum.push_back(0.0);
+                gpuSum.push_back(0.0);
+            }
+            const double ms = ToMs(e.end - e.begin);
+            if (e.thread == kGpuThread) { gpuSum[i] += ms; m_stats[i].gpu = true; }
+            else                        { cpuSum[i] += ms; m_stats[i].cpu = true; }
+        }
+
+        for (size_t i = 0; i < m_stats.size(); ++i)
+        {
+            if (m_stats[i].cpu) m_stats[i].cpuMs = Smooth(m_stats[i].cpuMs, cpuSum[i]);
+            if (m_stats[i].gpu) m_stats[i].gpuMs = Smooth(m_stats[i].gpuMs, gpuSum[i]);
+        }
+    }
+
+    size_t FindStat(const char* name)
+    {
+        for (size_t i = 0; i < m_stats.size(); ++i)
+            if (m_stats[i].name == name || strcmp(m_stats[i].name, name) == 0)
+                return i;
+        Stat stat;
+        stat.name = name;
+        m_stats.push_back(stat);
+        return m_stats.size() - 1;
+    }
+
+    static double Smooth(double previous, double sample) { return previous == 0.0 ? sample : previous * 0.9 + sample * 0.1; }
+
+    int64_t GpuToQpc(UINT64 gpuTicks, UINT64 gpuRef, UINT64 cpuRef) const
+    {
+        const double seconds = ((double)gpuTicks - (double)gpuRef) / (double)m_gpuFrequency;
+        return (int64_t)cpuRef + (int64_t)(seconds * (double)m_qpcFrequency);
+    }
+
+    UINT QueryIndex(UINT slot, UINT query) const { return slot * kMaxGpuScopes * 2 + query; }
+
+    // Ring
+    Event                   m_ring[kRingSize];
+    std::atomic<uint64_t>   m_head{ 0 };
+    uint64_t                m_readCursor = 0;
+
+    // Stats, render thread only
+    std::vector<Stat>       m_stats;
+    std::vector<double>     m_cpuSum;
+    std::vector<double>     m_gpuSum;
+    int64_t                 m_qpcFrequency   = 1;
+    int64_t                 m_lastFrameStart = 0;
+    double                  m_frameMs        = 0.0;
+    double                  m_gpuFrameMs     = 0.0;
+    double                  m_lastGpuFrameMs = 0.0;
+
+    // GPU timestamps
+    ID3D12CommandQueue*     m_queue        = nullptr;
+    UINT64                  m_gpuFrequency = 0;
+    UINT                    m_frameCount   = 0;
+    UINT                    m_slot         = 0;
+    ComPtr<ID3D12QueryHeap> m_queryHeap;
+    ComPtr<ID3D12Resource>  m_readback[kMaxFrames];
+    UINT64*                 m_readbackCpu[kMaxFrames] = {};
+    const char*             m_gpuNames[kMaxFrames][kMaxGpuScopes] = {};
+    UINT                    m_gpuResolved[kMaxFrames] = {};
+    std::atomic<UINT>       m_gpuScopeCount{ 0 };
+};
+
+// RAII helpers behind the macros
+class ProfileScope
+{
+public:
+    ProfileScope(Profiler& profiler, const char* name)
+        : m_profiler(profiler), m_name(name), m_begin(Profiler::Now())
+    {
+#if defined(USE_PIX)
+        PIXBeginEvent(0, "%s", name);
+#endif
+    }
+
+    ~ProfileScope()
+    {
+#if defined(USE_PIX)
+        PIXEndEvent();
+#endif
+        m_profiler.Record(m_name, m_begin, Profiler::Now(), JobSystem::ThreadIndex());
+    }
+
+private:
+    Profiler&   m_profiler;
+    const char* m_name;
+    int64_t     m_begin;
+};
+
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(Profiler& profiler, ID3D12GraphicsCommandList* cl, const char* name)
+        : m_profiler(profiler), m_cl(cl), m_scope(profiler.BeginGpu(cl, name)) {}
+    ~GpuProfileScope() { m_profiler.EndGpu(m_cl, m_scope); }
+
+private:
+    Profiler&                  m_profiler;
+    ID3D12GraphicsCommandList* m_cl;
+    UINT                       m_scope;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b)       PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name)         ProfileScope    PROFILE_CONCAT(profileScope_, __LINE__)(g_profiler, name)
+#define PROFILE_GPU_SCOPE(cl, name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope_, __LINE__)(g_profiler, cl, name)
@@ -0,0 +1,531 @@
+// ---------------------------------------------------------------
+// PSO cache – dedup by content hash, persisted via ID3D12PipelineLibrary
+// ---------------------------------------------------------------
+// Every D3D12_GRAPHICS_PIPELINE_STATE_DESC is hashed by *content* (shader
+// bytecode, input layout, fixed-function state, root signature blob), so
+// identical states share one PSO. Compiled PSOs are stored in a pipeline
+// library that is written to disk on shutdown and handed back to the driver
+// next launch, which skips the expensive driver compile.
+//
+//   ID3D12PipelineState* pso = psos.Get(desc);              // blocking
+//
+//   ID3D12PipelineState* cs  = psos.GetCompute(computeDesc); // compute PSOs, blocking
+//   ID3D12PipelineState* ms  = psos.GetMesh(meshDesc);       // amplification/mesh PSOs, blocking
+//
+//   uint64_t key = psos.Request(desc);                      // compiles on the job system
+//   cl->SetPipelineState(psos.Resolve(key, fallbackPso));   // fallback until it's ready
+//
+//   ID3D12PipelineState* next = psos.Rebuild(pso, stages);  // same state, new shaders (hot reload)
+//   psos.Evict(pso);                                        // once the GPU is done with it
+#pragma once
+
+#include "dxhelpers.h"
+#include "jobsystem.h"
+#include "shaderpak.h"      // HashBytes
+#include <atomic>
+#include <cstring>
+#include <cwchar>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The parts of a graphics desc a mesh shader pipeline has – no input layout, AS/MS instead of VS..GS
+struct MeshPipelineDesc
+{
+    ID3D12RootSignature*     pRootSignature = nullptr;
+    D3D12_SHADER_BYTECODE    AS{};          // optional
+    D3D12_SHADER_BYTECODE    MS{};
+    D3D12_SHADER_BYTECODE    PS{};
+    D3D12_BLEND_DESC         BlendState{};
+    UINT                     SampleMask = UINT_MAX;
+    D3D12_RASTERIZER_DESC    RasterizerState{};
+    D3D12_DEPTH_STENCIL_DESC DepthStencilState{};
+    UINT                     NumRenderTargets = 0;
+    DXGI_FORMAT              RTVFormats[8]{};
+    DXGI_FORMAT              DSVFormat = DXGI_FORMAT_UNKNOWN;
+    DXGI_SAMPLE_DESC         SampleDesc{ 1, 0 };
+};
+
+class PsoCache
+{
+public:
+    void Init(ID3D12Device* device, const char* libraryPath, JobSystem* jobs)
+    {
+        m_device      = device;
+        m_jobs        = jobs;
+        m_libraryPath = libraryPath;
+
+        // Mesh pipelines go through pipeline state streams, which need ID3D12Device2
+        device->QueryInterface(IID_PPV_ARGS(&m_device2));
+
+        // Pipeline libraries need ID3D12Device1; without one we still dedup, just don't persist
+        if (FAILED(device->QueryInterface(IID_PPV_ARGS(&m_device1))))
+            return;
+
+        std::ifstream in(libraryPath, std::ios::binary);
+        if (in)
+            m_libraryBlob.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        // A blob from another driver/adapter is rejected – just start over
+        if (m_libraryBlob.empty() ||
+            FAILED(m_device1->CreatePipelineLibrary(m_libraryBlob.data(), m_libraryBlob.size(),
+                                                    IID_PPV_ARGS(&m_library))))
+        {
+            m_libraryBlob.clear();
+            if (FAILED(m_device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_library))))
+                m_library.Reset();      // e.g. running under a tool that doesn't support them
+        }
+    }
+
+    // Waits for in-flight async compiles, then writes the library if anything new was added
+    void Shutdown()
+    {
+        m_jobs->Wait(m_pending);
+
+        if (m_library && m_dirty)
+        {
+            std::vector<char> blob(m_library->GetSerializedSize());
+            if (SUCCEEDED(m_library->Serialize(blob.data(), blob.size())))
+            {
+                std::ofstream out(m_libraryPath, std::ios::binary);
+                out.write(blob.data(), (std::streamsize)blob.size());
+            }
+        }
+
+        m_entries.clear();
+        m_library.Reset();
+        m_libraryBlob.clear();      // must outlive the library
+        m_rootSigHashes.clear();
+    }
+
+    // Root signatures are hashed by their serialized blob so keys survive a restart
+    void RegisterRootSignature(ID3D12RootSignature* rootSig, const void* blob, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rootSigHashes[rootSig] = HashBytes(blob, size);
+    }
+
+    ID3D12PipelineState* Get(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+    {
+        Entry* entry = FindOrAdd(desc);
+        if (!entry->ready.load(std::memory_order_acquire))
+        {
+            // Someone may already be compiling it on a worker; add ours only if nobody started
+            bool expected = false;
+            if (entry->started.compare_exchange_strong(expected, true))
+                Compile(*entry);
+            else
+                while (!entry->ready.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+        }
+        if (!entry->pso)
+            throw std::runtime_error("Failed to create pipeline state");
+        return entry->pso.Get();
+    }
+
+    ID3D12PipelineState* GetCompute(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc)
+    {
+        Entry* entry = FindOrAddCompute(desc);
+        bool expected = false;
+        if (entry->started.compare_exchange_strong(expected, true))
+            Compile(*entry);
+        else
+            while (!entry->ready.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        if (!entry->pso)
+            throw std::runtime_error("Failed to create compute pipeline state");
+        return entry->pso.Get();
+    }
+
+    ID3D12PipelineState* GetMesh(const MeshPipelineDesc& desc)
+    {
+        if (!m_device2)
+            throw std::runtime_error("Mesh shader pipelines need ID3D12Device2");
+        Entry* entry = FindOrAddMesh(desc);
+        bool expected = false;
+        if (entry->started.compare_exchange_strong(expected, true))
+            Compile(*entry);
+        else
+            while (!entry->ready.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        if (!entry->pso)
+            throw std::runtime_error("Failed to create mesh shader pipeline state");
+        return entry->pso.Get();
+    }
+
+    uint64_t Request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+    {
+        Entry* entry = FindOrAdd(desc);
+        bool expected = false;
+        if (entry->started.compare_exchange_strong(expected, true))
+            m_jobs->Run([this, entry] { Compile(*entry); }, &m_pending);
+        return entry->key;
+    }
+
+    ID3D12PipelineState* Resolve(uint64_t key, ID3D12PipelineState* fallback)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end() || !it->second->ready.load(std::memory_order_acquire) || !it->second->pso)
+            return fallback;
+        return it->second->pso.Get();
+    }
+
+    // The pipeline `pso` came from with its shaders swapped: stages are in Entry::shaders
+    // order, an empty one keeps what it had. Blocking, like Get() – call it off the render thread.
+    ID3D12PipelineState* Rebuild(ID3D12PipelineState* pso, const D3D12_SHADER_BYTECODE (&stages)[5])
+    {
+        // Copied out under the lock; the pointers in the copy stay good because
+        // entries are only freed by Evict(), which the caller won't do before this returns
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC graphics{};
+        D3D12_COMPUTE_PIPELINE_STATE_DESC  compute{};
+        MeshPipelineDesc                   mesh{};
+        int                                kind = -1;      // 0 graphics, 1 compute, 2 mesh
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& it : m_entries)
+            {
+                const Entry& e = *it.second;
+                if (e.pso.Get() != pso)
+                    continue;
+                kind = e.compute ? 1 : e.mesh ? 2 : 0;
+                graphics = e.desc;
+                compute  = e.computeDesc;
+                mesh     = e.meshDesc;
+                break;
+            }
+        }
+
+        auto pick = [&stages](D3D12_SHADER_BYTECODE& stage, int i) { if (stages[i].pShaderBytecode) stage = stages[i]; };
+        switch (kind)
+        {
+        case 0:
+            pick(graphics.VS, 0); pick(graphics.PS, 1); pick(graphics.DS, 2); pick(graphics.HS, 3); pick(graphics.GS, 4);
+            return Get(graphics);
+        case 1:
+            pick(compute.CS, 0);
+            return GetCompute(compute);
+        case 2:
+            pick(mesh.AS, 0); pick(mesh.MS, 1); pick(mesh.PS, 2);
+            return GetMesh(mesh);
+        default:
+            throw std::runtime_error("PsoCache: Rebuild() of a pipeline it didn't make");
+        }
+    }
+
+    // Drops the entry `pso` came from, and with it the cache's reference; the library keeps
+    // its copy. Only once nothing will ask for it again and the GPU is done with it.
+    void Evict(ID3D12PipelineState* pso)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+            if (it->second->pso.Get() == pso && it->second->ready.load(std::memory_order_acquire))
+            {
+                m_entries.erase(it);
+                return;
+            }
+    }
+
+    size_t Count()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+private:
+    // Deep copy of a desc so it can be compiled later on another thread
+    struct Entry
+    {
+        uint64_t                              key = 0;
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC    desc{};
+        ComPtr<ID3D12RootSignature>           rootSig;
+        std::vector<D3D12_INPUT_ELEMENT_DESC> elements;
+        std::vector<std::string>              semantics;
+        std::vector<char>                     shaders[5];   // VS PS DS HS GS (CS in [0], AS MS PS in [0..2])
+
+        bool                                  compute = false;
+        D3D12_COMPUTE_PIPELINE_STATE_DESC     computeDesc{};
+        bool                                  mesh = false;
+        MeshPipelineDesc                      meshDesc{};
+
+        ComPtr<ID3D12PipelineState>           pso;
+        std::atomic<bool>                     started{ false };
+        std::atomic<bool>                     ready{ false };     // pso set, or null if it failed
+    };
+
+    template <typename T>
+    static uint64_t HashValue(const T& value, uint64_t hash) { return HashBytes(&value, sizeof(T), hash); }
+
+    static uint64_t HashShader(const D3D12_SHADER_BYTECODE& code, uint64_t hash)
+    {
+        hash = HashValue(code.BytecodeLength, hash);
+        return code.pShaderBytecode ? HashBytes(code.pShaderBytecode, code.BytecodeLength, hash) : hash;
+    }
+
+    // Field by field – several of these structs have padding we mustn't hash
+    uint64_t HashDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& d)
+    {
+        uint64_t h = HashBytes(nullptr, 0);
+
+        auto rs = m_rootSigHashes.find(d.pRootSignature);
+        h = rs != m_rootSigHashes.end() ? HashValue(rs->second, h) : HashValue(d.pRootSignature, h);
+
+        h = HashShader(d.VS, h); h = HashShader(d.PS, h); h = HashShader(d.DS, h);
+        h = HashShader(d.HS, h); h = HashShader(d.GS, h);
+        h = HashFixedFunction(d.BlendState, d.SampleMask, d.RasterizerState, d.DepthStencilState, h);
+
+        for (UINT i = 0; i < d.InputLayout.NumElements; ++i)
+        {
+            const D3D12_INPUT_ELEMENT_DESC& e = d.InputLayout.pInputElementDescs[i];
+            h = HashBytes(e.SemanticName, strlen(e.SemanticName), h);
+            h = HashValue(e.SemanticIndex, h);     h = HashValue(e.Format, h);
+            h = HashValue(e.InputSlot, h);         h = HashValue(e.AlignedByteOffset, h);
+            h = HashValue(e.InputSlotClass, h);    h = HashValue(e.InstanceDataStepRate, h);
+        }
+
+        h = HashValue(d.IBStripCutValue, h);
+        h = HashValue(d.PrimitiveTopologyType, h);
+        h = HashValue(d.NumRenderTargets, h);
+        h = HashValue(d.RTVFormats, h);
+        h = HashValue(d.DSVFormat, h);
+        h = HashValue(d.SampleDesc, h);
+        h = HashValue(d.NodeMask, h);
+        h = HashValue(d.Flags, h);
+        return h;
+    }
+
+    static uint64_t HashFixedFunction(const D3D12_BLEND_DESC& b, UINT sampleMask, const D3D12_RASTERIZER_DESC& raster,
+                                      const D3D12_DEPTH_STENCIL_DESC& ds, uint64_t h)
+    {
+        h = HashValue(b.AlphaToCoverageEnable, h);
+        h = HashValue(b.IndependentBlendEnable, h);
+        for (const D3D12_RENDER_TARGET_BLEND_DESC& rt : b.RenderTarget)
+        {
+            h = HashValue(rt.BlendEnable, h);   h = HashValue(rt.LogicOpEnable, h);
+            h = HashValue(rt.SrcBlend, h);      h = HashValue(rt.DestBlend, h);
+            h = HashValue(rt.BlendOp, h);       h = HashValue(rt.SrcBlendAlpha, h);
+            h = HashValue(rt.DestBlendAlpha, h); h = HashValue(rt.BlendOpAlpha, h);
+            h = HashValue(rt.LogicOp, h);       h = HashValue(rt.RenderTargetWriteMask, h);
+        }
+        h = HashValue(sampleMask, h);
+        h = HashValue(raster, h);               // all 4-byte fields, no padding
+
+        h = HashValue(ds.DepthEnable, h);      h = HashValue(ds.DepthWriteMask, h);
+        h = HashValue(ds.DepthFunc, h);        h = HashValue(ds.StencilEnable, h);
+        h = HashValue(ds.StencilReadMask, h);  h = HashValue(ds.StencilWriteMask, h);
+        h = HashValue(ds.FrontFace, h);        h = HashValue(ds.BackFace, h);
+        return h;
+    }
+
+    Entry* FindOrAddMesh(const MeshPipelineDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        static const char tag[] = "mesh";
+        uint64_t h = HashBytes(tag, sizeof(tag));
+        auto rs = m_rootSigHashes.find(desc.pRootSignature);
+        h = rs != m_rootSigHashes.end() ? HashValue(rs->second, h) : HashValue(desc.pRootSignature, h);
+        h = HashShader(desc.AS, h); h = HashShader(desc.MS, h); h = HashShader(desc.PS, h);
+        h = HashFixedFunction(desc.BlendState, desc.SampleMask, desc.RasterizerState, desc.DepthStencilState, h);
+        h = HashValue(desc.NumRenderTargets, h);
+        h = HashValue(desc.RTVFormats, h);
+        h = HashValue(desc.DSVFormat, h);
+        h = HashValue(desc.SampleDesc, h);
+
+        std::unique_ptr<Entry>& slot = m_entries[h];
+        if (slot)
+            return slot.get();
+
+        slot = std::make_unique<Entry>();
+        Entry& e = *slot;
+        e.key      = h;
+        e.mesh     = true;
+        e.meshDesc = desc;
+        e.rootSig  = desc.pRootSignature;
+        const D3D12_SHADER_BYTECODE* stages[3] = { &desc.AS, &desc.MS, &desc.PS };
+        D3D12_SHADER_BYTECODE*       copies[3] = { &e.meshDesc.AS, &e.meshDesc.MS, &e.meshDesc.PS };
+        for (int i = 0; i < 3; ++i)
+        {
+            if (!stages[i]->pShaderBytecode) continue;
+            const char* bytes = static_cast<const char*>(stages[i]->pShaderBytecode);
+            e.shaders[i].assign(bytes, bytes + stages[i]->BytecodeLength);
+            *copies[i] = { e.shaders[i].data(), e.shaders[i].size() };
+        }
+        return &e;
+    }
+
+    // Pipeline state stream – each subobject pointer aligned, tagged with its type
+    template <D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type, typename T>
+    struct alignas(void*) Subobject
+    {
+        D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type = Type;
+        T                                   value{};
+    };
+
+    struct MeshStream
+    {
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, ID3D12RootSignature*>       rootSig;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, D3D12_SHADER_BYTECODE>                  as;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, D3D12_SHADER_BYTECODE>                  ms;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, D3D12_SHADER_BYTECODE>                  ps;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND, D3D12_BLEND_DESC>                    blend;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK, UINT>                          sampleMask;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, D3D12_RASTERIZER_DESC>          raster;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL, D3D12_DEPTH_STENCIL_DESC>    depthStencil;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS, D3D12_RT_FORMAT_ARRAY> rtvFormats;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT, DXGI_FORMAT>          dsvFormat;
+        Subobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC, DXGI_SAMPLE_DESC>              sampleDesc;
+    };
+
+    static MeshStream BuildMeshStream(const MeshPipelineDesc& d)
+    {
+        MeshStream s;
+        s.rootSig.value      = d.pRootSignature;
+        s.as.value           = d.AS;
+        s.ms.value           = d.MS;
+        s.ps.value           = d.PS;
+        s.blend.value        = d.BlendState;
+        s.sampleMask.value   = d.SampleMask;
+        s.raster.value       = d.RasterizerState;
+        s.depthStencil.value = d.DepthStencilState;
+        s.rtvFormats.value.NumRenderTargets = d.NumRenderTargets;
+        memcpy(s.rtvFormats.value.RTFormats, d.RTVFormats, sizeof(d.RTVFormats));
+        s.dsvFormat.value    = d.DSVFormat;
+        s.sampleDesc.value   = d.SampleDesc;
+        return s;
+    }
+
+    Entry* FindOrAddCompute(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        static const char tag[] = "compute";
+        uint64_t h = HashBytes(tag, sizeof(tag));
+        auto rs = m_rootSigHashes.find(desc.pRootSignature);
+        h = rs != m_rootSigHashes.end() ? HashValue(rs->second, h) : HashValue(desc.pRootSignature, h);
+        h = HashShader(desc.CS, h);
+        h = HashValue(desc.NodeMask, h);
+        h = HashValue(desc.Flags, h);
+
+        std::unique_ptr<Entry>& slot = m_entries[h];
+        if (slot)
+            return slot.get();
+
+        slot = std::make_unique<Entry>();
+        Entry& e = *slot;
+        e.key         = h;
+        e.compute     = true;
+        e.computeDesc = desc;
+        e.rootSig     = desc.pRootSignature;
+        const char* bytes = static_cast<const char*>(desc.CS.pShaderBytecode);
+        e.shaders[0].assign(bytes, bytes + desc.CS.BytecodeLength);
+        e.computeDesc.CS = { e.shaders[0].data(), e.shaders[0].size() };
+        return &e;
+    }
+
+    Entry* FindOrAdd(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+    {
+        if (desc.StreamOutput.NumEntries != 0 || desc.CachedPSO.pCachedBlob)
+            throw std::runtime_error("PsoCache: stream output / cached blobs not supported");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint64_t key = HashDesc(desc);
+        std::unique_ptr<Entry>& slot = m_entries[key];
+        if (slot)
+            return slot.get();
+
+        slot = std::make_unique<Entry>();
+        Entry& e = *slot;
+        e.key     = key;
+        e.desc    = desc;
+        e.rootSig = desc.pRootSignature;
+
+        const D3D12_SHADER_BYTECODE* stages[5] = { &desc.VS, &desc.PS, &desc.DS, &desc.HS, &desc.GS };
+        D3D12_SHADER_BYTECODE*       copies[5] = { &e.desc.VS, &e.desc.PS, &e.desc.DS, &e.desc.HS, &e.desc.GS };
+        for (int i = 0; i < 5; ++i)
+        {
+            if (!stages[i]->pShaderBytecode) continue;
+            const char* bytes = static_cast<const char*>(stages[i]->pShaderBytecode);
+            e.shaders[i].assign(bytes, bytes + stages[i]->BytecodeLength);
+            *copies[i] = { e.shaders[i].data(), e.shaders[i].size() };
+        }
+
+        e.semantics.reserve(desc.InputLayout.NumElements);
+        for (UINT i = 0; i < desc.InputLayout.NumElements; ++i)
+        {
+            e.elements.push_back(desc.InputLayout.pInputElementDescs[i]);
+            e.semantics.push_back(e.elements.back().SemanticName);
+        }
+        for (size_t i = 0; i < e.elements.size(); ++i)
+            e.elements[i].SemanticName = e.semantics[i].c_str();
+        e.desc.InputLayout = { e.elements.data(), (UINT)e.elements.size() };
+        return &e;
+    }
+
+    void Compile(Entry& e)
+    {
+        wchar_t name[17];
+        swprintf(name, 17, L"%016llx", (unsigned long long)e.key);
+
+        MeshStream                       stream;
+        D3D12_PIPELINE_STATE_STREAM_DESC streamDesc{ sizeof(stream), &stream };
+        if (e.mesh)
+            stream = BuildMeshStream(e.meshDesc);
+
+        if (m_library)
+        {
+            std::lock_guard<std::mutex> lock(m_libraryMutex);
+            ComPtr<ID3D12PipelineLibrary1> library1;
+            HRESULT loaded = e.mesh
+                ? (SUCCEEDED(m_library.As(&library1)) ? library1->LoadPipeline(name, &streamDesc, IID_PPV_ARGS(&e.pso))
+                                                      : E_NOINTERFACE)
+                : e.compute
+                ? m_library->LoadComputePipeline(name, &e.computeDesc, IID_PPV_ARGS(&e.pso))
+                : m_library->LoadGraphicsPipeline(name, &e.desc, IID_PPV_ARGS(&e.pso));
+            if (SUCCEEDED(loaded))
+            {
+                e.ready.store(true, std::memory_order_release);
+                return;
+            }
+        }
+
+        // The slow part – the driver compile – runs outside any lock
+        HRESULT hr = e.mesh
+            ? m_device2->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&e.pso))
+            : e.compute
+            ? m_device->CreateComputePipelineState(&e.computeDesc, IID_PPV_ARGS(&e.pso))
+            : m_device->CreateGraphicsPipelineState(&e.desc, IID_PPV_ARGS(&e.pso));
+        if (FAILED(hr))
+        {
+            e.ready.store(true, std::memory_order_release);   // stays on the fallback forever
+            ThrowIfFailed(hr);
+        }
+
+        if (m_library)
+        {
+            std::lock_guard<std::mutex> lock(m_libraryMutex);
+            if (SUCCEEDED(m_library->StorePipeline(name, e.pso.Get())))
+                m_dirty = true;
+        }
+        e.ready.store(true, std::memory_order_release);
+    }
+
+    ID3D12Device*                                        m_device = nullptr;
+    ComPtr<ID3D12Device1>                                m_device1;
+    ComPtr<ID3D12Device2>                                m_device2;
+    JobSystem*                                           m_jobs   = nullptr;
+    JobSystem::Counter                                   m_pending;
+
+    std::string                                          m_libraryPath;
+    std::vector<char>                                    m_libraryBlob;
+    ComPtr<ID3D12PipelineLibrary>                        m_library;
+    std::mutex                                           m_libraryMutex;
+    bool                                                 m_dirty = false;
+
+    std::unordered_map<uint64_t, std::unique_ptr<Entry>> m_entries;
+    std::unordered_map<ID3D12RootSignature*, uint64_t>   m_rootSigHashes;
+    std::mutex                                           m_mutex;
+};
@@ -0,0 +1,842 @@
+// ---------------------------------------------------------------
+// Render graph – passes declare what they read and write, the graph
+// places the barriers, drops dead passes and aliases transient memory
+// ---------------------------------------------------------------
+// Rebuilt every frame:
+//
+//   graph.Reset(completedFence);
+//   RenderGraph::Resource color = graph.CreateTexture("SceneColor", desc, &clear);
+//   RenderGraph::Resource back  = graph.Import("BackBuffer", backBuffer, PRESENT, PRESENT);
+//   graph.AddPass("Scene",   [&](ID3D12GraphicsCommandList* cl) { ... }).Write(color, RENDER_TARGET);
+//   graph.AddPass("Upscale", [&](ID3D12GraphicsCommandList* cl) { ... })
+//        .Read(color, PIXEL_SHADER_RESOURCE).Write(back, RENDER_TARGET);
+//   graph.Compile(frameFence);        // transients exist from here on – create views now
+//   graph.Record(cl);
+//
+// Barriers: one ResourceBarrier() batch in front of every pass. A resource
+// read by several passes in a row goes into the union of their read states
+// once. A transition with passes in between that don't touch the resource
+// is split – BEGIN right after its last use, END in front of the next – so
+// the GPU can overlap it with that work.
+//
+// Culling: a pass survives if it is kPassNeverCull, writes an imported
+// resource, or writes something a surviving pass after it reads.
+//
+// Aliasing: transients are placed in one heap per resource category (RT/DS
+// and other textures, so resource heap tier 1 works) and share memory when
+// their lifetimes – first to last use in pass order – don't overlap. Memory
+// shared with another transient gets an aliasing barrier on first use, and
+// RT/DS targets a DiscardResource(); passes must fully write (clear) a
+// transient before anything reads it. Transients end every frame back in
+// their creation state, so the same placed resources replay frame after
+// frame and are only recreated when the set of transients changes (resize).
+// Replaced heaps and resources are kept until the last fence that used them.
+//
+// Everything per frame – passes, accesses, barrier lists, Compile()'s scratch –
+// lives in the graph's LinearArena (framememory.h), which Reset() rewinds, so
+// a warm graph rebuilds without touching the heap.
+//
+// kPassExternal passes are recorded by the caller into command lists of its
+// own (parallel recording): Record() puts their barriers in the current list,
+// stops in front of them and returns where to carry on in the list after.
+//
+// kPassAsyncCompute passes run on the compute queue. Back-to-back async passes
+// form one group: the graph forks in front of it (transitions on the direct
+// queue – compute lists can't touch graphics states – then kStopFork, the
+// caller submits, signals, and records the group with RecordAsync() for the
+// compute queue to run after a wait) and joins (kStopJoin, the direct queue
+// waits on the compute fence) in front of the first later pass touching
+// anything the group used, at the latest before the final barriers. Graphics
+// passes in between overlap with it. Async passes may only change states
+// compute lists can (UAV, shader resource, copy) between themselves.
+#pragma once
+
+#include "dxhelpers.h"
+#include "framememory.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+class RenderGraph
+{
+public:
+    using Resource     = UINT;      // handle, valid until the next Reset()
+    using PassFunction = std::function<void(ID3D12GraphicsCommandList*)>;
+
+    static const UINT                  kEnd       = ~0u;
+    static const D3D12_RESOURCE_STATES kKeepState = (D3D12_RESOURCE_STATES)~0u;  // import: leave as the last pass did
+
+    enum PassFlags : UINT
+    {
+        kPassNeverCull = 1,     // side effects the graph can't see (readbacks, queries)
+        kPassExternal     = 2,  // recorded by the caller, see Record()
+        kPassAsyncCompute = 4,  // compute queue, see RecordAsync()
+    };
+
+    enum StopKind : UINT
+    {
+        kStopEnd,               // everything recorded
+        kStopExternal,          // caller records the external pass into lists of its own
+        kStopFork,              // submit, signal, RecordAsync() + run it on the compute queue
+        kStopJoin,              // submit, make the direct queue wait for the compute queue
+    };
+
+    struct Stop
+    {
+        StopKind kind;
+        UINT     next;          // pass to Record() from, in a new list
+    };
+
+    struct Stats
+    {
+        UINT   passes           = 0;    // declared
+        UINT   culledPasses     = 0;
+        UINT   barrierBatches   = 0;    // ResourceBarrier() calls
+        UINT   barriers         = 0;
+        UINT   splitBarriers    = 0;    // BEGIN/END pairs
+        UINT   aliasingBarriers = 0;
+        UINT   asyncPasses      = 0;
+        UINT   transients       = 0;
+        UINT64 transientBytes   = 0;    // heap memory actually reserved
+        UINT64 unaliasedBytes   = 0;    // what separate allocations would take
+    };
+
+    class PassBuilder
+    {
+    public:
+        PassBuilder& Read(Resource resource, D3D12_RESOURCE_STATES state)
+        {
+            m_graph->AddAccess(m_pass, resource, state, false);
+            return *this;
+        }
+        PassBuilder& Write(Resource resource, D3D12_RESOURCE_STATES state)
+        {
+            m_graph->AddAccess(m_pass, resource, state, true);
+            return *this;
+        }
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph* graph, UINT pass) : m_graph(graph), m_pass(pass) {}
+        RenderGraph* m_graph;
+        UINT         m_pass;
+    };
+
+    void Init(ID3D12Device* device) { m_device = device; }
+
+    // Off: kPassAsyncCompute passes run in place on the direct queue like any other
+    void SetAsyncCompute(bool enabled) { m_asyncEnabled = enabled; }
+
+    // GPU must be idle
+    void Shutdown()
+    {
+        Reset(~0ull);
+        m_placed.clear();
+        for (Heap& heap : m_heaps)
+            heap = Heap();
+    }
+
+    // Starts a new frame's graph and releases memory the GPU is done with
+    void Reset(UINT64 completedFence)
+    {
+        ReleaseVector(m_passes);
+        ReleaseVector(m_resources);
+        ReleaseVector(m_order);
+        ReleaseVector(m_groups);
+        ReleaseVector(m_groupOf);
+        ReleaseVector(m_steps);
+        ReleaseVector(m_finalBarriers);
+        m_arena.Reset();
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+                                       [&](const Retired& r) { return r.fence <= completedFence; }),
+                        m_retired.end());
+    }
+
+    // Something that lives outside the graph, currently in `state`; `finalState` is where it's left
+    Resource Import(const char* name, ID3D12Resource* resource, D3D12_RESOURCE_STATES state,
+                    D3D12_RESOURCE_STATES finalState = kKeepState)
+    {
+        ResourceNode node{};
+        node.name       = name;
+        node.resource   = resource;
+        node.imported   = true;
+        node.initial    = state;
+        node.finalState = finalState;
+        m_resources.push_back(node);
+        return (Resource)m_resources.size() - 1;
+    }
+
+    // Frame-local texture in graph-owned memory, only created if a surviving pass uses it
+    Resource CreateTexture(const char* name, const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clear = nullptr)
+    {
+        ResourceNode node{};
+        node.name     = name;
+        node.desc     = desc;
+        node.hasClear = clear != nullptr;
+        if (clear)
+            node.clear = *clear;
+        node.category = desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
+                      ? kCategoryRtDs : kCategoryTexture;
+
+        D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+        if (info.SizeInBytes == UINT64_MAX)
+            throw std::runtime_error("Invalid transient resource description");
+        node.size      = info.SizeInBytes;
+        node.alignment = info.Alignment;
+        m_resources.push_back(node);
+        return (Resource)m_resources.size() - 1;
+    }
+
+    // One state per resource per pass; read and write of the same resource in one pass is a Write
+    PassBuilder AddPass(const char* name, PassFunction execute, UINT flags = 0)
+    {
+        Pass pass(&m_arena);
+        pass.name    = name;
+        pass.execute = std::move(execute);
+        pass.flags   = flags;
+        m_passes.push_back(std::move(pass));
+        return PassBuilder(this, (UINT)m_passes.size() - 1);
+    }
+
+    // Culls, places and creates transients, plans every barrier. `frameFence` is
+    // the value signalled once this frame's lists have run.
+    void Compile(UINT64 frameFence)
+    {
+        m_stats = Stats();
+        m_stats.passes = (UINT)m_passes.size();
+
+        Cull();
+        GroupAsync();
+        ComputeLifetimes();
+        for (UINT category = 0; category < kCategoryCount; ++category)
+            Place(category);
+        CreateTransients();
+        PlanBarriers();
+        BuildSteps();
+
+        m_lastFence = frameFence;
+    }
+
+    ID3D12Resource* GetResource(Resource resource) const { return m_resources[resource].resource; }
+
+    // Records the direct queue's share of the frame from `from` on into cl, up to
+    // the next point the caller has to act on (see StopKind). Whatever the stop,
+    // cl is complete – close it, do what the stop says, carry on in a new list.
+    Stop Record(ID3D12GraphicsCommandList* cl, UINT from = 0)
+    {
+        for (UINT i = from; i < (UINT)m_steps.size(); ++i)
+        {
+            const Step& step = m_steps[i];
+            switch (step.kind)
+            {
+            case kStepPass:
+            {
+                Pass& pass = m_passes[m_order[step.index]];
+                Flush(cl, pass.barriers);
+                for (ID3D12Resource* resource : pass.discards)
+                    cl->DiscardResource(resource, nullptr);
+                if (pass.flags & kPassExternal)
+                    return { kStopExternal, i + 1 };
+                pass.execute(cl);
+                break;
+            }
+            case kStepFork:
+            {
+                AsyncGroup& group = m_groups[step.index];
+                Flush(cl, group.forkBarriers);
+                for (ID3D12Resource* resource : group.forkDiscards)
+                    cl->DiscardResource(resource, nullptr);
+                m_forkGroup = step.index;
+                return { kStopFork, i + 1 };
+            }
+            case kStepJoin:
+                return { kStopJoin, i + 1 };
+            }
+        }
+        Flush(cl, m_finalBarriers);
+        return { kStopEnd, kEnd };
+    }
+
+    // After kStopFork: the group's passes into a compute list
+    void RecordAsync(ID3D12GraphicsCommandList* cl)
+    {
+        const AsyncGroup& group = m_groups[m_forkGroup];
+        for (UINT pos = group.first; pos <= group.last; ++pos)
+        {
+            Pass& pass = m_passes[m_order[pos]];
+            Flush(cl, pass.barriers);
+            pass.execute(cl);
+        }
+    }
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    enum : UINT { kCategoryTexture, kCategoryRtDs, kCategoryCount };
+    enum : UINT { kStepPass, kStepFork, kStepJoin };
+    static constexpr UINT kNotUsed = ~0u;
+
+    struct Step
+    {
+        UINT kind;
+        UINT index;             // kStepPass: position in m_order, kStepFork: group
+    };
+
+    // Back-to-back async passes, submitted together
+    struct AsyncGroup
+    {
+        AsyncGroup(UINT pos, UINT passCount, LinearArena* arena)
+            : first(pos), last(pos), join(passCount), forkBarriers(arena), forkDiscards(arena) {}
+
+        UINT                                 first;      // positions in m_order
+        UINT                                 last;
+        UINT                                 join;       // position the direct queue waits in front of
+        ArenaVector<D3D12_RESOURCE_BARRIER>  forkBarriers;
+        ArenaVector<ID3D12Resource*>         forkDiscards;
+    };
+
+    struct Access
+    {
+        Resource              resource;
+        D3D12_RESOURCE_STATES state;
+        D3D12_RESOURCE_STATES target;   // state actually transitioned to (merged reads)
+        bool                  write;
+    };
+
+    struct Pass
+    {
+        explicit Pass(LinearArena* arena) : accesses(arena), barriers(arena), discards(arena) {}
+
+        const char*                         name = nullptr;
+        PassFunction                        execute;
+        UINT                                flags = 0;
+        ArenaVector<Access>                 accesses;
+        bool                                live  = false;
+        ArenaVector<D3D12_RESOURCE_BARRIER> barriers;   // recorded in front of the pass
+        ArenaVector<ID3D12Resource*>        discards;
+    };
+
+    struct ResourceNode
+    {
+        const char*           name;
+        ID3D12Resource*       resource;
+        bool                  imported;
+        D3D12_RESOURCE_STATES initial;          // imported: current state, transient: creation state
+        D3D12_RESOURCE_STATES finalState;
+
+        // Transients
+        D3D12_RESOURCE_DESC   desc;
+        D3D12_CLEAR_VALUE     clear;
+        bool                  hasClear;
+        UINT                  category;
+        UINT64                size;
+        UINT64                alignment;
+        UINT64                offset;
+        UINT                  first;            // positions in m_order
+        UINT                  last;
+        bool                  aliased;          // shares memory with another transient
+    };
+
+    // A placed resource kept across frames while the plan doesn't change
+    struct Placed
+    {
+        D3D12_RESOURCE_DESC    desc;
+        D3D12_CLEAR_VALUE      clear;
+        bool                   hasClear;
+        UINT                   category;
+        UINT64                 offset;
+        D3D12_RESOURCE_STATES  state;
+        ComPtr<ID3D12Resource> resource;
+        bool                   used;
+    };
+
+    struct Heap
+    {
+        ComPtr<ID3D12Heap> heap;
+        UINT64             size      = 0;
+        UINT64             alignment = 0;
+    };
+
+    struct Retired
+    {
+        ComPtr<ID3D12Pageable> object;
+        UINT64                 fence;
+    };
+
+    void AddAccess(UINT pass, Resource resource, D3D12_RESOURCE_STATES state, bool write)
+    {
+        for (Access& access : m_passes[pass].accesses)
+        {
+            if (access.resource == resource)
+            {
+                access.state  = write ? state : access.state;
+                access.write |= write;
+                return;
+            }
+        }
+        m_passes[pass].accesses.push_back({ resource, state, state, write });
+    }
+
+    // Backwards: a pass is needed if later needed work reads what it writes
+    void Cull()
+    {
+        ArenaVector<bool> needed(m_resources.size(), false, &m_arena);
+        for (UINT r = 0; r < (UINT)m_resources.size(); ++r)
+            needed[r] = m_resources[r].imported;
+
+        for (UINT p = (UINT)m_passes.size(); p-- > 0;)
+        {
+            Pass& pass = m_passes[p];
+            pass.live  = (pass.flags & kPassNeverCull) != 0;
+            for (const Access& access : pass.accesses)
+                if (access.write && needed[access.resource])
+                    pass.live = true;
+            if (!pass.live)
+                continue;
+            for (const Access& access : pass.accesses)
+                if (!access.write)
+                    needed[access.resource] = true;
+        }
+
+        for (UINT p = 0; p < (UINT)m_passes.size(); ++p)
+        {
+            if (m_passes[p].live)
+                m_order.push_back(p);
+            else
+                ++m_stats.culledPasses;
+        }
+    }
+
+    // Async groups and where each joins: in front of the first later pass (or
+    // later group) that touches any of its resources, else before the final barriers
+    void GroupAsync()
+    {
+        const UINT passCount = (UINT)m_order.size();
+        m_groupOf.assign(passCount, kNotUsed);
+        for (UINT pos = 0; pos < passCount; ++pos)
+        {
+            if (!m_asyncEnabled || !(m_passes[m_order[pos]].flags & kPassAsyncCompute))
+                continue;
+            if (pos == 0 || m_groupOf[pos - 1] == kNotUsed)
+                m_groups.emplace_back(pos, passCount, &m_arena);
+            m_groups.back().last = pos;
+            m_groupOf[pos] = (UINT)m_groups.size() - 1;
+            ++m_stats.asyncPasses;
+        }
+
+        ArenaVector<bool> used(m_resources.size(), false, &m_arena);
+        for (UINT g = 0; g < (UINT)m_groups.size(); ++g)
+        {
+            AsyncGroup& group = m_groups[g];
+            std::fill(used.begin(), used.end(), false);
+            for (UINT pos = group.first; pos <= group.last; ++pos)
+                for (const Access& access : m_passes[m_order[pos]].accesses)
+                    used[access.resource] = true;
+
+            for (UINT pos = group.last + 1; pos < passCount && group.join == passCount; ++pos)
+                for (const Access& access : m_passes[m_order[pos]].accesses)
+                    if (used[access.resource])
+                        group.join = m_groupOf[pos] == kNotUsed ? pos : m_groups[m_groupOf[pos]].first;
+        }
+    }
+
+    // First/last use of every resource, plus one target state per run of consecutive reads
+    void ComputeLifetimes()
+    {
+        for (ResourceNode& node : m_resources)
+        {
+            node.first   = kNotUsed;
+            node.last    = kNotUsed;
+            node.aliased = false;
+        }
+
+        ArenaVector<Access*> runStart(m_resources.size(), nullptr, &m_arena);
+        for (UINT pos = 0; pos < (UINT)m_order.size(); ++pos)
+        {
+            for (Access& access : m_passes[m_order[pos]].accesses)
+            {
+                ResourceNode& node = m_resources[access.resource];
+                if (node.first == kNotUsed)
+                    node.first = pos;
+                node.last = pos;
+
+                if (access.write)
+                {
+                    runStart[access.resource] = nullptr;
+                    continue;
+                }
+                if (!runStart[access.resource])
+                    runStart[access.resource] = &access;
+                else
+                    runStart[access.resource]->target |= access.state;
+            }
+        }
+
+        // Whatever an async group touches stays put until the direct queue has joined it
+        for (const AsyncGroup& group : m_groups)
+            for (UINT pos = group.first; pos <= group.last; ++pos)
+                for (const Access& access : m_passes[m_order[pos]].accesses)
+                    m_resources[access.resource].last = (std::max)(m_resources[access.resource].last, group.join - 1);
+
+        // Every read in a run ends up in the run's union state
+        ArenaVector<D3D12_RESOURCE_STATES> runState(m_resources.size(), D3D12_RESOURCE_STATE_COMMON, &m_arena);
+        ArenaVector<bool>                  inRun(m_resources.size(), false, &m_arena);
+        for (UINT pos = 0; pos < (UINT)m_order.size(); ++pos)
+        {
+            for (Access& access : m_passes[m_order[pos]].accesses)
+            {
+                if (access.write)
+                {
+                    inRun[access.resource] = false;
+                    continue;
+                }
+                if (!inRun[access.resource])
+                {
+                    inRun[access.resource]    = true;
+                    runState[access.resource] = access.target;
+                }
+                access.target = runState[access.resource];
+            }
+        }
+
+        // Transients are created in (and return to) the state of their first use
+        for (UINT r = 0; r < (UINT)m_resources.size(); ++r)
+        {
+            ResourceNode& node = m_resources[r];
+            if (node.imported || node.first == kNotUsed)
+                continue;
+            for (const Access& access : m_passes[m_order[node.first]].accesses)
+                if (access.resource == r)
+                    node.initial = access.target;
+            ++m_stats.transients;
+            m_stats.unaliasedBytes += node.size;
+        }
+    }
+
+    // First fit, biggest first: each transient goes at the lowest offset that
+    // doesn't collide with anything placed whose lifetime overlaps its own
+    void Place(UINT category)
+    {
+        ArenaVector<UINT> resources(&m_arena);
+        UINT64            alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        for (UINT r = 0; r < (UINT)m_resources.size(); ++r)
+        {
+            const ResourceNode& node = m_resources[r];
+            if (!node.imported && node.first != kNotUsed && node.category == category)
+            {
+                resources.push_back(r);
+                alignment = (std::max)(alignment, node.alignment);
+            }
+        }
+        if (resources.empty())
+            return;
+        // Ties in declaration order (stable_sort would want a temporary buffer)
+        std::sort(resources.begin(), resources.end(), [&](UINT a, UINT b)
+        {
+            return m_resources[a].size != m_resources[b].size ? m_resources[a].size > m_resources[b].size : a < b;
+        });
+
+        UINT64 heapSize = 0;
+        for (UINT i = 0; i < (UINT)resources.size(); ++i)
+        {
+            ResourceNode& node   = m_resources[resources[i]];
+            UINT64        offset = 0;
+            for (bool moved = true; moved;)
+            {
+                moved = false;
+                for (UINT j = 0; j < i; ++j)
+                {
+                    const ResourceNode& other = m_resources[resources[j]];
+                    const bool liveTogether = node.first <= other.last && other.first <= node.last;
+                    const bool overlaps     = offset < other.offset + other.size && other.offset < offset + node.size;
+                    if (liveTogether && overlaps)
+                    {
+                        offset = AlignUp(other.offset + other.size, node.alignment);
+                        moved  = true;
+                    }
+                }
+            }
+            node.offset = offset;
+            heapSize    = (std::max)(heapSize, offset + node.size);
+        }
+
+        // Anything sharing bytes with another transient needs the aliasing barrier
+        for (UINT i = 0; i < (UINT)resources.size(); ++i)
+        {
+            ResourceNode& node = m_resources[resources[i]];
+            for (UINT j = 0; j < (UINT)resources.size(); ++j)
+            {
+                const ResourceNode& other = m_resources[resources[j]];
+                if (i != j && node.offset < other.offset + other.size && other.offset < node.offset + node.size)
+                    node.aliased = true;
+            }
+        }
+
+        // Grow only – a smaller plan keeps using the bigger heap
+        Heap& heap = m_heaps[category];
+        if (heapSize > heap.size || alignment > heap.alignment)
+        {
+            if (heap.heap)
+                m_retired.push_back({ heap.heap, m_lastFence });
+            for (Placed& placed : m_placed)
+                if (placed.category == category)
+                    m_retired.push_back({ placed.resource, m_lastFence });
+            m_placed.erase(std::remove_if(m_placed.begin(), m_placed.end(),
+                                          [&](const Placed& p) { return p.category == category; }),
+                           m_placed.end());
+
+            D3D12_HEAP_DESC desc{};
+            desc.SizeInBytes     = AlignUp(heapSize, alignment);
+            desc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+            desc.Alignment       = alignment;
+            desc.Flags           = category == kCategoryRtDs ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES
+                                                             : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+            ThrowIfFailed(m_device->CreateHeap(&desc, IID_PPV_ARGS(&heap.heap)));
+            heap.size      = desc.SizeInBytes;
+            heap.alignment = alignment;
+        }
+    }
+
+    static bool SameDesc(const D3D12_RESOURCE_DESC& a, const D3D12_RESOURCE_DESC& b)
+    {
+        return a.Dimension == b.Dimension && a.Alignment == b.Alignment && a.Width == b.Width &&
+               a.Height == b.Height && a.DepthOrArraySize == b.DepthOrArraySize && a.MipLevels == b.MipLevels &&
+               a.Format == b.Format && a.SampleDesc.Count == b.SampleDesc.Count &&
+               a.SampleDesc.Quality == b.SampleDesc.Quality && a.Layout == b.Layout && a.Flags == b.Flags;
+    }
+
+    // Reuses last frame's placed resources where nothing changed, creates the rest
+    void CreateTransients()
+    {
+        for (Placed& placed : m_placed)
+            placed.used = false;
+
+        for (ResourceNode& node : m_resources)
+        {
+            if (node.imported || node.first == kNotUsed)
+                continue;
+
+            Placed* match = nullptr;
+            for (Placed& placed : m_placed)
+            {
+                if (!placed.used && placed.category == node.category && placed.offset == node.offset &&
+                    placed.state == node.initial && placed.hasClear == node.hasClear &&
+                    (!node.hasClear || memcmp(&placed.clear, &node.clear, sizeof(node.clear)) == 0) &&
+                    SameDesc(placed.desc, node.desc))
+                {
+                    match = &placed;
+                    break;
+                }
+            }
+
+            if (!match)
+            {
+                Placed placed{};
+                placed.desc     = node.desc;
+                placed.clear    = node.clear;
+                placed.hasClear = node.hasClear;
+                placed.category = node.category;
+                placed.offset   = node.offset;
+                placed.state    = node.initial;
+                ThrowIfFailed(m_device->CreatePlacedResource(m_heaps[node.category].heap.Get(), node.offset,
+                                                             &node.desc, node.initial,
+                                                             node.hasClear ? &node.clear : nullptr,
+                                                             IID_PPV_ARGS(&placed.resource)));
+                wchar_t name[64] = {};
+                for (UINT i = 0; i < 63 && node.name[i]; ++i)
+                    name[i] = (wchar_t)node.name[i];
+                placed.resource->SetName(name);
+                m_placed.push_back(placed);
+                match = &m_placed.back();
+            }
+            match->used   = true;
+            node.resource = match->resource.Get();
+        }
+
+        // Whatever this frame didn't want goes once the GPU is past the last frame
+        for (Placed& placed : m_placed)
+            if (!placed.used)
+                m_retired.push_back({ placed.resource, m_lastFence });
+        m_placed.erase(std::remove_if(m_placed.begin(), m_placed.end(), [](const Placed& p) { return !p.used; }),
+                       m_placed.end());
+
+        for (const Heap& heap : m_heaps)
+            m_stats.transientBytes += heap.size;
+    }
+
+    void PlanBarriers()
+    {
+        const UINT passCount = (UINT)m_order.size();
+
+        // Which direct queue list a pass's barriers land in – externals, forks and joins each end one.
+        // Async passes get kNotUsed: their barriers are on the compute queue.
+        ArenaVector<UINT> segment(passCount, kNotUsed, &m_arena);
+        ArenaVector<bool> joinAt(passCount + 1, false, &m_arena);
+        for (const AsyncGroup& group : m_groups)
+            joinAt[group.join] = true;
+        for (UINT pos = 0, list = 0; pos < passCount; ++pos)
+        {
+            if (joinAt[pos])
+                ++list;
+            if (m_groupOf[pos] != kNotUsed)
+            {
+                if (m_groups[m_groupOf[pos]].first == pos)
+                    ++list;
+                continue;
+            }
+            segment[pos] = list;
+            if (m_passes[m_order[pos]].flags & kPassExternal)
+                ++list;
+        }
+
+        // Direct queue barriers for a position – a group's go in front of its fork
+        auto directBarriers = [&](UINT pos) -> ArenaVector<D3D12_RESOURCE_BARRIER>&
+        {
+            return m_groupOf[pos] != kNotUsed ? m_groups[m_groupOf[pos]].forkBarriers : m_passes[m_order[pos]].barriers;
+        };
+        ArenaVector<UINT> touchedBy(m_resources.size(), kNotUsed, &m_arena);     // last async group, per resource
+
+        ArenaVector<D3D12_RESOURCE_STATES> state(m_resources.size(), D3D12_RESOURCE_STATE_COMMON, &m_arena);
+        ArenaVector<UINT>                  lastPos(m_resources.size(), kNotUsed, &m_arena);
+        ArenaVector<bool>                  lastWrite(m_resources.size(), false, &m_arena);
+        for (UINT r = 0; r < (UINT)m_resources.size(); ++r)
+            state[r] = m_resources[r].initial;
+
+        for (UINT pos = 0; pos < passCount; ++pos)
+        {
+            Pass& pass = m_passes[m_order[pos]];
+
+            // Transients done with go back to their creation state first – before
+            // an aliasing barrier below can hand their memory to someone else
+            for (UINT r = 0; r < (UINT)m_resources.size(); ++r)
+            {
+                const ResourceNode& node = m_resources[r];
+                if (!node.imported && node.last + 1 == pos && state[r] != node.initial)
+                {
+                    directBarriers(pos).push_back(TransitionBarrier(node.resource, state[r], node.initial));
+                    state[r] = node.initial;
+                }
+            }
+
+            const UINT group = m_groupOf[pos];
+            for (const Access& access : pass.accesses)
+            {
+                const Resource r    = access.resource;
+                ResourceNode&  node = m_resources[r];
+
+                // In a group, a resource's first barrier is on the direct queue ahead of the fork
+                const bool onCompute = group != kNotUsed && touchedBy[r] == group;
+                ArenaVector<D3D12_RESOURCE_BARRIER>& barriers = onCompute ? pass.barriers : directBarriers(pos);
+                if (group != kNotUsed)
+                    touchedBy[r] = group;
+
+                if (!node.imported && pos == node.first && node.aliased)
+                {
+                    D3D12_RESOURCE_BARRIER aliasing{};
+                    aliasing.Type                     = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+                    aliasing.Aliasing.pResourceBefore = nullptr;    // any of them
+                    aliasing.Aliasing.pResourceAfter  = node.resource;
+                    barriers.push_back(aliasing);
+                    ++m_stats.aliasingBarriers;
+                    if (node.initial == D3D12_RESOURCE_STATE_RENDER_TARGET ||
+                        node.initial == D3D12_RESOURCE_STATE_DEPTH_WRITE)
+                        (group != kNotUsed ? m_groups[group].forkDiscards : pass.discards).push_back(node.resource);
+                }
+
+                if (state[r] != access.target)
+                {
+                    const UINT last = lastPos[r];
+                    if (last != kNotUsed && pos > last + 1 && segment[pos] != kNotUsed && segment[last + 1] == segment[pos])
+                    {
+                        D3D12_RESOURCE_BARRIER begin = TransitionBarrier(node.resource, state[r], access.target);
+                        D3D12_RESOURCE_BARRIER end   = begin;
+                        begin.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+                        end.Flags   = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+                        m_passes[m_order[last + 1]].barriers.push_back(begin);
+                        pass.barriers.push_back(end);
+                        ++m_stats.splitBarriers;
+                    }
+                    else
+                        barriers.push_back(TransitionBarrier(node.resource, state[r], access.target));
+                    state[r] = access.target;
+                }
+                else if ((access.target & D3D12_RESOURCE_STATE_UNORDERED_ACCESS) && lastPos[r] != kNotUsed &&
+                         (access.write || lastWrite[r]))
+                    barriers.push_back(UavBarrier(node.resource));
+
+                lastPos[r]   = pos;
+                lastWrite[r] = access.write;
+            }
+        }
+
+        // Imports go where they were asked, transients used by the last pass back to their creation state
+        for (UINT r = 0; r < (UINT)m_resources.size(); ++r)
+        {
+            const ResourceNode& node = m_resources[r];
+            if (node.imported && node.finalState != kKeepState && state[r] != node.finalState)
+                m_finalBarriers.push_back(TransitionBarrier(node.resource, state[r], node.finalState));
+            else if (!node.imported && node.first != kNotUsed && state[r] != node.initial)
+                m_finalBarriers.push_back(TransitionBarrier(node.resource, state[r], node.initial));
+        }
+
+        for (UINT pos = 0; pos < passCount; ++pos)
+        {
+            const Pass& pass = m_passes[m_order[pos]];
+            m_stats.barriers       += (UINT)pass.barriers.size();
+            m_stats.barrierBatches += pass.barriers.empty() ? 0 : 1;
+        }
+        for (const AsyncGroup& group : m_groups)
+        {
+            m_stats.barriers       += (UINT)group.forkBarriers.size();
+            m_stats.barrierBatches += group.forkBarriers.empty() ? 0 : 1;
+        }
+        m_stats.barriers       += (UINT)m_finalBarriers.size();
+        m_stats.barrierBatches += m_finalBarriers.empty() ? 0 : 1;
+    }
+
+    // The direct queue's program: passes in order, a fork per group, joins where they're due
+    void BuildSteps()
+    {
+        const UINT passCount = (UINT)m_order.size();
+        ArenaVector<bool> joinAt(passCount + 1, false, &m_arena);
+        for (const AsyncGroup& group : m_groups)
+            joinAt[group.join] = true;
+
+        for (UINT pos = 0; pos < passCount; ++pos)
+        {
+            if (joinAt[pos])
+                m_steps.push_back({ kStepJoin, 0 });
+            if (m_groupOf[pos] == kNotUsed)
+                m_steps.push_back({ kStepPass, pos });
+            else if (m_groups[m_groupOf[pos]].first == pos)
+                m_steps.push_back({ kStepFork, m_groupOf[pos] });
+        }
+        if (joinAt[passCount])
+            m_steps.push_back({ kStepJoin, 0 });
+    }
+
+    static void Flush(ID3D12GraphicsCommandList* cl, const ArenaVector<D3D12_RESOURCE_BARRIER>& barriers)
+    {
+        if (!barriers.empty())
+            cl->ResourceBarrier((UINT)barriers.size(), barriers.data());
+    }
+
+    ID3D12Device*                       m_device = nullptr;
+    LinearArena                         m_arena;            // before everything that lives in it
+    ArenaVector<Pass>                   m_passes{ ArenaAllocator<Pass>(&m_arena) };
+    ArenaVector<ResourceNode>           m_resources{ ArenaAllocator<ResourceNode>(&m_arena) };
+    ArenaVector<UINT>                   m_order{ ArenaAllocator<UINT>(&m_arena) };      // surviving passes, declaration order
+    ArenaVector<AsyncGroup>             m_groups{ ArenaAllocator<AsyncGroup>(&m_arena) };
+    ArenaVector<UINT>                   m_groupOf{ ArenaAllocator<UINT>(&m_arena) };    // per position in m_order, kNotUsed if direct
+    ArenaVector<Step>                   m_steps{ ArenaAllocator<Step>(&m_arena) };
+    UINT                                m_forkGroup    = 0;
+    bool                                m_asyncEnabled = true;
+    ArenaVector<D3D12_RESOURCE_BARRIER> m_finalBarriers{ ArenaAllocator<D3D12_RESOURCE_BARRIER>(&m_arena) };
+    Stats                               m_stats;
+
+    Heap                                m_heaps[kCategoryCount];
+    std::vector<Placed>                 m_placed;
+    std::vector<Retired>                m_retired;
+    UINT64                              m_lastFence = 0;
+};
@@ -0,0 +1,105 @@
+// ---------------------------------------------------------------
+// Scene meshes – the procedural stand-in geometry
+// ---------------------------------------------------------------
+// tools/assetcook bakes these into assets.pak; the engine only builds them
+// itself when there's no archive to stream them from. Order matches the
+// SceneMesh enum in main.cpp.
+//
+// Plain triangle lists with every corner spelled out – welding, ordering and
+// packing are meshcook.h's job.
+//
+// Plain std only – shared with the cooker.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+struct Vertex { float pos[3]; float normal[3]; float col[4]; };
+
+// Archive names, in SceneMesh order
+static const char* const kSceneMeshNames[] = { "mesh/triangle", "mesh/quad", "mesh/cube", "mesh/sphere", "mesh/ground" };
+
+struct MeshSource
+{
+    const char*         name;       // archive name
+    std::vector<Vertex> vertices;   // triangle list
+};
+
+inline std::vector<MeshSource> BuildSceneMeshes()
+{
+    const float kPi = 3.14159265f;
+    std::vector<MeshSource> meshes;
+
+    // Flat ones face -Z, towards a camera looking down +Z
+    meshes.push_back({ kSceneMeshNames[0],
+    {
+        { { 0.0f,  0.5f, 0.0f }, { 0.f, 0.f, -1.f }, {1.f, 0.f, 0.f, 1.f} },
+        { {-0.5f,-0.5f, 0.0f }, { 0.f, 0.f, -1.f }, {0.f, 1.f, 0.f, 1.f} },
+        { { 0.5f,-0.5f, 0.0f }, { 0.f, 0.f, -1.f }, {0.f, 0.f, 1.f, 1.f} },
+    } });
+
+    meshes.push_back({ kSceneMeshNames[1],
+    {
+        { {-0.4f,-0.4f, 0.0f }, { 0.f, 0.f, -1.f }, {1.f, 1.f, 1.f, 1.f} },
+        { {-0.4f, 0.4f, 0.0f }, { 0.f, 0.f, -1.f }, {1.f, 1.f, 0.f, 1.f} },
+        { { 0.4f, 0.4f, 0.0f }, { 0.f, 0.f, -1.f }, {1.f, 1.f, 1.f, 1.f} },
+        { {-0.4f,-0.4f, 0.0f }, { 0.f, 0.f, -1.f }, {1.f, 1.f, 1.f, 1.f} },
+        { { 0.4f, 0.4f, 0.0f }, { 0.f, 0.f, -1.f }, {1.f, 1.f, 1.f, 1.f} },
+        { { 0.4f,-0.4f, 0.0f }, { 0.f, 0.f, -1.f }, {0.f, 1.f, 1.f, 1.f} },
+    } });
+
+    // Cube: per face, two triangles, flat normals
+    MeshSource& cube = meshes.emplace_back(MeshSource{ kSceneMeshNames[2], {} });
+    for (int axis = 0; axis < 3; ++axis)
+        for (float side : { -0.5f, 0.5f })
+        {
+            const int   u = (axis + 1) % 3, v = (axis + 2) % 3;
+            const float corners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+            for (int corner : { 0, 1, 2, 0, 2, 3 })
+            {
+                Vertex vertex{ {}, {}, { 1.0f, 1.0f, 1.0f, 1.0f } };
+                vertex.pos[axis]    = side;
+                vertex.normal[axis] = side * 2.0f;
+                vertex.pos[u]    = corners[corner][0];
+                vertex.pos[v]    = corners[corner][1];
+                cube.vertices.push_back(vertex);
+            }
+        }
+
+    // Sphere: latitude/longitude bands, radius 0.5
+    const uint32_t rings = 10, segments = 16;
+    MeshSource& sphere = meshes.emplace_back(MeshSource{ kSceneMeshNames[3], {} });
+    auto spherePoint = [&](uint32_t ring, uint32_t segment)
+    {
+        const float theta = kPi * (float)ring / (float)rings;
+        const float phi   = 2.0f * kPi * (float)segment / (float)segments;
+        const float c     = segment % 2 ? 0.85f : 1.0f;      // stripes show it rolling
+        const float n[3]  = { sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi) };
+        return Vertex{ { 0.5f * n[0], 0.5f * n[1], 0.5f * n[2] }, { n[0], n[1], n[2] }, { c, c, c, 1.0f } };
+    };
+    for (uint32_t ring = 0; ring < rings; ++ring)
+        for (uint32_t segment = 0; segment < segments; ++segment)
+            for (uint32_t corner : { 0u, 1u, 2u, 2u, 1u, 3u })
+                sphere.vertices.push_back(spherePoint(ring + (corner & 1), segment + (corner >> 1)));
+
+    // Ground: unit quad in XZ
+    MeshSource& ground = meshes.emplace_back(MeshSource{ kSceneMeshNames[4], {} });
+    for (uint32_t corner : { 0u, 1u, 3u, 0u, 3u, 2u })
+        ground.vertices.push_back({ { corner & 1 ? 0.5f : -0.5f, 0.0f, corner & 2 ? 0.5f : -0.5f }, { 0.0f, 1.0f, 0.0f },
+                                    { 0.35f, 0.35f, 0.38f, 1.0f } });
+
+    return meshes;
+}
+
+// Bounding sphere around the mesh origin
+inline float MeshBoundsRadius(const std::vector<Vertex>& vertices)
+{
+    float radiusSq = 0.0f;
+    for (const Vertex& v : vertices)
+    {
+        const float r = v.pos[0] * v.pos[0] + v.pos[1] * v.pos[1] + v.pos[2] * v.pos[2];
+        radiusSq = r > radiusSq ? r : radiusSq;
+    }
+    return sqrtf(radiusSq);
+}
@@ -0,0 +1,117 @@
+// ---------------------------------------------------------------
+// Scene textures – the procedural stand-in images
+// ---------------------------------------------------------------
+// tools/assetcook compresses these (texcook.h) into assets.pak. Order
+// matches the SceneTexture enum in main.cpp. Both tile: every pattern
+// repeats a whole number of times across the image.
+//
+//   texture/planks   4K BC7 deck planks – the ship
+//   texture/ocean    4K BC5 wave normals – the ground is the sea
+//
+// Plain std only – shared with the cooker.
+#pragma once
+
+#include "texcook.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Archive names, in SceneTexture order
+static const char* const kSceneTextureNames[] = { "texture/planks", "texture/ocean" };
+
+// Tileable value noise: lattice `period` cells across, smoothstepped, in [0, 1]
+inline float TileNoise(float u, float v, uint32_t period, uint32_t seed)
+{
+    auto hash = [period, seed](int32_t x, int32_t y)
+    {
+        uint32_t h = (uint32_t)((x % (int32_t)period + (int32_t)period) % (int32_t)period) * 73856093u ^
+                     (uint32_t)((y % (int32_t)period + (int32_t)period) % (int32_t)period) * 19349663u ^ seed * 83492791u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+        return (float)(h & 0xffffff) * (1.0f / 16777215.0f);
+    };
+    const float x = u * (float)period, y = v * (float)period;
+    const int32_t x0 = (int32_t)std::floor(x), y0 = (int32_t)std::floor(y);
+    float fx = x - (float)x0, fy = y - (float)y0;
+    fx = fx * fx * (3.0f - 2.0f * fx);
+    fy = fy * fy * (3.0f - 2.0f * fy);
+    const float top    = hash(x0, y0) + (hash(x0 + 1, y0) - hash(x0, y0)) * fx;
+    const float bottom = hash(x0, y0 + 1) + (hash(x0 + 1, y0 + 1) - hash(x0, y0 + 1)) * fx;
+    return top + (bottom - top) * fy;
+}
+
+inline std::vector<TextureSource> BuildSceneTextures()
+{
+    std::vector<TextureSource> textures;
+
+    // Planks run along U, 16 across; staggered butt joints, grain stretched along the board
+    {
+        TextureSource& planks = textures.emplace_back(TextureSource{ kSceneTextureNames[0], kTextureBC7, false, 4096, 4096, {} });
+        planks.rgba.resize((size_t)planks.width * planks.height * 4);
+        for (uint32_t y = 0; y < planks.height; ++y)
+            for (uint32_t x = 0; x < planks.width; ++x)
+            {
+                const float    u     = (float)x / (float)planks.width;
+                const float    v     = (float)y / (float)planks.height;
+                const float    board = v * 16.0f;
+                const uint32_t row   = (uint32_t)board;
+                const float    along = u * 4.0f + (float)(row * 7 % 4) * 0.25f;    // four lengths per row
+                const float    seamV = std::fabs(board - (float)row - 0.5f) * 2.0f;    // 1 at the edges
+                const float    seamU = std::fabs(along - std::floor(along) - 0.5f) * 2.0f;
+                const float    grain = TileNoise(u, v * 16.0f, 64, 1) * 0.6f + TileNoise(u, v, 512, 2) * 0.4f;
+                const float    rings = 0.5f + 0.5f * std::sin(grain * 40.0f + (float)row * 1.7f);
+                const float    tone  = 0.75f + 0.25f * TileNoise((float)row / 16.0f, (float)(uint32_t)along / 4.0f, 16, 3);
+                float shade = tone * (0.8f + 0.2f * rings);
+                if (seamV > 0.96f || seamU > 0.995f)
+                    shade *= 0.35f;                                     // tarred gaps
+                uint8_t* out = &planks.rgba[((size_t)y * planks.width + x) * 4];
+                out[0] = (uint8_t)std::lround(std::fmin(shade * 0.78f, 1.0f) * 255.0f);
+                out[1] = (uint8_t)std::lround(std::fmin(shade * 0.58f, 1.0f) * 255.0f);
+                out[2] = (uint8_t)std::lround(std::fmin(shade * 0.38f, 1.0f) * 255.0f);
+                out[3] = 255;
+            }
+    }
+
+    // Sum of sines with whole wave numbers (so it tiles) plus two noise octaves of chop
+    {
+        TextureSource& ocean = textures.emplace_back(TextureSource{ kSceneTextureNames[1], kTextureBC5, true, 4096, 4096, {} });
+        ocean.rgba.resize((size_t)ocean.width * ocean.height * 4);
+        static const float kWaves[][4] =     // kx, ky (waves per tile), amplitude, phase
+        {
+            { 3, 1, 0.020f, 0.0f }, { 2, -3, 0.014f, 1.3f }, { 7, 4, 0.006f, 2.1f },
+            { -5, 9, 0.004f, 0.4f }, { 13, -6, 0.0025f, 4.0f }, { 21, 17, 0.0012f, 5.2f },
+        };
+        const float kTwoPi = 6.28318531f;
+        std::vector<float> height((size_t)ocean.width * ocean.height);
+        for (uint32_t y = 0; y < ocean.height; ++y)
+            for (uint32_t x = 0; x < ocean.width; ++x)
+            {
+                const float u = (float)x / (float)ocean.width, v = (float)y / (float)ocean.height;
+                float h = 0.0f;
+                for (const float* wave : kWaves)
+                    h += wave[2] * std::sin(kTwoPi * (wave[0] * u + wave[1] * v) + wave[3]);
+                h += 0.0015f * TileNoise(u, v, 128, 4) + 0.0006f * TileNoise(u, v, 512, 5);
+                height[(size_t)y * ocean.width + x] = h;
+            }
+        // Central differences, wrapping – the slope is what ends up in the normal
+        const float scale = (float)ocean.width * 0.5f;
+        for (uint32_t y = 0; y < ocean.height; ++y)
+            for (uint32_t x = 0; x < ocean.width; ++x)
+            {
+                auto at = [&](uint32_t px, uint32_t py)
+                {
+                    return height[(size_t)(py % ocean.height) * ocean.width + px % ocean.width];
+                };
+                const float dx = (at(x + 1, y) - at(x + ocean.width - 1, y)) * scale;
+                const float dy = (at(x, y + 1) - at(x, y + ocean.height - 1)) * scale;
+                const float invLength = 1.0f / std::sqrt(dx * dx + dy * dy + 1.0f);
+                uint8_t* out = &ocean.rgba[((size_t)y * ocean.width + x) * 4];
+                out[0] = (uint8_t)std::lround((-dx * invLength * 0.5f + 0.5f) * 255.0f);
+                out[1] = (uint8_t)std::lround((-dy * invLength * 0.5f + 0.5f) * 255.0f);
+                out[2] = (uint8_t)std::lround((invLength * 0.5f + 0.5f) * 255.0f);
+                out[3] = 255;
+            }
+    }
+    return textures;
+}
@@ -0,0 +1,293 @@
+// ---------------------------------------------------------------
+// Shader library – precompiled DXIL archive + dev compile cache
+// ---------------------------------------------------------------
+// Release: shaders.pak (built by tools/shaderpack) is memory-mapped and
+// bytecode is handed out straight from the mapping, no compiling at all.
+//
+// Development (_DEBUG): shaders are rebuilt from the source listed in
+// shaders/shaders.txt through DXC, but only when the source actually
+// changed – results are cached on disk keyed by a hash of the source,
+// the .hlsli files next to it, entry, profile, defines and flags.
+// Either path falls back to the other if it can't find a shader.
+//
+// Reload() recompiles one from source whatever the build (hotreload.h); from
+// then on Get() hands out the new bytecode too. Old bytecode stays valid.
+#pragma once
+
+#include "dxhelpers.h"
+#include "shaderpak.h"
+#include <dxcapi.h>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+class ShaderLibrary
+{
+public:
+    void Init(const char* archivePath, const char* manifestPath, const char* cacheDir)
+    {
+        m_cacheDir = cacheDir;
+        m_manifest = ParseShaderManifest(manifestPath);
+        OpenArchive(archivePath);
+    }
+
+    void Shutdown()
+    {
+        if (m_view)    UnmapViewOfFile(m_view);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_view = nullptr; m_mapping = nullptr; m_file = INVALID_HANDLE_VALUE;
+        m_compiled.clear();
+        m_retired.clear();
+        m_compiler.Reset();
+        m_utils.Reset();
+        if (m_dxcModule) FreeLibrary(m_dxcModule);
+        m_dxcModule = nullptr;
+    }
+
+    // Valid until Shutdown()
+    D3D12_SHADER_BYTECODE Get(const char* name)
+    {
+#if defined(_DEBUG)
+        const bool preferSource = true;
+#else
+        const bool preferSource = false;
+#endif
+        std::lock_guard<std::mutex> lock(m_mutex);
+        D3D12_SHADER_BYTECODE code{};
+        if (!preferSource && !m_compiled.count(name) && FindInArchive(name, code))
+            return code;
+
+        for (const ShaderManifestEntry& entry : m_manifest)
+            if (entry.name == name && std::filesystem::exists(entry.file))
+                return CompileCached(entry);
+
+        if (FindInArchive(name, code))
+            return code;
+
+        throw std::runtime_error(std::string("Shader not found: ") + name);
+    }
+
+    // Compiles from source again, past the in-memory copy (the disk cache still
+    // applies, so an unchanged source costs nothing). Throws with DXC's errors.
+    D3D12_SHADER_BYTECODE Reload(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const ShaderManifestEntry& entry : m_manifest)
+            if (entry.name == name)
+            {
+                auto found = m_compiled.find(name);
+                if (found != m_compiled.end())
+                {
+                    m_retired.push_back(std::move(found->second));  // someone may still hold a pointer into it
+                    m_compiled.erase(found);
+                }
+                return CompileCached(entry);
+            }
+        throw std::runtime_error("Shader not in the manifest: " + name);
+    }
+
+    // Every shader built from `file` – all of them for an .hlsli, they're all hashed with every one
+    std::vector<std::string> ShadersFrom(const std::filesystem::path& file) const
+    {
+        std::vector<std::string> names;
+        const bool include = file.extension() == ".hlsli";
+        for (const ShaderManifestEntry& entry : m_manifest)
+            if (include || std::filesystem::path(entry.file).filename() == file.filename())
+                names.push_back(entry.name);
+        return names;
+    }
+
+private:
+    void OpenArchive(const char* path)
+    {
+        m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return;     // no archive – dev compile path only
+
+        LARGE_INTEGER size{};
+        GetFileSizeEx(m_file, &size);
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping)
+            m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_view)
+            throw std::runtime_error("Failed to map shader archive");
+
+        auto* header = reinterpret_cast<const ShaderPakHeader*>(m_view);
+        if ((UINT64)size.QuadPart < sizeof(ShaderPakHeader) ||
+            header->magic != kShaderPakMagic || header->version != kShaderPakVersion ||
+            sizeof(ShaderPakHeader) + sizeof(ShaderPakEntry) * (UINT64)header->entryCount > (UINT64)size.QuadPart)
+            throw std::runtime_error("Shader archive is corrupt or out of date");
+
+        m_entries    = reinterpret_cast<const ShaderPakEntry*>(m_view + sizeof(ShaderPakHeader));
+        m_entryCount = header->entryCount;
+        m_viewSize   = (UINT64)size.QuadPart;
+    }
+
+    bool FindInArchive(const char* name, D3D12_SHADER_BYTECODE& out) const
+    {
+        if (!m_entries)
+            return false;
+
+        const uint64_t hash = HashString(name);
+        UINT lo = 0, hi = m_entryCount;
+        while (lo < hi)
+        {
+            UINT mid = (lo + hi) / 2;
+            if (m_entries[mid].nameHash < hash) lo = mid + 1;
+            else                                hi = mid;
+        }
+        if (lo == m_entryCount || m_entries[lo].nameHash != hash)
+            return false;
+
+        const ShaderPakEntry& e = m_entries[lo];
+        if (e.offset + e.size > m_viewSize)
+            throw std::runtime_error("Shader archive entry out of range");
+        out = { m_view + e.offset, (SIZE_T)e.size };
+        return true;
+    }
+
+    static bool ReadFileBytes(const std::filesystem::path& path, std::vector<char>& out)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    static std::wstring Widen(const std::string& s) { return std::wstring(s.begin(), s.end()); }
+
+    D3D12_SHADER_BYTECODE CompileCached(const ShaderManifestEntry& entry)
+    {
+        auto found = m_compiled.find(entry.name);
+        if (found != m_compiled.end())
+            return { found->second.data(), found->second.size() };
+
+        std::vector<char> source;
+        if (!ReadFileBytes(entry.file, source))
+            throw std::runtime_error("Failed to read shader source: " + entry.file);
+
+        // Cache key – anything that changes the output has to be in here
+        uint64_t key = HashBytes(source.data(), source.size());
+        std::filesystem::path dir = std::filesystem::path(entry.file).parent_path();
+        for (const auto& file : std::filesystem::directory_iterator(dir.empty() ? "." : dir))
+        {
+            if (file.path().extension() != ".hlsli") continue;
+            std::vector<char> include;
+            if (ReadFileBytes(file.path(), include))
+                key = HashBytes(include.data(), include.size(), key);
+        }
+        std::string options = entry.entry + "|" + entry.profile + "|" + CompileFlags();
+        for (const std::string& d : entry.defines)
+            options += "|" + d;
+        key = HashBytes(options.data(), options.size(), key);
+
+        char keyName[32];
+        snprintf(keyName, sizeof(keyName), "%016llx.dxil", (unsigned long long)key);
+        std::filesystem::path cachePath = std::filesystem::path(m_cacheDir) / keyName;
+
+        std::vector<char> blob;
+        if (!ReadFileBytes(cachePath, blob))
+        {
+            blob = Compile(entry, source);
+
+            std::error_code ec;
+            std::filesystem::create_directories(m_cacheDir, ec);
+            std::ofstream out(cachePath, std::ios::binary);
+            out.write(blob.data(), (std::streamsize)blob.size());
+        }
+
+        std::vector<char>& stored = m_compiled[entry.name] = std::move(blob);
+        return { stored.data(), stored.size() };
+    }
+
+    static std::string CompileFlags()
+    {
+#if defined(_DEBUG)
+        return kShaderFlagsDebug;
+#else
+        return kShaderFlagsRelease;
+#endif
+    }
+
+    // dxcompiler.dll is loaded on demand, so shipping builds that only use the archive don't need it
+    void InitCompiler()
+    {
+        if (m_compiler)
+            return;
+
+        m_dxcModule = LoadLibraryW(L"dxcompiler.dll");
+        if (!m_dxcModule)
+            throw std::runtime_error("dxcompiler.dll not found – build shaders.pak or install DXC");
+        auto create = reinterpret_cast<DxcCreateInstanceProc>(GetProcAddress(m_dxcModule, "DxcCreateInstance"));
+        if (!create)
+            throw std::runtime_error("dxcompiler.dll has no DxcCreateInstance");
+
+        ThrowIfFailed(create(CLSID_DxcUtils, IID_PPV_ARGS(&m_utils)));
+        ThrowIfFailed(create(CLSID_DxcCompiler, IID_PPV_ARGS(&m_compiler)));
+    }
+
+    std::vector<char> Compile(const ShaderManifestEntry& entry, const std::vector<char>& source)
+    {
+        InitCompiler();
+
+        std::vector<std::wstring> args = { Widen(entry.file), L"-E", Widen(entry.entry),
+                                           L"-T", Widen(entry.profile) };
+        for (const std::string& d : entry.defines)
+        {
+            args.push_back(L"-D");
+            args.push_back(Widen(d));
+        }
+        std::istringstream flags(CompileFlags());
+        std::string flag;
+        while (flags >> flag)
+            args.push_back(Widen(flag));
+
+        std::vector<LPCWSTR> argv;
+        for (const std::wstring& a : args)
+            argv.push_back(a.c_str());
+
+        ComPtr<IDxcIncludeHandler> includes;
+        ThrowIfFailed(m_utils->CreateDefaultIncludeHandler(&includes));
+
+        DxcBuffer buffer{ source.data(), source.size(), DXC_CP_UTF8 };
+        ComPtr<IDxcResult> result;
+        ThrowIfFailed(m_compiler->Compile(&buffer, argv.data(), (UINT32)argv.size(),
+                                          includes.Get(), IID_PPV_ARGS(&result)));
+
+        ComPtr<IDxcBlobUtf8> errors;
+        result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr);
+        if (errors && errors->GetStringLength() > 0)
+            OutputDebugStringA(errors->GetStringPointer());
+
+        HRESULT status = E_FAIL;
+        result->GetStatus(&status);
+        if (FAILED(status))
+            throw std::runtime_error("Shader compilation failed: " + entry.name +
+                                     (errors ? std::string("\n") + errors->GetStringPointer() : std::string()));
+
+        ComPtr<IDxcBlob> object;
+        ThrowIfFailed(result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&object), nullptr));
+        const char* bytes = static_cast<const char*>(object->GetBufferPointer());
+        return std::vector<char>(bytes, bytes + object->GetBufferSize());
+    }
+
+    // Archive
+    HANDLE                 m_file       = INVALID_HANDLE_VALUE;
+    HANDLE                 m_mapping    = nullptr;
+    const uint8_t*         m_view       = nullptr;
+    UINT64                 m_viewSize   = 0;
+    const ShaderPakEntry*  m_entries    = nullptr;
+    UINT                   m_entryCount = 0;
+
+    // Runtime compile path
+    std::vector<ShaderManifestEntry>                   m_manifest;
+    std::string                                        m_cacheDir;
+    std::unordered_map<std::string, std::vector<char>> m_compiled;
+    std::vector<std::vector<char>>                     m_retired;      // replaced by Reload(), kept for Get()'s promise
+    std::mutex                                         m_mutex;        // Get() from the init tasks vs each other and the hot reload thread
+    HMODULE                                            m_dxcModule = nullptr;
+    ComPtr<IDxcUtils>                                  m_utils;
+    ComPtr<IDxcCompiler3>                              m_compiler;
+};
@@ -0,0 +1,96 @@
+// ---------------------------------------------------------------
+// Shader archive format (shaders.pak)
+// ---------------------------------------------------------------
+// Written by tools/shaderpack.cpp, memory-mapped by shaderlibrary.h.
+//
+//   ShaderPakHeader
+//   ShaderPakEntry[entryCount]      sorted by nameHash
+//   blobs                           each DXIL container 16-byte aligned
+//
+// Also home of the shaders/shaders.txt manifest parser, which both sides use.
+// Plain std only – the pack tool has to build without the Windows SDK.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const uint32_t kShaderPakMagic   = 0x50535753;   // 'SWSP'
+static const uint32_t kShaderPakVersion = 1;
+
+// DXC flags for both the pack tool and the runtime fallback – PsoCache keys pipelines on the
+// bytecode, so the two must build identical DXIL
+static const char kShaderFlagsDebug[]   = "-Od -Zi -Qembed_debug";
+static const char kShaderFlagsRelease[] = "-O3 -Qstrip_debug -Qstrip_reflect";
+
+struct ShaderPakHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct ShaderPakEntry
+{
+    uint64_t nameHash;
+    uint64_t offset;      // from the start of the file
+    uint64_t size;
+    char     name[40];    // for tools / error messages only
+};
+
+// FNV-1a, used for archive names and the runtime compile cache keys
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint64_t HashString(const char* str)
+{
+    size_t len = 0;
+    while (str[len]) ++len;
+    return HashBytes(str, len);
+}
+
+// One line of shaders/shaders.txt
+struct ShaderManifestEntry
+{
+    std::string              name;
+    std::string              file;
+    std::string              entry;
+    std::string              profile;
+    std::vector<std::string> defines;   // NAME or NAME=VALUE
+};
+
+// Returns an empty list if the manifest can't be opened
+inline std::vector<ShaderManifestEntry> ParseShaderManifest(const char* path)
+{
+    std::vector<ShaderManifestEntry> entries;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.resize(hash);
+
+        std::istringstream words(line);
+        ShaderManifestEntry e;
+        if (!(words >> e.name >> e.file >> e.entry >> e.profile))
+            continue;
+        std::string define;
+        while (words >> define)
+            e.defines.push_back(define);
+        entries.push_back(e);
+    }
+    return entries;
+}
@@ -0,0 +1,49 @@
+// Bindless resource access – everything lives in one shader-visible heap and
+// shaders get indices through the per-draw root constants (b0).
+//
+// BINDLESS_HEAP defined (SM 6.6, binding tier 3): ResourceDescriptorHeap[] directly.
+// Otherwise (SM 6.0, tier 2): unbounded tables the root signature maps over the
+// same heap, one per resource type. Use the Get*() helpers and it doesn't matter.
+#ifndef BINDLESS_HLSLI
+#define BINDLESS_HLSLI
+
+// 16 dwords of root constants; each pass decides what they mean
+cbuffer DrawConstants : register(b0)
+{
+    uint4 g_drawConstants[4];
+};
+
+uint DrawConstant(uint i) { return g_drawConstants[i >> 2][i & 3]; }
+
+// b1 is the per-frame root CBV, declared by whoever uses it
+
+#ifdef BINDLESS_HEAP
+
+ByteAddressBuffer   GetBuffer(uint i)          { return ResourceDescriptorHeap[NonUniformResourceIndex(i)]; }
+RWByteAddressBuffer GetRWBuffer(uint i)        { return ResourceDescriptorHeap[NonUniformResourceIndex(i)]; }
+Texture2D<float4>   GetTexture2D(uint i)       { return ResourceDescriptorHeap[NonUniformResourceIndex(i)]; }
+RWTexture2D<float4> GetRWTexture2D(uint i)     { return ResourceDescriptorHeap[NonUniformResourceIndex(i)]; }
+RWTexture2D<float>  GetRWTexture2DFloat(uint i){ return ResourceDescriptorHeap[NonUniformResourceIndex(i)]; }
+
+#else
+
+ByteAddressBuffer   g_bindlessBuffers[]        : register(t0, space1);
+Texture2D<float4>   g_bindlessTextures[]       : register(t0, space2);
+RWByteAddressBuffer g_bindlessRWBuffers[]      : register(u0, space1);
+RWTexture2D<float4> g_bindlessRWTextures[]     : register(u0, space2);
+RWTexture2D<float>  g_bindlessRWTexturesFloat[]: register(u0, space3);
+
+ByteAddressBuffer   GetBuffer(uint i)          { return g_bindlessBuffers[NonUniformResourceIndex(i)]; }
+RWByteAddressBuffer GetRWBuffer(uint i)        { return g_bindlessRWBuffers[NonUniformResourceIndex(i)]; }
+Texture2D<float4>   GetTexture2D(uint i)       { return g_bindlessTextures[NonUniformResourceIndex(i)]; }
+RWTexture2D<float4> GetRWTexture2D(uint i)     { return g_bindlessRWTextures[NonUniformResourceIndex(i)]; }
+RWTexture2D<float>  GetRWTexture2DFloat(uint i){ return g_bindlessRWTexturesFloat[NonUniformResourceIndex(i)]; }
+
+#endif
+
+// Static samplers baked into the root signature
+SamplerState g_linearClamp : register(s0);
+SamplerState g_linearWrap  : register(s1);
+SamplerState g_pointClamp  : register(s2);
+
+#endif // BINDLESS_HLSLI
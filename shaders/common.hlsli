@@ -0,0 +1,75 @@
+// Per-frame constants and per-instance data shared by the scene shaders
+#ifndef COMMON_HLSLI
+#define COMMON_HLSLI
+
+#include "bindless.hlsli"
+
+// Root CBV b1 – mirrors FrameConstants in main.cpp
+cbuffer FrameConstants : register(b1)
+{
+    float4x4 g_viewProj;
+    float4x4 g_prevViewProj;        // last frame's – the HiZ was rendered with it
+    float4   g_frustumPlanes[6];    // world space, xyz inward normal, w distance
+    float3   g_cameraPos;
+    float    g_time;
+    float2   g_hizSize;
+    uint     g_hizMips;
+    uint     g_hizValid;            // 0 on the first frame and after resizes
+    uint     g_materialTable;       // SRV, ~0 when there are no textures
+    uint     g_textureTable;        // SRV, this frame's – see texturestream.hlsli
+    uint     g_textureFeedback;     // RW buffer, ~0 when there are no textures
+    uint     g_lightBuffer;         // SRV, this frame's LightData[] – see lighting.hlsli
+    float4x4 g_view;
+    float4   g_projParams;          // P00, P11, near, far – what the clusters are cut from
+    float2   g_renderSize;          // viewport, pixels
+    uint     g_lightCount;
+    uint     g_clusterBuffer;       // SRV, the light bin's output
+    float    g_sunIntensity;
+    float    g_ambient;
+    float2   g_jitter;              // render pixels the projection is offset by – see temporalupscale.h
+    float4x4 g_unjitteredViewProj;  // motion vectors leave the jitter out
+    float4x4 g_prevUnjitteredViewProj;
+};
+
+// Scene passes' targets: colour, and where the pixel was last frame as a uv offset
+struct SceneTargets
+{
+    float4 color : SV_TARGET0;
+    float2 motion : SV_TARGET1;     // ignored without TAA – the PSO has one target then
+};
+
+// uv now - uv last frame, from the two unjittered clip positions
+float2 MotionVector(float4 clip, float4 prevClip)
+{
+    return (clip.xy / clip.w - prevClip.xy / prevClip.w) * float2(0.5, -0.5);
+}
+
+// Mirrors InstanceData in drawbatch.h – 64 bytes
+struct InstanceData
+{
+    float3x4 world;
+    float4   color;
+};
+
+InstanceData LoadInstance(ByteAddressBuffer buffer, uint index)
+{
+    uint  base = index * 64;
+    InstanceData d;
+    d.world = float3x4(asfloat(buffer.Load4(base +  0)),
+                       asfloat(buffer.Load4(base + 16)),
+                       asfloat(buffer.Load4(base + 32)));
+    d.color = asfloat(buffer.Load4(base + 48));
+    return d;
+}
+
+// World-space sphere against the camera frustum
+bool FrustumVisible(float3 center, float radius)
+{
+    [unroll]
+    for (uint i = 0; i < 6; ++i)
+        if (dot(g_frustumPlanes[i].xyz, center) + g_frustumPlanes[i].w < -radius)
+            return false;
+    return true;
+}
+
+#endif // COMMON_HLSLI
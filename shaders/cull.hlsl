@@ -0,0 +1,144 @@
+// GPU culling – frustum + previous frame's HiZ, writes compacted indirect arguments
+//
+// Three dispatches, UAV barriers in between:
+//   ClearCS      one thread per batch (+1), zeroes the counters
+//   CullCS       one thread per instance, appends visible ones to their batch's range
+//   ArgsCS       one thread per batch, emits a draw for every batch with anything visible
+//
+// Draw constants:
+//   0 instances (SRV)       1 batch table (SRV)     2 batch count
+//   3 visible list (UAV)    4 counters (UAV)        5 arguments (UAV)
+//   6 HiZ (SRV)             7 flags: 1 frustum, 2 occlusion, 4 mesh shader arguments
+//   8 instance count
+//
+// Counters: [0] draws emitted (the ExecuteIndirect count), [1 + b] visible instances in batch b
+// Batch (48 bytes, mirrors GpuBatch in main.cpp):
+//   indexCount, firstIndex, firstInstance, instanceCount, material, baseVertex, mesh, meshletGroups,
+//   bounds center, radius
+// Argument (32 bytes, mirrors IndirectCommand):
+//   firstInstance, material, mesh (-> draw constants 1..3), D3D12_DRAW_INDEXED_ARGUMENTS
+// or with flag 4 (24 bytes, mirrors MeshCommand – see meshlet.hlsl):
+//   firstInstance, material, mesh, D3D12_DISPATCH_MESH_ARGUMENTS (meshletGroups, visible, 1)
+#include "common.hlsli"
+
+static const uint kBatchStride = 48;
+
+// Projects the sphere's box with last frame's camera and compares its nearest
+// depth against the farthest depth the HiZ has over that rect
+bool HiZVisible(float3 center, float radius)
+{
+    float2 minUv = 1.0, maxUv = 0.0;
+    float  minZ  = 1.0;
+
+    [unroll]
+    for (uint c = 0; c < 8; ++c)
+    {
+        float3 corner = center + radius * float3((c & 1) ? 1.0 : -1.0,
+                                                 (c & 2) ? 1.0 : -1.0,
+                                                 (c & 4) ? 1.0 : -1.0);
+        float4 clip = mul(g_prevViewProj, float4(corner, 1.0));
+        if (clip.w <= 0.0)
+            return true;        // straddles the camera plane, can't tell
+
+        float3 ndc = clip.xyz / clip.w;
+        float2 uv  = ndc.xy * float2(0.5, -0.5) + 0.5;
+        minUv = min(minUv, uv);
+        maxUv = max(maxUv, uv);
+        minZ  = min(minZ, ndc.z);
+    }
+    minUv = saturate(minUv);
+    maxUv = saturate(maxUv);
+
+    // Smallest mip where the rect covers at most 2x2 texels
+    float2 size   = (maxUv - minUv) * g_hizSize;
+    uint   mip    = min((uint)ceil(log2(max(max(size.x, size.y), 1.0))), g_hizMips - 1);
+    uint2  extent = max(uint2(g_hizSize) >> mip, 1);
+    uint2  lo     = min(uint2(minUv * extent), extent - 1);
+    uint2  hi     = min(uint2(maxUv * extent), extent - 1);
+
+    Texture2D<float4> hiz  = GetTexture2D(DrawConstant(6));
+    float             maxZ = 0.0;
+    for (uint y = lo.y; y <= hi.y; ++y)
+        for (uint x = lo.x; x <= hi.x; ++x)
+            maxZ = max(maxZ, hiz.Load(int3(x, y, mip)).r);
+
+    return minZ <= maxZ;
+}
+
+[numthreads(64, 1, 1)]
+void ClearCS(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x <= DrawConstant(2))
+        GetRWBuffer(DrawConstant(4)).Store(id.x * 4, 0);
+}
+
+[numthreads(64, 1, 1)]
+void CullCS(uint3 id : SV_DispatchThreadID)
+{
+    const uint index = id.x;
+    if (index >= DrawConstant(8))
+        return;
+
+    // Batches are sorted by firstInstance – find ours
+    ByteAddressBuffer batches = GetBuffer(DrawConstant(1));
+    uint lo = 0, hi = DrawConstant(2) - 1;
+    while (lo < hi)
+    {
+        uint mid = (lo + hi + 1) / 2;
+        if (batches.Load(mid * kBatchStride + 8) <= index) lo = mid;
+        else                                               hi = mid - 1;
+    }
+    const uint   batch         = lo;
+    const uint   firstInstance = batches.Load(batch * kBatchStride + 8);
+    const float4 bounds        = asfloat(batches.Load4(batch * kBatchStride + 32));
+
+    InstanceData inst   = LoadInstance(GetBuffer(DrawConstant(0)), index);
+    float3       center = mul(inst.world, float4(bounds.xyz, 1.0));
+    float        scale  = max(length(inst.world._m00_m10_m20),
+                          max(length(inst.world._m01_m11_m21), length(inst.world._m02_m12_m22)));
+    float        radius = bounds.w * scale;
+
+    const uint flags   = DrawConstant(7);
+    bool       visible = true;
+    if (flags & 1)
+        visible = FrustumVisible(center, radius);
+    if (visible && (flags & 2) && g_hizValid)
+        visible = HiZVisible(center, radius);
+
+    if (visible)
+    {
+        uint slot;
+        GetRWBuffer(DrawConstant(4)).InterlockedAdd(4 + batch * 4, 1, slot);
+        GetRWBuffer(DrawConstant(3)).Store((firstInstance + slot) * 4, index);
+    }
+}
+
+[numthreads(64, 1, 1)]
+void ArgsCS(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= DrawConstant(2))
+        return;
+
+    RWByteAddressBuffer counters = GetRWBuffer(DrawConstant(4));
+    const uint          count    = counters.Load(4 + id.x * 4);
+    if (count == 0)
+        return;
+
+    ByteAddressBuffer batches  = GetBuffer(DrawConstant(1));
+    uint4             b        = batches.Load4(id.x * kBatchStride);
+    uint4             draw     = batches.Load4(id.x * kBatchStride + 16);      // material, baseVertex, mesh, meshletGroups
+
+    uint slot;
+    counters.InterlockedAdd(0, 1, slot);
+
+    RWByteAddressBuffer args = GetRWBuffer(DrawConstant(5));
+    if (DrawConstant(7) & 4)
+    {
+        args.Store3(slot * 24,      uint3(b.z, draw.x, draw.z));
+        args.Store3(slot * 24 + 12, uint3(draw.w, count, 1));
+        return;
+    }
+    args.Store3(slot * 32,      uint3(b.z, draw.x, draw.z));
+    args.Store4(slot * 32 + 12, uint4(b.x, count, b.y, draw.y));
+    args.Store(slot * 32 + 28,  0);                                             // StartInstanceLocation
+}
@@ -0,0 +1,38 @@
+// HiZ pyramid – every texel holds the farthest depth of the area it covers,
+// so "nearest point is behind it" is a conservative occlusion test.
+//
+// Draw constants: 0 source, 1 destination (UAV), 2..3 source size, 4..5 destination size,
+//                 6 source kind: 1 = depth buffer SRV, 0 = previous HiZ mip UAV
+//
+// Sizes needn't be powers of two: each destination texel takes the max over
+// every source texel it touches (up to 3x3 on odd sizes).
+#include "bindless.hlsli"
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 id : SV_DispatchThreadID)
+{
+    const uint2 srcSize = uint2(DrawConstant(2), DrawConstant(3));
+    const uint2 dstSize = uint2(DrawConstant(4), DrawConstant(5));
+    if (any(id.xy >= dstSize))
+        return;
+
+    const uint2 lo = id.xy * srcSize / dstSize;
+    const uint2 hi = min(((id.xy + 1) * srcSize + dstSize - 1) / dstSize, srcSize);
+
+    float z = 0.0;
+    if (DrawConstant(6))
+    {
+        Texture2D<float4> src = GetTexture2D(DrawConstant(0));
+        for (uint y = lo.y; y < hi.y; ++y)
+            for (uint x = lo.x; x < hi.x; ++x)
+                z = max(z, src.Load(int3(x, y, 0)).r);
+    }
+    else
+    {
+        RWTexture2D<float> src = GetRWTexture2DFloat(DrawConstant(0));
+        for (uint y = lo.y; y < hi.y; ++y)
+            for (uint x = lo.x; x < hi.x; ++x)
+                z = max(z, src[uint2(x, y)]);
+    }
+    GetRWTexture2DFloat(DrawConstant(1))[id.xy] = z;
+}
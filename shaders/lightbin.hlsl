@@ -0,0 +1,58 @@
+// Light binning – one thread per cluster (see lighting.hlsli), 64 clusters
+// a group. The group pulls the lights through groupshared memory 64 at a
+// time, in view space, and each thread keeps the ones whose sphere touches
+// its cluster's box.
+//
+// Draw constants: 0 cluster buffer (UAV)
+#include "lighting.hlsli"
+
+static const uint kBinGroupSize = 64;
+
+groupshared float4 s_lights[kBinGroupSize];     // view-space center, radius
+
+[numthreads(kBinGroupSize, 1, 1)]
+void BinCS(uint3 id : SV_DispatchThreadID, uint index : SV_GroupIndex)
+{
+    RWByteAddressBuffer clusters = GetRWBuffer(DrawConstant(0));
+    const uint cluster = id.x;
+    const bool valid   = cluster < kClusterCount;
+
+    // View-space box around the cluster: its tile's corners at both slice depths.
+    // Tile rows run down the screen, NDC y runs up.
+    const uint3  cell   = uint3(cluster % kClustersX, (cluster / kClustersX) % kClustersY,
+                                min(cluster / (kClustersX * kClustersY), kClustersZ - 1));
+    const float2 ndcLo  = float2(cell.x / (float)kClustersX * 2.0 - 1.0, 1.0 - (cell.y + 1) / (float)kClustersY * 2.0);
+    const float2 ndcHi  = float2((cell.x + 1) / (float)kClustersX * 2.0 - 1.0, 1.0 - cell.y / (float)kClustersY * 2.0);
+    const float2 toView = 1.0 / g_projParams.xy;
+    const float  zNear  = SliceDepth(cell.z), zFar = SliceDepth(cell.z + 1);
+    const float2 a = ndcLo * toView * zNear, b = ndcHi * toView * zNear;
+    const float2 c = ndcLo * toView * zFar,  d = ndcHi * toView * zFar;
+    const float3 boxLo = float3(min(min(a, b), min(c, d)), zNear);
+    const float3 boxHi = float3(max(max(a, b), max(c, d)), zFar);
+
+    uint count = 0;
+    for (uint base = 0; base < g_lightCount; base += kBinGroupSize)
+    {
+        if (base + index < g_lightCount)
+        {
+            Light light = LoadLight(base + index);
+            s_lights[index] = float4(mul(g_view, float4(light.position, 1.0)).xyz, light.radius);
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        const uint batch = min(kBinGroupSize, g_lightCount - base);
+        for (uint i = 0; i < batch && valid; ++i)
+        {
+            const float4 sphere  = s_lights[i];
+            const float3 outside = max(max(boxLo - sphere.xyz, 0.0), sphere.xyz - boxHi);
+            if (dot(outside, outside) <= sphere.w * sphere.w && count < kMaxClusterLights)
+            {
+                clusters.Store((kClusterCount + cluster * kMaxClusterLights + count) * 4, base + i);
+                ++count;
+            }
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+    if (valid)
+        clusters.Store(cluster * 4, count);
+}
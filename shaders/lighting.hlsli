@@ -0,0 +1,78 @@
+// Clustered lighting – the view frustum is cut into kClustersX x kClustersY
+// screen tiles times kClustersZ exponential depth slices. lightbin.hlsl
+// lists the lights touching each cluster every frame; a pixel only loops
+// over its own cluster's list, so its cost follows the lights around it,
+// not how many there are in total.
+//
+// Cluster buffer: kClusterCount light counts, then kMaxClusterLights light
+// indices per cluster. A cluster with more lights than that drops the rest.
+#ifndef LIGHTING_HLSLI
+#define LIGHTING_HLSLI
+
+#include "common.hlsli"
+
+// Mirror kClusters* / kMaxClusterLights in main.cpp
+static const uint kClustersX        = 16;
+static const uint kClustersY        = 9;
+static const uint kClustersZ        = 24;
+static const uint kClusterCount     = kClustersX * kClustersY * kClustersZ;
+static const uint kMaxClusterLights = 128;
+
+// Light (32 bytes, mirrors LightData in main.cpp) – colour has the intensity folded in
+struct Light
+{
+    float3 position;
+    float  radius;
+    float3 color;
+};
+
+Light LoadLight(uint index)
+{
+    ByteAddressBuffer lights = GetBuffer(g_lightBuffer);
+    float4 a = asfloat(lights.Load4(index * 32));
+    Light light;
+    light.position = a.xyz;
+    light.radius   = a.w;
+    light.color    = asfloat(lights.Load3(index * 32 + 16));
+    return light;
+}
+
+// View depth where slice k starts – slices are thin near the camera, thick far away
+float SliceDepth(uint slice)
+{
+    return g_projParams.z * pow(g_projParams.w / g_projParams.z, (float)slice / (float)kClustersZ);
+}
+
+// SV_Position.w is view depth for a perspective projection
+uint ClusterIndex(float4 svPosition)
+{
+    uint2 tile  = min(uint2(svPosition.xy / g_renderSize * float2(kClustersX, kClustersY)),
+                      uint2(kClustersX - 1, kClustersY - 1));
+    float depth = max(svPosition.w, g_projParams.z);
+    uint  slice = min((uint)(log(depth / g_projParams.z) / log(g_projParams.w / g_projParams.z) * kClustersZ),
+                      kClustersZ - 1);
+    return tile.x + kClustersX * (tile.y + kClustersY * slice);
+}
+
+// Diffuse from every light in the pixel's cluster; smooth quadratic falloff to zero at the radius
+float3 ClusteredLighting(float4 svPosition, float3 world, float3 n)
+{
+    if (g_lightCount == 0)
+        return 0.0;
+    ByteAddressBuffer clusters = GetBuffer(g_clusterBuffer);
+    uint   cluster = ClusterIndex(svPosition);
+    uint   count   = min(clusters.Load(cluster * 4), kMaxClusterLights);
+    uint   list    = (kClusterCount + cluster * kMaxClusterLights) * 4;
+    float3 sum     = 0.0;
+    for (uint i = 0; i < count; ++i)
+    {
+        Light  light    = LoadLight(clusters.Load(list + i * 4));
+        float3 toLight  = light.position - world;
+        float  distance2 = dot(toLight, toLight);
+        float  falloff  = saturate(1.0 - distance2 / (light.radius * light.radius));
+        sum += light.color * (falloff * falloff) * saturate(dot(n, toLight * rsqrt(max(distance2, 1e-8))));
+    }
+    return sum;
+}
+
+#endif // LIGHTING_HLSLI
@@ -0,0 +1,112 @@
+// Meshlet path – amplification shader culls, mesh shader expands (SM 6.5)
+//
+// One AS group per 32 meshlets of one instance: DispatchMesh(ceil(meshlets / 32),
+// instances, 1), from the CPU per batch or from ArgsCS through ExecuteIndirect.
+// Each thread tests one meshlet – world-space bounding sphere against the
+// frustum, normal cone against the camera – and the survivors go to the MS,
+// one group per meshlet.
+//
+// Draw constants: see scene.hlsli, plus 8 = 1 to cull meshlets (0 with --no-cull).
+// Meshlet layout (48 bytes, mirrors Meshlet in assetpak.h):
+//   vertexOffset, vertexCount, triangleOffset, triangleCount, center, radius, coneAxis, coneCutoff
+#include "scene.hlsli"
+
+static const uint kMeshletsPerGroup   = 32;
+static const uint kMeshletStride      = 48;
+static const uint kMaxMeshletVertices = 64;
+static const uint kMaxMeshletTris     = 124;
+
+struct Payload
+{
+    uint instance;                          // batch-relative, like SV_InstanceID
+    uint meshlets[kMeshletsPerGroup];
+};
+
+groupshared Payload s_payload;
+groupshared uint    s_count;
+
+bool MeshletVisible(InstanceData inst, MeshInfo mesh, uint meshlet)
+{
+    ByteAddressBuffer meshlets = GetBuffer(DrawConstant(7));
+    const uint   base   = mesh.meshletOffset + meshlet * kMeshletStride;
+    const float4 bounds = asfloat(meshlets.Load4(base + 16));
+    const float4 cone   = asfloat(meshlets.Load4(base + 32));
+
+    const float3 scales = float3(length(inst.world._m00_m10_m20), length(inst.world._m01_m11_m21),
+                                 length(inst.world._m02_m12_m22));
+    const float  scale  = max(scales.x, max(scales.y, scales.z));
+    const float3 center = mul(inst.world, float4(bounds.xyz, 1.0));
+    const float  radius = bounds.w * scale;
+    if (!FrustumVisible(center, radius))
+        return false;
+
+    // Cones only survive uniform scales – a squashed box's normals don't follow its axes
+    const bool uniform = scale - min(scales.x, min(scales.y, scales.z)) <= 1e-3 * scale;
+    if (cone.w < 1.0 && uniform)
+    {
+        const float3 axis = mul((float3x3)inst.world, cone.xyz) / scale;
+        const float3 view = center - g_cameraPos;
+        if (dot(view, axis) >= cone.w * length(view) + radius)
+            return false;
+    }
+    return true;
+}
+
+[numthreads(kMeshletsPerGroup, 1, 1)]
+void ASMain(uint3 thread : SV_GroupThreadID, uint3 group : SV_GroupID)
+{
+    if (thread.x == 0)
+    {
+        s_count            = 0;
+        s_payload.instance = group.y;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const MeshInfo mesh    = LoadMesh(DrawConstant(3));
+    const uint     meshlet = group.x * kMeshletsPerGroup + thread.x;
+    if (meshlet < mesh.meshletCount &&
+        (DrawConstant(8) == 0 || MeshletVisible(LoadSceneInstance(group.y), mesh, meshlet)))
+    {
+        uint slot;
+        InterlockedAdd(s_count, 1, slot);
+        s_payload.meshlets[slot] = meshlet;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(s_count, 1, 1, s_payload);
+}
+
+float Snorm16(uint bits)
+{
+    return max((float)((int)(bits << 16) >> 16) / 32767.0, -1.0);
+}
+
+[numthreads(128, 1, 1)]
+[outputtopology("triangle")]
+void MSMain(uint thread : SV_GroupThreadID, uint group : SV_GroupID, in payload Payload input,
+            out vertices SceneVertex verts[kMaxMeshletVertices], out indices uint3 tris[kMaxMeshletTris])
+{
+    const MeshInfo    mesh     = LoadMesh(DrawConstant(3));
+    ByteAddressBuffer meshlets = GetBuffer(DrawConstant(7));
+    const uint4       meshlet  = meshlets.Load4(mesh.meshletOffset + input.meshlets[group] * kMeshletStride);
+    const uint        vertexIndices = mesh.meshletOffset + mesh.meshletCount * kMeshletStride;
+    const uint        triangles     = vertexIndices + mesh.meshletVertexCount * 4;
+
+    SetMeshOutputCounts(meshlet.y, meshlet.w);
+
+    if (thread < meshlet.y)
+    {
+        // PackedVertex by hand: snorm16 xyz(w), octahedral snorm16 normal, unorm8 colour
+        const uint  vertex = meshlets.Load(vertexIndices + (meshlet.x + thread) * 4);
+        const uint4 raw    = GetBuffer(DrawConstant(6)).Load4((mesh.firstVertex + vertex) * 16);
+        const float3 pos    = float3(Snorm16(raw.x), Snorm16(raw.x >> 16), Snorm16(raw.y));
+        const float2 normal = float2(Snorm16(raw.z), Snorm16(raw.z >> 16));
+        const float4 col    = float4(raw.w & 0xff, (raw.w >> 8) & 0xff, (raw.w >> 16) & 0xff, raw.w >> 24) / 255.0;
+        verts[thread] = TransformVertex(input.instance, mesh, pos, normal, col);
+    }
+    if (thread < meshlet.w)
+    {
+        const uint packed = meshlets.Load(triangles + (meshlet.z + thread) * 4);
+        tris[thread] = uint3(packed & 0xff, (packed >> 8) & 0xff, (packed >> 16) & 0xff);
+    }
+}
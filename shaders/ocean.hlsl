@@ -0,0 +1,121 @@
+// Ocean surface – clipmap tiles over the FFT maps (oceanfft.hlsl), lit like
+// the scene: sun, sky reflection, the clustered lights, foam where it folds.
+//
+// Draw constants:
+//   TilesCS  0 tiles (UAV)   1 draw arguments (UAV)
+//   VS/PS    0 tiles (SRV)   1 displacement (SRV)      2 slopes (SRV)
+#include "ocean.hlsli"
+#include "lighting.hlsli"
+
+// One group walks every candidate tile: each level's kOceanLevelTiles²
+// around the camera, snapped to two of its tiles so the finer level's block
+// always lands on whole tiles of it, minus that block, minus what's off screen
+groupshared uint s_tileCount;
+
+[numthreads(64, 1, 1)]
+void TilesCS(uint index : SV_GroupIndex)
+{
+    RWByteAddressBuffer tiles = GetRWBuffer(DrawConstant(0));
+    if (index == 0)
+        s_tileCount = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint perLevel = kOceanLevelTiles * kOceanLevelTiles;
+    for (uint t = index; t < kOceanLevels * perLevel; t += 64)
+    {
+        const uint  level    = t / perLevel;
+        const uint2 local    = uint2(t % kOceanLevelTiles, (t % perLevel) / kOceanLevelTiles);
+        const float tileSize = kOceanCell * kOceanTileCells * exp2((float)level);
+        const int2  tile     = (int2)floor(g_cameraPos.xz / (2.0 * tileSize)) * 2 - (int)kOceanLevelTiles / 2 + int2(local);
+        if (level > 0)
+        {
+            const int2 finer = (int2)floor(g_cameraPos.xz / tileSize);     // its block, in our tiles: finer +-2
+            if (all(tile >= finer - 2) && all(tile < finer + 2))
+                continue;
+        }
+
+        const float2 origin = float2(tile) * tileSize;
+        const float2 centre = origin + 0.5 * tileSize;
+        if (!FrustumVisible(float3(centre.x, kSeaLevel, centre.y), tileSize * 0.7072 + kOceanMaxWave))
+            continue;
+
+        // Only a level's outer ring borders the next one out
+        uint stitch = 0;
+        if (level + 1 < kOceanLevels)
+            stitch = (local.x == 0 ? 1u : 0u) | (local.x == kOceanLevelTiles - 1 ? 2u : 0u) |
+                     (local.y == 0 ? 4u : 0u) | (local.y == kOceanLevelTiles - 1 ? 8u : 0u);
+        uint slot;
+        InterlockedAdd(s_tileCount, 1, slot);
+        tiles.Store4(slot * 16, uint4(asuint(origin), asuint(tileSize / kOceanTileCells), stitch));
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // D3D12_DRAW_ARGUMENTS: one instance per tile
+    if (index == 0)
+        GetRWBuffer(DrawConstant(1)).Store4(0, uint4(kOceanTileCells * kOceanTileCells * 6, s_tileCount, 0, 0));
+}
+
+struct OceanVertex
+{
+    float4 pos : SV_POSITION;
+    float3 world : WORLDPOS;
+    float2 grid : GRID;         // undisplaced xz – where the slopes are looked up
+    float  fade : FADE;
+    float4 clip : CLIPPOS;
+    float4 prevClip : PREVCLIPPOS;  // same point through last frame's camera – the waves' own motion is left out
+};
+
+static const uint2 kCellCorners[6] = { uint2(0, 0), uint2(0, 1), uint2(1, 0), uint2(1, 0), uint2(0, 1), uint2(1, 1) };
+
+// No vertex buffer: a tile is kOceanTileCells² cells, six vertices each
+OceanVertex VSMain(uint vertex : SV_VertexID, uint instance : SV_InstanceID)
+{
+    const OceanTile tile = LoadOceanTile(GetBuffer(DrawConstant(0)), instance);
+    const uint      cell = vertex / 6;
+    uint2 grid = uint2(cell % kOceanTileCells, cell / kOceanTileCells) + kCellCorners[vertex % 6];
+
+    // Next to the coarser level, odd vertices along the edge fall onto their even neighbour:
+    // the edge then matches the coarse one exactly, the odd triangles go degenerate
+    if (((tile.stitch & 1) && grid.x == 0) || ((tile.stitch & 2) && grid.x == kOceanTileCells))
+        grid.y &= ~1u;
+    if (((tile.stitch & 4) && grid.y == 0) || ((tile.stitch & 8) && grid.y == kOceanTileCells))
+        grid.x &= ~1u;
+
+    const float2 xz   = tile.origin + float2(grid) * tile.cellSize;
+    const float  fade = OceanFade(xz);
+    const float3 d    = OceanDisplacement(GetTexture2D(DrawConstant(1)), xz) * fade;
+
+    OceanVertex output;
+    output.world    = float3(xz.x + d.x, kSeaLevel + d.y, xz.y + d.z);
+    output.pos      = mul(g_viewProj, float4(output.world, 1.0));
+    output.clip     = mul(g_unjitteredViewProj, float4(output.world, 1.0));
+    output.prevClip = mul(g_prevUnjitteredViewProj, float4(output.world, 1.0));
+    output.grid     = xz;
+    output.fade     = fade;
+    return output;
+}
+
+[earlydepthstencil]
+SceneTargets PSMain(OceanVertex input)
+{
+    const float4 slopes = GetTexture2D(DrawConstant(2)).Sample(g_linearWrap, input.grid / kOceanPatch);
+    const float3 n      = normalize(float3(slopes.x * input.fade, 1.0, slopes.y * input.fade));
+    const float3 toEye  = normalize(g_cameraPos - input.world);
+    const float3 sunDir = normalize(float3(0.3, 1.0, -0.2));
+
+    // Deep blue-green, lighter up the crests; the sky (the clear colour) on top by Fresnel
+    const float3 albedo  = lerp(float3(0.02, 0.08, 0.12), float3(0.06, 0.22, 0.25),
+                                saturate((input.world.y - kSeaLevel) * 0.5 + 0.5));
+    const float3 light   = g_ambient + g_sunIntensity * saturate(dot(n, sunDir)) + ClusteredLighting(input.pos, input.world, n);
+    const float  fresnel = 0.02 + 0.98 * pow(1.0 - saturate(dot(n, toEye)), 5.0);
+    float3 color = lerp(albedo * light, float3(0.2, 0.4, 0.6) * (g_ambient + g_sunIntensity), fresnel);
+
+    const float foam = saturate((0.85 - slopes.z) * 2.5) * input.fade;
+    color = lerp(color, 0.8 * light, foam);
+    color += g_sunIntensity * 3.0 * pow(saturate(dot(n, normalize(sunDir + toEye))), 256.0);
+
+    SceneTargets output;
+    output.color  = float4(color, 1.0);
+    output.motion = MotionVector(input.clip, input.prevClip);
+    return output;
+}
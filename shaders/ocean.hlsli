@@ -0,0 +1,54 @@
+// Ocean constants and lookups shared by the FFT (oceanfft.hlsl) and the
+// clipmap geometry (ocean.hlsl). See ocean.h.
+#ifndef OCEAN_HLSLI
+#define OCEAN_HLSLI
+
+#include "common.hlsli"
+
+// Mirror Ocean::k* in ocean.h and kGroundHeight in main.cpp
+static const uint  kOceanSize       = 256;
+static const uint  kOceanLog2Size   = 8;
+static const float kOceanPatch      = 64.0;
+static const uint  kOceanLevels     = 5;
+static const uint  kOceanLevelTiles = 8;
+static const uint  kOceanTileCells  = 16;
+static const float kOceanCell       = 0.25;
+static const float kSeaLevel        = -0.5;
+static const float kOceanChoppiness = 1.2;
+static const float kOceanPeriod     = 200.0;    // seconds before the sea repeats
+static const float kOceanMaxWave    = 3.0;      // metres of swell and sideways push, for culling
+
+// Past this the waves flatten out – the far rings are too coarse to show them without shimmering
+static const float kOceanFadeStart  = 60.0;
+static const float kOceanFadeEnd    = 220.0;
+
+// Tile list entry (16 bytes, mirrors OceanTile in ocean.h)
+struct OceanTile
+{
+    float2 origin;
+    float  cellSize;
+    uint   stitch;          // 1 -x, 2 +x, 4 -z, 8 +z: snap odd vertices, a coarser level is next door
+};
+
+OceanTile LoadOceanTile(ByteAddressBuffer tiles, uint index)
+{
+    uint4 raw = tiles.Load4(index * 16);
+    OceanTile tile;
+    tile.origin   = asfloat(raw.xy);
+    tile.cellSize = asfloat(raw.z);
+    tile.stitch   = raw.w;
+    return tile;
+}
+
+float OceanFade(float2 xz)
+{
+    return 1.0 - saturate((length(xz - g_cameraPos.xz) - kOceanFadeStart) / (kOceanFadeEnd - kOceanFadeStart));
+}
+
+// (Dx, height, Dz) at an undisplaced position – mip 0 always, so neighbouring tiles agree exactly
+float3 OceanDisplacement(Texture2D<float4> displacement, float2 xz)
+{
+    return displacement.SampleLevel(g_linearWrap, xz / kOceanPatch, 0).xyz;
+}
+
+#endif // OCEAN_HLSLI
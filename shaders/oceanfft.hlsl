@@ -0,0 +1,135 @@
+// Ocean waves – Tessendorf's FFT ocean, see ocean.h for the passes.
+//
+// Spectrum buffers are kOceanSize² float4s: (h + i*Dx, Dz) as two complex
+// numbers. Both fields come out of one inverse FFT real – h in the real
+// part, Dx in the imaginary – because both are spectra of real signals.
+//
+// The first four run back to back in one pass with UAV barriers between, so
+// the spectrum buffers are read through their UAVs too.
+//
+// Draw constants:
+//   SpectrumCS  0 h0 (SRV)        1 spectrum (UAV)
+//   FftCS       0 source (UAV)    1 destination (UAV)  2 0 rows, 1 columns
+//   FinalizeCS  0 spectrum (UAV)  1 displacement (UAV) 2 slopes (UAV)
+//   QueryCS     0 points (SRV)    1 count              2 results (UAV)   3 displacement (SRV)
+#include "ocean.hlsli"
+
+static const float kPi      = 3.14159265;
+static const float kGravity = 9.81;
+
+float2 ComplexMul(float2 a, float2 b)
+{
+    return float2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+// h(k,t) = h0(k) e^iwt + conj(h0(-k)) e^-iwt, and the choppy D(k) = -i k/|k| h(k)
+[numthreads(8, 8, 1)]
+void SpectrumCS(uint3 id : SV_DispatchThreadID)
+{
+    const uint   index   = id.y * kOceanSize + id.x;
+    const float4 h0      = asfloat(GetBuffer(DrawConstant(0)).Load4(index * 16));
+    const float2 k       = 2.0 * kPi * (float2(id.xy) - kOceanSize / 2) / kOceanPatch;
+    const float  kLength = length(k);
+
+    // Deep water dispersion, rounded to whole multiples of the loop frequency
+    const float repeat = 2.0 * kPi / kOceanPeriod;
+    const float omega  = floor(sqrt(kGravity * kLength) / repeat) * repeat;
+    float s, c;
+    sincos(omega * fmod(g_time, kOceanPeriod), s, c);
+    const float2 h = ComplexMul(h0.xy, float2(c, s)) + ComplexMul(h0.zw, float2(c, -s));
+
+    const float2 unit   = kLength > 1e-6 ? k / kLength : 0.0;
+    const float2 minusI = float2(h.y, -h.x);        // -i * h
+    const float2 dx     = minusI * unit.x;
+    const float2 dz     = minusI * unit.y;
+    GetRWBuffer(DrawConstant(1)).Store4(index * 16, asuint(float4(h + float2(-dx.y, dx.x), dz)));
+}
+
+// Stockham radix 2 – every stage reads one groupshared line and writes the
+// other, and the result comes out in natural order with no bit reversal
+groupshared float4 s_line[2][kOceanSize];
+
+uint LineAddress(uint lineIndex, uint element, bool columns)
+{
+    return (columns ? element * kOceanSize + lineIndex : lineIndex * kOceanSize + element) * 16;
+}
+
+[numthreads(kOceanSize / 2, 1, 1)]
+void FftCS(uint3 group : SV_GroupID, uint j : SV_GroupIndex)
+{
+    const bool columns  = DrawConstant(2) != 0;
+    const uint halfSize = kOceanSize / 2;
+    RWByteAddressBuffer source = GetRWBuffer(DrawConstant(0));
+    s_line[0][j]            = asfloat(source.Load4(LineAddress(group.x, j, columns)));
+    s_line[0][j + halfSize] = asfloat(source.Load4(LineAddress(group.x, j + halfSize, columns)));
+    GroupMemoryBarrierWithGroupSync();
+
+    uint from = 0;
+    [unroll]
+    for (uint stage = 0; stage < kOceanLog2Size; ++stage)
+    {
+        const uint   span = 1u << stage;
+        const uint   k    = j & (span - 1);
+        const float4 a    = s_line[from][j];
+        const float4 b    = s_line[from][j + halfSize];
+        float s, c;
+        sincos(kPi * k / span, s, c);               // +i: inverse transform
+        const float4 wb  = float4(ComplexMul(b.xy, float2(c, s)), ComplexMul(b.zw, float2(c, s)));
+        const uint   dst = (j << 1) - k;
+        s_line[1 - from][dst]        = a + wb;
+        s_line[1 - from][dst + span] = a - wb;
+        from = 1 - from;
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    RWByteAddressBuffer destination = GetRWBuffer(DrawConstant(1));
+    destination.Store4(LineAddress(group.x, j, columns), asuint(s_line[from][j]));
+    destination.Store4(LineAddress(group.x, j + halfSize, columns), asuint(s_line[from][j + halfSize]));
+}
+
+// k was centred, so every other texel comes out negated – (-1)^(x+y) undoes it
+float3 LoadSpatial(RWByteAddressBuffer spectrum, int2 texel)
+{
+    texel &= kOceanSize - 1;
+    const float4 v = asfloat(spectrum.Load4((texel.y * kOceanSize + texel.x) * 16));
+    const float  flip = ((texel.x + texel.y) & 1) ? -1.0 : 1.0;
+    return float3(v.y * kOceanChoppiness, v.x, v.z * kOceanChoppiness) * flip;     // Dx, h, Dz
+}
+
+// Displacement, and the displaced surface's normal as slopes (n.xz / n.y) plus
+// the Jacobian of the sideways push – under 1 where the crests fold, foam
+[numthreads(8, 8, 1)]
+void FinalizeCS(uint3 id : SV_DispatchThreadID)
+{
+    RWByteAddressBuffer spectrum = GetRWBuffer(DrawConstant(0));
+    const int2   texel = int2(id.xy);
+    const float3 d     = LoadSpatial(spectrum, texel);
+    const float3 dx    = (LoadSpatial(spectrum, texel + int2(1, 0)) - LoadSpatial(spectrum, texel - int2(1, 0))) *
+                         (kOceanSize / (2.0 * kOceanPatch));
+    const float3 dz    = (LoadSpatial(spectrum, texel + int2(0, 1)) - LoadSpatial(spectrum, texel - int2(0, 1))) *
+                         (kOceanSize / (2.0 * kOceanPatch));
+    const float3 tangentX = float3(1.0 + dx.x, dx.y, dx.z);
+    const float3 tangentZ = float3(dz.x, dz.y, 1.0 + dz.z);
+    const float3 normal   = cross(tangentZ, tangentX);
+    const float  jacobian = tangentX.x * tangentZ.z - tangentZ.x * tangentX.z;
+
+    GetRWTexture2D(DrawConstant(1))[id.xy] = float4(d, 0.0);
+    GetRWTexture2D(DrawConstant(2))[id.xy] = float4(normal.xz / normal.y, jacobian, 0.0);
+}
+
+// Height at a world xz: the surface was pushed sideways, so find the
+// undisplaced point that lands there first – a few fixed-point steps do
+[numthreads(64, 1, 1)]
+void QueryCS(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= DrawConstant(1))
+        return;
+    const float2      target       = asfloat(GetBuffer(DrawConstant(0)).Load2(id.x * 12));
+    Texture2D<float4> displacement = GetTexture2D(DrawConstant(3));
+    float2 source = target;
+    [unroll]
+    for (uint i = 0; i < 4; ++i)
+        source = target - OceanDisplacement(displacement, source).xz * OceanFade(source);
+    const float height = kSeaLevel + OceanDisplacement(displacement, source).y * OceanFade(source);
+    GetRWBuffer(DrawConstant(2)).Store(id.x * 4, asuint(height));
+}
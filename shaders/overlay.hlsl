@@ -0,0 +1,43 @@
+// Debug overlay quads – see overlay.h
+//
+// Draw constants: 0 = quad buffer (SRV), 1..2 = viewport size in pixels (float bits)
+#include "bindless.hlsli"
+
+struct PSInput
+{
+    float4 pos   : SV_POSITION;
+    float2 uv    : TEXCOORD0;
+    nointerpolation uint glyph : GLYPH;
+    float4 color : COLOR0;
+};
+
+PSInput VSMain(uint vertex : SV_VertexID, uint instance : SV_InstanceID)
+{
+    ByteAddressBuffer quads = GetBuffer(DrawConstant(0));
+    float4 rect  = asfloat(quads.Load4(instance * 32));
+    uint2  data  = quads.Load2(instance * 32 + 16);
+
+    // Two triangles: 0 1 2, 2 1 3 over the corners (0,0) (1,0) (0,1) (1,1)
+    static const uint corners[6] = { 0, 1, 2, 2, 1, 3 };
+    float2 uv    = float2(corners[vertex] & 1, corners[vertex] >> 1);
+    float2 pixel = rect.xy + uv * rect.zw;
+    float2 size  = float2(asfloat(DrawConstant(1)), asfloat(DrawConstant(2)));
+
+    PSInput output;
+    output.pos   = float4(pixel / size * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    output.uv    = uv;
+    output.glyph = data.x;
+    output.color = float4(data.y & 0xff, (data.y >> 8) & 0xff, (data.y >> 16) & 0xff, data.y >> 24) / 255.0;
+    return output;
+}
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    if (input.glyph != 0)
+    {
+        uint2 cell = min(uint2(input.uv * float2(3.0, 5.0)), uint2(2, 4));
+        if (((input.glyph >> (14 - (cell.y * 3 + cell.x))) & 1) == 0)
+            discard;
+    }
+    return input.color;
+}
@@ -0,0 +1,106 @@
+// Shared by the scene's two geometry paths – triangle.hlsl (input assembler)
+// and meshlet.hlsl (amplification + mesh shaders) – so either feeds the same PS.
+//
+// Scene draw constants:
+//   0 instances (SRV)     1 first instance        2 material
+//   3 mesh                4 visible list (SRV, ~0 = every instance)
+//   5 mesh table (SRV)    6 geometry (SRV)        7 meshlets (SRV)
+//   9 last frame's worlds (SRV, float3x4 per instance in 0's order, ~0 = none)
+// 1..3 come from the indirect arguments when drawn through ExecuteIndirect;
+// 6 and 7 are only read by the mesh shader path.
+#ifndef SCENE_HLSLI
+#define SCENE_HLSLI
+
+#include "common.hlsli"
+
+// Mesh table entry (32 bytes, mirrors MeshTableEntry in main.cpp)
+struct MeshInfo
+{
+    float3 positionOffset;      // mesh space = snorm16 position * positionScale + positionOffset
+    float  positionScale;
+    uint   meshletOffset;       // byte offset of the mesh's Meshlet[] in the meshlet buffer
+    uint   meshletCount;
+    uint   meshletVertexCount;  // uint32 vertex indices right after the Meshlet[], then the triangles
+    uint   firstVertex;         // in the geometry buffer
+};
+
+MeshInfo LoadMesh(uint mesh)
+{
+    ByteAddressBuffer table = GetBuffer(DrawConstant(5));
+    float4 dequant = asfloat(table.Load4(mesh * 32));
+    uint4  meshlet = table.Load4(mesh * 32 + 16);
+    MeshInfo info;
+    info.positionOffset     = dequant.xyz;
+    info.positionScale      = dequant.w;
+    info.meshletOffset      = meshlet.x;
+    info.meshletCount       = meshlet.y;
+    info.meshletVertexCount = meshlet.z;
+    info.firstVertex        = meshlet.w;
+    return info;
+}
+
+// Batch-relative instance -> index into the instance buffer, through the visible list when culling wrote one
+uint SceneInstanceIndex(uint instance)
+{
+    uint index = DrawConstant(1) + instance;
+    if (DrawConstant(4) != 0xffffffff)
+        index = GetBuffer(DrawConstant(4)).Load(index * 4);
+    return index;
+}
+
+InstanceData LoadSceneInstance(uint instance)
+{
+    return LoadInstance(GetBuffer(DrawConstant(0)), SceneInstanceIndex(instance));
+}
+
+// Where the instance was last frame – for motion vectors only
+float3x4 LoadPrevWorld(uint index, float3x4 world)
+{
+    if (DrawConstant(9) == 0xffffffff)
+        return world;
+    ByteAddressBuffer worlds = GetBuffer(DrawConstant(9));
+    return float3x4(asfloat(worlds.Load4(index * 48 +  0)),
+                    asfloat(worlds.Load4(index * 48 + 16)),
+                    asfloat(worlds.Load4(index * 48 + 32)));
+}
+
+float3 OctDecode(float2 e)
+{
+    float3 n = float3(e, 1.0 - abs(e.x) - abs(e.y));
+    float  t = saturate(-n.z);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+struct SceneVertex
+{
+    float4 pos : SV_POSITION;
+    float3 normal : NORMAL;
+    float3 world : WORLDPOS;
+    float3 surface : SURFACE;       // mesh space at world scale – textures are projected from it
+    float4 col : COLOR0;
+    float4 clip : CLIPPOS;          // unjittered, this frame and last – see MotionVector()
+    float4 prevClip : PREVCLIPPOS;
+};
+
+SceneVertex TransformVertex(uint instance, MeshInfo mesh, float3 pos, float2 octNormal, float4 col)
+{
+    const uint         index = SceneInstanceIndex(instance);
+    const InstanceData inst  = LoadInstance(GetBuffer(DrawConstant(0)), index);
+    float3 local = pos * mesh.positionScale + mesh.positionOffset;
+    float3 world = mul(inst.world, float4(local, 1.0));
+    float3 prev  = mul(LoadPrevWorld(index, inst.world), float4(local, 1.0));
+
+    SceneVertex output;
+    output.pos      = mul(g_viewProj, float4(world, 1.0));
+    output.clip     = mul(g_unjitteredViewProj, float4(world, 1.0));
+    output.prevClip = mul(g_prevUnjitteredViewProj, float4(prev, 1.0));
+    output.normal  = mul((float3x3)inst.world, OctDecode(octNormal));    // uniform-ish scales, renormalized in the PS
+    output.world   = world;
+    output.surface = local * length(inst.world._m00_m10_m20);
+    output.col     = col * inst.color;
+    return output;
+}
+
+#endif // SCENE_HLSLI
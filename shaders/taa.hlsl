@@ -0,0 +1,126 @@
+// Temporal AA + upsampling – the built-in TemporalUpscaler (temporalupscale.h)
+//
+// One thread per output pixel. This frame's colour is reconstructed at the
+// pixel's centre from the 3x3 render samples nearest to it, weighted by how
+// far the jitter put each one; last frame's output is reprojected along the
+// motion of the nearest depth in that neighbourhood (so edges carry the
+// foreground's motion), clipped to the neighbourhood's colour box in YCoCg
+// and blended in. Still pixels converge on a supersampled image within
+// ~16 frames, the box keeps whatever moved or got uncovered from ghosting.
+//
+// Draw constants: 0 colour, 1 depth, 2 motion, 3 history (SRVs), 4 output (UAV),
+//   5..6 output size (float bits), 7 = 1 to drop the history
+#include "common.hlsli"
+
+float3 RgbToYCoCg(float3 c)
+{
+    return float3(dot(c, float3(0.25, 0.5, 0.25)), dot(c, float3(0.5, 0.0, -0.5)), dot(c, float3(-0.25, 0.5, -0.25)));
+}
+
+float3 YCoCgToRgb(float3 c)
+{
+    return float3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Catmull-Rom in five bilinear taps (the corners dropped) – one bilinear tap would blur a little more every frame
+float3 SampleHistory(Texture2D<float4> history, float2 uv, float2 size)
+{
+    const float2 pos  = uv * size;
+    const float2 tc1  = floor(pos - 0.5) + 0.5;
+    const float2 f    = pos - tc1;
+    const float2 w0   = f * (-0.5 + f * (1.0 - 0.5 * f));
+    const float2 w1   = 1.0 + f * f * (-2.5 + 1.5 * f);
+    const float2 w2   = f * (0.5 + f * (2.0 - 1.5 * f));
+    const float2 w3   = f * f * (-0.5 + 0.5 * f);
+    const float2 w12  = w1 + w2;
+    const float2 tc0  = (tc1 - 1.0) / size;
+    const float2 tc3  = (tc1 + 2.0) / size;
+    const float2 tc12 = (tc1 + w2 / w12) / size;
+
+    float3 c = history.SampleLevel(g_linearClamp, float2(tc12.x, tc0.y), 0).rgb * (w12.x * w0.y)
+             + history.SampleLevel(g_linearClamp, float2(tc0.x, tc12.y), 0).rgb * (w0.x * w12.y)
+             + history.SampleLevel(g_linearClamp, tc12, 0).rgb * (w12.x * w12.y)
+             + history.SampleLevel(g_linearClamp, float2(tc3.x, tc12.y), 0).rgb * (w3.x * w12.y)
+             + history.SampleLevel(g_linearClamp, float2(tc12.x, tc3.y), 0).rgb * (w12.x * w3.y);
+    const float total = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return max(c / total, 0.0);     // the negative lobes can undershoot
+}
+
+// Towards the box's centre until it's inside – keeps the history's hue, where a per-channel clamp wouldn't
+float3 ClipToBox(float3 history, float3 boxMin, float3 boxMax)
+{
+    const float3 center = 0.5 * (boxMax + boxMin);
+    const float3 extent = 0.5 * (boxMax - boxMin) + 1e-4;
+    const float3 offset = history - center;
+    const float3 units  = abs(offset / extent);
+    const float  most   = max(units.x, max(units.y, units.z));
+    return most > 1.0 ? center + offset / most : history;
+}
+
+[numthreads(8, 8, 1)]
+void ResolveCS(uint3 id : SV_DispatchThreadID)
+{
+    const float2 outputSize = float2(asfloat(DrawConstant(5)), asfloat(DrawConstant(6)));
+    if (any((float2)id.xy >= outputSize))
+        return;
+    Texture2D<float4> color  = GetTexture2D(DrawConstant(0));
+    Texture2D<float4> depth  = GetTexture2D(DrawConstant(1));
+    Texture2D<float4> motion = GetTexture2D(DrawConstant(2));
+
+    // The pixel's centre in render pixels; render sample i sits at i + 0.5 - jitter this frame
+    const float2 uv     = ((float2)id.xy + 0.5) / outputSize;
+    const float2 pos    = uv * g_renderSize;
+    const int2   center = int2(floor(pos + g_jitter));
+    const int2   last   = int2(g_renderSize) - 1;
+
+    float3 sum = 0.0, m1 = 0.0, m2 = 0.0;
+    float  weights = 0.0, nearest = 0.0, closest = 1.0;
+    int2   closestAt = clamp(center, 0, last);
+    [unroll]
+    for (int y = -1; y <= 1; ++y)
+    {
+        [unroll]
+        for (int x = -1; x <= 1; ++x)
+        {
+            const int2   texel   = clamp(center + int2(x, y), 0, last);
+            const float3 c       = RgbToYCoCg(color.Load(int3(texel, 0)).rgb);
+            const float2 d       = float2(texel) + 0.5 - g_jitter - pos;
+            const float  spatial = exp(-2.29 * dot(d, d));     // ~Blackman-Harris over a pixel and a half
+
+            // Luma-weighted, so one bright sample doesn't flicker as the jitter moves over it
+            const float  w = spatial / (1.0 + c.x);
+            sum     += c * w;
+            weights += w;
+            nearest  = max(nearest, spatial);
+            m1 += c;
+            m2 += c * c;
+
+            const float z = depth.Load(int3(texel, 0)).r;
+            if (z < closest)
+            {
+                closest   = z;
+                closestAt = texel;
+            }
+        }
+    }
+    const float3 current = sum / max(weights, 1e-5);
+
+    // Where this pixel was last frame – off screen or a reset starts over from this frame
+    const float2 velocity = motion.Load(int3(closestAt, 0)).rg;
+    const float2 prevUv   = uv - velocity;
+    float3 result = current;
+    if (DrawConstant(7) == 0 && all(prevUv >= 0.0) && all(prevUv <= 1.0))
+    {
+        // Variance box of the neighbourhood, a little looser than a min/max box is on edges
+        const float3 mean  = m1 / 9.0;
+        const float3 sigma = sqrt(abs(m2 / 9.0 - mean * mean));
+        const float3 history = ClipToBox(RgbToYCoCg(SampleHistory(GetTexture2D(DrawConstant(3)), prevUv, outputSize)),
+                                         mean - 1.25 * sigma, mean + 1.25 * sigma);
+
+        // More of this frame when a sample landed close to the pixel, and when it moves – less smear
+        const float speed = length(velocity * outputSize);
+        const float alpha = clamp(0.1 * nearest + 0.01 * speed, 0.03, 0.5);
+        result = lerp(history, current, alpha);
+    }
+    GetRWTexture2D(DrawConstant(4))[id.xy] = float4(YCoCgToRgb(result), 1.0);
+}
@@ -0,0 +1,54 @@
+// Streamed textures (texturestreamer.h) – sampling clamped to what's resident,
+// and the mip that was actually wanted written back as feedback.
+#ifndef TEXTURESTREAM_HLSLI
+#define TEXTURESTREAM_HLSLI
+
+#include "common.hlsli"
+
+// Texture table entry (16 bytes, mirrors TextureTableEntry in texturestreamer.h)
+struct TextureInfo
+{
+    uint  srv;          // ~0 until the mip tail is resident
+    float minLod;       // finest resident mip – never sample past it
+};
+
+TextureInfo LoadTextureInfo(uint texture)
+{
+    uint2 entry = GetBuffer(g_textureTable).Load2(texture * 16);
+    TextureInfo info;
+    info.srv    = entry.x;
+    info.minLod = asfloat(entry.y);
+    return info;
+}
+
+// Feedback is the finest mip the footprint wanted, min'd over the frame; one
+// atomic per wave when the whole wave samples the same texture, which is the usual case
+void WriteTextureFeedback(uint texture, Texture2D<float4> tex, float2 uv)
+{
+    if (g_textureFeedback == 0xffffffff)
+        return;
+    float lod    = tex.CalculateLevelOfDetailUnclamped(g_linearWrap, uv);
+    uint  wanted = (uint)max(floor(lod), 0.0);
+    RWByteAddressBuffer feedback = GetRWBuffer(g_textureFeedback);
+    if (WaveActiveAllEqual(texture))
+    {
+        uint finest = WaveActiveMin(wanted);
+        if (WaveIsFirstLane())
+            feedback.InterlockedMin(texture * 4, finest);
+    }
+    else
+        feedback.InterlockedMin(texture * 4, wanted);
+}
+
+// Wrapping, trilinear. Before anything is resident: `fallback`.
+float4 SampleStreamed(uint texture, float2 uv, float4 fallback)
+{
+    TextureInfo info = LoadTextureInfo(texture);
+    if (info.srv == 0xffffffff)
+        return fallback;
+    Texture2D<float4> tex = GetTexture2D(info.srv);
+    WriteTextureFeedback(texture, tex, uv);
+    return tex.Sample(g_linearWrap, uv, int2(0, 0), info.minLod);
+}
+
+#endif // TEXTURESTREAM_HLSLI
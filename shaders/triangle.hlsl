@@ -0,0 +1,100 @@
+// Textured, vertex-coloured geometry lit by a fixed sun and the clustered lights, instanced – the input assembler path
+//
+// Draw constants: see scene.hlsli.
+//
+// Vertices are PackedVertex (meshcook.h): positions snorm16 over the mesh's
+// bounds – the mesh table has the offset and scale per mesh – and octahedral
+// snorm16 normals. The input layout unpacks them, the VS only dequantizes.
+#include "scene.hlsli"
+#include "texturestream.hlsli"
+#include "lighting.hlsli"
+
+struct VSInput
+{
+    float4 pos : POSITION;
+    float2 normal : NORMAL;
+    float4 col : COLOR0;
+    uint   instance : SV_InstanceID;
+};
+
+SceneVertex VSMain(VSInput input)
+{
+    return TransformVertex(input.instance, LoadMesh(DrawConstant(3)), input.pos.xyz, input.normal, input.col);
+}
+
+// Material table entry (32 bytes, mirrors MaterialEntry in main.cpp); textures are streamed ones, ~0 = none
+struct MaterialInfo
+{
+    uint   albedo;
+    uint   normal;          // BC5, z rebuilt
+    float  uvScale;         // repeats per metre
+    float  specular;
+    float2 scroll;          // uv per second
+};
+
+MaterialInfo LoadMaterial(uint material)
+{
+    ByteAddressBuffer table = GetBuffer(g_materialTable);
+    uint4  a = table.Load4(material * 32);
+    float4 b = asfloat(table.Load4(material * 32 + 16));
+    MaterialInfo info;
+    info.albedo   = a.x;
+    info.normal   = a.y;
+    info.uvScale  = asfloat(a.z);
+    info.specular = asfloat(a.w);
+    info.scroll   = b.xy;
+    return info;
+}
+
+// No UVs in the vertices – project the surface along whichever axis the face is most square to
+float2 SurfaceUV(float3 surface)
+{
+    float3 face = abs(cross(ddx(surface), ddy(surface)));
+    return face.y >= max(face.x, face.z) ? surface.xz : face.x >= face.z ? surface.zy : surface.xy;
+}
+
+// Tangent frame from screen derivatives, no tangents needed (Schüler, "Normal Mapping Without Precomputed Tangents")
+float3 PerturbNormal(float3 n, float3 world, float2 uv, float2 tangentNormal)
+{
+    float3 dp1 = ddx(world), dp2 = ddy(world);
+    float2 duv1 = ddx(uv), duv2 = ddy(uv);
+    float3 dp2perp = cross(dp2, n), dp1perp = cross(n, dp1);
+    float3 t = dp2perp * duv1.x + dp1perp * duv2.x;
+    float3 b = dp2perp * duv1.y + dp1perp * duv2.y;
+    float  invMax = rsqrt(max(max(dot(t, t), dot(b, b)), 1e-20));
+    float3 tn = float3(tangentNormal, sqrt(saturate(1.0 - dot(tangentNormal, tangentNormal))));
+    return normalize(t * invMax * tn.x + b * invMax * tn.y + n * tn.z);
+}
+
+// Early depth so hidden pixels don't ask for mips nobody sees
+[earlydepthstencil]
+SceneTargets PSMain(SceneVertex input)
+{
+    // Culling is off for the flat meshes, so light whichever side is showing
+    float3 n   = normalize(input.normal);
+    n          = dot(n, g_cameraPos - input.world) < 0.0 ? -n : n;
+    float3 albedo   = input.col.rgb;
+    float  specular = 0.0;
+
+    // Material is per draw, so every branch here is uniform and derivatives stay valid
+    if (g_materialTable != 0xffffffff)
+    {
+        MaterialInfo material = LoadMaterial(DrawConstant(2));
+        float2 uv = SurfaceUV(input.surface) * material.uvScale + material.scroll * g_time;
+        if (material.albedo != 0xffffffff)
+            albedo *= SampleStreamed(material.albedo, uv, 1.0).rgb;
+        if (material.normal != 0xffffffff)
+            n = PerturbNormal(n, input.world, uv, SampleStreamed(material.normal, uv, float4(0.5, 0.5, 1.0, 1.0)).xy * 2.0 - 1.0);
+        specular = material.specular;
+    }
+
+    float3 sunDir = normalize(float3(0.3, 1.0, -0.2));
+    float  sun    = saturate(dot(n, sunDir));
+    float3 h      = normalize(sunDir + normalize(g_cameraPos - input.world));
+    float  spec   = g_sunIntensity * specular * pow(saturate(dot(n, h)), 64.0) * (sun > 0.0 ? 1.0 : 0.0);
+    float3 local  = ClusteredLighting(input.pos, input.world, n);
+    SceneTargets output;
+    output.color  = float4(albedo * (g_ambient + g_sunIntensity * sun + local) + spec, input.col.a);
+    output.motion = MotionVector(input.clip, input.prevClip);
+    return output;
+}
@@ -0,0 +1,30 @@
+// Scene colour -> back buffer. The scene only covers the top-left corner of
+// its target when rendering at a reduced scale (see dynres.h), so uvs are
+// scaled into that corner and clamped half a texel inside it, which keeps
+// the bilinear filter from picking up stale texels past the edge.
+//
+// Draw constants: 0 = scene colour (SRV), 1..2 = uv scale, 3..4 = uv clamp (float bits)
+#include "bindless.hlsli"
+
+struct PSInput
+{
+    float4 pos : SV_POSITION;
+    float2 uv  : TEXCOORD0;
+};
+
+// One triangle covering the screen
+PSInput VSMain(uint vertex : SV_VertexID)
+{
+    PSInput output;
+    output.uv  = float2((vertex << 1) & 2, vertex & 2);
+    output.pos = float4(output.uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    return output;
+}
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    float2 scale = float2(asfloat(DrawConstant(1)), asfloat(DrawConstant(2)));
+    float2 limit = float2(asfloat(DrawConstant(3)), asfloat(DrawConstant(4)));
+    float2 uv    = min(input.uv * scale, limit);
+    return GetTexture2D(DrawConstant(0)).SampleLevel(g_linearClamp, uv, 0);
+}
@@ -0,0 +1,613 @@
+// ---------------------------------------------------------------
+// SIMD math – value types + batched SoA kernels with runtime dispatch
+// ---------------------------------------------------------------
+// Single values (Float3, Quat, Float3x4, Transform) are plain structs with
+// inline scalar ops – gameplay code touches a handful at a time and
+// DirectXMath is right there when it needs more. Where the CPU time goes is
+// the same operation over thousands of entities, so those are kernels:
+//
+//   TransformsToMatrices(count, transforms, matrices);     // TRS -> 3x4, e.g. ECS chunks
+//   n = CullAabbs(count, aabbs, planes, visibleOut);       // frustum test, compacted indices
+//   IntegrateBodies(count, bodies, step);                  // semi-implicit Euler
+//
+// Each kernel has a scalar, an SSE2 (4 wide) and an AVX2+FMA (8 wide)
+// version; CPUID picks one at first use and SetSimdLevel() can force a
+// lower one (--simd=). Kernels work on SoA – epilogues fall back to scalar
+// for the last count % width elements. Arrays of 16 byte records (Transform
+// halves, matrix rows) are transposed to SoA on load and back on store.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+
+// MSVC emits AVX for AVX intrinsics anywhere; GCC/Clang need the function tagged
+#if defined(_MSC_VER)
+#define SIMD_TARGET_AVX2
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+// ---------------------------------
+// Value types
+// ---------------------------------
+struct Float3
+{
+    float x, y, z;
+};
+
+inline Float3 operator+(const Float3& a, const Float3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline Float3 operator-(const Float3& a, const Float3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline Float3 operator*(const Float3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+inline Float3 operator*(float s, const Float3& a) { return a * s; }
+inline Float3 operator-(const Float3& a) { return { -a.x, -a.y, -a.z }; }
+inline Float3& operator+=(Float3& a, const Float3& b) { return a = a + b; }
+inline Float3& operator-=(Float3& a, const Float3& b) { return a = a - b; }
+
+inline float  Dot(const Float3& a, const Float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Float3 Cross(const Float3& a, const Float3& b)
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+inline float  Length(const Float3& a) { return sqrtf(Dot(a, a)); }
+inline Float3 Normalize(const Float3& a)
+{
+    const float length = Length(a);
+    return length > 0.0f ? a * (1.0f / length) : Float3{ 0.0f, 0.0f, 0.0f };
+}
+inline Float3 Min(const Float3& a, const Float3& b) { return { fminf(a.x, b.x), fminf(a.y, b.y), fminf(a.z, b.z) }; }
+inline Float3 Max(const Float3& a, const Float3& b) { return { fmaxf(a.x, b.x), fmaxf(a.y, b.y), fmaxf(a.z, b.z) }; }
+
+// Unit quaternion, x y z vector part
+struct Quat
+{
+    float x, y, z, w;
+};
+
+inline Quat QuatIdentity() { return { 0.0f, 0.0f, 0.0f, 1.0f }; }
+
+// axis must be normalized
+inline Quat QuatFromAxisAngle(const Float3& axis, float angle)
+{
+    const float s = sinf(angle * 0.5f);
+    return { axis.x * s, axis.y * s, axis.z * s, cosf(angle * 0.5f) };
+}
+
+// a * b – rotates by b first, then a
+inline Quat operator*(const Quat& a, const Quat& b)
+{
+    return { a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+             a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+             a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+             a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+}
+
+inline Quat Normalize(const Quat& q)
+{
+    const float length = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    const float inv    = length > 0.0f ? 1.0f / length : 0.0f;
+    return length > 0.0f ? Quat{ q.x * inv, q.y * inv, q.z * inv, q.w * inv } : QuatIdentity();
+}
+
+inline Quat Conjugate(const Quat& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+inline Float3 Rotate(const Quat& q, const Float3& v)
+{
+    // v + 2w(u x v) + 2u x (u x v), u = vector part
+    const Float3 u{ q.x, q.y, q.z };
+    const Float3 t = 2.0f * Cross(u, v);
+    return v + q.w * t + Cross(u, t);
+}
+
+// Rows of an affine transform, column-vector convention: p' = M * (p, 1)
+struct Float3x4
+{
+    float m[3][4];
+};
+
+inline Float3x4 Float3x4Identity()
+{
+    return { { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f } } };
+}
+
+inline Float3 TransformPoint(const Float3x4& a, const Float3& p)
+{
+    return { a.m[0][0] * p.x + a.m[0][1] * p.y + a.m[0][2] * p.z + a.m[0][3],
+             a.m[1][0] * p.x + a.m[1][1] * p.y + a.m[1][2] * p.z + a.m[1][3],
+             a.m[2][0] * p.x + a.m[2][1] * p.y + a.m[2][2] * p.z + a.m[2][3] };
+}
+
+inline Float3 TransformVector(const Float3x4& a, const Float3& v)
+{
+    return { a.m[0][0] * v.x + a.m[0][1] * v.y + a.m[0][2] * v.z,
+             a.m[1][0] * v.x + a.m[1][1] * v.y + a.m[1][2] * v.z,
+             a.m[2][0] * v.x + a.m[2][1] * v.y + a.m[2][2] * v.z };
+}
+
+// a * b – b applies first
+inline Float3x4 operator*(const Float3x4& a, const Float3x4& b)
+{
+    Float3x4 r;
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            r.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j];
+        r.m[i][3] += a.m[i][3];
+    }
+    return r;
+}
+
+// Position, uniform scale, rotation – 32 bytes, two 16 byte halves for the kernels
+struct Transform
+{
+    Float3 position;
+    float  scale;
+    Quat   rotation;
+};
+static_assert(sizeof(Transform) == 32, "Transform is loaded as two float4s");
+
+inline Float3x4 ToMatrix(const Transform& t)
+{
+    const Quat& q = t.rotation;
+    const float s = t.scale;
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    return { { { s * (1.0f - 2.0f * (yy + zz)), s * 2.0f * (xy - wz), s * 2.0f * (xz + wy), t.position.x },
+               { s * 2.0f * (xy + wz), s * (1.0f - 2.0f * (xx + zz)), s * 2.0f * (yz - wx), t.position.y },
+               { s * 2.0f * (xz - wy), s * 2.0f * (yz + wx), s * (1.0f - 2.0f * (xx + yy)), t.position.z } } };
+}
+
+// ---------------------------------
+// Kernel inputs – SoA
+// ---------------------------------
+// Center/half-extent boxes, world space
+struct AabbArrays
+{
+    const float* center[3];
+    const float* extent[3];
+};
+
+// One rigid body per index. invMass 0 = static or kinematic: velocities
+// still move it, gravity and forces don't.
+struct BodyArrays
+{
+    float*       position[3];
+    float*       velocity[3];
+    float*       angularVelocity[3];
+    float*       orientation[4];        // x y z w
+    float*       force[3];              // accumulated over the step, cleared by it
+    const float* invMass;
+};
+
+struct IntegrateParams
+{
+    float dt;
+    float gravity[3];
+    float linearDamping;                // per second
+    float angularDamping;
+};
+
+enum class SimdLevel : uint32_t { Scalar, Sse2, Avx2 };
+
+// ---------------------------------
+// Scalar kernels – also the epilogues of the SIMD ones
+// ---------------------------------
+namespace SimdScalar
+{
+inline void TransformsToMatrices(uint32_t count, const Transform* in, Float3x4* out)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        out[i] = ToMatrix(in[i]);
+}
+
+inline uint32_t CullAabbs(uint32_t begin, uint32_t end, const AabbArrays& boxes, const float planes[6][4],
+                          uint32_t* visible)
+{
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        bool inside = true;
+        for (uint32_t p = 0; p < 6 && inside; ++p)
+        {
+            const float distance = planes[p][0] * boxes.center[0][i] + planes[p][1] * boxes.center[1][i] +
+                                   planes[p][2] * boxes.center[2][i] + planes[p][3];
+            const float radius   = fabsf(planes[p][0]) * boxes.extent[0][i] + fabsf(planes[p][1]) * boxes.extent[1][i] +
+                                   fabsf(planes[p][2]) * boxes.extent[2][i];
+            inside = distance >= -radius;
+        }
+        if (inside)
+            visible[count++] = i;
+    }
+    return count;
+}
+
+inline void IntegrateBodies(uint32_t begin, uint32_t end, const BodyArrays& b, const IntegrateParams& step)
+{
+    const float linearScale  = 1.0f / (1.0f + step.dt * step.linearDamping);
+    const float angularScale = 1.0f / (1.0f + step.dt * step.angularDamping);
+    const float halfDt       = 0.5f * step.dt;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const float invMass = b.invMass[i];
+        const float dynamic = invMass > 0.0f ? 1.0f : 0.0f;
+        for (int k = 0; k < 3; ++k)
+        {
+            const float v = (b.velocity[k][i] + (step.gravity[k] * dynamic + b.force[k][i] * invMass) * step.dt) * linearScale;
+            b.velocity[k][i]  = v;
+            b.position[k][i] += v * step.dt;
+            b.force[k][i]     = 0.0f;
+            b.angularVelocity[k][i] *= angularScale;
+        }
+
+        // q += dt/2 * (w, 0) * q, renormalized
+        const float wx = b.angularVelocity[0][i], wy = b.angularVelocity[1][i], wz = b.angularVelocity[2][i];
+        const float qx = b.orientation[0][i], qy = b.orientation[1][i], qz = b.orientation[2][i], qw = b.orientation[3][i];
+        const Quat  q  = Normalize(Quat{ qx + halfDt * ( wx * qw + wy * qz - wz * qy),
+                                         qy + halfDt * ( wy * qw + wz * qx - wx * qz),
+                                         qz + halfDt * ( wz * qw + wx * qy - wy * qx),
+                                         qw + halfDt * (-wx * qx - wy * qy - wz * qz) });
+        b.orientation[0][i] = q.x;
+        b.orientation[1][i] = q.y;
+        b.orientation[2][i] = q.z;
+        b.orientation[3][i] = q.w;
+    }
+}
+}   // namespace SimdScalar
+
+// ---------------------------------
+// SSE2 – 4 wide, always there on x64
+// ---------------------------------
+namespace SimdSse2
+{
+// Rotation + scale rows from SoA quaternions, the shared core of the TRS kernels
+#define SIMD_TRS_ROWS(V, add, sub, mul, set1)                                               \
+    const V two = set1(2.0f), one = set1(1.0f);                                             \
+    const V xx = mul(qx, qx), yy = mul(qy, qy), zz = mul(qz, qz);                           \
+    const V xy = mul(qx, qy), xz = mul(qx, qz), yz = mul(qy, qz);                           \
+    const V wx = mul(qw, qx), wy = mul(qw, qy), wz = mul(qw, qz);                           \
+    const V ts = mul(two, s);                                                               \
+    V r00 = mul(s, sub(one, mul(two, add(yy, zz)))), r01 = mul(ts, sub(xy, wz)), r02 = mul(ts, add(xz, wy)); \
+    V r10 = mul(ts, add(xy, wz)), r11 = mul(s, sub(one, mul(two, add(xx, zz)))), r12 = mul(ts, sub(yz, wx)); \
+    V r20 = mul(ts, sub(xz, wy)), r21 = mul(ts, add(yz, wx)), r22 = mul(s, sub(one, mul(two, add(xx, yy))));
+
+inline void TransformsToMatrices(uint32_t count, const Transform* in, Float3x4* out)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const float* src = reinterpret_cast<const float*>(in + i);
+        __m128 px = _mm_loadu_ps(src + 0),  py = _mm_loadu_ps(src + 8),  pz = _mm_loadu_ps(src + 16), s  = _mm_loadu_ps(src + 24);
+        __m128 qx = _mm_loadu_ps(src + 4),  qy = _mm_loadu_ps(src + 12), qz = _mm_loadu_ps(src + 20), qw = _mm_loadu_ps(src + 28);
+        _MM_TRANSPOSE4_PS(px, py, pz, s);
+        _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+        SIMD_TRS_ROWS(__m128, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_set1_ps)
+
+        // Back to one row per register: lanes are entities, transposing gives entity k's row
+        float* dst = reinterpret_cast<float*>(out + i);
+        _MM_TRANSPOSE4_PS(r00, r01, r02, px);
+        _MM_TRANSPOSE4_PS(r10, r11, r12, py);
+        _MM_TRANSPOSE4_PS(r20, r21, r22, pz);
+        const __m128 rows[4][3] = { { r00, r10, r20 }, { r01, r11, r21 }, { r02, r12, r22 }, { px, py, pz } };
+        for (int k = 0; k < 4; ++k)
+            for (int r = 0; r < 3; ++r)
+                _mm_storeu_ps(dst + k * 12 + r * 4, rows[k][r]);
+    }
+    SimdScalar::TransformsToMatrices(count - i, in + i, out + i);
+}
+
+inline uint32_t CullAabbs(uint32_t count, const AabbArrays& boxes, const float planes[6][4], uint32_t* visible)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    uint32_t visibleCount = 0, i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 cx = _mm_loadu_ps(boxes.center[0] + i), cy = _mm_loadu_ps(boxes.center[1] + i), cz = _mm_loadu_ps(boxes.center[2] + i);
+        const __m128 ex = _mm_loadu_ps(boxes.extent[0] + i), ey = _mm_loadu_ps(boxes.extent[1] + i), ez = _mm_loadu_ps(boxes.extent[2] + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m128 nx = _mm_set1_ps(planes[p][0]), ny = _mm_set1_ps(planes[p][1]), nz = _mm_set1_ps(planes[p][2]);
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                               _mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(planes[p][3])));
+            const __m128 radius   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(nx, absMask), ex),
+                                                          _mm_mul_ps(_mm_and_ps(ny, absMask), ey)),
+                                               _mm_mul_ps(_mm_and_ps(nz, absMask), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_sub_ps(_mm_setzero_ps(), radius)));
+        }
+        for (int bits = _mm_movemask_ps(inside); bits; bits &= bits - 1)
+        {
+            unsigned long lane;
+#if defined(_MSC_VER)
+            _BitScanForward(&lane, (unsigned long)bits);
+#else
+            lane = (unsigned long)__builtin_ctz((unsigned)bits);
+#endif
+            visible[visibleCount++] = i + (uint32_t)lane;
+        }
+    }
+    return visibleCount + SimdScalar::CullAabbs(i, count, boxes, planes, visible + visibleCount);
+}
+
+inline void IntegrateBodies(uint32_t count, const BodyArrays& b, const IntegrateParams& step)
+{
+    const __m128 dt           = _mm_set1_ps(step.dt);
+    const __m128 halfDt       = _mm_set1_ps(0.5f * step.dt);
+    const __m128 linearScale  = _mm_set1_ps(1.0f / (1.0f + step.dt * step.linearDamping));
+    const __m128 angularScale = _mm_set1_ps(1.0f / (1.0f + step.dt * step.angularDamping));
+    const __m128 zero         = _mm_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 invMass = _mm_loadu_ps(b.invMass + i);
+        const __m128 dynamic = _mm_cmpgt_ps(invMass, zero);
+        for (int k = 0; k < 3; ++k)
+        {
+            const __m128 gravity = _mm_and_ps(_mm_set1_ps(step.gravity[k]), dynamic);
+            const __m128 accel   = _mm_add_ps(gravity, _mm_mul_ps(_mm_loadu_ps(b.force[k] + i), invMass));
+            const __m128 v       = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(b.velocity[k] + i), _mm_mul_ps(accel, dt)), linearScale);
+            _mm_storeu_ps(b.velocity[k] + i, v);
+            _mm_storeu_ps(b.position[k] + i, _mm_add_ps(_mm_loadu_ps(b.position[k] + i), _mm_mul_ps(v, dt)));
+            _mm_storeu_ps(b.force[k] + i, zero);
+            _mm_storeu_ps(b.angularVelocity[k] + i, _mm_mul_ps(_mm_loadu_ps(b.angularVelocity[k] + i), angularScale));
+        }
+
+        const __m128 wx = _mm_loadu_ps(b.angularVelocity[0] + i), wy = _mm_loadu_ps(b.angularVelocity[1] + i),
+                     wz = _mm_loadu_ps(b.angularVelocity[2] + i);
+        const __m128 qx = _mm_loadu_ps(b.orientation[0] + i), qy = _mm_loadu_ps(b.orientation[1] + i),
+                     qz = _mm_loadu_ps(b.orientation[2] + i), qw = _mm_loadu_ps(b.orientation[3] + i);
+        const __m128 nx = _mm_add_ps(qx, _mm_mul_ps(halfDt, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(wx, qw), _mm_mul_ps(wy, qz)), _mm_mul_ps(wz, qy))));
+        const __m128 ny = _mm_add_ps(qy, _mm_mul_ps(halfDt, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(wy, qw), _mm_mul_ps(wz, qx)), _mm_mul_ps(wx, qz))));
+        const __m128 nz = _mm_add_ps(qz, _mm_mul_ps(halfDt, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(wz, qw), _mm_mul_ps(wx, qy)), _mm_mul_ps(wy, qx))));
+        const __m128 nw = _mm_sub_ps(qw, _mm_mul_ps(halfDt, _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, qx), _mm_mul_ps(wy, qy)), _mm_mul_ps(wz, qz))));
+        const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)),
+                                                     _mm_add_ps(_mm_mul_ps(nz, nz), _mm_mul_ps(nw, nw))));
+        const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), length);
+        _mm_storeu_ps(b.orientation[0] + i, _mm_mul_ps(nx, inv));
+        _mm_storeu_ps(b.orientation[1] + i, _mm_mul_ps(ny, inv));
+        _mm_storeu_ps(b.orientation[2] + i, _mm_mul_ps(nz, inv));
+        _mm_storeu_ps(b.orientation[3] + i, _mm_mul_ps(nw, inv));
+    }
+    SimdScalar::IntegrateBodies(i, count, b, step);
+}
+}   // namespace SimdSse2
+
+// ---------------------------------
+// AVX2 + FMA – 8 wide
+// ---------------------------------
+namespace SimdAvx2
+{
+// Two 16 byte records per register (i in the low lane, i + 4 in the high), then a per-lane 4x4 transpose
+SIMD_TARGET_AVX2 inline __m256 LoadPair(const float* low, const float* high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+SIMD_TARGET_AVX2 inline void Transpose4x4Lanes(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+SIMD_TARGET_AVX2 inline void TransformsToMatrices(uint32_t count, const Transform* in, Float3x4* out)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const float* src = reinterpret_cast<const float*>(in + i);
+        __m256 px = LoadPair(src + 0,  src + 32), py = LoadPair(src + 8,  src + 40);
+        __m256 pz = LoadPair(src + 16, src + 48), s  = LoadPair(src + 24, src + 56);
+        __m256 qx = LoadPair(src + 4,  src + 36), qy = LoadPair(src + 12, src + 44);
+        __m256 qz = LoadPair(src + 20, src + 52), qw = LoadPair(src + 28, src + 60);
+        Transpose4x4Lanes(px, py, pz, s);
+        Transpose4x4Lanes(qx, qy, qz, qw);
+
+        SIMD_TRS_ROWS(__m256, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_set1_ps)
+
+        float* dst = reinterpret_cast<float*>(out + i);
+        Transpose4x4Lanes(r00, r01, r02, px);
+        Transpose4x4Lanes(r10, r11, r12, py);
+        Transpose4x4Lanes(r20, r21, r22, pz);
+        const __m256 rows[4][3] = { { r00, r10, r20 }, { r01, r11, r21 }, { r02, r12, r22 }, { px, py, pz } };
+        for (int k = 0; k < 4; ++k)
+            for (int r = 0; r < 3; ++r)
+            {
+                _mm_storeu_ps(dst + k * 12 + r * 4,       _mm256_castps256_ps128(rows[k][r]));
+                _mm_storeu_ps(dst + (k + 4) * 12 + r * 4, _mm256_extractf128_ps(rows[k][r], 1));
+            }
+    }
+    SimdSse2::TransformsToMatrices(count - i, in + i, out + i);
+}
+
+SIMD_TARGET_AVX2 inline uint32_t CullAabbs(uint32_t count, const AabbArrays& boxes, const float planes[6][4],
+                                           uint32_t* visible)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    uint32_t visibleCount = 0, i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 cx = _mm256_loadu_ps(boxes.center[0] + i), cy = _mm256_loadu_ps(boxes.center[1] + i),
+                     cz = _mm256_loadu_ps(boxes.center[2] + i);
+        const __m256 ex = _mm256_loadu_ps(boxes.extent[0] + i), ey = _mm256_loadu_ps(boxes.extent[1] + i),
+                     ez = _mm256_loadu_ps(boxes.extent[2] + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m256 nx = _mm256_set1_ps(planes[p][0]), ny = _mm256_set1_ps(planes[p][1]), nz = _mm256_set1_ps(planes[p][2]);
+            const __m256 distance = _mm256_fmadd_ps(nx, cx, _mm256_fmadd_ps(ny, cy, _mm256_fmadd_ps(nz, cz, _mm256_set1_ps(planes[p][3]))));
+            const __m256 radius   = _mm256_fmadd_ps(_mm256_and_ps(nx, absMask), ex,
+                                    _mm256_fmadd_ps(_mm256_and_ps(ny, absMask), ey, _mm256_mul_ps(_mm256_and_ps(nz, absMask), ez)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_sub_ps(_mm256_setzero_ps(), radius), _CMP_GE_OQ));
+        }
+        for (int bits = _mm256_movemask_ps(inside); bits; bits &= bits - 1)
+        {
+            unsigned long lane;
+#if defined(_MSC_VER)
+            _BitScanForward(&lane, (unsigned long)bits);
+#else
+            lane = (unsigned long)__builtin_ctz((unsigned)bits);
+#endif
+            visible[visibleCount++] = i + (uint32_t)lane;
+        }
+    }
+    return visibleCount + SimdScalar::CullAabbs(i, count, boxes, planes, visible + visibleCount);
+}
+
+SIMD_TARGET_AVX2 inline void IntegrateBodies(uint32_t count, const BodyArrays& b, const IntegrateParams& step)
+{
+    const __m256 dt           = _mm256_set1_ps(step.dt);
+    const __m256 halfDt       = _mm256_set1_ps(0.5f * step.dt);
+    const __m256 linearScale  = _mm256_set1_ps(1.0f / (1.0f + step.dt * step.linearDamping));
+    const __m256 angularScale = _mm256_set1_ps(1.0f / (1.0f + step.dt * step.angularDamping));
+    const __m256 zero         = _mm256_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 invMass = _mm256_loadu_ps(b.invMass + i);
+        const __m256 dynamic = _mm256_cmp_ps(invMass, zero, _CMP_GT_OQ);
+        for (int k = 0; k < 3; ++k)
+        {
+            const __m256 gravity = _mm256_and_ps(_mm256_set1_ps(step.gravity[k]), dynamic);
+            const __m256 accel   = _mm256_fmadd_ps(_mm256_loadu_ps(b.force[k] + i), invMass, gravity);
+            const __m256 v       = _mm256_mul_ps(_mm256_fmadd_ps(accel, dt, _mm256_loadu_ps(b.velocity[k] + i)), linearScale);
+            _mm256_storeu_ps(b.velocity[k] + i, v);
+            _mm256_storeu_ps(b.position[k] + i, _mm256_fmadd_ps(v, dt, _mm256_loadu_ps(b.position[k] + i)));
+            _mm256_storeu_ps(b.force[k] + i, zero);
+            _mm256_storeu_ps(b.angularVelocity[k] + i, _mm256_mul_ps(_mm256_loadu_ps(b.angularVelocity[k] + i), angularScale));
+        }
+
+        const __m256 wx = _mm256_loadu_ps(b.angularVelocity[0] + i), wy = _mm256_loadu_ps(b.angularVelocity[1] + i),
+                     wz = _mm256_loadu_ps(b.angularVelocity[2] + i);
+        const __m256 qx = _mm256_loadu_ps(b.orientation[0] + i), qy = _mm256_loadu_ps(b.orientation[1] + i),
+                     qz = _mm256_loadu_ps(b.orientation[2] + i), qw = _mm256_loadu_ps(b.orientation[3] + i);
+        const __m256 nx = _mm256_fmadd_ps(halfDt, _mm256_fmsub_ps(wx, qw, _mm256_fmsub_ps(wz, qy, _mm256_mul_ps(wy, qz))), qx);
+        const __m256 ny = _mm256_fmadd_ps(halfDt, _mm256_fmsub_ps(wy, qw, _mm256_fmsub_ps(wx, qz, _mm256_mul_ps(wz, qx))), qy);
+        const __m256 nz = _mm256_fmadd_ps(halfDt, _mm256_fmsub_ps(wz, qw, _mm256_fmsub_ps(wy, qx, _mm256_mul_ps(wx, qy))), qz);
+        const __m256 nw = _mm256_fnmadd_ps(halfDt, _mm256_fmadd_ps(wx, qx, _mm256_fmadd_ps(wy, qy, _mm256_mul_ps(wz, qz))), qw);
+        const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(ny, ny, _mm256_fmadd_ps(nz, nz, _mm256_mul_ps(nw, nw)))));
+        const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), length);
+        _mm256_storeu_ps(b.orientation[0] + i, _mm256_mul_ps(nx, inv));
+        _mm256_storeu_ps(b.orientation[1] + i, _mm256_mul_ps(ny, inv));
+        _mm256_storeu_ps(b.orientation[2] + i, _mm256_mul_ps(nz, inv));
+        _mm256_storeu_ps(b.orientation[3] + i, _mm256_mul_ps(nw, inv));
+    }
+    SimdScalar::IntegrateBodies(i, count, b, step);
+}
+}   // namespace SimdAvx2
+
+#undef SIMD_TRS_ROWS
+
+// ---------------------------------
+// Dispatch
+// ---------------------------------
+inline uint64_t ReadXcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+// Best level the CPU *and* the OS (saved YMM state) support
+inline SimdLevel DetectSimdLevel()
+{
+    unsigned int regs[4] = {};      // eax ebx ecx edx
+#if defined(_MSC_VER)
+    __cpuid(reinterpret_cast<int*>(regs), 1);
+#else
+    __get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    const bool fma     = (regs[2] & (1u << 12)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx     = (regs[2] & (1u << 28)) != 0;
+    if (!(fma && osxsave && avx) || (ReadXcr0() & 0x6) != 0x6)
+        return SimdLevel::Sse2;
+
+#if defined(_MSC_VER)
+    __cpuidex(reinterpret_cast<int*>(regs), 7, 0);
+#else
+    __get_cpuid_count(7, 0, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    return (regs[1] & (1u << 5)) ? SimdLevel::Avx2 : SimdLevel::Sse2;
+}
+
+inline const char* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Avx2: return "AVX2";
+    case SimdLevel::Sse2: return "SSE2";
+    default:              return "scalar";
+    }
+}
+
+struct SimdKernels
+{
+    SimdLevel level;
+    void      (*transformsToMatrices)(uint32_t, const Transform*, Float3x4*);
+    uint32_t  (*cullAabbs)(uint32_t, const AabbArrays&, const float[6][4], uint32_t*);
+    void      (*integrateBodies)(uint32_t, const BodyArrays&, const IntegrateParams&);
+};
+
+inline SimdKernels MakeSimdKernels(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Avx2:
+        return { level, SimdAvx2::TransformsToMatrices, SimdAvx2::CullAabbs, SimdAvx2::IntegrateBodies };
+    case SimdLevel::Sse2:
+        return { level, SimdSse2::TransformsToMatrices, SimdSse2::CullAabbs, SimdSse2::IntegrateBodies };
+    default:
+        return { level, SimdScalar::TransformsToMatrices,
+                 [](uint32_t count, const AabbArrays& boxes, const float planes[6][4], uint32_t* visible)
+                 { return SimdScalar::CullAabbs(0, count, boxes, planes, visible); },
+                 [](uint32_t count, const BodyArrays& bodies, const IntegrateParams& step)
+                 { SimdScalar::IntegrateBodies(0, count, bodies, step); } };
+    }
+}
+
+inline SimdKernels& ActiveSimdKernels()
+{
+    static SimdKernels kernels = MakeSimdKernels(DetectSimdLevel());
+    return kernels;
+}
+
+// Can only go down from what the CPU has; call before any worker uses the kernels
+inline void SetSimdLevel(SimdLevel level)
+{
+    const SimdLevel best = DetectSimdLevel();
+    ActiveSimdKernels() = MakeSimdKernels((uint32_t)level < (uint32_t)best ? level : best);
+}
+
+inline SimdLevel ActiveSimdLevel() { return ActiveSimdKernels().level; }
+
+inline void TransformsToMatrices(uint32_t count, const Transform* in, Float3x4* out)
+{
+    ActiveSimdKernels().transformsToMatrices(count, in, out);
+}
+
+// Indices of the boxes inside or touching all six planes (normals pointing in), ascending; returns how many
+inline uint32_t CullAabbs(uint32_t count, const AabbArrays& boxes, const float planes[6][4], uint32_t* visible)
+{
+    return ActiveSimdKernels().cullAabbs(count, boxes, planes, visible);
+}
+
+inline void IntegrateBodies(uint32_t count, const BodyArrays& bodies, const IntegrateParams& step)
+{
+    ActiveSimdKernels().integrateBodies(count, bodies, step);
+}
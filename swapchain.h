@@ -0,0 +1,239 @@
+// ---------------------------------------------------------------
+// Swap chain + frame pacing
+// ---------------------------------------------------------------
+// FLIP_DISCARD swap chain created with a frame latency waitable object, so
+// the CPU can block *before* it samples input until DXGI actually wants a
+// new frame, instead of queueing frames behind Present():
+//
+//   swapChain.WaitForNextFrame();      // latency object + optional fps cap
+//   PumpMessages();                     // input is as fresh as it gets
+//   Render(); swapChain.Present();
+//
+// Tearing (DXGI_PRESENT_ALLOW_TEARING) is used with vsync off when the
+// system supports it – needed for VRR displays and uncapped windowed flips.
+//
+// InitOffscreen() has the same interface over plain render targets and no
+// DXGI at all – Present() only rotates them. For headless benchmark runs: no
+// compositor, no display rate, nothing a window on the desktop can change.
+#pragma once
+
+#include "dxhelpers.h"
+#include <dxgi1_6.h>
+
+struct SwapChainSettings
+{
+    UINT bufferCount     = 3;       // 2..SwapChain::kMaxBuffers
+    UINT maxFrameLatency = 1;       // frames DXGI may queue ahead of the display
+    bool vsync           = true;
+    UINT fpsCap          = 0;       // 0 = off; sleeps in WaitForNextFrame
+};
+
+class SwapChain
+{
+public:
+    static const UINT        kMaxBuffers = 4;
+    static const DXGI_FORMAT kFormat     = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+    void Init(IDXGIFactory6* factory, ID3D12Device* device, ID3D12CommandQueue* queue, HWND hwnd,
+              UINT width, UINT height, const SwapChainSettings& settings)
+    {
+        m_device   = device;
+        m_settings = settings;
+        m_settings.bufferCount     = max(2u, min(settings.bufferCount, kMaxBuffers));
+        m_settings.maxFrameLatency = max(1u, settings.maxFrameLatency);
+
+        BOOL tearing = FALSE;
+        m_tearingSupported = SUCCEEDED(factory->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING,
+                                                                    &tearing, sizeof(tearing))) && tearing;
+
+        m_flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+        if (m_tearingSupported)
+            m_flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+
+        DXGI_SWAP_CHAIN_DESC1 desc{};
+        desc.BufferCount       = m_settings.bufferCount;
+        desc.Width             = width;
+        desc.Height            = height;
+        desc.Format            = kFormat;
+        desc.BufferUsage       = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        desc.SwapEffect        = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        desc.SampleDesc.Count  = 1;
+        desc.Flags             = m_flags;
+
+        ComPtr<IDXGISwapChain1> swapChain1;
+        ThrowIfFailed(factory->CreateSwapChainForHwnd(queue, hwnd, &desc, nullptr, nullptr, &swapChain1));
+        ThrowIfFailed(swapChain1.As(&m_swapChain));
+
+        // Exclusive fullscreen would drop the tearing/latency flags on the floor
+        factory->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
+
+        ThrowIfFailed(m_swapChain->SetMaximumFrameLatency(m_settings.maxFrameLatency));
+        m_latencyWaitable = m_swapChain->GetFrameLatencyWaitableObject();
+
+        InitBuffers(width, height);
+    }
+
+    // bufferCount textures rotated like a swap chain's, starting in PRESENT (= COMMON) as those do
+    void InitOffscreen(ID3D12Device* device, UINT width, UINT height, const SwapChainSettings& settings)
+    {
+        m_device    = device;
+        m_settings  = settings;
+        m_settings.bufferCount = max(2u, min(settings.bufferCount, kMaxBuffers));
+        m_offscreen = true;
+
+        InitBuffers(width, height);
+    }
+
+    void Shutdown()
+    {
+        for (ComPtr<ID3D12Resource>& buffer : m_buffers)
+            buffer.Reset();
+        if (m_latencyWaitable) CloseHandle(m_latencyWaitable);
+        if (m_timer)           CloseHandle(m_timer);
+        m_latencyWaitable = nullptr;
+        m_timer           = nullptr;
+        m_swapChain.Reset();
+        m_rtvHeap.Reset();
+    }
+
+    // The GPU must be idle – nothing may still reference the old back buffers
+    void Resize(UINT width, UINT height)
+    {
+        if (width == m_width && height == m_height)
+            return;
+        for (ComPtr<ID3D12Resource>& buffer : m_buffers)
+            buffer.Reset();
+        if (!m_offscreen)
+            ThrowIfFailed(m_swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, m_flags));
+        m_width   = width;
+        m_height  = height;
+        m_current = 0;
+        CreateViews();
+    }
+
+    // Blocks until DXGI wants the next frame, then holds to the fps cap. Call before reading input.
+    void WaitForNextFrame()
+    {
+        if (m_latencyWaitable)
+            WaitForSingleObjectEx(m_latencyWaitable, 1000, TRUE);
+
+        if (!m_ticksPerFrame)
+            return;
+
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        if (m_nextFrame == 0 || now.QuadPart - m_nextFrame > m_ticksPerFrame)
+            m_nextFrame = now.QuadPart;     // first frame, or we fell a whole frame behind – resync
+
+        // Timer for the bulk, spin for the last half millisecond
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        const LONGLONG spin      = frequency.QuadPart / 2000;
+        const LONGLONG remaining = m_nextFrame - now.QuadPart;
+        if (m_timer && remaining > spin)
+        {
+            LARGE_INTEGER due;
+            due.QuadPart = -((remaining - spin) * 10000000 / frequency.QuadPart);   // relative, 100 ns units
+            if (SetWaitableTimerEx(m_timer, &due, 0, nullptr, nullptr, nullptr, 0))
+                WaitForSingleObject(m_timer, INFINITE);
+        }
+        do
+        {
+            YieldProcessor();
+            QueryPerformanceCounter(&now);
+        } while (now.QuadPart < m_nextFrame);
+
+        m_nextFrame += m_ticksPerFrame;
+    }
+
+    void Present()
+    {
+        if (m_offscreen)
+        {
+            m_current = (m_current + 1) % m_settings.bufferCount;
+            return;
+        }
+        const bool tear = !m_settings.vsync && m_tearingSupported;
+        ThrowIfFailed(m_swapChain->Present(m_settings.vsync ? 1 : 0, tear ? DXGI_PRESENT_ALLOW_TEARING : 0));
+    }
+
+    UINT CurrentIndex() const { return m_offscreen ? m_current : m_swapChain->GetCurrentBackBufferIndex(); }
+    UINT BufferCount() const { return m_settings.bufferCount; }
+    UINT Width() const { return m_width; }
+    UINT Height() const { return m_height; }
+    bool TearingSupported() const { return m_tearingSupported; }
+    bool Offscreen() const { return m_offscreen; }
+
+    ID3D12Resource* BackBuffer(UINT index) const { return m_buffers[index].Get(); }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE Rtv(UINT index) const
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+        handle.ptr += (SIZE_T)index * m_rtvSize;
+        return handle;
+    }
+
+private:
+    // Fps cap timer, RTV heap and the buffers' views – shared by both Init()s
+    void InitBuffers(UINT width, UINT height)
+    {
+        if (m_settings.fpsCap)
+        {
+            m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+            if (!m_timer)       // pre-1803 Windows – plain timer, coarser
+                m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            m_ticksPerFrame = frequency.QuadPart / m_settings.fpsCap;
+        }
+
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{};
+        rtvHeapDesc.NumDescriptors = kMaxBuffers;
+        rtvHeapDesc.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        ThrowIfFailed(m_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap)));
+        m_rtvSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+
+        m_width  = width;
+        m_height = height;
+        CreateViews();
+    }
+
+    void CreateViews()
+    {
+        for (UINT i = 0; i < m_settings.bufferCount; ++i)
+        {
+            if (m_offscreen)
+            {
+                const D3D12_HEAP_PROPERTIES heap = HeapProperties(D3D12_HEAP_TYPE_DEFAULT);
+                const D3D12_RESOURCE_DESC   desc = Texture2DDesc(kFormat, m_width, m_height, 1,
+                                                                 D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+                ThrowIfFailed(m_device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc,
+                                                                D3D12_RESOURCE_STATE_PRESENT, nullptr,
+                                                                IID_PPV_ARGS(&m_buffers[i])));
+            }
+            else
+                ThrowIfFailed(m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_buffers[i])));
+            m_device->CreateRenderTargetView(m_buffers[i].Get(), nullptr, Rtv(i));
+        }
+    }
+
+    ID3D12Device*                m_device = nullptr;
+    ComPtr<IDXGISwapChain3>      m_swapChain;
+    SwapChainSettings            m_settings;
+    UINT                         m_flags            = 0;
+    bool                         m_tearingSupported = false;
+    bool                         m_offscreen        = false;
+    UINT                         m_current          = 0;        // offscreen: the buffer being drawn
+    UINT                         m_width            = 0;
+    UINT                         m_height           = 0;
+
+    ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
+    UINT                         m_rtvSize = 0;
+    ComPtr<ID3D12Resource>       m_buffers[kMaxBuffers];
+
+    // Pacing
+    HANDLE                       m_latencyWaitable = nullptr;
+    HANDLE                       m_timer           = nullptr;
+    LONGLONG                     m_ticksPerFrame   = 0;
+    LONGLONG                     m_nextFrame       = 0;
+};
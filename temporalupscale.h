@@ -0,0 +1,191 @@
+// ---------------------------------------------------------------
+// Temporal upscaling – jittered, lower resolution frames in, full resolution antialiased out
+// ---------------------------------------------------------------
+// The scene renders with a sub-pixel offset on the projection that changes
+// every frame (HaltonJitter), writes a motion vector per pixel next to its
+// colour, and a TemporalUpscaler turns colour + depth + motion + its own
+// history into the output frame. Run at the tier's render scale (or inside
+// dynamic resolution's range) it accumulates the missing pixels over frames.
+//
+// TemporalUpscaler is the plugin point: the built-in TaaUpscaler below is
+// one compute pass (shaders/taa.hlsl); an FSR2, DLSS or XeSS wrapper takes
+// the same inputs and registers a factory under its name for --upscaler=.
+//
+//   upscaler->Resize(width, height);          // GPU idle – drops the history too
+//   upscaler->BeginFrame();                   // once a frame, before Output() is imported
+//   upscaler->Record(cl, inputs);             // compute root signature + heap + frame constants bound
+//
+// Contract: inputs arrive in NON_PIXEL_SHADER_RESOURCE, Output() is written
+// in UNORDERED_ACCESS and rests in NON_PIXEL_SHADER_RESOURCE between frames;
+// the render graph moves it. Anything else the upscaler owns is its business.
+#pragma once
+
+#include "descriptors.h"
+#include "dxhelpers.h"
+#include "gpuallocator.h"
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Sample offset for frame `index` (from 1) in pixels, both axes in [-0.5, 0.5) – Halton(2, 3).
+// Plain std only.
+inline void HaltonJitter(uint32_t index, float* x, float* y)
+{
+    auto halton = [](uint32_t i, uint32_t base)
+    {
+        float f = 1.0f, r = 0.0f;
+        for (; i > 0; i /= base)
+        {
+            f /= (float)base;
+            r += f * (float)(i % base);
+        }
+        return r;
+    };
+    *x = halton(index, 2) - 0.5f;
+    *y = halton(index, 3) - 0.5f;
+}
+
+// One frame's worth – SRVs/UAV are descriptor heap indices
+struct TemporalInputs
+{
+    ID3D12Resource* color;          // render resolution, in the top-left corner of the target
+    ID3D12Resource* depth;
+    ID3D12Resource* motion;         // R16G16_FLOAT, uv now - uv last frame, unjittered
+    UINT            colorSrv;
+    UINT            depthSrv;       // R32_FLOAT view
+    UINT            motionSrv;
+    UINT            renderWidth;
+    UINT            renderHeight;
+    float           jitterX;        // render pixels, what the projection was offset by
+    float           jitterY;
+    float           frameSeconds;
+    float           nearPlane;
+    float           farPlane;
+    float           verticalFov;    // radians
+    bool            reset;          // camera cut, resize – nothing from before applies
+};
+
+class TemporalUpscaler
+{
+public:
+    virtual ~TemporalUpscaler() = default;
+
+    virtual const char*     Name() const = 0;
+    virtual void            Resize(UINT outputWidth, UINT outputHeight) = 0;
+    virtual void            BeginFrame() = 0;
+    virtual void            Record(ID3D12GraphicsCommandList* cl, const TemporalInputs& inputs) = 0;
+    virtual ID3D12Resource* Output() = 0;       // this frame's, output size, valid after BeginFrame()
+    virtual UINT            OutputSrv() = 0;
+    virtual void            Shutdown() = 0;     // GPU idle
+};
+
+// Plugins register before InitD3D12; the built-in one is there without registering
+using TemporalUpscalerFactory = std::unique_ptr<TemporalUpscaler> (*)(ID3D12Device* device, GpuAllocator* allocator,
+                                                                      DescriptorHeap* descriptors);
+
+inline std::vector<std::pair<std::string, TemporalUpscalerFactory>>& TemporalUpscalerPlugins()
+{
+    static std::vector<std::pair<std::string, TemporalUpscalerFactory>> plugins;
+    return plugins;
+}
+
+inline void RegisterTemporalUpscaler(const char* name, TemporalUpscalerFactory factory)
+{
+    TemporalUpscalerPlugins().emplace_back(name, factory);
+}
+
+// nullptr when nothing by that name is registered – the caller falls back to TaaUpscaler
+inline std::unique_ptr<TemporalUpscaler> CreateTemporalUpscalerPlugin(const char* name, ID3D12Device* device,
+                                                                      GpuAllocator* allocator, DescriptorHeap* descriptors)
+{
+    for (const auto& [plugin, factory] : TemporalUpscalerPlugins())
+        if (plugin == name)
+            return factory(device, allocator, descriptors);
+    return nullptr;
+}
+
+// ---------------------------------------------------------------
+// Built-in: TAA with upsampling, see shaders/taa.hlsl
+// ---------------------------------------------------------------
+// Two RGBA16F textures at output size, ping-ponged: one is this frame's
+// output, the other last frame's – that's the history, read in
+// NON_PIXEL_SHADER_RESOURCE, where the contract already leaves it.
+class TaaUpscaler : public TemporalUpscaler
+{
+public:
+    static const DXGI_FORMAT kFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+    // `pso` is main's ComPtr, so hot reload's swaps reach it
+    TaaUpscaler(GpuAllocator* allocator, DescriptorHeap* descriptors, ComPtr<ID3D12PipelineState>* pso)
+        : m_allocator(allocator), m_descriptors(descriptors), m_pso(pso)
+    {
+    }
+
+    const char* Name() const override { return "TAA"; }
+
+    void Resize(UINT outputWidth, UINT outputHeight) override
+    {
+        Shutdown();
+        m_width  = outputWidth;
+        m_height = outputHeight;
+        for (UINT i = 0; i < 2; ++i)
+        {
+            m_textures[i] = m_allocator->CreateResource(D3D12_HEAP_TYPE_DEFAULT,
+                                                        Texture2DDesc(kFormat, outputWidth, outputHeight, 1,
+                                                                      D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS),
+                                                        D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, nullptr);
+            m_srvs[i] = m_descriptors->AllocatePersistent();
+            m_uavs[i] = m_descriptors->AllocatePersistent();
+            m_descriptors->CreateTextureSrv(m_srvs[i], m_textures[i]->resource.Get());
+            m_descriptors->CreateTextureUav(m_uavs[i], m_textures[i]->resource.Get());
+        }
+        m_valid = false;        // the old history is gone with them
+    }
+
+    void BeginFrame() override { m_current ^= 1; }
+
+    void Record(ID3D12GraphicsCommandList* cl, const TemporalInputs& inputs) override
+    {
+        const float size[2] = { (float)m_width, (float)m_height };
+        UINT constants[8] =
+        {
+            inputs.colorSrv, inputs.depthSrv, inputs.motionSrv, m_srvs[m_current ^ 1], m_uavs[m_current],
+            0, 0, (inputs.reset || !m_valid) ? 1u : 0u,
+        };
+        memcpy(&constants[5], size, sizeof(size));
+        cl->SetComputeRoot32BitConstants(0, _countof(constants), constants, 0);   // b0, the draw constants
+        cl->SetPipelineState(m_pso->Get());
+        cl->Dispatch((m_width + 7) / 8, (m_height + 7) / 8, 1);
+        m_valid = true;
+    }
+
+    ID3D12Resource* Output() override { return m_textures[m_current]->resource.Get(); }
+    UINT            OutputSrv() override { return m_srvs[m_current]; }
+
+    void Shutdown() override
+    {
+        for (UINT i = 0; i < 2; ++i)
+        {
+            if (!m_textures[i])
+                continue;
+            m_descriptors->FreePersistent(m_srvs[i], 0);
+            m_descriptors->FreePersistent(m_uavs[i], 0);
+            m_allocator->Free(m_textures[i]);
+            m_textures[i] = nullptr;
+        }
+    }
+
+private:
+    GpuAllocator*                m_allocator;
+    DescriptorHeap*              m_descriptors;
+    ComPtr<ID3D12PipelineState>* m_pso;
+    GpuAllocation*               m_textures[2] = {};
+    UINT                         m_srvs[2] = { DescriptorHeap::kInvalid, DescriptorHeap::kInvalid };
+    UINT                         m_uavs[2] = { DescriptorHeap::kInvalid, DescriptorHeap::kInvalid };
+    UINT                         m_width   = 0;
+    UINT                         m_height  = 0;
+    UINT                         m_current = 0;
+    bool                         m_valid   = false;     // the other texture holds a real frame
+};
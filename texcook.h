@@ -0,0 +1,371 @@
+// ---------------------------------------------------------------
+// Texture cooking – RGBA8 image -> BC-compressed mip chain
+// ---------------------------------------------------------------
+// CookTexture() runs the whole pipeline:
+//
+//   mips       2x2 box filter down to 1x1, in float; normal maps are
+//              renormalized at every level so they don't flatten out
+//   BC7        mode 6 only – one subset, RGBA 7.7.7.7 endpoints with a shared
+//              bit each, 4 bit indices. Endpoints along the block's principal
+//              axis, then a least squares refit; all four shared-bit pairs
+//              are tried and the best kept. Not a match for a full
+//              8-mode search, but solid on the smooth, noisy stuff we have
+//   BC5        two BC4 channels, min/max endpoints, 8 value mode
+//   layout     TextureMip() (assetpak.h) – pitched rows of blocks, mips
+//              placed for a straight GPU copy
+//
+// Blocks are encoded over all cores; a 4K texture takes a few seconds.
+//
+// Plain std only – tools/assetcook runs it offline. The engine never cooks
+// textures itself: no archive, no textures.
+#pragma once
+
+#include "assetpak.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+struct TextureSource
+{
+    const char*          name;          // archive name
+    AssetTextureFormat   format;
+    bool                 normalMap;     // RGB holds a unit vector * 0.5 + 0.5
+    uint32_t             width;         // powers of two, >= 4
+    uint32_t             height;
+    std::vector<uint8_t> rgba;          // width * height * 4, top row first
+};
+
+struct CookedTexture
+{
+    TextureAssetMeta  meta{};
+    std::vector<char> blob;             // every mip at its TextureMip() offset
+};
+
+// ---- Mips ----
+
+inline std::vector<float> NextMip(const std::vector<float>& src, uint32_t width, uint32_t height, bool normalMap)
+{
+    const uint32_t w = width > 1 ? width / 2 : 1, h = height > 1 ? height / 2 : 1;
+    std::vector<float> dst((size_t)w * h * 4);
+    for (uint32_t y = 0; y < h; ++y)
+        for (uint32_t x = 0; x < w; ++x)
+        {
+            const uint32_t x0 = (std::min)(x * 2, width - 1), x1 = (std::min)(x * 2 + 1, width - 1);
+            const uint32_t y0 = (std::min)(y * 2, height - 1), y1 = (std::min)(y * 2 + 1, height - 1);
+            float* out = &dst[((size_t)y * w + x) * 4];
+            for (uint32_t c = 0; c < 4; ++c)
+                out[c] = 0.25f * (src[((size_t)y0 * width + x0) * 4 + c] + src[((size_t)y0 * width + x1) * 4 + c] +
+                                  src[((size_t)y1 * width + x0) * 4 + c] + src[((size_t)y1 * width + x1) * 4 + c]);
+            if (normalMap)
+            {
+                float n[3] = { out[0] * 2.0f - 1.0f, out[1] * 2.0f - 1.0f, out[2] * 2.0f - 1.0f };
+                const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                for (uint32_t c = 0; c < 3; ++c)
+                    out[c] = length > 1e-6f ? n[c] / length * 0.5f + 0.5f : (c == 2 ? 1.0f : 0.5f);
+            }
+        }
+    return dst;
+}
+
+// ---- BC7 ----
+
+static const int kBC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Little-endian bit writer over one 16 byte block
+struct BlockBits
+{
+    uint8_t* out;
+    uint32_t bit = 0;
+
+    void Put(uint32_t value, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i, ++bit)
+            if (value >> i & 1)
+                out[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+    }
+};
+
+struct BC7Candidate
+{
+    int      endpoints[2][4];       // 7 bit
+    int      pbits[2];
+    uint8_t  indices[16];
+    uint32_t error = UINT32_MAX;
+};
+
+// Quantizes two float endpoints with the given shared bits, then picks indices by projection
+inline void BC7Evaluate(const uint8_t px[16][4], const float lo[4], const float hi[4], int p0, int p1, BC7Candidate& best)
+{
+    BC7Candidate c;
+    c.pbits[0] = p0;
+    c.pbits[1] = p1;
+    int e[2][4];
+    for (int ch = 0; ch < 4; ++ch)
+    {
+        c.endpoints[0][ch] = std::clamp((int)std::lround((lo[ch] - (float)p0) * 0.5f), 0, 127);
+        c.endpoints[1][ch] = std::clamp((int)std::lround((hi[ch] - (float)p1) * 0.5f), 0, 127);
+        e[0][ch] = c.endpoints[0][ch] << 1 | p0;
+        e[1][ch] = c.endpoints[1][ch] << 1 | p1;
+    }
+
+    int palette[16][4];
+    for (int i = 0; i < 16; ++i)
+        for (int ch = 0; ch < 4; ++ch)
+            palette[i][ch] = ((64 - kBC7Weights[i]) * e[0][ch] + kBC7Weights[i] * e[1][ch] + 32) >> 6;
+
+    const float axis[4] = { (float)(e[1][0] - e[0][0]), (float)(e[1][1] - e[0][1]),
+                            (float)(e[1][2] - e[0][2]), (float)(e[1][3] - e[0][3]) };
+    const float axisLength2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+    uint32_t error = 0;
+    for (int p = 0; p < 16; ++p)
+    {
+        int index = 0;
+        if (axisLength2 > 0.0f)
+        {
+            float t = 0.0f;
+            for (int ch = 0; ch < 4; ++ch)
+                t += ((float)px[p][ch] - (float)e[0][ch]) * axis[ch];
+            index = std::clamp((int)std::lround(t / axisLength2 * 15.0f), 0, 15);
+        }
+        // The weights aren't quite even – the neighbours can be closer
+        uint32_t bestError = UINT32_MAX;
+        for (int candidate = (std::max)(index - 1, 0); candidate <= (std::min)(index + 1, 15); ++candidate)
+        {
+            uint32_t d = 0;
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                const int delta = (int)px[p][ch] - palette[candidate][ch];
+                d += (uint32_t)(delta * delta);
+            }
+            if (d < bestError)
+            {
+                bestError = d;
+                c.indices[p] = (uint8_t)candidate;
+            }
+        }
+        error += bestError;
+    }
+    c.error = error;
+    if (c.error < best.error)
+        best = c;
+}
+
+inline void BC7TryEndpoints(const uint8_t px[16][4], const float lo[4], const float hi[4], BC7Candidate& best)
+{
+    for (int p0 = 0; p0 < 2; ++p0)
+        for (int p1 = 0; p1 < 2; ++p1)
+            BC7Evaluate(px, lo, hi, p0, p1, best);
+}
+
+inline void EncodeBC7Block(const uint8_t px[16][4], uint8_t out[16])
+{
+    // Principal axis of the block, by power iteration on the covariance
+    float mean[4] = {};
+    for (int p = 0; p < 16; ++p)
+        for (int ch = 0; ch < 4; ++ch)
+            mean[ch] += (float)px[p][ch] * (1.0f / 16.0f);
+    float cov[4][4] = {};
+    for (int p = 0; p < 16; ++p)
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                cov[i][j] += ((float)px[p][i] - mean[i]) * ((float)px[p][j] - mean[j]);
+    float axis[4] = { 1.0f, 1.0f, 1.0f, 0.5f };
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                next[i] += cov[i][j] * axis[j];
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+        if (length < 1e-6f)
+            break;
+        for (int i = 0; i < 4; ++i)
+            axis[i] = next[i] / length;
+    }
+
+    float tMin = 1e9f, tMax = -1e9f;
+    for (int p = 0; p < 16; ++p)
+    {
+        float t = 0.0f;
+        for (int ch = 0; ch < 4; ++ch)
+            t += ((float)px[p][ch] - mean[ch]) * axis[ch];
+        tMin = (std::min)(tMin, t);
+        tMax = (std::max)(tMax, t);
+    }
+    float lo[4], hi[4];
+    for (int ch = 0; ch < 4; ++ch)
+    {
+        lo[ch] = std::clamp(mean[ch] + axis[ch] * tMin, 0.0f, 255.0f);
+        hi[ch] = std::clamp(mean[ch] + axis[ch] * tMax, 0.0f, 255.0f);
+    }
+    BC7Candidate best;
+    BC7TryEndpoints(px, lo, hi, best);
+
+    // Least squares refit to the indices we got: minimizes sum |(1-w)a + wb - p|^2
+    for (int refine = 0; refine < 2; ++refine)
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f, ap[4] = {}, bp[4] = {};
+        for (int p = 0; p < 16; ++p)
+        {
+            const float w = (float)kBC7Weights[best.indices[p]] / 64.0f;
+            aa += (1.0f - w) * (1.0f - w);
+            ab += (1.0f - w) * w;
+            bb += w * w;
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                ap[ch] += (1.0f - w) * (float)px[p][ch];
+                bp[ch] += w * (float)px[p][ch];
+            }
+        }
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f)
+            break;
+        for (int ch = 0; ch < 4; ++ch)
+        {
+            lo[ch] = std::clamp((ap[ch] * bb - bp[ch] * ab) / det, 0.0f, 255.0f);
+            hi[ch] = std::clamp((bp[ch] * aa - ap[ch] * ab) / det, 0.0f, 255.0f);
+        }
+        const uint32_t before = best.error;
+        BC7TryEndpoints(px, lo, hi, best);
+        if (best.error >= before)
+            break;
+    }
+
+    // The first index's top bit is implied 0 – swap the ends if it would be set
+    if (best.indices[0] >= 8)
+    {
+        for (int ch = 0; ch < 4; ++ch)
+            std::swap(best.endpoints[0][ch], best.endpoints[1][ch]);
+        std::swap(best.pbits[0], best.pbits[1]);
+        for (uint8_t& index : best.indices)
+            index = (uint8_t)(15 - index);
+    }
+
+    memset(out, 0, 16);
+    BlockBits bits{ out };
+    bits.Put(1u << 6, 7);                       // mode 6
+    for (int ch = 0; ch < 4; ++ch)
+    {
+        bits.Put((uint32_t)best.endpoints[0][ch], 7);
+        bits.Put((uint32_t)best.endpoints[1][ch], 7);
+    }
+    bits.Put((uint32_t)best.pbits[0], 1);
+    bits.Put((uint32_t)best.pbits[1], 1);
+    for (int p = 0; p < 16; ++p)
+        bits.Put(best.indices[p], p == 0 ? 3 : 4);
+}
+
+// ---- BC5 ----
+
+// One BC4 channel: red0 > red1 picks the 8 value mode
+inline void EncodeBC4Block(const uint8_t values[16], uint8_t out[8])
+{
+    uint8_t hi = 0, lo = 255;
+    for (int p = 0; p < 16; ++p)
+    {
+        hi = (std::max)(hi, values[p]);
+        lo = (std::min)(lo, values[p]);
+    }
+    memset(out, 0, 8);
+    BlockBits bits{ out };
+    if (hi == lo)
+    {
+        bits.Put(hi, 8);
+        bits.Put(lo, 8);                        // 6 value mode, every index 0 = red0
+        return;
+    }
+    bits.Put(hi, 8);
+    bits.Put(lo, 8);
+    for (int p = 0; p < 16; ++p)
+    {
+        // Palette order: red0, red1, then the six in between from red0 towards red1
+        const int step = (int)std::lround((float)(hi - values[p]) * 7.0f / (float)(hi - lo));
+        bits.Put((uint32_t)(step == 0 ? 0 : step == 7 ? 1 : step + 1), 3);
+    }
+}
+
+inline void EncodeBC5Block(const uint8_t px[16][4], uint8_t out[16])
+{
+    uint8_t channel[16];
+    for (int c = 0; c < 2; ++c)
+    {
+        for (int p = 0; p < 16; ++p)
+            channel[p] = px[p][c];
+        EncodeBC4Block(channel, out + c * 8);
+    }
+}
+
+// ---- Whole texture ----
+
+inline CookedTexture CookTexture(const TextureSource& source)
+{
+    const uint32_t width = source.width, height = source.height;
+    if (width < 4 || height < 4 || (width & (width - 1)) || (height & (height - 1)))
+        throw std::runtime_error("texture sizes have to be powers of two, 4 or more");
+    if (source.rgba.size() != (size_t)width * height * 4)
+        throw std::runtime_error("texture data doesn't match its size");
+
+    CookedTexture cooked;
+    cooked.meta.format   = source.format;
+    cooked.meta.width    = width;
+    cooked.meta.height   = height;
+    cooked.meta.mipCount = 1;
+    while ((width | height) >> cooked.meta.mipCount)
+        ++cooked.meta.mipCount;
+    const TextureMipLayout last = TextureMip(cooked.meta, cooked.meta.mipCount - 1);
+    cooked.blob.assign((size_t)(last.offset + last.size), 0);
+
+    std::vector<float> level(source.rgba.begin(), source.rgba.end());
+    for (float& value : level)
+        value *= 1.0f / 255.0f;
+
+    const unsigned threads = (std::max)(1u, std::thread::hardware_concurrency());
+    for (uint32_t mip = 0; mip < cooked.meta.mipCount; ++mip)
+    {
+        const TextureMipLayout layout = TextureMip(cooked.meta, mip);
+        const uint32_t blocksWide = (layout.width + 3) / 4;
+        uint8_t* const dst = reinterpret_cast<uint8_t*>(cooked.blob.data()) + layout.offset;
+
+        // Rows of blocks, interleaved over the threads; edges clamp for mips under 4 texels
+        auto encodeRows = [&](uint32_t first)
+        {
+            uint8_t px[16][4];
+            for (uint32_t by = first; by < layout.rows; by += threads)
+                for (uint32_t bx = 0; bx < blocksWide; ++bx)
+                {
+                    for (uint32_t p = 0; p < 16; ++p)
+                    {
+                        const uint32_t x = (std::min)(bx * 4 + p % 4, layout.width - 1);
+                        const uint32_t y = (std::min)(by * 4 + p / 4, layout.height - 1);
+                        for (uint32_t c = 0; c < 4; ++c)
+                            px[p][c] = (uint8_t)std::lround(std::clamp(level[((size_t)y * layout.width + x) * 4 + c],
+                                                                       0.0f, 1.0f) * 255.0f);
+                    }
+                    uint8_t* block = dst + (size_t)by * layout.rowPitch + (size_t)bx * kTextureBlockBytes;
+                    if (source.format == kTextureBC7)
+                        EncodeBC7Block(px, block);
+                    else
+                        EncodeBC5Block(px, block);
+                }
+        };
+        if (layout.rows < 64)
+            for (uint32_t first = 0; first < threads; ++first)
+                encodeRows(first);
+        else
+        {
+            std::vector<std::thread> workers;
+            for (uint32_t first = 0; first < threads; ++first)
+                workers.emplace_back(encodeRows, first);
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+
+        if (mip + 1 < cooked.meta.mipCount)
+            level = NextMip(level, layout.width, layout.height, source.normalMap);
+    }
+    return cooked;
+}
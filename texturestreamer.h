@@ -0,0 +1,463 @@
+// ---------------------------------------------------------------
+// Texture streaming – reserved textures, mips paged in on feedback
+// ---------------------------------------------------------------
+// Every texture is a reserved (tiled) resource with its whole mip chain, but
+// only what's been sampled lately has memory behind it. Tiles come from a
+// pool of 64KB tiles in 16MB heaps, grown on demand up to the budget.
+//
+//   - The mip tail (the packed small mips, or just the last mip when the
+//     hardware packs none) is mapped and loaded by Add() and never leaves.
+//   - Shaders (shaders/texturestream.hlsli) InterlockedMin the mip they
+//     wanted into a feedback buffer, one uint per texture. It's reset and
+//     copied back every frame, and Update() reads a slot's copy once that
+//     slot's fence has passed.
+//   - A texture that wants finer than it has gets the next finer mip, one
+//     at a time, coarse to fine. A mip nobody asked for in kEvictFrames is
+//     dropped, and when the pool is full the least recently wanted one goes.
+//
+// Shaders clamp sampling to the texture table's minLod, so an unmapped tile
+// is never touched. Tile mappings go to the uploader's copy queue, which
+// orders them against the mip uploads (assetstreamer.h); unmapping waits for
+// the frame fence, so nothing in flight still reads the mip.
+#pragma once
+
+#include "assetstreamer.h"
+#include "descriptors.h"
+#include "dxhelpers.h"
+#include "gpuallocator.h"
+#include "uploader.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Texture table entry, mirrors TextureInfo in shaders/texturestream.hlsli
+struct TextureTableEntry
+{
+    UINT  srv;          // ~0 until the tail is resident
+    float minLod;       // finest resident mip
+    UINT  pad[2];
+};
+static_assert(sizeof(TextureTableEntry) == 16, "TextureTableEntry must match the HLSL layout");
+
+class TextureStreamer
+{
+public:
+    static const UINT   kMaxTextures   = 64;
+    static const UINT   kMaxMips       = 16;
+    static const UINT   kMaxSlots      = 3;
+    static const UINT64 kTileSize      = D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+    static const UINT64 kPoolHeapSize  = 16ull * 1024 * 1024;
+    static const UINT   kTilesPerHeap  = (UINT)(kPoolHeapSize / kTileSize);
+    static const UINT   kEvictFrames   = 120;   // unasked-for this long and a mip goes
+    static const UINT   kMinKeepFrames = 8;     // never evicted for room sooner than this
+
+    struct Stats
+    {
+        UINT   textures      = 0;
+        UINT   pendingLoads  = 0;
+        UINT64 residentBytes = 0;       // tiles mapped to textures
+        UINT64 poolBytes     = 0;       // heaps created so far
+        UINT64 budgetBytes   = 0;
+        UINT64 evictions     = 0;
+    };
+
+    // False without tiled resources – the caller leaves textures off
+    bool Init(ID3D12Device* device, GpuAllocator* allocator, DescriptorHeap* descriptors, Uploader* uploader,
+              AssetStreamer* assets, UINT64 budget, UINT slotCount)
+    {
+        D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+        if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) ||
+            options.TiledResourcesTier == D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED)
+            return false;
+
+        m_device      = device;
+        m_allocator   = allocator;
+        m_descriptors = descriptors;
+        m_uploader    = uploader;
+        m_assets      = assets;
+        m_slotCount   = (std::min)(slotCount, kMaxSlots);
+        m_stats.budgetBytes = (std::max)(budget / kPoolHeapSize, 1ull) * kPoolHeapSize;
+
+        // Feedback: cleared by a copy from a buffer of ~0s, copied back into one readback slot a frame
+        const UINT64 feedbackSize = kMaxTextures * sizeof(UINT);
+        m_feedback = allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, feedbackSize, D3D12_RESOURCE_STATE_COMMON,
+                                             D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        m_feedbackUav = descriptors->AllocatePersistent();
+        descriptors->CreateRawBufferUav(m_feedbackUav, m_feedback->resource.Get(), 0, feedbackSize);
+
+        m_feedbackClear = allocator->CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, feedbackSize, D3D12_RESOURCE_STATE_GENERIC_READ);
+        void* clear = nullptr;
+        D3D12_RANGE noRead{ 0, 0 };
+        ThrowIfFailed(m_feedbackClear->resource->Map(0, &noRead, &clear));
+        memset(clear, 0xff, feedbackSize);
+        m_feedbackClear->resource->Unmap(0, nullptr);
+
+        m_readback = allocator->CreateBuffer(D3D12_HEAP_TYPE_READBACK, feedbackSize * m_slotCount,
+                                             D3D12_RESOURCE_STATE_COPY_DEST);
+        ThrowIfFailed(m_readback->resource->Map(0, nullptr, reinterpret_cast<void**>(&m_readbackCpu)));
+
+        // Texture table, one copy per slot, each with its own view
+        const UINT64 tableSize = kMaxTextures * sizeof(TextureTableEntry);
+        m_table = allocator->CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, tableSize * m_slotCount,
+                                          D3D12_RESOURCE_STATE_GENERIC_READ);
+        ThrowIfFailed(m_table->resource->Map(0, &noRead, reinterpret_cast<void**>(&m_tableCpu)));
+        for (UINT slot = 0; slot < m_slotCount; ++slot)
+        {
+            m_tableSrv[slot] = descriptors->AllocatePersistent();
+            descriptors->CreateRawBufferSrv(m_tableSrv[slot], m_table->resource.Get(), slot * tableSize, tableSize);
+        }
+
+        m_textures.reserve(kMaxTextures);
+        m_coordinates.reserve(kTilesPerHeap);
+        m_regionSizes.reserve(kTilesPerHeap);
+        m_heapOffsets.reserve(kTilesPerHeap);
+        m_rangeCounts.reserve(kTilesPerHeap);
+        m_enabled = true;
+        return true;
+    }
+
+    void Shutdown()
+    {
+        if (!m_enabled)
+            return;
+        for (Texture& texture : m_textures)
+            texture.resource.Reset();
+        m_textures.clear();
+        m_heaps.clear();
+        m_allocator->Free(m_feedback);
+        m_allocator->Free(m_feedbackClear);
+        m_allocator->Free(m_readback);
+        m_allocator->Free(m_table);
+        m_enabled = false;
+    }
+
+    bool Enabled() const { return m_enabled; }
+
+    // A kAssetTexture entry – its tail starts loading now. Returns the shaders' texture index.
+    UINT Add(const AssetPakEntry* entry)
+    {
+        if (m_textures.size() == kMaxTextures)
+            throw std::runtime_error("Too many streamed textures");
+        const TextureAssetMeta meta = ReadAssetMeta<TextureAssetMeta>(*entry);
+        if (entry->type != kAssetTexture || meta.mipCount == 0 || meta.mipCount > kMaxMips)
+            throw std::runtime_error(std::string("Not a streamable texture: ") + entry->name);
+
+        Texture& texture = m_textures.emplace_back();
+        texture.entry = entry;
+        texture.meta  = meta;
+
+        D3D12_RESOURCE_DESC desc = Texture2DDesc(meta.format == kTextureBC5 ? DXGI_FORMAT_BC5_UNORM : DXGI_FORMAT_BC7_UNORM,
+                                                 meta.width, meta.height, (UINT16)meta.mipCount);
+        desc.Layout = D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
+        ThrowIfFailed(m_device->CreateReservedResource(&desc, D3D12_RESOURCE_STATE_COMMON, nullptr,
+                                                       IID_PPV_ARGS(&texture.resource)));
+
+        UINT                   tileCount = 0, tilingCount = meta.mipCount;
+        D3D12_PACKED_MIP_INFO  packed{};
+        D3D12_TILE_SHAPE       shape{};
+        m_device->GetResourceTiling(texture.resource.Get(), &tileCount, &packed, &shape, &tilingCount, 0,
+                                    texture.tilings);
+        texture.standardMips = packed.NumStandardMips;
+        texture.tailFirst    = packed.NumPackedMips ? packed.NumStandardMips : meta.mipCount - 1;
+        texture.residentMip  = meta.mipCount;       // nothing until the tail lands
+        texture.srv          = m_descriptors->AllocatePersistent();
+        m_descriptors->CreateTextureSrv(texture.srv, texture.resource.Get());
+
+        // The tail – small, and what every texture falls back to
+        const UINT tailTiles = packed.NumPackedMips ? packed.NumTilesForPackedMips : TileCount(texture, texture.tailFirst);
+        if (!AllocateTiles(tailTiles, texture.tiles[texture.tailFirst]))
+            throw std::runtime_error("Texture budget can't even hold the mip tails");
+        MapTiles(texture, texture.tailFirst, false);
+        for (UINT mip = texture.tailFirst; mip < meta.mipCount; ++mip)
+            texture.loads[mip] = m_assets->RequestTextureMip(entry, texture.resource.Get(), mip,
+                                                             AssetStreamer::kPriorityHigh);
+        texture.loadingMip = texture.tailFirst;
+        return (UINT)m_textures.size() - 1;
+    }
+
+    // Once a frame, after the slot's fence wait. frameFence is the value this frame will signal.
+    void Update(UINT slot, UINT64 frameFence, UINT64 completedFence)
+    {
+        if (!m_enabled)
+            return;
+        ++m_frame;
+
+        // Evicted mips nothing in flight can sample any more – unmap, and their tiles are free again
+        while (!m_unmaps.empty() && m_unmaps.front().fence <= completedFence)
+        {
+            const PendingUnmap unmap = m_unmaps.front();
+            m_unmaps.erase(m_unmaps.begin());
+            Texture& texture = m_textures[unmap.texture];
+            MapTiles(texture, unmap.mip, true);
+            texture.unmapping &= ~(1u << unmap.mip);
+            m_freeTiles.insert(m_freeTiles.end(), texture.tiles[unmap.mip].begin(), texture.tiles[unmap.mip].end());
+            texture.tiles[unmap.mip].clear();
+        }
+
+        // What the frame that last used this slot sampled
+        if (m_readbackPending[slot])
+        {
+            const UINT* wanted = m_readbackCpu + slot * kMaxTextures;
+            for (size_t i = 0; i < m_textures.size(); ++i)
+            {
+                Texture& texture = m_textures[i];
+                if (wanted[i] == ~0u)
+                    continue;
+                for (UINT mip = (std::min)(wanted[i], texture.meta.mipCount - 1); mip < texture.meta.mipCount; ++mip)
+                    texture.lastWanted[mip] = m_frame;
+            }
+            m_readbackPending[slot] = false;
+        }
+
+        m_stats.pendingLoads = 0;
+        for (UINT i = 0; i < (UINT)m_textures.size(); ++i)
+        {
+            Texture& texture = m_textures[i];
+            if (texture.loadingMip != kNone)
+            {
+                if (!Loaded(texture))
+                {
+                    ++m_stats.pendingLoads;
+                    continue;
+                }
+                texture.residentMip = texture.loadingMip;
+                texture.loadingMip  = kNone;
+            }
+
+            // Idle – the finest mip goes first, the tail never does
+            if (texture.residentMip < texture.tailFirst &&
+                m_frame - texture.lastWanted[texture.residentMip] > kEvictFrames)
+            {
+                Evict(i, frameFence);
+                continue;
+            }
+
+            // Wants finer: the next mip down, if there's room or room can be made – and it isn't still coming out
+            if (texture.residentMip == 0 || texture.lastWanted[texture.residentMip - 1] != m_frame)
+                continue;
+            const UINT mip = texture.residentMip - 1;
+            if (texture.unmapping & (1u << mip))
+                continue;
+            if (!AllocateTiles(TileCount(texture, mip), texture.tiles[mip]))
+            {
+                EvictForRoom(i, frameFence);
+                continue;
+            }
+            MapTiles(texture, mip, false);
+            texture.loads[mip] = m_assets->RequestTextureMip(texture.entry, texture.resource.Get(), mip,
+                                                             AssetStreamer::kPriorityNormal);
+            texture.loadingMip = mip;
+            ++m_stats.pendingLoads;
+        }
+
+        // This frame's table
+        TextureTableEntry* table = reinterpret_cast<TextureTableEntry*>(m_tableCpu) + slot * kMaxTextures;
+        for (size_t i = 0; i < m_textures.size(); ++i)
+        {
+            const Texture& texture = m_textures[i];
+            const bool     ready   = texture.residentMip < texture.meta.mipCount;
+            table[i] = { ready ? texture.srv : DescriptorHeap::kInvalid, (float)texture.residentMip, { 0, 0 } };
+        }
+    }
+
+    // Graph passes: before anything samples, and after the last thing that did
+    void RecordFeedbackReset(ID3D12GraphicsCommandList* cl)
+    {
+        cl->CopyBufferRegion(m_feedback->resource.Get(), 0, m_feedbackClear->resource.Get(), 0,
+                             kMaxTextures * sizeof(UINT));
+    }
+
+    void RecordFeedbackReadback(ID3D12GraphicsCommandList* cl, UINT slot)
+    {
+        cl->CopyBufferRegion(m_readback->resource.Get(), slot * kMaxTextures * sizeof(UINT),
+                             m_feedback->resource.Get(), 0, kMaxTextures * sizeof(UINT));
+        m_readbackPending[slot] = true;
+    }
+
+    ID3D12Resource* FeedbackBuffer() const { return m_enabled ? m_feedback->resource.Get() : nullptr; }
+    UINT FeedbackUav() const { return m_enabled ? m_feedbackUav : DescriptorHeap::kInvalid; }
+    UINT TableSrv(UINT slot) const { return m_enabled ? m_tableSrv[slot] : DescriptorHeap::kInvalid; }
+
+    Stats GetStats() const
+    {
+        Stats stats          = m_stats;
+        stats.textures       = (UINT)m_textures.size();
+        stats.poolBytes      = m_heaps.size() * kPoolHeapSize;
+        stats.residentBytes  = stats.poolBytes - m_freeTiles.size() * kTileSize;
+        return stats;
+    }
+
+private:
+    static const UINT kNone = ~0u;
+
+    struct Texture
+    {
+        const AssetPakEntry*     entry        = nullptr;
+        TextureAssetMeta         meta{};
+        ComPtr<ID3D12Resource>   resource;
+        UINT                     srv          = DescriptorHeap::kInvalid;
+        UINT                     standardMips = 0;          // the rest share the packed tail
+        UINT                     tailFirst    = 0;          // first mip that's always resident
+        UINT                     residentMip  = 0;          // finest one with data, = mipCount before the tail
+        UINT                     loadingMip   = kNone;
+        D3D12_SUBRESOURCE_TILING tilings[kMaxMips]{};
+        std::vector<UINT>        tiles[kMaxMips];           // pool tiles per mip; the tail's live at tailFirst
+        AssetStreamer::Handle    loads[kMaxMips]{};
+        uint64_t                 lastWanted[kMaxMips]{};    // frame feedback last asked for this mip or finer
+        UINT                     unmapping    = 0;          // bit per mip evicted but not unmapped yet
+    };
+
+    struct PendingUnmap
+    {
+        UINT   texture;
+        UINT   mip;
+        UINT64 fence;
+    };
+
+    UINT TileCount(const Texture& texture, UINT mip) const
+    {
+        return texture.tilings[mip].WidthInTiles * texture.tilings[mip].HeightInTiles * texture.tilings[mip].DepthInTiles;
+    }
+
+    // The mip in flight – for the tail, every mip in it
+    bool Loaded(const Texture& texture) const
+    {
+        const UINT end = texture.loadingMip == texture.tailFirst ? texture.meta.mipCount : texture.loadingMip + 1;
+        for (UINT mip = texture.loadingMip; mip < end; ++mip)
+            if (!m_assets->IsReady(texture.loads[mip]))
+                return false;
+        return true;
+    }
+
+    // Grows the pool a heap at a time while the budget allows; all or nothing
+    bool AllocateTiles(UINT count, std::vector<UINT>& out)
+    {
+        while (m_freeTiles.size() < count && (m_heaps.size() + 1) * kPoolHeapSize <= m_stats.budgetBytes)
+        {
+            D3D12_HEAP_DESC desc{};
+            desc.SizeInBytes     = kPoolHeapSize;
+            desc.Properties      = HeapProperties(D3D12_HEAP_TYPE_DEFAULT);
+            desc.Alignment       = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+            desc.Flags           = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+            ComPtr<ID3D12Heap> heap;
+            ThrowIfFailed(m_device->CreateHeap(&desc, IID_PPV_ARGS(&heap)));
+            const UINT first = (UINT)m_heaps.size() * kTilesPerHeap;
+            m_heaps.push_back(heap);
+            for (UINT i = kTilesPerHeap; i-- > 0;)
+                m_freeTiles.push_back(first + i);
+        }
+        if (m_freeTiles.size() < count)
+            return false;
+        out.assign(m_freeTiles.end() - count, m_freeTiles.end());
+        m_freeTiles.resize(m_freeTiles.size() - count);
+        std::sort(out.begin(), out.end());      // runs per heap in MapTiles
+        return true;
+    }
+
+    // One UpdateTileMappings per heap the mip's tiles come from, or one NULL mapping for the lot
+    void MapTiles(const Texture& texture, UINT mip, bool unmap)
+    {
+        ID3D12CommandQueue* queue = m_uploader->Queue();
+        const bool          tail  = mip >= texture.standardMips;
+        const std::vector<UINT>& tiles = texture.tiles[mip];
+        if (unmap)
+        {
+            const D3D12_TILED_RESOURCE_COORDINATE coordinate{ 0, 0, 0, mip };
+            D3D12_TILE_REGION_SIZE size{};
+            size.NumTiles = (UINT)tiles.size();
+            const D3D12_TILE_RANGE_FLAGS flag = D3D12_TILE_RANGE_FLAG_NULL;
+            queue->UpdateTileMappings(texture.resource.Get(), 1, &coordinate, &size, nullptr, 1, &flag,
+                                      nullptr, nullptr, D3D12_TILE_MAPPING_FLAG_NONE);
+            return;
+        }
+
+        // Standard mips tile row by row; packed tiles are just numbered, on the first packed subresource
+        const UINT width = tail ? 1 : texture.tilings[mip].WidthInTiles;
+        for (size_t begin = 0; begin < tiles.size();)
+        {
+            const UINT heap = tiles[begin] / kTilesPerHeap;
+            m_coordinates.clear();
+            m_regionSizes.clear();
+            m_heapOffsets.clear();
+            m_rangeCounts.clear();
+            size_t end = begin;
+            for (; end < tiles.size() && tiles[end] / kTilesPerHeap == heap; ++end)
+            {
+                const UINT i = (UINT)end;
+                m_coordinates.push_back(tail ? D3D12_TILED_RESOURCE_COORDINATE{ i, 0, 0, mip }
+                                             : D3D12_TILED_RESOURCE_COORDINATE{ i % width, i / width, 0, mip });
+                D3D12_TILE_REGION_SIZE size{};
+                size.NumTiles = 1;
+                m_regionSizes.push_back(size);
+                m_heapOffsets.push_back(tiles[end] % kTilesPerHeap);
+                m_rangeCounts.push_back(1);
+            }
+            queue->UpdateTileMappings(texture.resource.Get(), (UINT)m_coordinates.size(), m_coordinates.data(),
+                                      m_regionSizes.data(), m_heaps[heap].Get(), (UINT)m_heapOffsets.size(),
+                                      nullptr, m_heapOffsets.data(), m_rangeCounts.data(),
+                                      D3D12_TILE_MAPPING_FLAG_NONE);
+            begin = end;
+        }
+    }
+
+    // The table stops pointing at the mip this frame; the tiles follow once the frame is done
+    void Evict(UINT index, UINT64 frameFence)
+    {
+        Texture& texture = m_textures[index];
+        m_unmaps.push_back({ index, texture.residentMip, frameFence });
+        texture.unmapping |= 1u << texture.residentMip;
+        ++texture.residentMip;
+        ++m_stats.evictions;
+    }
+
+    // Pool's full: the finest mip of whichever texture wanted its own least recently, if that wasn't just now
+    void EvictForRoom(UINT requester, UINT64 frameFence)
+    {
+        UINT     victim = kNone;
+        uint64_t oldest = m_frame > kMinKeepFrames ? m_frame - kMinKeepFrames : 0;
+        for (UINT i = 0; i < (UINT)m_textures.size(); ++i)
+        {
+            const Texture& texture = m_textures[i];
+            if (i == requester || texture.loadingMip != kNone || texture.residentMip >= texture.tailFirst)
+                continue;
+            if (texture.lastWanted[texture.residentMip] < oldest)
+            {
+                oldest = texture.lastWanted[texture.residentMip];
+                victim = i;
+            }
+        }
+        if (victim != kNone)
+            Evict(victim, frameFence);
+    }
+
+    ID3D12Device*                m_device      = nullptr;
+    GpuAllocator*                m_allocator   = nullptr;
+    DescriptorHeap*              m_descriptors = nullptr;
+    Uploader*                    m_uploader    = nullptr;
+    AssetStreamer*               m_assets      = nullptr;
+    bool                         m_enabled     = false;
+    UINT                         m_slotCount   = 0;
+    uint64_t                     m_frame       = 0;
+    Stats                        m_stats;
+
+    std::vector<Texture>         m_textures;
+    std::vector<ComPtr<ID3D12Heap>> m_heaps;
+    std::vector<UINT>            m_freeTiles;               // heap * kTilesPerHeap + tile
+    std::vector<PendingUnmap>    m_unmaps;                  // in fence order
+
+    GpuAllocation*               m_feedback      = nullptr;
+    GpuAllocation*               m_feedbackClear = nullptr;
+    GpuAllocation*               m_readback      = nullptr;
+    GpuAllocation*               m_table         = nullptr;
+    UINT                         m_feedbackUav   = DescriptorHeap::kInvalid;
+    UINT                         m_tableSrv[kMaxSlots];
+    UINT*                        m_readbackCpu   = nullptr;
+    UINT8*                       m_tableCpu      = nullptr;
+    bool                         m_readbackPending[kMaxSlots] = {};
+
+    // Reused by MapTiles
+    std::vector<D3D12_TILED_RESOURCE_COORDINATE> m_coordinates;
+    std::vector<D3D12_TILE_REGION_SIZE>          m_regionSizes;
+    std::vector<UINT>                            m_heapOffsets;
+    std::vector<UINT>                            m_rangeCounts;
+};
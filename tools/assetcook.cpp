@@ -0,0 +1,189 @@
+// ---------------------------------------------------------------
+// assetcook – offline asset build step
+// ---------------------------------------------------------------
+// Bakes the scene's meshes and textures into the archive the engine streams
+// from (assetpak.h). Payloads are written exactly as the GPU wants them –
+// meshes go through CookMesh() (meshcook.h) first, textures through
+// CookTexture() (texcook.h).
+//
+//   assetcook assets.pak [--gdeflate]
+//
+// --gdeflate compresses entries for DirectStorage's GPU decompression –
+// textures excepted, they are read a mip at a time. It needs the DirectStorage SDK, so it's only there when built with it:
+//
+// Build: cl /EHsc /std:c++20 /O2 tools\assetcook.cpp /Fe:tools\assetcook.exe
+//        (add /DUSE_DIRECTSTORAGE /I<sdk>\include <sdk>\lib\x64\dstorage.lib for --gdeflate)
+#include "../assetpak.h"
+#include "../meshcook.h"
+#include "../scenetextures.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(USE_DIRECTSTORAGE)
+#include <dstorage.h>
+#include <wrl/client.h>
+#pragma comment(lib, "dstorage.lib")
+
+// Falls back to storing the blob if compressing doesn't make it smaller
+static bool CompressGDeflate(const std::vector<char>& in, std::vector<char>& out)
+{
+    static Microsoft::WRL::ComPtr<IDStorageCompressionCodec> codec;
+    if (!codec && FAILED(DStorageCreateCompressionCodec(DSTORAGE_COMPRESSION_FORMAT_GDEFLATE, 0, IID_PPV_ARGS(&codec))))
+        return false;
+    out.resize(codec->CompressBufferBound((UINT32)in.size()));
+    size_t written = 0;
+    if (FAILED(codec->CompressBuffer(in.data(), in.size(), DSTORAGE_COMPRESSION_BEST_RATIO, out.data(), out.size(), &written)))
+        return false;
+    out.resize(written);
+    return written < in.size();
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: assetcook <out.pak> [--gdeflate]\n");
+        return 1;
+    }
+
+    bool gdeflate = false;
+    for (int i = 2; i < argc; ++i)
+        if (!strcmp(argv[i], "--gdeflate")) gdeflate = true;
+#if !defined(USE_DIRECTSTORAGE)
+    if (gdeflate)
+    {
+        fprintf(stderr, "assetcook: --gdeflate needs a build with USE_DIRECTSTORAGE\n");
+        return 1;
+    }
+#endif
+
+    std::vector<AssetPakEntry>     entries;
+    std::vector<std::vector<char>> blobs;
+
+    auto add = [&](const std::string& name, AssetType type, std::vector<char> blob, const auto& meta)
+    {
+        if (name.size() >= sizeof(AssetPakEntry::name))
+        {
+            fprintf(stderr, "assetcook: name too long: %s\n", name.c_str());
+            exit(1);
+        }
+
+        AssetPakEntry e{};
+        e.nameHash    = HashString(name.c_str());
+        e.size        = blob.size();
+        e.storedSize  = blob.size();
+        e.type        = type;
+        e.compression = kAssetCompressionNone;
+        WriteAssetMeta(e, meta);
+        memcpy(e.name, name.data(), name.size());
+
+#if defined(USE_DIRECTSTORAGE)
+        std::vector<char> compressed;
+        if (gdeflate && type != kAssetTexture && CompressGDeflate(blob, compressed))
+        {
+            e.storedSize  = compressed.size();
+            e.compression = kAssetCompressionGDeflate;
+            blob          = std::move(compressed);
+        }
+#endif
+        printf("%-24s %8llu -> %8llu bytes\n", e.name, (unsigned long long)e.size, (unsigned long long)e.storedSize);
+        entries.push_back(e);
+        blobs.push_back(std::move(blob));
+    };
+
+    for (const MeshSource& mesh : BuildSceneMeshes())
+    {
+        CookedMesh cooked;
+        try
+        {
+            cooked = CookMesh(mesh.vertices);
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "assetcook: %s: %s\n", mesh.name, e.what());
+            return 1;
+        }
+        printf("%-24s %zu corners -> %u vertices, %u triangles, %u meshlets, ACMR %.2f -> %.2f\n", mesh.name,
+               mesh.vertices.size(), cooked.meta.vertexCount, cooked.meta.indexCount / 3, cooked.meta.meshletCount,
+               cooked.acmrBefore, cooked.acmrAfter);
+
+        add(mesh.name, kAssetMesh, MeshBlob(cooked), cooked.meta);
+        const MeshletAssetMeta meshletMeta{ (uint32_t)cooked.meshlets.size(), (uint32_t)cooked.meshletVertices.size(),
+                                            (uint32_t)cooked.meshletTriangles.size() };
+        add(std::string(mesh.name) + "/meshlets", kAssetMeshlets, MeshletBlob(cooked), meshletMeta);
+    }
+
+    for (const TextureSource& texture : BuildSceneTextures())
+    {
+        CookedTexture cooked;
+        try
+        {
+            cooked = CookTexture(texture);
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "assetcook: %s: %s\n", texture.name, e.what());
+            return 1;
+        }
+        printf("%-24s %ux%u %s, %u mips\n", texture.name, cooked.meta.width, cooked.meta.height,
+               cooked.meta.format == kTextureBC7 ? "BC7" : "BC5", cooked.meta.mipCount);
+        add(texture.name, kAssetTexture, std::move(cooked.blob), cooked.meta);
+    }
+
+    // Sort by hash so the runtime can binary search, and refuse collisions
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return entries[a].nameHash < entries[b].nameHash; });
+    for (size_t i = 1; i < order.size(); ++i)
+    {
+        if (entries[order[i]].nameHash == entries[order[i - 1]].nameHash)
+        {
+            fprintf(stderr, "assetcook: duplicate or colliding name %s / %s\n",
+                    entries[order[i]].name, entries[order[i - 1]].name);
+            return 1;
+        }
+    }
+
+    uint64_t offset = sizeof(AssetPakHeader) + sizeof(AssetPakEntry) * entries.size();
+    std::vector<AssetPakEntry> sorted;
+    for (size_t i : order)
+    {
+        offset = (offset + kAssetPakAlignment - 1) & ~(kAssetPakAlignment - 1);
+        AssetPakEntry e = entries[i];
+        e.offset = offset;
+        offset  += e.storedSize;
+        sorted.push_back(e);
+    }
+
+    std::ofstream out(argv[1], std::ios::binary);
+    AssetPakHeader header{ kAssetPakMagic, kAssetPakVersion, (uint32_t)sorted.size(), 0 };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sorted.data()), sizeof(AssetPakEntry) * sorted.size());
+
+    uint64_t written = sizeof(AssetPakHeader) + sizeof(AssetPakEntry) * sorted.size();
+    const std::vector<char> zeros(kAssetPakAlignment);
+    for (size_t n = 0; n < order.size(); ++n)
+    {
+        out.write(zeros.data(), (std::streamsize)(sorted[n].offset - written));
+        out.write(blobs[order[n]].data(), (std::streamsize)blobs[order[n]].size());
+        written = sorted[n].offset + sorted[n].storedSize;
+    }
+    // Pad the tail too, so the last blob can be read in whole sectors
+    out.write(zeros.data(), (std::streamsize)(((written + kAssetPakAlignment - 1) & ~(kAssetPakAlignment - 1)) - written));
+
+    if (!out)
+    {
+        fprintf(stderr, "assetcook: failed to write %s\n", argv[1]);
+        return 1;
+    }
+    printf("assetcook: %zu assets -> %s\n", sorted.size(), argv[1]);
+    return 0;
+}
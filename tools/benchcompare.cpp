@@ -0,0 +1,240 @@
+// ---------------------------------------------------------------
+// benchcompare – checks a benchmark result against a baseline
+// ---------------------------------------------------------------
+// Reads two files main.exe --benchmark wrote (benchmark.h) and compares
+// every frame time percentile and memory high-water mark in them. Higher is
+// worse for all of them; anything over the baseline by more than the
+// tolerance is a regression and the exit code says so.
+//
+//   benchcompare <baseline.json> <result.json> [--tolerance=0.1] [--min-ms=0.05] [--update]
+//
+// --tolerance  relative slack, 0.1 = 10%
+// --min-ms     absolute slack on timings, so a 0.02 ms pass can't fail on noise
+// --update     make the result the new baseline (also what happens when there is none yet)
+//
+// Exit code: 0 ok, 1 regression, 2 bad arguments or unreadable files.
+//
+// Build: cl /EHsc /std:c++20 /O2 tools\benchcompare.cpp /Fe:tools\benchcompare.exe
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// "a": { "b": 1 } -> out["a.b"] = "1"; values are kept as their text
+class FlatJson
+{
+public:
+    bool Parse(const std::string& text, std::map<std::string, std::string>& out)
+    {
+        m_text = &text;
+        m_pos  = 0;
+        m_out  = &out;
+        Skip();
+        if (!Value(""))
+            return false;
+        Skip();
+        return m_pos == text.size();
+    }
+
+private:
+    void Skip()
+    {
+        while (m_pos < m_text->size() && isspace((unsigned char)(*m_text)[m_pos]))
+            ++m_pos;
+    }
+
+    bool String(std::string& out)
+    {
+        if ((*m_text)[m_pos] != '"')
+            return false;
+        for (++m_pos; m_pos < m_text->size(); ++m_pos)
+        {
+            const char c = (*m_text)[m_pos];
+            if (c == '"')
+            {
+                ++m_pos;
+                return true;
+            }
+            if (c == '\\' && ++m_pos == m_text->size())
+                return false;
+            out += (*m_text)[m_pos];
+        }
+        return false;
+    }
+
+    bool Value(const std::string& path)
+    {
+        if (m_pos >= m_text->size())
+            return false;
+        const char c = (*m_text)[m_pos];
+        if (c == '{')
+        {
+            ++m_pos;
+            Skip();
+            if ((*m_text)[m_pos] == '}')
+            {
+                ++m_pos;
+                return true;
+            }
+            while (true)
+            {
+                std::string key;
+                Skip();
+                if (!String(key))
+                    return false;
+                Skip();
+                if (m_pos >= m_text->size() || (*m_text)[m_pos++] != ':')
+                    return false;
+                Skip();
+                if (!Value(path.empty() ? key : path + "." + key))
+                    return false;
+                Skip();
+                if (m_pos >= m_text->size())
+                    return false;
+                const char next = (*m_text)[m_pos++];
+                if (next == '}')
+                    return true;
+                if (next != ',')
+                    return false;
+            }
+        }
+        if (c == '"')
+        {
+            std::string value;
+            if (!String(value))
+                return false;
+            (*m_out)[path] = value;
+            return true;
+        }
+        // Number, true, false – no arrays in our files
+        const size_t start = m_pos;
+        while (m_pos < m_text->size() && (isalnum((unsigned char)(*m_text)[m_pos]) ||
+                                          strchr("+-.", (*m_text)[m_pos])))
+            ++m_pos;
+        if (m_pos == start)
+            return false;
+        (*m_out)[path] = m_text->substr(start, m_pos - start);
+        return true;
+    }
+
+    const std::string*                  m_text = nullptr;
+    size_t                              m_pos  = 0;
+    std::map<std::string, std::string>* m_out  = nullptr;
+};
+
+static bool Load(const fs::path& path, std::map<std::string, std::string>& out)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return FlatJson().Parse(text, out);
+}
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+    const size_t n = strlen(suffix);
+    return s.size() >= n && !s.compare(s.size() - n, n, suffix);
+}
+
+// Percentiles of every timing, and every memory figure – means and maxima are reported, not gated on
+static bool Compared(const std::string& key)
+{
+    if (!key.compare(0, 7, "memory."))
+        return true;
+    return EndsWith(key, "Ms.p50") || EndsWith(key, "Ms.p99") || EndsWith(key, "Ms.p999");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: benchcompare <baseline.json> <result.json> [--tolerance=0.1] [--min-ms=0.05] [--update]\n");
+        return 2;
+    }
+
+    const fs::path baselinePath = argv[1];
+    const fs::path resultPath   = argv[2];
+    double tolerance = 0.1, minMs = 0.05;
+    bool   update    = false;
+    for (int i = 3; i < argc; ++i)
+    {
+        if (!strncmp(argv[i], "--tolerance=", 12)) tolerance = atof(argv[i] + 12);
+        else if (!strncmp(argv[i], "--min-ms=", 9)) minMs = atof(argv[i] + 9);
+        else if (!strcmp(argv[i], "--update"))      update = true;
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::map<std::string, std::string> result, baseline;
+    if (!Load(resultPath, result))
+    {
+        fprintf(stderr, "can't read %s\n", resultPath.string().c_str());
+        return 2;
+    }
+
+    // First run on this machine, or told to – the result becomes the baseline
+    if (update || !fs::exists(baselinePath))
+    {
+        std::error_code ec;
+        if (baselinePath.has_parent_path())
+            fs::create_directories(baselinePath.parent_path(), ec);
+        fs::copy_file(resultPath, baselinePath, fs::copy_options::overwrite_existing, ec);
+        if (ec)
+        {
+            fprintf(stderr, "can't write %s: %s\n", baselinePath.string().c_str(), ec.message().c_str());
+            return 2;
+        }
+        printf("%s: baseline %s\n", result["scene"].c_str(), update ? "updated" : "recorded (there was none)");
+        return 0;
+    }
+    if (!Load(baselinePath, baseline))
+    {
+        fprintf(stderr, "can't read %s\n", baselinePath.string().c_str());
+        return 2;
+    }
+
+    // Numbers from different setups don't mean anything side by side
+    for (const auto& [key, value] : baseline)
+        if (!key.compare(0, 7, "config.") && result[key] != value)
+            printf("warning: %s is %s, baseline has %s\n", key.c_str(), result[key].c_str(), value.c_str());
+
+    printf("%s  (tolerance %.0f%%)\n", result["scene"].c_str(), tolerance * 100.0);
+    printf("  %-28s %14s %14s %8s\n", "", "baseline", "result", "change");
+    int regressions = 0;
+    for (const auto& [key, text] : baseline)
+    {
+        if (!Compared(key))
+            continue;
+        const auto found = result.find(key);
+        if (found == result.end())
+        {
+            printf("  %-28s %14s %14s  missing\n", key.c_str(), text.c_str(), "-");
+            continue;
+        }
+        const double before = atof(text.c_str());
+        const double after  = atof(found->second.c_str());
+        const double slack  = before * tolerance + (key.compare(0, 7, "memory.") ? minMs : 0.0);
+        const bool   worse  = after > before + slack;
+        regressions += worse ? 1 : 0;
+        printf("  %-28s %14.4g %14.4g %+7.1f%%%s\n", key.c_str(), before, after,
+               before > 0.0 ? (after - before) * 100.0 / before : 0.0, worse ? "  REGRESSION" : "");
+    }
+
+    if (regressions)
+    {
+        printf("%d regression%s against %s\n", regressions, regressions == 1 ? "" : "s", baselinePath.string().c_str());
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------
+// shaderpack – offline HLSL -> DXIL build step
+// ---------------------------------------------------------------
+// Compiles every shader in the manifest with dxc (SM 6.x) and packs the
+// results into one archive the engine memory-maps at startup.
+//
+//   shaderpack shaders/shaders.txt shaders.pak [--dxc path\to\dxc.exe] [--debug]
+//
+// Build: cl /EHsc /std:c++20 /O2 tools\shaderpack.cpp /Fe:tools\shaderpack.exe
+#include "../shaderpak.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static bool ReadFile(const fs::path& path, std::vector<char>& out)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: shaderpack <manifest> <out.pak> [--dxc <path>] [--debug]\n");
+        return 1;
+    }
+
+    std::string dxc = "dxc";
+    bool debug = false;
+    for (int i = 3; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--dxc") && i + 1 < argc) dxc = argv[++i];
+        else if (!strcmp(argv[i], "--debug"))          debug = true;
+    }
+
+    std::vector<ShaderManifestEntry> manifest = ParseShaderManifest(argv[1]);
+    if (manifest.empty())
+    {
+        fprintf(stderr, "shaderpack: no shaders in %s\n", argv[1]);
+        return 1;
+    }
+
+    fs::path outPath = argv[2];
+    fs::path objDir  = outPath;
+    objDir += ".obj";
+    fs::create_directories(objDir);
+
+    std::vector<ShaderPakEntry>    entries;
+    std::vector<std::vector<char>> blobs;
+
+    for (const ShaderManifestEntry& shader : manifest)
+    {
+        if (shader.name.size() >= sizeof(ShaderPakEntry::name))
+        {
+            fprintf(stderr, "shaderpack: name too long: %s\n", shader.name.c_str());
+            return 1;
+        }
+
+        fs::path obj = objDir / (shader.name + ".dxil");
+        std::string cmd = "\"" + dxc + "\" -nologo -T " + shader.profile + " -E " + shader.entry;
+        for (const std::string& d : shader.defines)
+            cmd += " -D " + d;
+        cmd += std::string(" ") + (debug ? kShaderFlagsDebug : kShaderFlagsRelease);
+        cmd += " -Fo \"" + obj.string() + "\" \"" + shader.file + "\"";
+
+        printf("%s\n", shader.name.c_str());
+        fflush(stdout);
+#ifdef _WIN32
+        cmd = "\"" + cmd + "\"";    // cmd.exe strips the outer pair of quotes
+#endif
+        if (std::system(cmd.c_str()) != 0)
+        {
+            fprintf(stderr, "shaderpack: dxc failed on %s\n", shader.name.c_str());
+            return 1;
+        }
+
+        std::vector<char> blob;
+        if (!ReadFile(obj, blob))
+        {
+            fprintf(stderr, "shaderpack: missing output %s\n", obj.string().c_str());
+            return 1;
+        }
+
+        ShaderPakEntry e{};
+        e.nameHash = HashString(shader.name.c_str());
+        e.size     = blob.size();
+        memcpy(e.name, shader.name.c_str(), shader.name.size());
+        entries.push_back(e);
+        blobs.push_back(std::move(blob));
+    }
+
+    // Sort by hash so the runtime can binary search, and refuse collisions
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return entries[a].nameHash < entries[b].nameHash; });
+    for (size_t i = 1; i < order.size(); ++i)
+    {
+        if (entries[order[i]].nameHash == entries[order[i - 1]].nameHash)
+        {
+            fprintf(stderr, "shaderpack: duplicate or colliding name %s / %s\n",
+                    entries[order[i]].name, entries[order[i - 1]].name);
+            return 1;
+        }
+    }
+
+    uint64_t offset = sizeof(ShaderPakHeader) + sizeof(ShaderPakEntry) * entries.size();
+    std::vector<ShaderPakEntry> sorted;
+    for (size_t i : order)
+    {
+        offset = (offset + 15) & ~15ull;
+        ShaderPakEntry e = entries[i];
+        e.offset = offset;
+        offset  += e.size;
+        sorted.push_back(e);
+    }
+
+    std::ofstream out(outPath, std::ios::binary);
+    ShaderPakHeader header{ kShaderPakMagic, kShaderPakVersion, (uint32_t)sorted.size(), 0 };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sorted.data()), sizeof(ShaderPakEntry) * sorted.size());
+
+    uint64_t written = sizeof(ShaderPakHeader) + sizeof(ShaderPakEntry) * sorted.size();
+    for (size_t n = 0; n < order.size(); ++n)
+    {
+        static const char zeros[16] = {};
+        out.write(zeros, (std::streamsize)(sorted[n].offset - written));
+        out.write(blobs[order[n]].data(), (std::streamsize)blobs[order[n]].size());
+        written = sorted[n].offset + sorted[n].size;
+    }
+
+    if (!out)
+    {
+        fprintf(stderr, "shaderpack: failed to write %s\n", outPath.string().c_str());
+        return 1;
+    }
+    printf("shaderpack: %zu shaders -> %s\n", sorted.size(), outPath.string().c_str());
+    return 0;
+}
@@ -0,0 +1,326 @@
+// ---------------------------------------------------------------
+// Resource uploads – copy queue + ring-buffered upload heap
+// ---------------------------------------------------------------
+// Data is staged in one big persistently mapped UPLOAD buffer and copied
+// into DEFAULT heap resources on a dedicated COPY queue, so streaming never
+// blocks the direct queue.
+//
+//   UINT64 ticket = uploader.Flush();            // after queueing copies
+//   uploader.QueueWait(g_commandQueue, ticket);  // GPU-side, before first use
+//   ...or poll uploader.IsComplete(ticket) and only use the resource afterwards
+//
+// Destinations must be in COMMON state. Buffers and read-only texture states
+// are promoted implicitly on both queues, so no barriers are needed here.
+#pragma once
+
+#include "dxhelpers.h"
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+class Uploader
+{
+public:
+    void Init(ID3D12Device* device, UINT64 ringSize = 64ull * 1024 * 1024)
+    {
+        m_device   = device;
+        m_ringSize = ringSize;
+
+        D3D12_COMMAND_QUEUE_DESC queueDesc{};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+        ThrowIfFailed(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_queue)));
+
+        ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+
+        m_ring = CreateBuffer(device, ringSize, D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ);
+        D3D12_RANGE readRange{ 0, 0 };
+        ThrowIfFailed(m_ring->Map(0, &readRange, reinterpret_cast<void**>(&m_ringCpu)));
+    }
+
+    void Shutdown()
+    {
+        if (!m_queue)
+            return;
+        WaitCpu(Flush());
+    }
+
+    ID3D12CommandQueue* Queue() const { return m_queue.Get(); }
+
+    // Queues a copy of `size` bytes into dst at dstOffset
+    void UploadBuffer(ID3D12Resource* dst, UINT64 dstOffset, const void* data, UINT64 size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Staging staging = AllocateStaging(size, 16);
+        memcpy(staging.cpu, data, size);
+        OpenList()->CopyBufferRegion(dst, dstOffset, staging.resource, staging.offset, size);
+    }
+
+    // Queues copies for subresources [first, first + count) of a texture
+    void UploadTexture(ID3D12Resource* dst, const D3D12_SUBRESOURCE_DATA* data, UINT first, UINT count)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        D3D12_RESOURCE_DESC desc = dst->GetDesc();
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(count);
+        std::vector<UINT>   numRows(count);
+        std::vector<UINT64> rowSizes(count);
+        UINT64 totalBytes = 0;
+        m_device->GetCopyableFootprints(&desc, first, count, 0,
+                                        layouts.data(), numRows.data(), rowSizes.data(), &totalBytes);
+
+        Staging staging = AllocateStaging(totalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        ID3D12GraphicsCommandList* cl = OpenList();
+
+        for (UINT i = 0; i < count; ++i)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = layouts[i];
+            const UINT slices = layout.Footprint.Depth;
+            for (UINT z = 0; z < slices; ++z)
+            {
+                for (UINT row = 0; row < numRows[i]; ++row)
+                {
+                    UINT8* dstRow = staging.cpu + layout.Offset
+                                  + (UINT64)z * layout.Footprint.RowPitch * numRows[i]
+                                  + (UINT64)row * layout.Footprint.RowPitch;
+                    const UINT8* srcRow = static_cast<const UINT8*>(data[i].pData)
+                                        + (UINT64)z * data[i].SlicePitch
+                                        + (UINT64)row * data[i].RowPitch;
+                    memcpy(dstRow, srcRow, (size_t)rowSizes[i]);
+                }
+            }
+
+            D3D12_TEXTURE_COPY_LOCATION dstLoc{};
+            dstLoc.pResource        = dst;
+            dstLoc.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dstLoc.SubresourceIndex = first + i;
+
+            D3D12_TEXTURE_COPY_LOCATION srcLoc{};
+            srcLoc.pResource        = staging.resource;
+            srcLoc.Type             = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            srcLoc.PlacedFootprint  = layout;
+            srcLoc.PlacedFootprint.Offset += staging.offset;
+
+            cl->CopyTextureRegion(&dstLoc, 0, 0, 0, &srcLoc, nullptr);
+        }
+    }
+
+    // Queues a copy of block rows [firstRow, firstRow + rowCount) of one subresource. `data` is
+    // already in copy layout – rows rowPitch apart, the pitch GetCopyableFootprints() gives.
+    // The whole subresource goes in one copy; pieces of it need 4-row-aligned mips (BC, >= 4 texels).
+    void UploadTextureRows(ID3D12Resource* dst, UINT subresource, const void* data, UINT rowPitch,
+                           UINT firstRow, UINT rowCount)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        D3D12_RESOURCE_DESC desc = dst->GetDesc();
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout{};
+        UINT   numRows  = 0;
+        UINT64 rowSize  = 0, totalBytes = 0;
+        m_device->GetCopyableFootprints(&desc, subresource, 1, 0, &layout, &numRows, &rowSize, &totalBytes);
+        if (layout.Footprint.RowPitch != rowPitch || firstRow + rowCount > numRows)
+            throw std::runtime_error("Texture data doesn't match the subresource's copy footprint");
+
+        const UINT64 size    = (UINT64)rowPitch * rowCount;
+        Staging      staging = AllocateStaging(size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        memcpy(staging.cpu, data, size);
+
+        // Texel rows per row of data: 4 for block compressed formats
+        const UINT blockHeight = layout.Footprint.Height / numRows;
+        D3D12_TEXTURE_COPY_LOCATION dstLoc{};
+        dstLoc.pResource        = dst;
+        dstLoc.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLoc.SubresourceIndex = subresource;
+
+        D3D12_TEXTURE_COPY_LOCATION srcLoc{};
+        srcLoc.pResource       = staging.resource;
+        srcLoc.Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLoc.PlacedFootprint = layout;
+        srcLoc.PlacedFootprint.Offset = staging.offset;
+        if (rowCount != numRows)
+            srcLoc.PlacedFootprint.Footprint.Height = rowCount * blockHeight;
+
+        OpenList()->CopyTextureRegion(&dstLoc, 0, firstRow * blockHeight, 0, &srcLoc, nullptr);
+    }
+
+    // Submits everything queued so far. The returned ticket is reached once those copies land.
+    UINT64 Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return FlushLocked();
+    }
+
+    bool IsComplete(UINT64 ticket) const { return m_fence->GetCompletedValue() >= ticket; }
+
+    // GPU-side wait: `queue` won't run past this point until the copies are done
+    void QueueWait(ID3D12CommandQueue* queue, UINT64 ticket)
+    {
+        if (!IsComplete(ticket))
+            ThrowIfFailed(queue->Wait(m_fence.Get(), ticket));
+    }
+
+    // A null event makes SetEventOnCompletion block, which is safe from any thread
+    void WaitCpu(UINT64 ticket)
+    {
+        if (!IsComplete(ticket))
+            ThrowIfFailed(m_fence->SetEventOnCompletion(ticket, nullptr));
+    }
+
+private:
+    struct Staging
+    {
+        ID3D12Resource* resource;
+        UINT64          offset;
+        UINT8*          cpu;
+    };
+
+    // Ring space handed out up to `end`, reusable once `fenceValue` completes
+    struct Retirement
+    {
+        UINT64                 fenceValue;
+        UINT64                 end;
+        ComPtr<ID3D12Resource> oversized;   // set for allocations that didn't fit the ring
+    };
+
+    struct PooledAllocator
+    {
+        ComPtr<ID3D12CommandAllocator> allocator;
+        UINT64                         fenceValue;
+    };
+
+    ID3D12GraphicsCommandList* OpenList()
+    {
+        if (m_listOpen)
+            return m_list.Get();
+
+        // Recycle the oldest allocator if the GPU is done with it
+        ComPtr<ID3D12CommandAllocator> allocator;
+        if (!m_allocatorPool.empty() && IsComplete(m_allocatorPool.front().fenceValue))
+        {
+            allocator = m_allocatorPool.front().allocator;
+            m_allocatorPool.pop_front();
+            ThrowIfFailed(allocator->Reset());
+        }
+        else
+        {
+            ThrowIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY,
+                                                           IID_PPV_ARGS(&allocator)));
+        }
+
+        if (!m_list)
+        {
+            ThrowIfFailed(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY,
+                                                      allocator.Get(), nullptr, IID_PPV_ARGS(&m_list)));
+        }
+        else
+        {
+            ThrowIfFailed(m_list->Reset(allocator.Get(), nullptr));
+        }
+
+        m_currentAllocator = allocator;
+        m_listOpen = true;
+        return m_list.Get();
+    }
+
+    UINT64 FlushLocked()
+    {
+        if (!m_listOpen)
+            return m_lastSubmitted;
+
+        ThrowIfFailed(m_list->Close());
+        ID3D12CommandList* lists[] = { m_list.Get() };
+        m_queue->ExecuteCommandLists(1, lists);
+
+        const UINT64 value = ++m_lastSubmitted;
+        ThrowIfFailed(m_queue->Signal(m_fence.Get(), value));
+
+        m_allocatorPool.push_back({ m_currentAllocator, value });
+        m_currentAllocator.Reset();
+        m_listOpen = false;
+
+        // Everything allocated since the last flush is freed by this fence value
+        if (m_head != m_retiredEnd || !m_oversized.empty())
+        {
+            m_retirements.push_back({ value, m_head, nullptr });
+            for (ComPtr<ID3D12Resource>& big : m_oversized)
+                m_retirements.push_back({ value, m_head, big });
+            m_oversized.clear();
+            m_retiredEnd = m_head;
+        }
+        return value;
+    }
+
+    void RetireCompleted()
+    {
+        while (!m_retirements.empty() && IsComplete(m_retirements.front().fenceValue))
+        {
+            m_tail = m_retirements.front().end;
+            m_retirements.pop_front();
+        }
+    }
+
+    // Free bytes in the ring, treating head/tail as monotonically growing offsets
+    UINT64 FreeSpace() const { return m_ringSize - (m_head - m_tail); }
+
+    Staging AllocateStaging(UINT64 size, UINT64 alignment)
+    {
+        // Too big for the ring – give it a throwaway buffer that is released with its fence
+        if (size + alignment > m_ringSize / 2)
+        {
+            ComPtr<ID3D12Resource> big = CreateBuffer(m_device, size, D3D12_HEAP_TYPE_UPLOAD,
+                                                      D3D12_RESOURCE_STATE_GENERIC_READ);
+            UINT8* cpu = nullptr;
+            D3D12_RANGE readRange{ 0, 0 };
+            ThrowIfFailed(big->Map(0, &readRange, reinterpret_cast<void**>(&cpu)));
+            m_oversized.push_back(big);
+            return { big.Get(), 0, cpu };
+        }
+
+        while (true)
+        {
+            RetireCompleted();
+
+            // Allocations never straddle the end of the ring; skip to the start instead
+            UINT64 offset = AlignUp(m_head % m_ringSize, alignment);
+            UINT64 skip   = offset - m_head % m_ringSize;
+            if (offset + size > m_ringSize)
+            {
+                skip   = m_ringSize - m_head % m_ringSize;
+                offset = 0;
+            }
+
+            if (skip + size <= FreeSpace())
+            {
+                m_head += skip + size;
+                return { m_ring.Get(), offset, m_ringCpu + offset };
+            }
+
+            // Ring is full: push what we have and wait for the oldest batch
+            FlushLocked();
+            if (!m_retirements.empty())
+                WaitCpu(m_retirements.front().fenceValue);
+        }
+    }
+
+    ID3D12Device*                       m_device = nullptr;
+    ComPtr<ID3D12CommandQueue>          m_queue;
+    ComPtr<ID3D12GraphicsCommandList>   m_list;
+    ComPtr<ID3D12CommandAllocator>      m_currentAllocator;
+    std::deque<PooledAllocator>         m_allocatorPool;
+    bool                                m_listOpen = false;
+
+    ComPtr<ID3D12Fence>                 m_fence;
+    UINT64                              m_lastSubmitted = 0;
+
+    ComPtr<ID3D12Resource>              m_ring;
+    UINT8*                              m_ringCpu    = nullptr;
+    UINT64                              m_ringSize   = 0;
+    UINT64                              m_head       = 0;   // monotonic byte counters
+    UINT64                              m_tail       = 0;
+    UINT64                              m_retiredEnd = 0;
+    std::deque<Retirement>              m_retirements;
+    std::vector<ComPtr<ID3D12Resource>> m_oversized;
+
+    std::mutex                          m_mutex;
+};